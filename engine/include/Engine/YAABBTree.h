@@ -0,0 +1,278 @@
+#pragma once
+#include "Engine/YBVH.h"
+#include "Math/YBox.h"
+#include "Math/YFrustum.h"
+#include <cstdint>
+#include <vector>
+
+// node of YAABBTree, a leaf holds one proxy
+struct YAABBTreeNode
+{
+	// the fat box of a leaf, the union of the children of an inner node
+	YBox box;
+	void* user_data = nullptr;
+	// the next free node while the node is unused
+	int parent = -1;
+	int child1 = -1;
+	int child2 = -1;
+	// 0 for a leaf, -1 for a free node
+	int height = -1;
+	bool IsLeaf() const { return child1 < 0; }
+};
+
+// incrementally updated bounding volume hierarchy over moving boxes
+// every proxy is stored with a fat box a little larger than its box, so small moves do not touch the tree,
+// inserts pick the sibling of least surface area cost and the path to the root is refit and rotated back into balance
+// a proxy is the index of its leaf and stays the same until it is destroyed
+// queries are const and may run together, not while the tree changes
+class YAABBTree
+{
+public:
+	// the fat box of a proxy grows by fat_ratio times the largest side of its box, at least min_fat_margin
+	explicit YAABBTree(float fat_ratio = 0.1f, float min_fat_margin = 0.0f);
+	int CreateProxy(const YBox& box, void* user_data);
+	void DestroyProxy(int proxy);
+	// true when the proxy left its fat box and was reinserted
+	bool MoveProxy(int proxy, const YBox& box);
+	void Clear();
+	void* GetUserData(int proxy) const { return nodes_[proxy].user_data; }
+	const YBox& GetFatBox(int proxy) const { return nodes_[proxy].box; }
+	int GetProxyCount() const { return proxy_count_; }
+	int GetHeight() const { return root_ < 0 ? 0 : nodes_[root_].height + 1; }
+	// func(proxy, user_data) for every proxy, in node order
+	template<typename Func>
+	void ForEachProxy(Func&& func) const
+	{
+		for (int node_index = 0; node_index < (int)nodes_.size(); ++node_index)
+		{
+			if (nodes_[node_index].height == 0)
+			{
+				func(node_index, nodes_[node_index].user_data);
+			}
+		}
+	}
+	// sum of the inner node surface areas over the root one, lower traces faster
+	float GetAreaRatio() const;
+	// checks the links, heights and boxes of every node, for tests
+	bool Validate() const;
+
+	// func(proxy) for every proxy whose fat box overlaps box
+	template<typename Func>
+	void QueryOverlap(const YBox& box, Func&& func) const;
+	// func(query_index, proxy) for every fat box overlapping boxes[query_index], one pass per 32 boxes
+	template<typename Func>
+	void QueryOverlaps(const YBox* boxes, int box_count, Func&& func) const;
+	// func(proxy) for every proxy whose fat box is not outside frustum, subtrees inside it are not tested any more
+	template<typename Func>
+	void QueryFrustum(const YFrustum& frustum, Func&& func) const;
+	// func(query_index, proxy) for every frustum, one pass per 32 frustums, such as the cascades of a shadow
+	template<typename Func>
+	void QueryFrustums(const YFrustum* frustums, int frustum_count, Func&& func) const;
+	// func(proxy) for every fat box an active ray of packet enters before its max_distance, roughly near to far
+	// func may lower packet.max_distance, what lies behind it is skipped from then on
+	template<typename Func>
+	void RayCastPacket(YRayPacket& packet, Func&& func) const;
+
+protected:
+	int AllocateNode();
+	void FreeNode(int node_index);
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	// refit and rebalance from node_index up to the root
+	void RefitAncestors(int node_index);
+	// rotates the higher grandchild above node_index when its children differ in height by more than one
+	// returns the node now at the place of node_index
+	int Balance(int node_index);
+	YBox GetFatBox(const YBox& box) const;
+	std::vector<YAABBTreeNode> nodes_;
+	int root_ = -1;
+	int free_list_ = -1;
+	int proxy_count_ = 0;
+	float fat_ratio_ = 0.1f;
+	float min_fat_margin_ = 0.0f;
+};
+
+template<typename Func>
+void YAABBTree::QueryOverlap(const YBox& box, Func&& func) const
+{
+	if (root_ < 0)
+	{
+		return;
+	}
+	std::vector<int> stack;
+	stack.reserve(64);
+	stack.push_back(root_);
+	while (!stack.empty())
+	{
+		const int node_index = stack.back();
+		stack.pop_back();
+		const YAABBTreeNode& node = nodes_[node_index];
+		if (!node.box.Intersect(box))
+		{
+			continue;
+		}
+		if (node.IsLeaf())
+		{
+			func(node_index);
+		}
+		else
+		{
+			stack.push_back(node.child2);
+			stack.push_back(node.child1);
+		}
+	}
+}
+
+template<typename Func>
+void YAABBTree::QueryOverlaps(const YBox* boxes, int box_count, Func&& func) const
+{
+	if (root_ < 0)
+	{
+		return;
+	}
+	std::vector<std::pair<int, uint32_t>> stack;
+	stack.reserve(64);
+	for (int first = 0; first < box_count; first += 32)
+	{
+		const int count = box_count - first < 32 ? box_count - first : 32;
+		// bit i set while the node may overlap boxes[first + i]
+		stack.emplace_back(root_, count == 32 ? 0xffffffffu : (1u << count) - 1);
+		while (!stack.empty())
+		{
+			const int node_index = stack.back().first;
+			const uint32_t parent_mask = stack.back().second;
+			stack.pop_back();
+			const YAABBTreeNode& node = nodes_[node_index];
+			uint32_t mask = 0;
+			for (uint32_t bits = parent_mask; bits; bits &= bits - 1)
+			{
+				const int i = YMath::CountTrailingZeros(bits);
+				if (node.box.Intersect(boxes[first + i]))
+				{
+					mask |= 1u << i;
+				}
+			}
+			if (!mask)
+			{
+				continue;
+			}
+			if (node.IsLeaf())
+			{
+				for (uint32_t bits = mask; bits; bits &= bits - 1)
+				{
+					func(first + YMath::CountTrailingZeros(bits), node_index);
+				}
+			}
+			else
+			{
+				stack.emplace_back(node.child2, mask);
+				stack.emplace_back(node.child1, mask);
+			}
+		}
+	}
+}
+
+template<typename Func>
+void YAABBTree::QueryFrustum(const YFrustum& frustum, Func&& func) const
+{
+	QueryFrustums(&frustum, 1, [&func](int, int proxy) { func(proxy); });
+}
+
+template<typename Func>
+void YAABBTree::QueryFrustums(const YFrustum* frustums, int frustum_count, Func&& func) const
+{
+	if (root_ < 0)
+	{
+		return;
+	}
+	struct Entry
+	{
+		int node_index;
+		// frustums that may see the node, and those of them that contain it completely
+		uint32_t test_mask;
+		uint32_t inside_mask;
+	};
+	std::vector<Entry> stack;
+	stack.reserve(64);
+	for (int first = 0; first < frustum_count; first += 32)
+	{
+		const int count = frustum_count - first < 32 ? frustum_count - first : 32;
+		stack.push_back({ root_, count == 32 ? 0xffffffffu : (1u << count) - 1, 0u });
+		while (!stack.empty())
+		{
+			const Entry entry = stack.back();
+			stack.pop_back();
+			const YAABBTreeNode& node = nodes_[entry.node_index];
+			uint32_t visible_mask = entry.inside_mask;
+			uint32_t inside_mask = entry.inside_mask;
+			for (uint32_t bits = entry.test_mask & ~entry.inside_mask; bits; bits &= bits - 1)
+			{
+				const int i = YMath::CountTrailingZeros(bits);
+				const EFrustumContainment containment = frustums[first + i].ClassifyBox(node.box);
+				visible_mask |= containment != FC_Outside ? 1u << i : 0u;
+				inside_mask |= containment == FC_Inside ? 1u << i : 0u;
+			}
+			if (!visible_mask)
+			{
+				continue;
+			}
+			if (node.IsLeaf())
+			{
+				for (uint32_t bits = visible_mask; bits; bits &= bits - 1)
+				{
+					func(first + YMath::CountTrailingZeros(bits), entry.node_index);
+				}
+			}
+			else
+			{
+				stack.push_back({ node.child2, visible_mask, inside_mask });
+				stack.push_back({ node.child1, visible_mask, inside_mask });
+			}
+		}
+	}
+}
+
+template<typename Func>
+void YAABBTree::RayCastPacket(YRayPacket& packet, Func&& func) const
+{
+	if (root_ < 0)
+	{
+		return;
+	}
+	float entry_distance = 0.0f;
+	std::vector<int> stack;
+	stack.reserve(64);
+	stack.push_back(root_);
+	while (!stack.empty())
+	{
+		const int node_index = stack.back();
+		stack.pop_back();
+		const YAABBTreeNode& node = nodes_[node_index];
+		// tested when popped, a hit found meanwhile may have moved the rays in front of the node
+		if (!packet.IntersectBox(node.box.min_corner, node.box.max_corner, entry_distance))
+		{
+			continue;
+		}
+		if (node.IsLeaf())
+		{
+			func(node_index);
+			continue;
+		}
+		const YAABBTreeNode& child1 = nodes_[node.child1];
+		const YAABBTreeNode& child2 = nodes_[node.child2];
+		float entry1 = 0.0f;
+		float entry2 = 0.0f;
+		const int hit1 = packet.IntersectBox(child1.box.min_corner, child1.box.max_corner, entry1);
+		const int hit2 = packet.IntersectBox(child2.box.min_corner, child2.box.max_corner, entry2);
+		// the nearer child is pushed last and popped first
+		if (hit1 && hit2)
+		{
+			stack.push_back(entry1 <= entry2 ? node.child2 : node.child1);
+			stack.push_back(entry1 <= entry2 ? node.child1 : node.child2);
+		}
+		else if (hit1 || hit2)
+		{
+			stack.push_back(hit1 ? node.child1 : node.child2);
+		}
+	}
+}
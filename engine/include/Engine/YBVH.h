@@ -0,0 +1,105 @@
+#pragma once
+#include "Math/YBox.h"
+#include "Math/YRay.h"
+#include "Math/YSimd.h"
+#include <vector>
+
+// node of a flat bounding volume hierarchy, the root is node 0
+struct YBVHNode
+{
+	YVector min_corner;
+	// inner node: the first child, the second one is first + 1. leaf: the first primitive slot
+	int first = 0;
+	YVector max_corner;
+	// primitives of a leaf, 0 for an inner node
+	int count = 0;
+};
+
+// up to four rays traced together, one sse lane each
+struct alignas(16) YRayPacket
+{
+	static constexpr int max_ray_count = 4;
+	float origin[3][max_ray_count];
+	float direction[3][max_ray_count];
+	// a large value instead of infinity for a 0 direction, so the slab test never multiplies 0 by infinity
+	float inv_direction[3][max_ray_count];
+	// the closest hit so far per ray, boxes and triangles behind it are skipped
+	float max_distance[max_ray_count];
+	// bit per lane with a ray
+	int active_mask = 0;
+	// max_distances may be null for unlimited rays, lanes past ray_count repeat the last ray and stay inactive
+	void Set(const YRay* rays, const float* max_distances, int ray_count);
+	// bit per active lane that enters the box before its max_distance, out_near is the closest entry of them
+	int IntersectBox(const YVector& min_corner, const YVector& max_corner, float& out_near) const;
+};
+
+struct YBVH
+{
+	// nodes this deep are leaves, the traversal stack holds one entry per level
+	static constexpr int max_depth = 64;
+	// binned surface area heuristic over primitive boxes, out_order[slot] is the primitive of a leaf slot
+	// leaves hold at most max_leaf_size primitives unless their centers can not be told apart
+	static void Build(const std::vector<YBox>& boxes, int max_leaf_size, std::vector<YBVHNode>& out_nodes, std::vector<int>& out_order);
+	// as Build, but the split stops at cluster_size primitives, for leaves that are drawn or culled as a whole
+	static void BuildClusters(const std::vector<YBox>& boxes, int cluster_size, std::vector<YBVHNode>& out_nodes, std::vector<int>& out_order);
+	static int GetDepth(const std::vector<YBVHNode>& nodes);
+	// leaf_func(first, count) for every leaf an active ray of packet reaches, the nearer child first
+	// leaf_func may lower packet.max_distance, what lies behind it is skipped from then on
+	template<typename LeafFunc>
+	static void TracePacket(const std::vector<YBVHNode>& nodes, YRayPacket& packet, LeafFunc&& leaf_func);
+protected:
+	static void BuildNodes(const std::vector<YBox>& boxes, int max_leaf_size, bool is_leaf_at_max_size, std::vector<YBVHNode>& out_nodes, std::vector<int>& out_order);
+};
+
+template<typename LeafFunc>
+void YBVH::TracePacket(const std::vector<YBVHNode>& nodes, YRayPacket& packet, LeafFunc&& leaf_func)
+{
+	float entry = 0.0f;
+	if (nodes.empty() || !packet.IntersectBox(nodes[0].min_corner, nodes[0].max_corner, entry))
+	{
+		return;
+	}
+	int stack[max_depth];
+	int stack_size = 0;
+	int node_index = 0;
+	while (true)
+	{
+		const YBVHNode& node = nodes[node_index];
+		if (node.count > 0)
+		{
+			leaf_func(node.first, node.count);
+		}
+		else
+		{
+			const YBVHNode& left = nodes[node.first];
+			const YBVHNode& right = nodes[node.first + 1];
+			float left_entry = 0.0f;
+			float right_entry = 0.0f;
+			const int left_hit = packet.IntersectBox(left.min_corner, left.max_corner, left_entry);
+			const int right_hit = packet.IntersectBox(right.min_corner, right.max_corner, right_entry);
+			if (left_hit && right_hit)
+			{
+				const bool left_first = left_entry <= right_entry;
+				stack[stack_size++] = left_first ? node.first + 1 : node.first;
+				node_index = left_first ? node.first : node.first + 1;
+				continue;
+			}
+			if (left_hit || right_hit)
+			{
+				node_index = left_hit ? node.first : node.first + 1;
+				continue;
+			}
+		}
+		// a node pushed before a hit may lie behind it now
+		bool found = false;
+		while (stack_size > 0 && !found)
+		{
+			node_index = stack[--stack_size];
+			found = packet.IntersectBox(nodes[node_index].min_corner, nodes[node_index].max_corner, entry) != 0;
+		}
+		if (!found)
+		{
+			return;
+		}
+	}
+}
@@ -1,11 +1,13 @@
 #pragma once
 #include "Math/YMatrix.h"
 #include "Math/YRotator.h"
+#include "Math/YRay.h"
 #include <memory>
 
 struct CameraElementProxy
 {
-	YVector position_;
+	// w 1, a position
+	YVectorRegister position_;
 	YRotator rotation_;
 	YMatrix inv_view_matrix_;
 	YMatrix view_matrix_;
@@ -37,6 +39,9 @@ public:
 	bool IsPerspectiveCamera() const;
 	YVector GetPosition() const;
 	YRotator GetRotator() const;
+	// world space ray through pixel (x, y) of a viewport_width x viewport_height view, from the near plane
+	// the direction has unit length
+	YRay GetScreenRay(float x, float y, float viewport_width, float viewport_height) const;
 
 	void SetNearPlane(float near_plane);
 	void SetFarPlane(float far_plane);
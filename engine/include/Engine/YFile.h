@@ -1,4 +1,6 @@
 #pragma  once
+#include <cstdio>
+#include <cstring>
 #include <string>
 #include <vector>
 #include <memory>
@@ -27,6 +29,8 @@ public:
 	YFile(const std::string& path, FileType type);
 	std::unique_ptr<MemoryFile> ReadFile();
 	bool WriteFile(const MemoryFile* memory_file, bool create_directory_recurvie = true);
+	// for writers that stream into the file, closed by the caller with fclose, nullptr on error
+	FILE* OpenForWrite(bool create_directory_recurvie = true);
 	inline FileType GetFileType() const {
 		return type_;
 	};
@@ -20,6 +20,8 @@ public:
 	std::vector<std::function<void(char c)>> key_up_funcs_;
 	std::vector < std::function<void(int x, int y)>> mouse_move_functions_;
 	std::vector < std::function<void(int x, int y, float z_delta)>> mouse_wheel_functions_;
+	void OnEventLButtonDown(int x, int y);
+	void OnEventLButtonUp(int x, int y);
 	void OnEventRButtonDown(int x, int y);
 	void OnEventRButtonUp(int x, int y);
 	void OnEventKeyDown(char c);
@@ -6,6 +6,7 @@
 #include <sstream>
 #include <iostream>
 #include <cassert>
+#include <mutex>
 enum LogType {
 	EVerbos = 0,
 	EWarning = 1,
@@ -14,6 +15,8 @@ enum LogType {
 extern std::string g_verbo_log;
 extern std::string g_warning_log;
 extern std::string g_error_log;
+// logs may come from task system workers
+std::mutex& GetLogMutex();
 
 template <typename ...Args>
 void MyTraceImplTmp(LogType log_type, int line, const char* fileName, Args&& ...args) {
@@ -33,6 +36,7 @@ void MyTraceImplTmp(LogType log_type, int line, const char* fileName, Args&& ...
 		break;
 	}
 	stream << log_name;
+	std::lock_guard<std::mutex> lock(GetLogMutex());
 	switch (log_type)
 	{
 	case LogType::EVerbos:
@@ -0,0 +1,57 @@
+#pragma once
+#include "Engine/YBVH.h"
+#include "Engine/YRawMesh.h"
+#include <cfloat>
+
+// the triangle a ray hit, the hit point is (1 - u - v) * v0 + u * v1 + v * v2 over vertex_instances
+struct YMeshHit
+{
+	// along the ray, in units of the length of its direction
+	float distance = FLT_MAX;
+	float u = 0.0f;
+	float v = 0.0f;
+	int polygon = INVALID_ID;
+	int polygon_group = INVALID_ID;
+	int vertex_instances[3] = { INVALID_ID, INVALID_ID, INVALID_ID };
+	bool IsValid() const { return polygon != INVALID_ID; }
+};
+
+// bounding volume hierarchy over the triangles of one YLODMesh, in the space of the mesh
+// the triangles are copied in leaf order, the mesh is not referenced after Build
+// queries are const and may run on any thread
+class YMeshBVH
+{
+public:
+	// false for a mesh without triangles
+	bool Build(const YLODMesh& lod_mesh);
+	// closest hits of up to four rays, a valid hit is only replaced by a closer one
+	// hits[i].distance is the limit of ray i, FLT_MAX for a new YMeshHit
+	void IntersectPacket(const YRay* rays, int ray_count, YMeshHit* hits) const;
+	// true when hit was replaced
+	bool Intersect(const YRay& ray, YMeshHit& hit) const;
+	const YBox& GetBounds() const { return bounds_; }
+	int GetTriangleCount() const { return (int)triangles_.size(); }
+	int GetNodeCount() const { return (int)nodes_.size(); }
+	int GetDepth() const { return YBVH::GetDepth(nodes_); }
+	size_t GetResourceSize() const;
+	static constexpr int max_leaf_size = 4;
+protected:
+	// edges from v0 for the moller trumbore test
+	struct Triangle
+	{
+		YVector v0;
+		YVector edge1;
+		YVector edge2;
+	};
+	// what a hit reports, read only for the closest triangle
+	struct TriangleSource
+	{
+		int polygon;
+		int polygon_group;
+		int vertex_instances[3];
+	};
+	std::vector<YBVHNode> nodes_;
+	std::vector<Triangle> triangles_;
+	std::vector<TriangleSource> sources_;
+	YBox bounds_;
+};
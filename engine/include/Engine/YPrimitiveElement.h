@@ -1,6 +1,7 @@
 #pragma once
 #include "Engine/YStaticMesh.h"
 #include "Math/YMatrix.h"
+#include "Math/YVectorRegister.h"
 
 
 struct PrimitiveElementProxy
@@ -11,11 +12,21 @@ public:
 	YMatrix local_to_world_ = YMatrix::Identity;
 };
 
+// instances of one mesh drawn with one instanced draw, their world matrices are a range of YRenderScene::instance_matrices_
+struct InstancedElementProxy
+{
+public:
+	YStaticMesh* mesh_{ nullptr };
+	int first_instance_ = 0;
+	int instance_count_ = 0;
+};
+
 struct DirectLightElementProxy
 {
 public:
 	DirectLightElementProxy();
-	YVector light_dir=YVector::forward_vector;
+	// w 0, a direction
+	YVectorRegister light_dir = YVectorRegister(YVector::forward_vector);
 	YVector4 light_color= YVector4(1.0f,1.0f,1.0f,1.0f);
 	float light_strength = 1.0f;
 };
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 #include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
 #include "YLog.h"
 /** A virtual interface for ref counted objects to implement. */
 class IRefCountedObject
@@ -11,35 +14,196 @@ public:
 };
 
 
+enum class ERefCountMode
+{
+	// plain counter, the object must stay on one thread
+	NotThreadSafe,
+	// atomic counter, AddRef is relaxed, Release is acquire/release
+	ThreadSafe
+};
+
+/**
+ * Shared between an object and its weak references, outlives the object.
+ * The lock is only taken by TWeakRefPtr::Pin and by the final Release of an object that has weak references.
+ */
+template<ERefCountMode Mode>
+class TRefCountedObject;
+
+template<ERefCountMode Mode>
+class TWeakReferenceProxy
+{
+public:
+	typedef typename std::conditional<Mode == ERefCountMode::ThreadSafe, std::atomic<uint32_t>, uint32_t>::type CounterType;
+	explicit TWeakReferenceProxy(const TRefCountedObject<Mode>* InObject) : Object(InObject), NumWeakRefs(1) {}
+	void AddWeakRef()
+	{
+		if constexpr (Mode == ERefCountMode::ThreadSafe)
+		{
+			NumWeakRefs.fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			++NumWeakRefs;
+		}
+	}
+	void ReleaseWeakRef()
+	{
+		if constexpr (Mode == ERefCountMode::ThreadSafe)
+		{
+			if (NumWeakRefs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				delete this;
+			}
+		}
+		else
+		{
+			if (--NumWeakRefs == 0)
+			{
+				delete this;
+			}
+		}
+	}
+	// nullptr once the object started destruction
+	const TRefCountedObject<Mode>* Object;
+	std::mutex Mutex;
+private:
+	CounterType NumWeakRefs;
+};
+
 /**
  * The base class of reference counted objects.
+ * The counting policy is chosen per class, single threaded objects pay nothing for the atomic version.
  */
-class  YRefCountedObject
+template<ERefCountMode Mode>
+class TRefCountedObject
 {
 public:
-	YRefCountedObject() : NumRefs(0) {}
-	virtual ~YRefCountedObject() { assert(!NumRefs); }
+	typedef TWeakReferenceProxy<Mode> WeakProxyType;
+	typedef typename std::conditional<Mode == ERefCountMode::ThreadSafe, std::atomic<uint32_t>, uint32_t>::type CounterType;
+	TRefCountedObject() : NumRefs(0), WeakProxy(nullptr) {}
+	virtual ~TRefCountedObject()
+	{
+		assert(!GetRefCount());
+		WeakProxyType* Proxy = LoadWeakProxy();
+		if (Proxy)
+		{
+			Proxy->ReleaseWeakRef();
+		}
+	}
 	uint32_t AddRef() const
 	{
-		return uint32_t(++NumRefs);
+		if constexpr (Mode == ERefCountMode::ThreadSafe)
+		{
+			return NumRefs.fetch_add(1, std::memory_order_relaxed) + 1;
+		}
+		else
+		{
+			return uint32_t(++NumRefs);
+		}
 	}
 	uint32_t Release() const
 	{
-		uint32_t Refs = uint32_t(--NumRefs);
+		uint32_t Refs = 0;
+		if constexpr (Mode == ERefCountMode::ThreadSafe)
+		{
+			Refs = NumRefs.fetch_sub(1, std::memory_order_acq_rel) - 1;
+		}
+		else
+		{
+			Refs = uint32_t(--NumRefs);
+		}
 		if (Refs == 0)
 		{
+			WeakProxyType* Proxy = LoadWeakProxy();
+			if (Proxy)
+			{
+				// a Pin holding the lock keeps the memory alive until it gives up
+				std::lock_guard<std::mutex> Lock(Proxy->Mutex);
+				Proxy->Object = nullptr;
+			}
 			delete this;
 		}
 		return Refs;
 	}
 	uint32_t GetRefCount() const
 	{
-		return uint32_t(NumRefs);
+		if constexpr (Mode == ERefCountMode::ThreadSafe)
+		{
+			return NumRefs.load(std::memory_order_relaxed);
+		}
+		else
+		{
+			return uint32_t(NumRefs);
+		}
+	}
+	// AddRef unless the object is already being destroyed
+	bool TryAddRef() const
+	{
+		if constexpr (Mode == ERefCountMode::ThreadSafe)
+		{
+			uint32_t Refs = NumRefs.load(std::memory_order_relaxed);
+			while (Refs != 0)
+			{
+				if (NumRefs.compare_exchange_weak(Refs, Refs + 1, std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+		else
+		{
+			if (NumRefs == 0)
+			{
+				return false;
+			}
+			++NumRefs;
+			return true;
+		}
+	}
+	// created on first use, owned by the object and every weak reference
+	WeakProxyType* GetWeakProxy() const
+	{
+		WeakProxyType* Proxy = LoadWeakProxy();
+		if (Proxy)
+		{
+			return Proxy;
+		}
+		WeakProxyType* NewProxy = new WeakProxyType(this);
+		if constexpr (Mode == ERefCountMode::ThreadSafe)
+		{
+			if (!WeakProxy.compare_exchange_strong(Proxy, NewProxy, std::memory_order_acq_rel))
+			{
+				delete NewProxy;
+				return Proxy;
+			}
+		}
+		else
+		{
+			WeakProxy = NewProxy;
+		}
+		return NewProxy;
 	}
 private:
-	mutable uint32_t NumRefs;
+	WeakProxyType* LoadWeakProxy() const
+	{
+		if constexpr (Mode == ERefCountMode::ThreadSafe)
+		{
+			return WeakProxy.load(std::memory_order_acquire);
+		}
+		else
+		{
+			return WeakProxy;
+		}
+	}
+	typedef typename std::conditional<Mode == ERefCountMode::ThreadSafe, std::atomic<WeakProxyType*>, WeakProxyType*>::type ProxyPointerType;
+	mutable CounterType NumRefs;
+	mutable ProxyPointerType WeakProxy;
 };
 
+typedef TRefCountedObject<ERefCountMode::NotThreadSafe> YRefCountedObject;
+typedef TRefCountedObject<ERefCountMode::ThreadSafe> YThreadSafeRefCountedObject;
+
 
 /**
  * A smart pointer to an object which implements AddRef/Release.
@@ -200,6 +364,100 @@ inline bool operator==(ReferencedType* A, const TRefCountPtr<ReferencedType>& B)
 	return A == B.GetReference();
 }
 
+/**
+ * A weak reference to an object derived from TRefCountedObject, does not keep the object alive.
+ * Pin() returns a strong reference or nullptr if the object is gone, safe across threads for thread safe objects.
+ */
+template<typename ReferencedType>
+class TWeakRefPtr
+{
+	typedef typename ReferencedType::WeakProxyType ProxyType;
+public:
+	TWeakRefPtr() :Proxy(nullptr) {}
+	TWeakRefPtr(const ReferencedType* InReference)
+		:Proxy(InReference ? InReference->GetWeakProxy() : nullptr)
+	{
+		if (Proxy)
+		{
+			Proxy->AddWeakRef();
+		}
+	}
+	TWeakRefPtr(const TRefCountPtr<ReferencedType>& InPtr)
+		:TWeakRefPtr(InPtr.GetReference())
+	{
+	}
+	TWeakRefPtr(const TWeakRefPtr& Copy)
+		:Proxy(Copy.Proxy)
+	{
+		if (Proxy)
+		{
+			Proxy->AddWeakRef();
+		}
+	}
+	TWeakRefPtr(TWeakRefPtr&& Copy)
+		:Proxy(Copy.Proxy)
+	{
+		Copy.Proxy = nullptr;
+	}
+	~TWeakRefPtr()
+	{
+		if (Proxy)
+		{
+			Proxy->ReleaseWeakRef();
+		}
+	}
+	TWeakRefPtr& operator=(const TWeakRefPtr& InPtr)
+	{
+		TWeakRefPtr Tmp(InPtr);
+		Swap(Tmp);
+		return *this;
+	}
+	TWeakRefPtr& operator=(TWeakRefPtr&& InPtr)
+	{
+		TWeakRefPtr Tmp(std::move(InPtr));
+		Swap(Tmp);
+		return *this;
+	}
+	TRefCountPtr<ReferencedType> Pin() const
+	{
+		if (!Proxy)
+		{
+			return nullptr;
+		}
+		std::lock_guard<std::mutex> Lock(Proxy->Mutex);
+		if (Proxy->Object && Proxy->Object->TryAddRef())
+		{
+			ReferencedType* Reference = const_cast<ReferencedType*>(static_cast<const ReferencedType*>(Proxy->Object));
+			// TryAddRef already took the reference
+			return TRefCountPtr<ReferencedType>(Reference, false);
+		}
+		return nullptr;
+	}
+	// may be stale by the time the caller looks at it, use Pin to access the object
+	bool IsValid() const
+	{
+		if (!Proxy)
+		{
+			return false;
+		}
+		std::lock_guard<std::mutex> Lock(Proxy->Mutex);
+		return Proxy->Object != nullptr;
+	}
+	void Reset()
+	{
+		TWeakRefPtr Tmp;
+		Swap(Tmp);
+	}
+	void Swap(TWeakRefPtr& InPtr)
+	{
+		ProxyType* OldProxy = Proxy;
+		Proxy = InPtr.Proxy;
+		InPtr.Proxy = OldProxy;
+	}
+private:
+	ProxyType* Proxy;
+};
+
 namespace std
 {
 	template <typename	T>
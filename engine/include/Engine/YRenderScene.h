@@ -3,17 +3,40 @@
 #include "Engine/YPrimitiveElement.h"
 #include "YLight.h"
 #include "SObject/SStaticMeshComponent.h"
+#include "SObject/SInstancedStaticMeshComponent.h"
 #include <unordered_set>
 #include "YReferenceCount.h"
 #include "SObject/SComponent.h"
+#include "SObject/SComponentStorage.h"
+#include "SObject/SSceneAABBTree.h"
 
+// mesh draws of a frame before and after YRenderScene::MergeInstancedDraws
+struct YDrawMergeStats
+{
+	int primitive_count = 0;
+	// primitives moved into instanced batches
+	int merged_primitive_count = 0;
+	int batch_count = 0;
+	// one per primitive and per instanced element
+	int draw_count_before = 0;
+	int draw_count_after = 0;
+};
 
 class YRenderScene
 {
 public:
 	YRenderScene();
+	// every group of at least min_batch_size primitives drawing the same mesh becomes one instanced element,
+	// the other primitives keep their order
+	// a mesh draws its first lod with its own shaders, so the mesh alone tells which primitives may share a draw
+	void MergeInstancedDraws(int min_batch_size = default_min_merge_batch_size);
+	static constexpr int default_min_merge_batch_size = 2;
 //protected:
 	std::vector<PrimitiveElementProxy> primitive_elements_;
+	std::vector<InstancedElementProxy> instanced_elements_;
+	// world matrices of every instanced element of the frame, uploaded with one copy
+	std::vector<YMatrix> instance_matrices_;
+	YDrawMergeStats draw_merge_stats_;
 	std::vector<DirectLightElementProxy> dir_light_elements_;
 	std::unique_ptr<CameraElementProxy> camera_element;
 	double deta_time = 0.0;
@@ -23,10 +46,15 @@ class YScene
 {
 public:
 	YScene();
-	std::unordered_set<SStaticMeshComponent*> static_meshes_components_;
-	std::unordered_set<SDirectionLightComponent*> direct_light_components_;
+	// components of the owning world, meshes and lights are read from here instead of per scene sets
+	const SComponentStorage* component_storage_ = nullptr;
+	// when set, only the static meshes whose bounds may be seen by camera_ are collected
+	// instanced meshes cull their clusters against camera_ either way
+	const SSceneAABBTree* spatial_tree_ = nullptr;
 	std::unique_ptr<YRenderScene> GenerateOneFrame() const;
 	CameraBase* camera_ = nullptr;
+	// static meshes drawn more than once in a frame are drawn instanced
+	bool merge_instanced_draws_ = true;
 	double deta_time = 0.0;
 	double game_time = 0.0;
 };
\ No newline at end of file
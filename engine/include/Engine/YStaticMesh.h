@@ -4,7 +4,11 @@
 #include <memory>
 #include "RHI/DirectX11/D3D11VertexFactory.h"
 #include "Engine/YCamera.h"
-class YStaticMesh
+#include "Engine/YReferenceCount.h"
+#include "Engine/YMeshBVH.h"
+#include <mutex>
+// shared between components through YStaticMeshCache
+class YStaticMesh : public YThreadSafeRefCountedObject
 {
 public:
 	YStaticMesh();
@@ -12,10 +16,23 @@ public:
 	void ReleaseGPUReosurce();
 	void	Render(CameraBase* camera);
 	void Render(class RenderParam* render_param);
+	// the instanced vertex shader, after AllocGpuResource
+	bool AllocInstancedGpuResource();
+	// instance_count instances whose world matrices are the YMatrix rows of instance_buffer from first_instance on
+	void RenderInstanced(class RenderParam* render_param, ID3D11Buffer* instance_buffer, int first_instance, int instance_count);
 	std::vector<YLODMesh> raw_meshes;
 
 	bool SaveV0(const std::string& dir);
 	bool LoadV0(const std::string& file_path);
+	// approximate cpu side size of the loaded mesh data in bytes
+	size_t GetResourceSize() const;
+	// hierarchy of raw_meshes[lod_index] for ray queries, built by the first call and kept with the mesh
+	// thread safe, nullptr for a missing lod or one without triangles
+	const YMeshBVH* GetBVH(int lod_index = 0);
+	// mesh space box around the vertices of every lod
+	const YBox& GetBounds() const { return bounds_; }
+	// after raw_meshes changed
+	void UpdateBounds();
 public:
 	friend class YStaticMeshVertexFactory;
 	bool allocated_gpu_resource = false;
@@ -29,5 +46,13 @@ public:
 	std::unique_ptr<D3DVertexShader> vertex_shader_;
 	std::unique_ptr<D3DPixelShader> pixel_shader_;
 	std::unique_ptr<DXVertexFactory> vertex_factory_;
+	// null until AllocInstancedGpuResource
+	std::unique_ptr<D3DVertexShader> instanced_vertex_shader_;
+	std::unique_ptr<DXVertexFactory> instanced_vertex_factory_;
 	std::string model_name;
+protected:
+	YBox bounds_;
+	std::mutex bvh_mutex_;
+	// per lod, an empty pointer until built, a failed build keeps a hierarchy without nodes
+	std::vector<std::unique_ptr<YMeshBVH>> bvhs_;
 };
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include "Engine/YStaticMesh.h"
+#include "Engine/YReferenceCount.h"
+
+// one YStaticMesh (and its gpu buffers) per model path, shared by every component that references it
+class YStaticMeshCache
+{
+public:
+	// returns the cached mesh or loads it, a caller asking for a mesh another thread is loading waits for that load
+	TRefCountPtr<YStaticMesh> LoadStaticMesh(const std::string& model_path);
+	// drop meshes only the cache still references, return the number released
+	int ReleaseUnused();
+	int GetCachedMeshCount() const;
+	static std::string GetCacheKey(const std::string& model_path);
+	static YStaticMeshCache& Get();
+protected:
+	struct CacheEntry
+	{
+		TRefCountPtr<YStaticMesh> mesh;
+		bool loading = true;
+	};
+	std::unordered_map<std::string, CacheEntry> meshes_;
+	mutable std::mutex mutex_;
+	std::condition_variable load_finish_cv_;
+};
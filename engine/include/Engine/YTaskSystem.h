@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+// fixed pool of worker threads, the calling thread joins the work while it waits
+class YTaskSystem
+{
+public:
+	YTaskSystem();
+	~YTaskSystem();
+	YTaskSystem(const YTaskSystem&) = delete;
+	YTaskSystem& operator=(const YTaskSystem&) = delete;
+
+	// worker_count < 0 means hardware_concurrency - 1
+	void Init(int worker_count = -1);
+	void Shutdown();
+	int GetWorkerCount() const { return (int)workers_.size(); }
+	// number of batches ParallelFor will split count elements into
+	static int GetBatchCount(int count, int batch_size);
+	// func(batch_index, begin, end), batches run concurrently, returns when all batches finished
+	// nested calls from a worker run inline, calls from different non worker threads share the workers
+	void ParallelFor(int count, int batch_size, const std::function<void(int batch_index, int begin, int end)>& func);
+	static bool IsInWorkerThread();
+	static YTaskSystem& Get();
+protected:
+	struct ParallelJob
+	{
+		const std::function<void(int, int, int)>* func = nullptr;
+		int count = 0;
+		int batch_size = 1;
+		int batch_count = 0;
+		std::atomic<int> next_batch{ 0 };
+		std::atomic<int> finished_batch{ 0 };
+	};
+	void WorkerMain();
+	void RunBatches(ParallelJob* job);
+	// first job that still has unclaimed batches, call with mutex_ locked
+	std::shared_ptr<ParallelJob> FindPendingJob() const;
+	std::vector<std::thread> workers_;
+	std::mutex mutex_;
+	std::condition_variable wake_cv_;
+	std::condition_variable done_cv_;
+	std::vector<std::shared_ptr<ParallelJob>> jobs_;
+	bool exit_ = false;
+	// guards Init and Shutdown, initialized_ is read without it by Get
+	std::mutex init_mutex_;
+	std::atomic<bool> initialized_{ false };
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include "Math/YMath.h"
+#include "Math/YVector.h"
+#include <cstddef>
+struct YMatrix;
+struct YQuat;
+struct YRotator;
+struct YVectorRegister;
+
+// one stream per component, for data kept in structure of arrays form
+struct YVectorSoA
+{
+	float* x = nullptr;
+	float* y = nullptr;
+	float* z = nullptr;
+};
+
+// operations over arrays of vectors and rotations, run by the YMathKernels tables of the current simd level
+// every level gives the same bits as the scalar YVector/YMatrix/YQuat functions, except for the sin and cos below
+// the output may be the input (in place) but must not partially overlap it
+struct YBatchMath
+{
+	// affine, the same as YMatrix::TransformPosition for matrices with a last column of (0, 0, 0, 1)
+	static void TransformPositions(YVector* out, const YMatrix& matrix, const YVector* positions, size_t count);
+	static void TransformPositions(const YVectorSoA& out, const YMatrix& matrix, const YVectorSoA& positions, size_t count);
+	// YMatrix::TransformVector, translation ignored
+	static void TransformVectors(YVector* out, const YMatrix& matrix, const YVector* directions, size_t count);
+	static void TransformVectors(const YVectorSoA& out, const YMatrix& matrix, const YVectorSoA& directions, size_t count);
+	// YMatrix::TransformVector4, w 1 for positions and 0 for directions
+	static void TransformVectors4(YVectorRegister* out, const YMatrix& matrix, const YVectorRegister* v, size_t count);
+	// YVector::GetSafeNormal
+	static void Normalize(YVector* out, const YVector* v, size_t count, float tolerance = SMALL_NUMBER);
+	static void Normalize(const YVectorSoA& out, const YVectorSoA& v, size_t count, float tolerance = SMALL_NUMBER);
+	// a[i] ^ b[i]
+	static void Cross(YVector* out, const YVector* a, const YVector* b, size_t count);
+	static void Cross(const YVectorSoA& out, const YVectorSoA& a, const YVectorSoA& b, size_t count);
+	// per component, count has to be at least 1
+	static void MinMax(YVector& out_min, YVector& out_max, const YVector* v, size_t count);
+	static void MinMax(YVector& out_min, YVector& out_max, const YVectorSoA& v, size_t count);
+
+	// sin and cos of radians, the simd levels use a polynomial within 8e-8 of the exact values for |radian| <= 8192,
+	// the error grows with the angle beyond that
+	static void SinCos(float* out_sin, float* out_cos, const float* radians, size_t count);
+	// YRotator::ToQuat and YRotator::ToMatrix on top of SinCos, within 3e-7 per component of the scalar functions
+	static void RotatorsToQuats(YQuat* out, const YRotator* rotators, size_t count);
+	static void RotatorsToMatrices(YMatrix* out, const YRotator* rotators, size_t count);
+	// YQuat::ToMatrix
+	static void QuatsToMatrices(YMatrix* out, const YQuat* quats, size_t count);
+	// YQuat::Rotator
+	static void QuatsToRotators(YRotator* out, const YQuat* quats, size_t count);
+	// YQuat::RotateVector of one quat over many vectors
+	static void RotateVectors(YVector* out, const YQuat& quat, const YVector* v, size_t count);
+	static void RotateVectors(const YVectorSoA& out, const YQuat& quat, const YVectorSoA& v, size_t count);
+};
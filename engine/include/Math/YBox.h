@@ -0,0 +1,44 @@
+#pragma once
+#include "Math/YMath.h"
+#include "Math/YVector.h"
+#include "Math/YRay.h"
+#include <type_traits>
+
+// axis aligned box, empty (min above max) until a point or a box is added
+struct YBox
+{
+public:
+	YVector min_corner;
+	YVector max_corner;
+	YBox();
+	YBox(const YVector& in_min, const YVector& in_max);
+	bool IsValid() const;
+	YBox& operator+=(const YVector& point);
+	YBox& operator+=(const YBox& box);
+	YVector GetCenter() const;
+	// half of the size
+	YVector GetExtent() const;
+	YVector GetSize() const;
+	// 0 for an empty box, the cost of the bvh builders
+	float GetSurfaceArea() const;
+	bool Intersect(const YBox& other) const;
+	bool IsInside(const YVector& point) const;
+	// other lies completely in this box
+	bool IsInside(const YBox& other) const;
+	// grown by amount on every side
+	YBox ExpandBy(float amount) const;
+	// the box around the transformed box
+	YBox TransformBy(const YMatrix& matrix) const;
+	// distances along the ray where it enters and leaves the box, clamped to 0 for an origin inside,
+	// false when it misses
+	bool IntersectRay(const YRay& ray, float& out_near, float& out_far) const;
+};
+
+namespace std
+{
+	template<>
+	struct is_pod<YBox>
+	{
+		static constexpr bool value = true;
+	};
+}
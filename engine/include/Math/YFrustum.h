@@ -0,0 +1,35 @@
+#pragma once
+#include "Math/YVector.h"
+#include "Math/YBox.h"
+#include <type_traits>
+struct YMatrix;
+
+enum EFrustumContainment
+{
+	FC_Outside = 0,
+	FC_Intersect,
+	FC_Inside
+};
+
+// convex volume of six planes, a point p is inside a plane when (plane.x, plane.y, plane.z) | p + plane.w >= 0
+struct YFrustum
+{
+public:
+	static constexpr int plane_count = 6;
+	// left, right, bottom, top, near, far
+	YVector4 planes[plane_count];
+	YFrustum() = default;
+	// the volume a view projection matrix maps to -1..1 in x and y and 0..1 in depth, the planes are normalized
+	static YFrustum FromViewProjection(const YMatrix& view_proj);
+	EFrustumContainment ClassifyBox(const YBox& box) const;
+	bool IntersectBox(const YBox& box) const { return ClassifyBox(box) != FC_Outside; }
+};
+
+namespace std
+{
+	template<>
+	struct is_pod<YFrustum>
+	{
+		static constexpr bool value = true;
+	};
+}
@@ -6,6 +6,7 @@
 struct YVector2;
 struct YVector;
 struct YVector4;
+struct YVectorRegister;
 struct YMatrix;
 struct YMatrix3x3;
 struct YRotator;
@@ -95,7 +96,6 @@ struct YMath
 		return (A <= B) ? A : B;
 	}
 
-	template<>
 	static   float Abs(const float A)
 	{
 		return fabsf(A);
@@ -143,6 +143,9 @@ struct YMath
 		return ((*(uint64_t*)&A) >= (uint64_t)0x8000000000000000); // Detects sign bit.
 	}
 
+	// index of the lowest set bit, value must not be 0
+	static int CountTrailingZeros(uint32_t value);
+
 	static   int TruncToInt(float F)
 	{
 		return static_cast<int>(F);
@@ -0,0 +1,75 @@
+#pragma once
+#include "Math/YSimd.h"
+#include <cstddef>
+struct YMatrix;
+struct YVector4;
+struct YTransform;
+struct YVector;
+struct YVectorSoA;
+struct YQuat;
+struct YRotator;
+struct YVectorRegister;
+
+// raw kernels behind the YMatrix functions, one table per simd level
+// the sse2 table gives the same bits as the scalar one except for inverse, avx2 uses fma and may differ in the last bits
+struct YMatrixKernels
+{
+	void (*multiply)(YMatrix& out, const YMatrix& matrix1, const YMatrix& matrix2);
+	float (*determinant)(const YMatrix& matrix);
+	// false and out untouched when the determinant is 0
+	bool (*inverse)(YMatrix& out, const YMatrix& matrix);
+	void (*transform_vector4)(YVector4& out, const YMatrix& matrix, const YVector4& v);
+	void (*transpose)(YMatrix& out, const YMatrix& matrix);
+};
+
+struct YTransformKernels
+{
+	// every level gives the same bits as YTransform::ToMatrix
+	void (*to_matrices)(YMatrix* out, const YTransform* transforms, size_t count);
+};
+
+// the functions behind YBatchMath
+struct YVectorKernels
+{
+	void (*transform_positions)(YVector* out, const YMatrix& matrix, const YVector* positions, size_t count);
+	void (*transform_positions_soa)(const YVectorSoA& out, const YMatrix& matrix, const YVectorSoA& positions, size_t count);
+	void (*transform_vectors)(YVector* out, const YMatrix& matrix, const YVector* directions, size_t count);
+	void (*transform_vectors_soa)(const YVectorSoA& out, const YMatrix& matrix, const YVectorSoA& directions, size_t count);
+	void (*normalize)(YVector* out, const YVector* v, size_t count, float tolerance);
+	void (*normalize_soa)(const YVectorSoA& out, const YVectorSoA& v, size_t count, float tolerance);
+	void (*cross)(YVector* out, const YVector* a, const YVector* b, size_t count);
+	void (*cross_soa)(const YVectorSoA& out, const YVectorSoA& a, const YVectorSoA& b, size_t count);
+	void (*min_max)(YVector& out_min, YVector& out_max, const YVector* v, size_t count);
+	void (*min_max_soa)(YVector& out_min, YVector& out_max, const YVectorSoA& v, size_t count);
+	void (*transform_vectors4)(YVectorRegister* out, const YMatrix& matrix, const YVectorRegister* v, size_t count);
+};
+
+// the functions behind the rotation part of YBatchMath
+// sin_cos and the rotator conversions of the simd levels use a polynomial instead of sinf and cosf,
+// the quat conversions and rotations give the same bits as the scalar YQuat functions
+struct YRotationKernels
+{
+	void (*sin_cos)(float* out_sin, float* out_cos, const float* radians, size_t count);
+	void (*rotators_to_quats)(YQuat* out, const YRotator* rotators, size_t count);
+	void (*rotators_to_matrices)(YMatrix* out, const YRotator* rotators, size_t count);
+	void (*quats_to_matrices)(YMatrix* out, const YQuat* quats, size_t count);
+	void (*quats_to_rotators)(YRotator* out, const YQuat* quats, size_t count);
+	void (*rotate_vectors)(YVector* out, const YQuat& quat, const YVector* v, size_t count);
+	void (*rotate_vectors_soa)(const YVectorSoA& out, const YQuat& quat, const YVectorSoA& v, size_t count);
+};
+
+struct YMathKernels
+{
+	// the tables of the current YSimd level, used by YMatrix, YTransform and YBatchMath
+	static YMatrixKernels matrix;
+	static YTransformKernels transform;
+	static YVectorKernels vector;
+	static YRotationKernels rotation;
+	// a given level, for validation against the scalar reference
+	static const YMatrixKernels& GetMatrixKernels(ESimdLevel level);
+	static const YTransformKernels& GetTransformKernels(ESimdLevel level);
+	static const YVectorKernels& GetVectorKernels(ESimdLevel level);
+	static const YRotationKernels& GetRotationKernels(ESimdLevel level);
+	// called by YSimd::SetSimdLevel
+	static void Select(ESimdLevel level);
+};
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+class YJsonWriter;
+
+struct YMathValidationOptions
+{
+	// elements of every benchmark array
+	size_t array_size = 1 << 20;
+	// inputs of every accuracy check
+	size_t accuracy_samples = 1 << 16;
+	// the fastest of repeat runs is reported
+	int repeat = 5;
+	uint32_t seed = 1;
+	// every simd level the cpu supports instead of the current one
+	bool all_levels = true;
+};
+
+// benchmarks of the math primitives and their accuracy against double precision references
+// the report is one json object
+// {"cpu": {...}, "levels": [{"level": "sse2", "benchmarks": [{"name", "count", "ns_per_op", "mops"}], "accuracy": [{"name", "metric", "samples", "max", "mean", "bound", "pass"}]}], "pass": bool}
+// metrics: "abs" absolute error, "rel" error over the size of the reference (the length of each axis
+// for transforms and decompositions, the product of the row lengths for determinants, the vector for rotations),
+// "sum_eps" error of a dot product over (sum of |a_k * b_k|) * FLT_EPSILON, for products and transforms,
+// "cond_eps" relative error over condition number * FLT_EPSILON, for inverses
+// it runs single threaded on the calling thread and restores the simd level it found
+struct YMathValidation
+{
+	// false when a check is over its bound, the report is complete either way
+	static bool Run(YJsonWriter& writer, const YMathValidationOptions& options = YMathValidationOptions());
+	// Run into a pretty printed file, false also when the file can not be written
+	static bool RunToFile(const std::string& path, const YMathValidationOptions& options = YMathValidationOptions());
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include "Math/YMath.h"
 #include "Math/YVector.h"
+#include "Math/YVectorRegister.h"
 struct YVector4;
 struct YMatrix3x3
 {
@@ -10,7 +11,8 @@ public:
 };
 
 
-struct YMatrix
+// 16 byte aligned so every row is one aligned sse load, the size stays 16 floats and files keep their layout
+struct alignas(16) YMatrix
 {
 public:
 	YMatrix();
@@ -32,11 +34,16 @@ public:
 	 *	If you want to transform a surface normal (or plane) and correctly account for non-uniform scaling you should use TransformByUsingAdjointT.
 	 */
 	YVector TransformVector(const YVector& v) const;
+	// the same as the YVector4/YVector functions above, the w of v is ignored by the position and vector ones
+	// which return w 1 and 0
+	YVectorRegister TransformVector4(const YVectorRegister& v) const;
+	YVectorRegister TransformPosition(const YVectorRegister& v) const;
+	YVectorRegister TransformVector(const YVectorRegister& v) const;
 	YVector GetScaledAxis(int axis) const;
 	/** Remove any scaling from this matrix (ie magnitude of each row is 1) and return the 3D scale vector that was initially present. */
 	YVector ExtractScaling(float Tolerance = SMALL_NUMBER);
 	void Decompose(YVector& tralsation, YQuat& quat, YVector& scale) const;
-	void YMatrix::SetAxis(int i, const YVector& axis);
+	void SetAxis(int i, const YVector& axis);
 	YVector GetOrigin() const;
 	bool ContainsNaN() const;
 	union
@@ -46,6 +53,7 @@ public:
 	static const YMatrix Identity;
 
 };
+static_assert(sizeof(YMatrix) == 16 * sizeof(float), "YMatrix is written to files as 16 floats");
 
 namespace std
 {
@@ -22,6 +22,8 @@ public:
 	YVector Euler() const;
 	YMatrix ToMatrix() const;
 	YVector RotateVector(const YVector& V) const;
+	// w of V is kept
+	YVectorRegister RotateVector(const YVectorRegister& V) const;
 	static YQuat Identity;
 	void Normalize(float Tolerance = SMALL_NUMBER);
 	YQuat GetNormalized(float Tolerance = SMALL_NUMBER) const;
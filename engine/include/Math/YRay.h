@@ -0,0 +1,13 @@
+#pragma once
+#include "Math/YVector.h"
+
+struct YRay
+{
+public:
+	YVector origin;
+	// unit length when distances should be in world units, the intersections take any length
+	YVector direction;
+	YRay() = default;
+	YRay(const YVector& in_origin, const YVector& in_direction) : origin(in_origin), direction(in_direction) {}
+	YVector GetPoint(float distance) const { return origin + direction * distance; }
+};
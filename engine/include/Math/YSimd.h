@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+
+// sse2 is part of x64 and of every x86 cpu the engine runs on, it is used without a runtime check
+// avx2 kernels are compiled for the function only and picked at runtime, see YSimd::GetSimdLevel
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define YMATH_SSE 1
+#include <emmintrin.h>
+#include <immintrin.h>
+// lanes picked in memory order, YMATH_SHUFFLE(a, b, 0, 1, 2, 3) is (a.x, a.y, b.z, b.w)
+#define YMATH_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x))
+#define YMATH_SWIZZLE(v, x, y, z, w) YMATH_SHUFFLE(v, v, x, y, z, w)
+#else
+#define YMATH_SSE 0
+#endif
+
+#if YMATH_SSE && (defined(__GNUC__) || defined(__clang__))
+#define YMATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+// gcc contracts a mul and an add into fma when it may, kernels that keep the scalar bits use this one
+#define YMATH_TARGET_AVX2_NO_FMA __attribute__((target("avx2")))
+#else
+// msvc accepts avx intrinsics in any function
+#define YMATH_TARGET_AVX2
+#define YMATH_TARGET_AVX2_NO_FMA
+#endif
+
+enum ESimdLevel
+{
+	SL_Scalar,
+	SL_SSE2,
+	// avx2 and fma, results may differ from the other levels in the last bits
+	SL_AVX2,
+};
+
+struct YCpuFeatures
+{
+	bool sse2 = false;
+	bool avx2 = false;
+	bool fma = false;
+};
+
+struct YSimd
+{
+	static const YCpuFeatures& GetCpuFeatures();
+	// the best level of the cpu unless lowered by SetSimdLevel
+	static ESimdLevel GetSimdLevel();
+	// clamped to what the cpu supports, for validation and benchmarks, not thread safe against running math
+	static ESimdLevel SetSimdLevel(ESimdLevel level);
+	static ESimdLevel GetMaxSimdLevel();
+	static const char* GetSimdLevelName(ESimdLevel level);
+};
@@ -14,9 +14,13 @@ public:
 	YTransform(const YVector& in_translation, const YQuat& in_quat, const YVector& in_scale);
 	YTransform(const YMatrix& mat);
 	YTransform operator*(const YTransform& in_transform)const;
-	static void YTransform::Multiply(YTransform* OutTransform, const YTransform* A, const YTransform* B);
+	static void Multiply(YTransform* OutTransform, const YTransform* A, const YTransform* B);
+	// a * b through the matrices, for negative scales which the quaternion path can not carry
+	static void MultiplyUsingMatrix(YTransform* out_transform, const YTransform* a, const YTransform* b);
 	static const YTransform identity;
 	YMatrix ToMatrix()const;
+	// out[i] = transforms[i].ToMatrix(), same bits, converted four at a time
+	static void ToMatrices(YMatrix* out, const YTransform* transforms, size_t count);
 };
 
 
@@ -0,0 +1,134 @@
+#pragma once
+#include "Math/YMath.h"
+#include "Math/YSimd.h"
+#include "Math/YVector.h"
+#include <type_traits>
+
+// x, y, z and w in one 16 byte aligned register, for vectors the engine keeps in memory and runs math on
+// positions carry w 1 and directions w 0, YVector and YVector4 stay the types of files and vertex layouts
+// the functions give the same bits as the YVector ones on x, y and z
+struct alignas(16) YVectorRegister
+{
+public:
+	float x;
+	float y;
+	float z;
+	float w;
+	YVectorRegister() = default;
+	YVectorRegister(const YVectorRegister&) = default;
+	YVectorRegister& operator=(const YVectorRegister&) = default;
+	YVectorRegister(float in_x, float in_y, float in_z, float in_w) : x(in_x), y(in_y), z(in_z), w(in_w) {}
+	explicit YVectorRegister(const YVector& v, float in_w = 0.0f) : x(v.x), y(v.y), z(v.z), w(in_w) {}
+	explicit YVectorRegister(const YVector4& v) : x(v.x), y(v.y), z(v.z), w(v.w) {}
+	YVector ToVector() const { return YVector(x, y, z); }
+	YVector4 ToVector4() const { return YVector4(x, y, z, w); }
+#if YMATH_SSE
+	explicit YVectorRegister(__m128 r) { _mm_store_ps(&x, r); }
+	__m128 Load() const { return _mm_load_ps(&x); }
+#endif
+
+	// per component, on all four lanes
+	YVectorRegister operator+(const YVectorRegister& v) const;
+	YVectorRegister operator-(const YVectorRegister& v) const;
+	YVectorRegister operator*(const YVectorRegister& v) const;
+	YVectorRegister operator*(float mul) const;
+	// cross product of x, y and z, w is 0
+	YVectorRegister operator^(const YVectorRegister& v) const;
+	// dot product of x, y and z
+	float operator|(const YVectorRegister& v) const;
+	// YVector::GetSafeNormal, w is kept
+	YVectorRegister GetSafeNormal(float tolerance = SMALL_NUMBER) const;
+};
+static_assert(sizeof(YVectorRegister) == 16, "YVectorRegister is one sse register");
+
+inline YVectorRegister YVectorRegister::operator+(const YVectorRegister& v) const
+{
+#if YMATH_SSE
+	return YVectorRegister(_mm_add_ps(Load(), v.Load()));
+#else
+	return YVectorRegister(x + v.x, y + v.y, z + v.z, w + v.w);
+#endif
+}
+
+inline YVectorRegister YVectorRegister::operator-(const YVectorRegister& v) const
+{
+#if YMATH_SSE
+	return YVectorRegister(_mm_sub_ps(Load(), v.Load()));
+#else
+	return YVectorRegister(x - v.x, y - v.y, z - v.z, w - v.w);
+#endif
+}
+
+inline YVectorRegister YVectorRegister::operator*(const YVectorRegister& v) const
+{
+#if YMATH_SSE
+	return YVectorRegister(_mm_mul_ps(Load(), v.Load()));
+#else
+	return YVectorRegister(x * v.x, y * v.y, z * v.z, w * v.w);
+#endif
+}
+
+inline YVectorRegister YVectorRegister::operator*(float mul) const
+{
+#if YMATH_SSE
+	return YVectorRegister(_mm_mul_ps(Load(), _mm_set1_ps(mul)));
+#else
+	return YVectorRegister(x * mul, y * mul, z * mul, w * mul);
+#endif
+}
+
+inline YVectorRegister operator*(float f, const YVectorRegister& v)
+{
+	return v * f;
+}
+
+inline YVectorRegister YVectorRegister::operator^(const YVectorRegister& v) const
+{
+#if YMATH_SSE
+	// (y z x) * (v.z v.x v.y) - (z x y) * (v.y v.z v.x), the w lanes are w * v.w - w * v.w
+	const __m128 a = Load();
+	const __m128 b = v.Load();
+	const __m128 r = _mm_sub_ps(_mm_mul_ps(YMATH_SWIZZLE(a, 1, 2, 0, 3), YMATH_SWIZZLE(b, 2, 0, 1, 3)),
+		_mm_mul_ps(YMATH_SWIZZLE(a, 2, 0, 1, 3), YMATH_SWIZZLE(b, 1, 2, 0, 3)));
+	// cleared so an inf or nan in w does not leak into it
+	return YVectorRegister(_mm_castsi128_ps(_mm_srli_si128(_mm_slli_si128(_mm_castps_si128(r), 4), 4)));
+#else
+	return YVectorRegister(y * v.z - z * v.y, z * v.x - x * v.z, x * v.y - y * v.x, 0.0f);
+#endif
+}
+
+inline float YVectorRegister::operator|(const YVectorRegister& v) const
+{
+#if YMATH_SSE
+	const __m128 m = _mm_mul_ps(Load(), v.Load());
+	// (x + y) + z as YVector does
+	const __m128 xy = _mm_add_ss(m, YMATH_SWIZZLE(m, 1, 1, 1, 1));
+	return _mm_cvtss_f32(_mm_add_ss(xy, YMATH_SWIZZLE(m, 2, 2, 2, 2)));
+#else
+	return x * v.x + y * v.y + z * v.z;
+#endif
+}
+
+inline YVectorRegister YVectorRegister::GetSafeNormal(float tolerance /*= SMALL_NUMBER*/) const
+{
+	const float square_sum = *this | *this;
+	if (square_sum == 1.f)
+	{
+		return *this;
+	}
+	else if (square_sum < tolerance)
+	{
+		return YVectorRegister(0.0f, 0.0f, 0.0f, w);
+	}
+	const float scale = YMath::InvSqrt(square_sum);
+	return YVectorRegister(x * scale, y * scale, z * scale, w);
+}
+
+namespace std
+{
+	template<>
+	struct is_pod<YVectorRegister>
+	{
+		static constexpr bool value = true;
+	};
+}
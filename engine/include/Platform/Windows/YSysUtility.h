@@ -1,5 +1,8 @@
+#if defined(_WIN32)
 #include <windows.h>
+#endif
 #include <string>
+#include <cstdint>
 class YSysUtility
 {
 public:
@@ -8,4 +11,8 @@ public:
 	static std::string UTF8ToString(const std::string& str);
 	static bool IsDirectoryExist(const std::string& str);
 	static bool FileExists(const std::string& str);
+	// last write time of a file, only comparable with the times of other files
+	static bool GetFileModifyTime(const std::string& str, uint64_t& out_time);
+	// renames from over an existing to in one step, readers see either the old or the new file
+	static bool MoveFileReplace(const std::string& from, const std::string& to);
 };
\ No newline at end of file
@@ -105,11 +105,15 @@ struct D3DConstantBuffer {
 		}
 	};
 	struct YCBMatrix4X4 {
-		static YMatrix& GetValue(D3DConstantBuffer* ConstantBuffer, unsigned int Offset) {
-			return *((YMatrix*)(ConstantBuffer->ShadowBuffer.data() + Offset));
+		// copied, the shadow buffer gives no 16 byte alignment for the aligned YMatrix
+		static YMatrix GetValue(D3DConstantBuffer* ConstantBuffer, unsigned int Offset) {
+			YMatrix Value;
+			memcpy_s(&Value, sizeof(YMatrix), ConstantBuffer->ShadowBuffer.data() + Offset, sizeof(YMatrix));
+			return Value;
 		}
 		static void SetValue(D3DConstantBuffer* ConstantBuffer, unsigned int Offset, const YMatrix& Value) {
-			*((YMatrix*)(ConstantBuffer->ShadowBuffer.data() + Offset)) = Value.GetTransposed();
+			const YMatrix Transposed = Value.GetTransposed();
+			memcpy_s(ConstantBuffer->ShadowBuffer.data() + Offset, sizeof(YMatrix), &Transposed, sizeof(YMatrix));
 		}
 	};
 
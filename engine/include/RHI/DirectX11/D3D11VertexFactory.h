@@ -32,7 +32,7 @@ enum DataType
 };
 struct VertexStreamDescription {
 	VertexStreamDescription();
-	VertexStreamDescription(VertexAttribute in_vertex_attribe, const std::string& in_name, DataType in_type, int in_cpu_data_index, int in_com_num, int in_buffer_size, int in_slot, int in_stride, bool in_normalized, bool in_release, bool in_dynamic);
+	VertexStreamDescription(VertexAttribute in_vertex_attribe, const std::string& in_name, DataType in_type, int in_cpu_data_index, int in_com_num, int in_buffer_size, int in_slot, int in_stride, bool in_normalized, bool in_release, bool in_dynamic, bool in_per_instance = false);
 	VertexAttribute vertex_attribute;
 	std::string name;
 	DataType data_type;
@@ -44,6 +44,8 @@ struct VertexStreamDescription {
 	bool normalized : 1;
 	bool release : 1;
 	bool dynamic : 1;
+	// advances once per instance instead of once per vertex
+	bool per_instance : 1;
 };
 class IVertexFactory {
 public:
@@ -13,7 +13,15 @@ public:
 
 
 	bool Clearup() override;
+	// merge of the mesh draws of the last frame
+	const YDrawMergeStats& GetDrawMergeStats() const { return draw_merge_stats_; }
 
 protected:
+	// the instance matrices of the frame into instance_buffer_, grown when they do not fit
+	bool UploadInstanceMatrices(const std::vector<YMatrix>& instance_matrices);
+	void ReportDrawMerge(const YDrawMergeStats& stats);
 	std::unique_ptr<YRenderScene> render_scene_;
+	TComPtr<ID3D11Buffer> instance_buffer_;
+	int instance_buffer_capacity_ = 0;
+	YDrawMergeStats draw_merge_stats_;
 };
\ No newline at end of file
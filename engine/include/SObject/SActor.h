@@ -1,11 +1,13 @@
 #pragma once
 #include "SObject/SObject.h"
 #include "SObject/SComponent.h"
+#include "SObject/SWorldTick.h"
 #include "Engine/YLog.h"
 #include "json.h"
 #include <vector>
 #include <string>
 
+class SCookedWorld;
 class SActor :public SObject
 {
 public:
@@ -14,40 +16,40 @@ public:
 	static constexpr  bool IsInstance() { return true; }
 	//virtual bool LoadFromJson(const TSharedPtr<FJsonObject>&RootJson);
 	virtual bool LoadFromJson(const Json::Value& RootJson);
+	bool LoadFromCooked(const SCookedWorld& cooked_world, int actor_index);
+	// false and nothing written for an actor LoadFromJson would not load, one without a saveable root component
+	bool SaveToJson(YJsonWriter& writer) const override;
 	virtual bool PostLoadOp();
 	void Update(double deta_time) override;
+	// called by SWorld for every phase in the tick phase mask, may run on a worker thread
+	virtual void TickPhase(ETickPhase phase, double deta_time, SWorldCommandBuffer& command_buffer);
+	uint32_t GetTickPhaseMask() const { return tick_phase_mask_; }
+	// loaded before the other actors of the world by SWorldLoader
+	bool IsCritical() const { return critical_; }
+	void SetTickPhaseMask(uint32_t mask) { tick_phase_mask_ = mask; }
+	// every scene component of the actor in tree order, rebuilt when the tree changes
+	const std::vector<SSceneComponent*>& GetComponents() const { return components_; }
 	template<typename T>
-	void RecursiveGetTypeComponent(SComponent* CurrentComponent, SComponent::EComponentType ComponentType, std::vector<T*>& InOutSelectComponents)
+	void GetComponents(std::vector<T*>& out_components) const
 	{
-		if (!CurrentComponent)
-			return;
-
-		if (CurrentComponent->GetComponentType() == ComponentType)
+		for (SSceneComponent* component : components_)
 		{
-			InOutSelectComponents.AddUnique(dynamic_cast<T*>(CurrentComponent));
-		}
-
-		SSceneComponent* SceneComponent = dynamic_cast<SSceneComponent*>(CurrentComponent);
-		if (SceneComponent)
-		{
-			for (TRefCountPtr<SSceneComponent>& Child : SceneComponent->child_components_)
+			if (component->GetComponentType() == T::GetStaticType())
 			{
-				RecursiveGetTypeComponent(Child.GetReference(), ComponentType, InOutSelectComponents);
+				out_components.push_back(static_cast<T*>(component));
 			}
 		}
 	}
-	template<typename T>
-	void RecurisveGetTypeComponent(SComponent::EComponentType ComponentType, std::vector<T*>& InOutSelectComponents)
-	{
-		std::vector<TRefCountPtr<SComponent>> children = root_component_->GetChildComponents();
-		for (TRefCountPtr<SComponent>& Component : children)
-		{
-			RecursiveGetTypeComponent(Component.GetReference(), ComponentType, InOutSelectComponents);
-		}
-	}
+	void UpdateComponentList();
+	SComponent* GetRootComponent() const { return root_component_.GetReference(); }
 	void RegisterToScene(class YScene* render_scene);
+	void UnregisterFromScene(class YScene* render_scene);
 protected:
+	void GatherComponents(SSceneComponent* component);
 	TRefCountPtr<SComponent> root_component_;
+	std::vector<SSceneComponent*> components_;
 	int id_ = -1;
 	std::string name_;
+	uint32_t tick_phase_mask_ = TickPhaseBit(TP_FinalizeTransform);
+	bool critical_ = false;
 };
@@ -6,10 +6,13 @@
 #include "Math/YVector.h"
 #include "Math/YRotator.h"
 #include "Math/YTransform.h"
+#include "Math/YBox.h"
 #include "json.h"
 class YRenderScene;
 class SActor;
 class SSceneComponent;
+class SCookedWorld;
+class SCookedWorldWriter;
 class SComponent :public SObject
 {
 public:
@@ -21,10 +24,12 @@ public:
 		StaticMeshComponent,
 		LightComponenet,
 		DirectLightComponent,
+		InstancedStaticMeshComponent,
 		ComNum
 	};
 	//SObject
 	static constexpr  bool IsInstance() { return true; };
+	static constexpr EComponentType GetStaticType() { return EComponentType::Base; }
 
 	//SComponent
 	// Type
@@ -33,35 +38,45 @@ public:
 
 	// Interface & Update
 	virtual void RegisterToScene(class YScene* scene);
+	virtual void UnregisterFromScene(class YScene* scene);
 
 	// Parent
 	SActor* GetParentActor()const;
 
 	//Create Factory
 	static TRefCountPtr<SSceneComponent> ComponentFactory(const Json::Value& RootJson);
+	// empty component of a register_component_map type, nullptr for an unknown type
+	static TRefCountPtr<SSceneComponent> CreateComponent(const std::string& type_name);
 
 protected:
 	virtual bool LoadChildFromJson(const Json::Value& root_json);
 
 protected:
+	friend class SActor;
+	friend class SWorld;
+	friend class SComponentStorage;
 	EComponentType component_type_;
 	SActor* actor_parent_{ nullptr };
+	// slot in the SComponentStorage array of component_type_, -1 when the component is not in a world
+	int storage_index_ = -1;
 };
 
 class SSceneComponent :public SComponent
 {
 public:
 	SSceneComponent() :SComponent(EComponentType::SceneComponent) {}
+	static constexpr EComponentType GetStaticType() { return EComponentType::SceneComponent; }
 	explicit SSceneComponent(EComponentType type);
 	//todo 
 	//FBoxSphereBounds Bounds;
-	YVector local_translation_;
-	YRotator local_rotation_;
+	// members missing from the json keep the identity, a save writes them all
+	YVector local_translation_ = YVector(0.0f, 0.0f, 0.0f);
+	YRotator local_rotation_ = YRotator(0.0f, 0.0f, 0.0f);
 	/**
 	*	Non-uniform scaling of the component relative to its parent.
 	*	Note that scaling is always applied in local space (no shearing etc)
 	*/
-	YVector local_scale_;
+	YVector local_scale_ = YVector(1.0f, 1.0f, 1.0f);
 
 
 	// update 
@@ -69,21 +84,50 @@ public:
 	virtual void UpdateComponentToWorld();
 	void SetComponentToWorld(const YTransform& NewComponentToWorld);
 	const YTransform& GetComponentTransform() const;
+	// world space, empty for a component without geometry
+	const YBox& GetBounds() const { return bounds_; }
+	// the bounds changed since the SSceneAABBTree of the world last took them
+	bool IsBoundsDirty() const { return is_bounds_dirty_; }
 
 	// load
 	bool LoadFromJson(const Json::Value& RootJson)override;
+	// the record and transform of this component are the last ones in writer, children are cooked by the writer
+	// returning false drops the component and its children, as a failed LoadFromJson does
+	virtual bool CookFromJson(const Json::Value& root_json, SCookedWorldWriter& writer) const;
+	virtual bool LoadFromCooked(const SCookedWorld& cooked_world, uint32_t component_index);
+	// save
+	// the component object with its children, false and nothing written for a type without a type name
+	bool SaveToJson(YJsonWriter& writer) const override;
+	// key of the type in register_component_map, nullptr if the type cannot be created from json
+	virtual const char* GetTypeName() const { return nullptr; }
 	virtual bool PostLoadOp();
 	virtual void RegisterToScene(class YScene* scene) override;
 	virtual void OnTransformChange();
 	// child
 	std::vector<TRefCountPtr<SSceneComponent>>& GetChildComponents() { return child_components_; }
+	SSceneComponent* GetParentComponent() const { return parent_component_; }
+	// tree only, use SWorld::AttachComponent/DetachComponent for components of an actor in a world
+	void AttachChild(TRefCountPtr<SSceneComponent> child);
+	TRefCountPtr<SSceneComponent> DetachChild(SSceneComponent* child);
 protected:
+	// members LoadFromJson reads, written inside the component object after "type"
+	virtual void SaveMembersToJson(YJsonWriter& writer) const;
 	void UpdateComponentToWorldWithParentRecursive();
 	void PropagateTransformUpdate();
+	// sets bounds_ from component_to_world_
 	virtual void UpdateBound();
 	void UpdateChildTransforms();
+	// local_rotation_ as a quat, converted again only when local_rotation_ has changed since the last call
+	const YQuat& GetLocalRotationQuat();
 protected:
+	friend class SSceneAABBTree;
 	YTransform component_to_world_;
+	YBox bounds_;
+	// leaf in the SSceneAABBTree of the world, -1 when the component is not in one
+	int spatial_proxy_ = -1;
+	bool is_bounds_dirty_ = false;
+	YRotator local_rotation_quat_source_ = YRotator(0.0f, 0.0f, 0.0f);
+	YQuat local_rotation_quat_ = YQuat(0.0f, 0.0f, 0.0f, 1.0f);
 	bool is_component_to_world_update_ = false;
 	SSceneComponent* parent_component_{ nullptr };
 	std::vector<TRefCountPtr<SSceneComponent>> child_components_;
@@ -96,6 +140,7 @@ public:
 	{
 		return true;
 	};
+	static constexpr EComponentType GetStaticType() { return EComponentType::RenderComponent; }
 	SRenderComponent();
 	explicit SRenderComponent(EComponentType Type);
 	void Update(double deta_time) override;
@@ -108,6 +153,7 @@ public:
 class SLightComponent :public SRenderComponent
 {
 public:
+	static constexpr EComponentType GetStaticType() { return EComponentType::LightComponenet; }
 	SLightComponent();
 	explicit SLightComponent(EComponentType type);
 	void Update(double deta_time) override;
@@ -120,12 +166,18 @@ class DirectLight;
 class SDirectionLightComponent :public SLightComponent
 {
 public:
+	static constexpr EComponentType GetStaticType() { return EComponentType::DirectLightComponent; }
 	SDirectionLightComponent();
 	~SDirectionLightComponent();
 	bool LoadFromJson(const Json::Value& RootJson) override;
-	void RegisterToScene(class YScene* scene) override;
+	bool CookFromJson(const Json::Value& root_json, SCookedWorldWriter& writer) const override;
+	bool LoadFromCooked(const SCookedWorld& cooked_world, uint32_t component_index) override;
+	static constexpr const char* type_name = "DirectionLight";
+	const char* GetTypeName() const override { return type_name; }
 	virtual bool PostLoadOp();
 	void OnTransformChange() override;
 	void Update(double deta_time) override;
 	std::unique_ptr<DirectLight> dir_light_;
+protected:
+	void SaveMembersToJson(YJsonWriter& writer) const override;
 };
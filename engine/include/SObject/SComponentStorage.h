@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include "SObject/SComponent.h"
+#include "SObject/SActor.h"
+
+// per world dense arrays of components grouped by EComponentType
+// filled when an actor enters the world and emptied when it leaves, removal swaps the last element in
+// components of one type come from one YObjectPool, so walking an array stays inside a few slabs
+class SComponentStorage
+{
+public:
+	void AddActorComponents(SActor* actor);
+	void RemoveActorComponents(SActor* actor);
+	void AddComponent(SComponent* component);
+	void RemoveComponent(SComponent* component);
+	void Clear();
+	const std::vector<SComponent*>& GetComponents(SComponent::EComponentType type) const;
+	int GetComponentCount(SComponent::EComponentType type) const;
+
+	// func(T*) for every component whose exact type is T, only the components of actor if it is not null
+	template<typename T, typename Func>
+	void ForEachComponent(Func&& func, const SActor* actor = nullptr) const
+	{
+		if (actor)
+		{
+			for (SSceneComponent* component : actor->GetComponents())
+			{
+				if (component->GetComponentType() == T::GetStaticType() && component->storage_index_ >= 0)
+				{
+					func(static_cast<T*>(component));
+				}
+			}
+			return;
+		}
+		for (SComponent* component : components_[T::GetStaticType()])
+		{
+			func(static_cast<T*>(component));
+		}
+	}
+protected:
+	std::vector<SComponent*> components_[SComponent::ComNum];
+};
@@ -0,0 +1,211 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <unordered_map>
+#include "SObject/SActor.h"
+#include "SObject/SWorldPartition.h"
+#include "Engine/YFile.h"
+#include "Engine/YReferenceCount.h"
+#include "json.h"
+
+// cooked world blob, every table is an array of POD records read with one memcpy
+// header | strings (offsets, chars) | actors | components | transforms | payload | partition settings | partition cells
+// the json world stays the editing format, SCookedWorld::CookWorldFile writes world.yasset next to world.json
+// and SObject::LoadFromPackage / SWorldLoader pick the yasset when it exists
+struct SCookedWorldHeader
+{
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint32_t flags = 0;
+	int tick_batch_size = 0;
+	uint32_t string_count = 0;
+	uint32_t string_data_size = 0;
+	uint32_t actor_count = 0;
+	uint32_t component_count = 0;
+	uint32_t payload_size = 0;
+	uint32_t partition_cell_count = 0;
+};
+
+struct SCookedActor
+{
+	enum EFlag
+	{
+		AF_TickPhases = 1 << 0,
+		AF_Critical = 1 << 1,
+	};
+	int id = -1;
+	uint32_t name = 0;
+	uint32_t flags = 0;
+	uint32_t tick_phase_mask = 0;
+	// the components of an actor are contiguous and in tree order, the first one is the root
+	uint32_t first_component = 0;
+	uint32_t component_count = 0;
+};
+
+struct SCookedComponent
+{
+	// register_component_map key
+	uint32_t type_name = 0;
+	// relative to the first component of the actor, -1 for the root
+	int parent = -1;
+	uint32_t payload_offset = 0;
+	uint32_t payload_size = 0;
+};
+
+// one per component, same index as the component record
+struct SCookedTransform
+{
+	enum EFlag
+	{
+		TF_Translation = 1 << 0,
+		TF_Rotation = 1 << 1,
+		TF_Scale = 1 << 2,
+	};
+	uint32_t flags = 0;
+	float translation[3] = { 0.0f,0.0f,0.0f };
+	// pitch yaw roll
+	float rotation[3] = { 0.0f,0.0f,0.0f };
+	float scale[3] = { 1.0f,1.0f,1.0f };
+};
+
+struct SCookedPartitionSettings
+{
+	float cell_size = 0.0f;
+	float loading_radius = 0.0f;
+	float unloading_radius = 0.0f;
+	int memory_budget_mb = 0;
+	double finalize_budget_ms = 0.0;
+};
+
+struct SCookedPartitionCell
+{
+	int x = 0;
+	int z = 0;
+	uint32_t file = 0;
+	int actor_count = 0;
+	// SWorldCellDesc::bounds, empty when min is above max
+	float bounds_min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float bounds_max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+};
+
+// filled by SCookedWorld::Cook, components append their payload from SSceneComponent::CookFromJson
+class SCookedWorldWriter
+{
+public:
+	uint32_t InternString(const std::string& str);
+	SCookedTransform& GetTransform() { return transforms_.back(); }
+	template<typename T>
+	void SetPayload(const T& payload)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "cooked payload must be POD");
+		SCookedComponent& component = components_.back();
+		component.payload_offset = (uint32_t)payload_.size();
+		component.payload_size = (uint32_t)sizeof(T);
+		payload_.resize(payload_.size() + sizeof(T));
+		memcpy(&payload_[component.payload_offset], &payload, sizeof(T));
+	}
+	// payload followed by a variable number of elements, read by the GetPayload with elements
+	template<typename T, typename E>
+	void SetPayload(const T& payload, const std::vector<E>& elements)
+	{
+		static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_copyable<E>::value, "cooked payload must be POD");
+		SetPayload(payload);
+		SCookedComponent& component = components_.back();
+		const size_t elements_size = elements.size() * sizeof(E);
+		payload_.resize(payload_.size() + elements_size);
+		if (elements_size)
+		{
+			memcpy(&payload_[component.payload_offset + sizeof(T)], elements.data(), elements_size);
+		}
+		component.payload_size += (uint32_t)elements_size;
+	}
+protected:
+	friend class SCookedWorld;
+	bool CookActor(const Json::Value& actor_json);
+	// false if the component and its children are dropped, as SComponent::ComponentFactory would
+	bool CookComponent(const Json::Value& component_json, int parent, uint32_t first_component);
+	void WriteToMemoryFile(MemoryFile& mem_file);
+
+	SCookedWorldHeader header_;
+	std::vector<std::string> strings_;
+	std::unordered_map<std::string, uint32_t> string_map_;
+	std::vector<SCookedActor> actors_;
+	std::vector<SCookedComponent> components_;
+	std::vector<SCookedTransform> transforms_;
+	std::vector<unsigned char> payload_;
+	SCookedPartitionSettings partition_settings_;
+	std::vector<SCookedPartitionCell> partition_cells_;
+};
+
+class SCookedWorld
+{
+public:
+	enum EFlag
+	{
+		WF_TickBatchSize = 1 << 0,
+		WF_Partition = 1 << 1,
+	};
+	static const uint32_t cooked_world_magic = 0x444C5759; // "YWLD"
+	static const uint32_t cooked_world_version = 2;
+
+	// the blob is validated here, every index used by LoadActor is in range afterwards
+	bool Load(std::unique_ptr<MemoryFile> mem_file);
+	int GetActorCount() const { return (int)actors_.size(); }
+	const SCookedActor& GetActor(int actor_index) const { return actors_[actor_index]; }
+	// thread safe, components that fail to load are dropped with their children as in SSceneComponent::LoadFromJson
+	TRefCountPtr<SActor> LoadActor(int actor_index) const;
+	const char* GetString(uint32_t index) const { return &string_data_[string_offsets_[index]]; }
+	const SCookedComponent& GetComponent(uint32_t component_index) const { return components_[component_index]; }
+	const SCookedTransform& GetTransform(uint32_t component_index) const { return transforms_[component_index]; }
+	// false if the payload size does not match, the component was cooked by another version
+	template<typename T>
+	bool GetPayload(uint32_t component_index, T& out_payload) const
+	{
+		const SCookedComponent& component = components_[component_index];
+		if (component.payload_size != sizeof(T))
+		{
+			return false;
+		}
+		memcpy(&out_payload, &payload_[component.payload_offset], sizeof(T));
+		return true;
+	}
+	// false if what follows the payload is not a whole number of elements
+	template<typename T, typename E>
+	bool GetPayload(uint32_t component_index, T& out_payload, std::vector<E>& out_elements) const
+	{
+		const SCookedComponent& component = components_[component_index];
+		if (component.payload_size < sizeof(T) || (component.payload_size - sizeof(T)) % sizeof(E) != 0)
+		{
+			return false;
+		}
+		memcpy(&out_payload, &payload_[component.payload_offset], sizeof(T));
+		out_elements.resize((component.payload_size - sizeof(T)) / sizeof(E));
+		if (!out_elements.empty())
+		{
+			memcpy(out_elements.data(), &payload_[component.payload_offset + sizeof(T)], out_elements.size() * sizeof(E));
+		}
+		return true;
+	}
+	bool HasTickBatchSize() const { return (header_.flags & WF_TickBatchSize) != 0; }
+	int GetTickBatchSize() const { return header_.tick_batch_size; }
+	bool HasPartition() const { return (header_.flags & WF_Partition) != 0; }
+	SWorldPartitionSettings GetPartitionSettings() const;
+	std::vector<SWorldCellDesc> GetPartitionCells() const;
+
+	static bool Cook(const Json::Value& world_json, MemoryFile& out_mem_file);
+	// json_path to the yasset beside it, the cells of a partitioned world are cooked beside their json too
+	static bool CookWorldFile(const std::string& json_path);
+	static std::string GetCookedPath(const std::string& path);
+protected:
+	SCookedWorldHeader header_;
+	std::vector<uint32_t> string_offsets_;
+	std::vector<char> string_data_;
+	std::vector<SCookedActor> actors_;
+	std::vector<SCookedComponent> components_;
+	std::vector<SCookedTransform> transforms_;
+	std::vector<unsigned char> payload_;
+	SCookedPartitionSettings partition_settings_;
+	std::vector<SCookedPartitionCell> partition_cells_;
+};
@@ -0,0 +1,188 @@
+#pragma once
+#include <vector>
+#include "SObject/SComponent.h"
+#include "Engine/YStaticMesh.h"
+#include "Engine/YReferenceCount.h"
+#include "Engine/YBVH.h"
+#include "Math/YFrustum.h"
+
+// one cluster of SInstancedStaticMeshComponent, a run of instance slots drawn by one instanced draw
+struct SInstanceCluster
+{
+	int first = 0;
+	int count = 0;
+	// world space, around the instances of the cluster
+	YBox box;
+	// leaf of the cluster tree, -1 for a cluster added after the last build
+	int node = -1;
+	bool is_dirty = false;
+};
+
+// one static mesh drawn at many transforms, for props placed by the thousand
+// the instances are kept in slots grouped into clusters of nearby instances under a bounding volume hierarchy,
+// a frame culls the hierarchy and draws every run of visible clusters with one instanced draw
+// an instance edit refits the clusters it touches, added instances go to clusters outside of the hierarchy
+// until enough of them have piled up to rebuild it
+// edits on the game thread or in a tick of the owning actor, they are applied by the next Update
+class SInstancedStaticMeshComponent :public SRenderComponent
+{
+public:
+	static constexpr EComponentType GetStaticType() { return EComponentType::InstancedStaticMeshComponent; }
+	SInstancedStaticMeshComponent();
+	~SInstancedStaticMeshComponent();
+	bool LoadFromJson(const Json::Value& RootJson) override;
+	bool CookFromJson(const Json::Value& root_json, SCookedWorldWriter& writer) const override;
+	bool LoadFromCooked(const SCookedWorld& cooked_world, uint32_t component_index) override;
+	static constexpr const char* type_name = "InstancedStaticMesh";
+	const char* GetTypeName() const override { return type_name; }
+	bool PostLoadOp() override;
+	void Update(double deta_time) override;
+	YStaticMesh* GetMesh();
+
+	// instance transforms are relative to the component
+	int GetInstanceCount() const { return (int)instances_.size(); }
+	const YTransform& GetInstanceTransform(int instance_index) const { return instances_[instance_index]; }
+	// index of the new instance
+	int AddInstance(const YTransform& transform);
+	void UpdateInstance(int instance_index, const YTransform& transform);
+	// the last instance takes the index of the removed one
+	void RemoveInstance(int instance_index);
+	void ClearInstances();
+	// applies the pending edits to the clusters and the bounds, Update calls it
+	void FlushInstanceUpdates();
+
+	// world matrices of the instances in slot order, a visible range indexes it
+	const std::vector<YMatrix>& GetInstanceMatrices() const { return slot_matrices_; }
+	const std::vector<SInstanceCluster>& GetClusters() const { return clusters_; }
+	// instances under the cluster tree, the rest were added after the last build
+	int GetBuiltInstanceCount() const { return built_slot_count_; }
+	// func(first_slot, slot_count) for every run of clusters that may be seen by frustum, in slot order
+	// clusters next to each other in the slots come as one run
+	template<typename Func>
+	void QueryVisibleRanges(const YFrustum& frustum, Func&& func) const;
+	// func(first_slot, slot_count) for every run of clusters, for a frame without culling
+	template<typename Func>
+	void ForEachRange(Func&& func) const;
+
+	static constexpr int default_cluster_size = 64;
+protected:
+	void SaveMembersToJson(YJsonWriter& writer) const override;
+	// every instance matrix from component_to_world_ and the pending edits
+	void UpdateBound() override;
+	// ranges of visible clusters merged in slot order
+	struct SRangeMerger;
+	bool NeedsClusterTreeBuild() const;
+	void BuildClusterTree();
+	void RefitClusters(bool refit_all);
+	YBox GetSlotBox(int slot) const;
+	void MarkClusterDirty(int cluster_index);
+	TRefCountPtr<YStaticMesh> static_mesh_;
+	// as referenced by the json, kept for saving
+	std::string model_path_;
+	// instances of a cluster tree leaf
+	int cluster_size_ = default_cluster_size;
+	std::vector<YTransform> instances_;
+	std::vector<int> instance_to_slot_;
+	std::vector<int> slot_to_instance_;
+	std::vector<int> slot_to_cluster_;
+	std::vector<YMatrix> slot_matrices_;
+	// the tree clusters first, then the ones added after the build, all in slot order
+	std::vector<SInstanceCluster> clusters_;
+	std::vector<YBVHNode> cluster_nodes_;
+	// cluster of every leaf of cluster_nodes_, -1 for an inner node
+	std::vector<int> node_to_cluster_;
+	std::vector<int> dirty_clusters_;
+	int built_slot_count_ = 0;
+	// instances removed from the tree clusters since the last build, they leave the tree boxes too large
+	int removed_since_build_ = 0;
+	bool has_pending_update_ = false;
+};
+
+struct SInstancedStaticMeshComponent::SRangeMerger
+{
+	int first = 0;
+	int count = 0;
+	template<typename Func>
+	void Add(int range_first, int range_count, Func& func)
+	{
+		if (range_count <= 0)
+		{
+			return;
+		}
+		if (count > 0 && first + count == range_first)
+		{
+			count += range_count;
+			return;
+		}
+		Flush(func);
+		first = range_first;
+		count = range_count;
+	}
+	template<typename Func>
+	void Flush(Func& func)
+	{
+		if (count > 0)
+		{
+			func(first, count);
+		}
+		count = 0;
+	}
+};
+
+template<typename Func>
+void SInstancedStaticMeshComponent::QueryVisibleRanges(const YFrustum& frustum, Func&& func) const
+{
+	SRangeMerger merger;
+	if (!cluster_nodes_.empty())
+	{
+		// leaves come in slot order as the left child of a node holds the lower slots
+		int stack[YBVH::max_depth * 2];
+		bool stack_inside[YBVH::max_depth * 2];
+		int stack_size = 0;
+		stack[stack_size] = 0;
+		stack_inside[stack_size++] = false;
+		while (stack_size > 0)
+		{
+			--stack_size;
+			const int node_index = stack[stack_size];
+			bool is_inside = stack_inside[stack_size];
+			const YBVHNode& node = cluster_nodes_[node_index];
+			if (!is_inside)
+			{
+				const EFrustumContainment containment = frustum.ClassifyBox(YBox(node.min_corner, node.max_corner));
+				if (containment == FC_Outside)
+				{
+					continue;
+				}
+				is_inside = containment == FC_Inside;
+			}
+			if (node.count > 0)
+			{
+				const SInstanceCluster& cluster = clusters_[node_to_cluster_[node_index]];
+				merger.Add(cluster.first, cluster.count, func);
+				continue;
+			}
+			stack[stack_size] = node.first + 1;
+			stack_inside[stack_size++] = is_inside;
+			stack[stack_size] = node.first;
+			stack_inside[stack_size++] = is_inside;
+		}
+	}
+	for (const SInstanceCluster& cluster : clusters_)
+	{
+		if (cluster.node < 0 && cluster.count > 0 && frustum.IntersectBox(cluster.box))
+		{
+			merger.Add(cluster.first, cluster.count, func);
+		}
+	}
+	merger.Flush(func);
+}
+
+template<typename Func>
+void SInstancedStaticMeshComponent::ForEachRange(Func&& func) const
+{
+	if (!slot_matrices_.empty())
+	{
+		func(0, (int)slot_matrices_.size());
+	}
+}
@@ -4,8 +4,22 @@
 #include <string>
 #include "Engine/YLog.h"
 #include "Engine/YReferenceCount.h"
+#include "Utility/YObjectPool.h"
 class MemoryFile;
-class SObject :public YRefCountedObject
+class YJsonWriter;
+
+// index into the SObjectManager slot table, generation changes every time the slot is reused
+struct SObjectHandle
+{
+	uint32_t index = invalid_index;
+	uint32_t generation = 0;
+	bool IsValid() const { return index != invalid_index; }
+	bool operator==(const SObjectHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const SObjectHandle& other) const { return !(*this == other); }
+	static constexpr uint32_t invalid_index = 0xffffffff;
+};
+
+class SObject :public YThreadSafeRefCountedObject
 {
 public:
 	virtual ~SObject();
@@ -15,17 +29,33 @@ public:
 	SObject& operator=(SObject&&) = default;
 	virtual bool LoadFromJson(const Json::Value& RootJson);
 	virtual bool LoadFromMemoryFile(std::unique_ptr<MemoryFile> mem_file);
-	virtual void SaveToPackage(const std::string& Path);
+	// Path + json_extension_with_dot written by SaveToJson in one pass, compact
+	virtual bool SaveToPackage(const std::string& Path);
+	// the json LoadFromJson reads back, false if the object has nothing to save
+	virtual bool SaveToJson(YJsonWriter& writer) const;
 	virtual bool PostLoadOp();
 	virtual void Update(double deta_time);
+	// hides YThreadSafeRefCountedObject::Release, tells the manager when only its own reference is left
+	uint32_t Release() const;
+	SObjectHandle GetHandle() const { return handle_; }
+	// new (YObjectPool::Get<T>()) T(...) puts the object in the slab pool of its type, plain new uses the heap
+	static void* operator new(size_t size) { return YObjectPool::AllocateFromHeap(size); }
+	static void* operator new(size_t size, YObjectPool& pool) { return pool.Allocate(size); }
+	static void operator delete(void* ptr) { YObjectPool::FreeObject(ptr); }
+	static void operator delete(void* ptr, YObjectPool&) { YObjectPool::FreeObject(ptr); }
 	static const std::string  asset_extension;
 	static const std::string  asset_extension_with_dot;
 	static const std::string  json_extension;
 	static const std::string  json_extension_with_dot;
+	// the binary package exists and is not older than the json it was cooked from, a missing json counts as older
+	static bool IsBinaryPackageUpToDate(const std::string& binary_path, const std::string& json_path);
 
 protected:
 	SObject();
 	virtual bool LoadFromPackage(const std::string& Path);
+	// parses the whole json package into a Json::Value for LoadFromJson, overridden by objects that stream their json
+	virtual bool LoadFromJsonFile(const std::string& json_path);
 private:
 	friend class SObjectManager;
+	SObjectHandle handle_;
 };
@@ -2,20 +2,24 @@
 #include "SObject/SObject.h"
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <utility>
 #include "Engine/YLog.h"
-#include <unordered_set>
-#include <set>
 #include "Engine/YReferenceCount.h"
+#include "Utility/YPath.h"
 class SObjectManager
 {
 public:
 	SObjectManager();
+	~SObjectManager();
 	template<typename ClassType, typename...T>
 	static TRefCountPtr<ClassType> ConstructInstance(T&&... Args)
 	{
 		assert(ClassType::IsInstance());
-		TRefCountPtr<ClassType> Obj(new ClassType(Forward<T>(Args)...), true);
-		GetManager().instanced_objects_.insert(TRefCountPtr<SObject>(Obj.GetReference(), true));
+		TRefCountPtr<ClassType> Obj(new (YObjectPool::Get<ClassType>()) ClassType(std::forward<T>(Args)...), true);
+		GetManager().Register(Obj.GetReference());
 		return Obj;
 	}
 
@@ -23,8 +27,8 @@ public:
 	static TRefCountPtr<ClassType> ConstructUnique(T&&... Args)
 	{
 		assert(!ClassType::IsInstance());
-		TRefCountPtr<ClassType> Obj(new ClassType(Forward<T>(Args)...), true);
-		GetManager().instanced_objects_.insert(TRefCountPtr<SObject>(Obj.GetReference(), true));
+		TRefCountPtr<ClassType> Obj(new (YObjectPool::Get<ClassType>()) ClassType(std::forward<T>(Args)...), true);
+		GetManager().Register(Obj.GetReference());
 		return Obj;
 	}
 
@@ -36,29 +40,60 @@ public:
 		// todo
 		//FPaths::NormalizeFilename(PackagePathNoSuffix);
 		std::string package_name = YPath::GetBaseFilename(PackagePathNoSuffix, false);
-		auto find_result = GetManager().unify_objects_.find(package_name);
-		if (find_result == GetManager().unify_objects_.end())
+		SObjectManager& manager = GetManager();
+		auto find_result = manager.unify_objects_.find(package_name);
+		if (find_result == manager.unify_objects_.end())
 		{
-			TRefCountPtr<ClassType> Obj((new ClassType(Forward<T>(Args)...)), true);
+			TRefCountPtr<ClassType> Obj((new (YObjectPool::Get<ClassType>()) ClassType(std::forward<T>(Args)...)), true);
 			if (Obj->LoadFromPackage(package_name))
 			{
-				GetManager().unify_objects_[package_name] = TRefCountPtr<SObject>(Obj.GetReference());
+				manager.unify_objects_[package_name] = manager.Register(Obj.GetReference(), package_name);
 				return Obj;
 			}
 			return nullptr;
 		}
 		else
 		{
-			return TRefCountPtr<ClassType>(dynamic_cast<ClassType*>(find_result->second.GetReference()), true);
+			return manager.Resolve<ClassType>(find_result->second);
 		}
 
 		return nullptr;
 	}
 
+	// construct and resolve are safe on any thread, unify objects and destroy are game thread only
+	// nullptr if the object behind the handle has been destroyed, the reference is taken under the slot lock
+	// so FrameDestroy on the game thread can not delete the object while the caller holds it
+	TRefCountPtr<SObject> Resolve(SObjectHandle handle) const;
+	template<typename ClassType>
+	TRefCountPtr<ClassType> Resolve(SObjectHandle handle) const
+	{
+		TRefCountPtr<SObject> object = Resolve(handle);
+		return TRefCountPtr<ClassType>(dynamic_cast<ClassType*>(object.GetReference()), true);
+	}
+	int GetLiveObjectCount() const { return live_object_count_.load(std::memory_order_relaxed); }
+	// called by SObject::Release when the manager holds the last reference, any thread
+	void EnqueuePendingDestroy(SObjectHandle handle);
+
 	void Destroy();
 	void FrameDestroy();
 	static SObjectManager& GetManager();
 private:
-	std::unordered_map<std::string, TRefCountPtr<SObject>> unify_objects_;
-	std::unordered_set<TRefCountPtr<SObject>> instanced_objects_;
-};
\ No newline at end of file
+	struct ObjectSlot
+	{
+		TRefCountPtr<SObject> object;
+		uint32_t generation = 0;
+		std::string unify_name;
+	};
+	SObjectHandle Register(SObject* object, const std::string& unify_name = "");
+	SObject* ResolveLocked(SObjectHandle handle) const;
+	// return number of destroyed objects
+	int DestroyPending();
+	std::vector<ObjectSlot> slots_;
+	std::vector<uint32_t> free_slots_;
+	std::vector<SObjectHandle> pending_destroy_;
+	std::vector<SObjectHandle> destroying_;
+	std::mutex pending_destroy_mutex_;
+	mutable std::mutex slots_mutex_;
+	std::atomic<int> live_object_count_{ 0 };
+	std::unordered_map<std::string, SObjectHandle> unify_objects_;
+};
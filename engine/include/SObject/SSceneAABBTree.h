@@ -0,0 +1,61 @@
+#pragma once
+#include "Engine/YAABBTree.h"
+#include "SObject/SComponent.h"
+class SActor;
+
+// dynamic hierarchy over the world bounds of the scene components of a world, for culling and proximity queries
+// components without bounds are left out, a component that gets bounds later is added by UpdateComponent
+// a moved component costs one leaf update, the rest of the tree is not touched
+// game thread only for changes, queries may run on any thread while nothing changes
+class SSceneAABBTree
+{
+public:
+	void AddComponent(SSceneComponent* component);
+	void RemoveComponent(SSceneComponent* component);
+	// takes the current bounds of component and clears its dirty flag
+	void UpdateComponent(SSceneComponent* component);
+	void AddActorComponents(SActor* actor);
+	void RemoveActorComponents(SActor* actor);
+	// the components with dirty bounds of actor
+	void UpdateActorComponents(SActor* actor);
+	void Clear();
+	int GetComponentCount() const { return tree_.GetProxyCount(); }
+	const YAABBTree& GetTree() const { return tree_; }
+	// number of leaves reinserted since the last call, the rest of the moves stayed inside their fat boxes
+	int ResetReinsertCount();
+
+	// func(SSceneComponent*) for every component whose fat box overlaps box
+	template<typename Func>
+	void QueryOverlap(const YBox& box, Func&& func) const
+	{
+		tree_.QueryOverlap(box, [this, &func](int proxy) { func(GetComponent(proxy)); });
+	}
+	// func(box_index, SSceneComponent*) in one walk for many boxes
+	template<typename Func>
+	void QueryOverlaps(const YBox* boxes, int box_count, Func&& func) const
+	{
+		tree_.QueryOverlaps(boxes, box_count, [this, &func](int box_index, int proxy) { func(box_index, GetComponent(proxy)); });
+	}
+	// func(SSceneComponent*) for every component that may be seen by frustum
+	template<typename Func>
+	void QueryFrustum(const YFrustum& frustum, Func&& func) const
+	{
+		tree_.QueryFrustum(frustum, [this, &func](int proxy) { func(GetComponent(proxy)); });
+	}
+	// func(frustum_index, SSceneComponent*) in one walk for many frustums
+	template<typename Func>
+	void QueryFrustums(const YFrustum* frustums, int frustum_count, Func&& func) const
+	{
+		tree_.QueryFrustums(frustums, frustum_count, [this, &func](int frustum_index, int proxy) { func(frustum_index, GetComponent(proxy)); });
+	}
+	// func(SSceneComponent*) for every component whose fat box an active ray of packet reaches, see YAABBTree::RayCastPacket
+	template<typename Func>
+	void RayCastPacket(YRayPacket& packet, Func&& func) const
+	{
+		tree_.RayCastPacket(packet, [this, &func](int proxy) { func(GetComponent(proxy)); });
+	}
+protected:
+	SSceneComponent* GetComponent(int proxy) const { return static_cast<SSceneComponent*>(tree_.GetUserData(proxy)); }
+	YAABBTree tree_;
+	int reinsert_count_ = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <vector>
+#include "Engine/YBVH.h"
+#include "Engine/YMeshBVH.h"
+#include "Math/YMatrix.h"
+#include "Math/YTransform.h"
+class SComponentStorage;
+class SStaticMeshComponent;
+class YStaticMesh;
+
+// the static mesh component a ray hit and the triangle of its mesh
+struct SSceneHit
+{
+	SStaticMeshComponent* component = nullptr;
+	// distance along the world ray and barycentrics of the triangle in the mesh
+	YMeshHit mesh_hit;
+	// world space
+	YVector position = YVector::zero_vector;
+	bool IsValid() const { return component != nullptr; }
+};
+
+// top level hierarchy over the static mesh components of a world, every instance is traced
+// through the YMeshBVH of its mesh in mesh space, so a mesh shared by many components is built once
+class SSceneBVH
+{
+public:
+	// rebuilt when a component was added, removed, moved or got another mesh since the last call, game thread only
+	// builds the mesh hierarchies that do not exist yet
+	void Update(const SComponentStorage& component_storage);
+	void Clear();
+	// closest hits of up to four world space rays, a valid hit is only replaced by a closer one
+	void IntersectPacket(const YRay* rays, int ray_count, SSceneHit* hits) const;
+	// true when hit was replaced
+	bool Intersect(const YRay& ray, SSceneHit& hit) const;
+	int GetInstanceCount() const { return (int)instances_.size(); }
+	int GetNodeCount() const { return (int)nodes_.size(); }
+	// instances in leaf order, for tools walking the scene
+	template<typename Func>
+	void ForEachInstance(Func&& func) const
+	{
+		for (const Instance& instance : instances_)
+		{
+			func(instance.component, instance.world_bounds);
+		}
+	}
+protected:
+	struct Instance
+	{
+		YMatrix world_to_local;
+		SStaticMeshComponent* component = nullptr;
+		const YMeshBVH* mesh_bvh = nullptr;
+		YBox world_bounds;
+	};
+	// what the hierarchy was built from, in storage order
+	struct Source
+	{
+		SStaticMeshComponent* component = nullptr;
+		YStaticMesh* mesh = nullptr;
+		YTransform component_to_world;
+	};
+	bool IsSourceChanged(const std::vector<Source>& sources) const;
+	std::vector<YBVHNode> nodes_;
+	std::vector<Instance> instances_;
+	std::vector<Source> sources_;
+};
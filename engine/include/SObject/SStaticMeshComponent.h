@@ -1,17 +1,26 @@
 #pragma once
 #include "SObject/SComponent.h"
 #include "Engine/YStaticMesh.h"
-#include <memory>
+#include "Engine/YReferenceCount.h"
 class SStaticMeshComponent:public SRenderComponent
 {
 public:
+	static constexpr EComponentType GetStaticType() { return EComponentType::StaticMeshComponent; }
 	SStaticMeshComponent();
 	~SStaticMeshComponent();
 	bool LoadFromJson(const Json::Value& RootJson) override;
+	bool CookFromJson(const Json::Value& root_json, SCookedWorldWriter& writer) const override;
+	bool LoadFromCooked(const SCookedWorld& cooked_world, uint32_t component_index) override;
+	static constexpr const char* type_name = "StaticMesh";
+	const char* GetTypeName() const override { return type_name; }
 	bool PostLoadOp() override;
 	void Update(double deta_time) override;
-	void RegisterToScene(class YScene* scene) override;
 	YStaticMesh* GetMesh();
 protected:
-	std::unique_ptr<YStaticMesh> static_mesh_;
+	void SaveMembersToJson(YJsonWriter& writer) const override;
+	// the bounds of the mesh around component_to_world_
+	void UpdateBound() override;
+	TRefCountPtr<YStaticMesh> static_mesh_;
+	// as referenced by the json, kept for saving
+	std::string model_path_;
 };
\ No newline at end of file
@@ -1,8 +1,15 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <functional>
 #include "SObject/SObject.h"
 #include "SObject/SActor.h"
+#include "SObject/SWorldTick.h"
+#include "SObject/SWorldPartition.h"
+#include "SObject/SComponentStorage.h"
+#include "SObject/SCookedWorld.h"
+#include "SObject/SSceneBVH.h"
+#include "SObject/SSceneAABBTree.h"
 #include "Engine/YRenderScene.h"
 
 class SWorld :public SObject
@@ -12,16 +19,70 @@ public:
 	virtual ~SWorld();
 	static constexpr bool IsInstance() { return false; };
 	virtual bool LoadFromJson(const Json::Value& RootJson);
+	// settings, partition and the actors that do not belong to a partition cell, game thread only
+	bool SaveToJson(YJsonWriter& writer) const override;
 	virtual bool PostLoadOp();
+	// cooked world written by SCookedWorld::CookWorldFile
+	virtual bool LoadFromMemoryFile(std::unique_ptr<MemoryFile> mem_file) override;
+	// world settings only, actors are loaded by LoadFromJson or SWorldLoader
+	bool LoadSettingsFromJson(const Json::Value& RootJson);
+	bool LoadSettingsFromCooked(const SCookedWorld& cooked_world);
+	// thread safe, nullptr if the actor json is invalid
+	static TRefCountPtr<SActor> LoadActorFromJson(const Json::Value& actor_json);
+	// one pass over a world or cell json without building the document, settings go to world when it is not null
+	// every actor is built as its own Json::Value and moved into out_actors, from arena when it is not null
+	// with an arena the file is parsed in place and kept alive by it
+	static bool StreamWorldJson(const std::string& json_path, SWorld* world, std::vector<Json::Value>& out_actors, size_t* out_file_size = nullptr, Json::Arena* arena = nullptr);
+	// load_actor(index) for every index on the task system, the actors that loaded are appended to out_actors in index order
+	static void LoadActorsParallel(int actor_count, const std::function<TRefCountPtr<SActor>(int)>& load_actor, std::vector<TRefCountPtr<SActor>>& out_actors);
+	// actors added after the scene exists are registered to it by AddActor
+	void CreateScene();
 	std::unique_ptr<YRenderScene> GenerateRenderScene();
 	void Update(double deta_time) override;
+	// game thread only, use SWorldCommandBuffer while ticking
+	void AddActor(TRefCountPtr<SActor> actor);
+	// game thread only, unregisters the actors from the scene and drops the world references
+	void RemoveActors(const std::vector<TRefCountPtr<SActor>>& actors);
+	// game thread only, attach component under parent (the root when parent is null) and keep the component storage in sync
+	bool AttachComponent(SActor* actor, TRefCountPtr<SSceneComponent> component, SSceneComponent* parent = nullptr);
+	bool DetachComponent(SSceneComponent* component);
+	const SComponentStorage& GetComponentStorage() const { return component_storage_; }
+	// bounds of the scene components in the world, kept up to date as they move
+	const SSceneAABBTree& GetSpatialTree() const { return spatial_tree_; }
+	// game thread only, moves the components of actor with dirty bounds in the spatial tree
+	// actors queue it while ticking, a component moved outside of a tick needs it before the next query
+	void UpdateComponentBounds(SActor* actor);
+	// nullptr for a world without "partition", all of its actors are always resident
+	SWorldPartition* GetPartition() const { return partition_.get(); }
+	const STickPhaseStats& GetTickPhaseStats(ETickPhase phase) const;
+	// closest static mesh along a world space ray, the scene hierarchy is brought up to date first, game thread only
+	bool RayCast(const YRay& ray, SSceneHit& out_hit);
+	// closest hits of many rays, traced in packets of four
+	void RayCastPacket(const YRay* rays, int ray_count, SSceneHit* out_hits);
+	// up to date hierarchy over the static mesh components, for tools with their own queries
+	const SSceneBVH& GetSceneBVH();
+	void SetTickBatchSize(int batch_size);
 	static SWorld* GetWorld() ;
 	static void SetWorld(TRefCountPtr<SWorld>& world);
 	//todo load camera
+	static const int actor_load_batch_size = 4;
 
 	void SetCamera(CameraBase* camera);
 protected:
+	bool LoadFromJsonFile(const std::string& json_path) override;
+	bool LoadPartitionFromJson(const Json::Value& partition_json);
+	void TickPhase(ETickPhase phase, double deta_time);
+	void RebuildTickLists();
 	std::vector<TRefCountPtr<SActor>> Actors;
+	std::vector<SActor*> tick_lists_[TP_Num];
+	bool tick_lists_dirty_ = true;
+	std::vector<SWorldCommandBuffer> command_buffers_;
+	STickPhaseStats tick_stats_[TP_Num];
+	int tick_batch_size_ = 64;
 	std::unique_ptr<YScene> scene_;
-	CameraBase* camera_;
+	SComponentStorage component_storage_;
+	std::unique_ptr<SWorldPartition> partition_;
+	SSceneBVH scene_bvh_;
+	SSceneAABBTree spatial_tree_;
+	CameraBase* camera_ = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include "SObject/SWorld.h"
+#include "Engine/YReferenceCount.h"
+
+enum EWorldLoadStage
+{
+	WLS_None,
+	WLS_ReadFile,
+	WLS_LoadActors,
+	// every actor is deserialized, waiting for the owning thread to finalize the rest
+	WLS_Finalize,
+	WLS_Finished,
+	WLS_Failed,
+};
+const char* GetWorldLoadStageName(EWorldLoadStage stage);
+
+struct SWorldLoadProgress
+{
+	EWorldLoadStage stage = WLS_None;
+	int total_actor_count = 0;
+	int critical_actor_count = 0;
+	int loaded_actor_count = 0;
+	int finalized_actor_count = 0;
+	double elapsed_ms = 0.0;
+	// 0 - 1, deserialize and finalize weigh the same
+	float GetFraction() const;
+};
+
+// world.yasset written by SCookedWorld is loaded instead of world.json when it exists
+// read -> parse -> deserialize actors and meshes on the task system -> finalize (gpu resources, scene registration) on the owning thread
+// actors with "critical": true are loaded and finalized first, if no actor is marked every actor is critical
+class SWorldLoader
+{
+public:
+	SWorldLoader();
+	~SWorldLoader();
+	SWorldLoader(const SWorldLoader&) = delete;
+	SWorldLoader& operator=(const SWorldLoader&) = delete;
+
+	// owning thread, world_path is the package path as for ConstructUnifyFromPackage
+	bool BeginLoad(const std::string& world_path);
+	// owning thread, finalize loaded actors until time_budget_ms is used up, returns true once every actor is finalized
+	bool Tick(double time_budget_ms);
+	// owning thread, blocks until every critical actor is in the world, false if the world file failed to load
+	bool WaitForCriticalActors();
+	bool IsCriticalReady() const;
+	bool IsFinished() const;
+	SWorldLoadProgress GetProgress() const;
+	TRefCountPtr<SWorld> GetWorld() const { return world_; }
+protected:
+	enum EActorLoadState
+	{
+		ALS_Pending,
+		ALS_Loaded,
+		ALS_Failed,
+	};
+	struct ActorLoadSlot
+	{
+		TRefCountPtr<SActor> actor;
+		EActorLoadState state = ALS_Pending;
+	};
+	void LoadThreadMain();
+	void LoadActors(int actor_count, const std::function<bool(int)>& is_critical, const std::function<TRefCountPtr<SActor>(int)>& load_actor);
+	void LoadActorRange(const std::function<TRefCountPtr<SActor>(int)>& load_actor, int first, int count);
+	// take loaded actors in load order, stops at the first actor still loading, call with mutex_ locked
+	void CollectLoadedActors(int max_count, std::vector<TRefCountPtr<SActor>>& out_actors);
+	void FinalizeActors(std::vector<TRefCountPtr<SActor>>& actors);
+	void SetStage(EWorldLoadStage stage);
+
+	std::string world_json_path_;
+	// empty when there is no cooked world and the json is loaded
+	std::string world_cooked_path_;
+	TRefCountPtr<SWorld> world_;
+	std::thread load_thread_;
+	std::atomic<bool> cancel_{ false };
+	std::chrono::time_point<std::chrono::high_resolution_clock> start_time_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable actor_loaded_cv_;
+	// critical actors first, then the rest, both in file order
+	std::vector<int> load_order_;
+	std::vector<ActorLoadSlot> slots_;
+	int finalize_cursor_ = 0;
+	SWorldLoadProgress progress_;
+};
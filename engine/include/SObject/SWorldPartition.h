@@ -0,0 +1,160 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include "SObject/SActor.h"
+#include "Engine/YReferenceCount.h"
+#include "Math/YVector.h"
+#include "Math/YBox.h"
+#include "json.h"
+
+class SWorld;
+class YJsonWriter;
+
+struct SWorldCellCoord
+{
+	int x = 0;
+	int z = 0;
+	bool operator==(const SWorldCellCoord& other) const { return x == other.x && z == other.z; }
+	uint64_t GetKey() const { return ((uint64_t)(uint32_t)x << 32) | (uint32_t)z; }
+};
+
+struct SWorldPartitionSettings
+{
+	// cells are square on the xz plane
+	float cell_size = 256.0f;
+	// cells closer than loading_radius are loaded, cells further than unloading_radius are unloaded
+	float loading_radius = 512.0f;
+	float unloading_radius = 768.0f;
+	int memory_budget_mb = 512;
+	// game thread time per frame to finalize streamed in actors
+	double finalize_budget_ms = 2.0;
+	bool LoadFromJson(const Json::Value& root_json);
+	// the members LoadFromJson reads, into the object being written
+	void SaveToJson(YJsonWriter& writer) const;
+};
+
+struct SWorldCellDesc
+{
+	SWorldCellCoord coord;
+	std::string file_path;
+	int actor_count = 0;
+	// world space box around the actors of the cell, may reach past the cell square, empty when unknown
+	YBox bounds;
+	// an entry of "cells"
+	void LoadFromJson(const Json::Value& cell_json);
+};
+
+struct SWorldPartitionStats
+{
+	int cell_count = 0;
+	int loading_cell_count = 0;
+	int resident_cell_count = 0;
+	int resident_actor_count = 0;
+	size_t resident_bytes = 0;
+	// loads skipped this frame because the budget is full
+	int budget_blocked_cell_count = 0;
+};
+
+// grid partitioned world, every cell is a json file holding the actors whose bounds are centered inside it
+// a cell is streamed by its distance to the union of its square and the bounds of its actors,
+// so a large actor is in range as soon as any part of it is
+// a cooked cell (SCookedWorld) beside the json is loaded instead when it exists
+// the world json references the cells:
+// "partition": { "cell_size": 256, "loading_radius": 512, "unloading_radius": 768, "memory_budget_mb": 512,
+//                "cells": [ { "x": 0, "z": 0, "file": "map/world_cells/cell_0_0.json", "actor_count": 12,
+//                             "bounds_min": [0, -10, 0], "bounds_max": [300, 40, 256] } ] }
+class SWorldPartition
+{
+public:
+	explicit SWorldPartition(SWorld* world);
+	~SWorldPartition();
+	SWorldPartition(const SWorldPartition&) = delete;
+	SWorldPartition& operator=(const SWorldPartition&) = delete;
+
+	bool LoadFromJson(const Json::Value& partition_json);
+	// settings and cell list, the cell files are not touched
+	void SaveToJson(YJsonWriter& writer) const;
+	// game thread, actors the world got from resident or finalizing cells, saved with their cell
+	void GetStreamedActors(std::unordered_set<const SActor*>& out_actors) const;
+	// settings are used as they are, LoadFromJson has already validated them
+	bool InitCells(const SWorldPartitionSettings& settings, const std::vector<SWorldCellDesc>& cells);
+	// game thread, request and finalize cells around the view, unload the far ones
+	void UpdateStreaming(const YVector& view_position);
+	// game thread, drop every resident cell, used when the world goes away
+	void UnloadAll();
+	SWorldCellCoord GetCellCoord(const YVector& position) const;
+	const SWorldPartitionSettings& GetSettings() const { return settings_; }
+	SWorldPartitionStats GetStats() const;
+
+	// split the actors of a flat world json into cells by the center of their world bounds and write a partitioned world
+	// the cells go to <out_world_path without extension>_cells/cell_x_z.json
+	// the actors are loaded to measure them, one that fails to load is placed by its root translation
+	static bool BuildPartitionedWorld(const std::string& world_path, const std::string& out_world_path, const SWorldPartitionSettings& settings);
+protected:
+	enum ECellState
+	{
+		CS_Unloaded,
+		// queued or being deserialized on the stream thread
+		CS_Loading,
+		// deserialized, waiting for the game thread to finalize
+		CS_Loaded,
+		CS_Resident,
+	};
+	struct WorldCell
+	{
+		SWorldCellCoord coord;
+		std::string file_path;
+		int actor_count = 0;
+		YBox bounds;
+		ECellState state = CS_Unloaded;
+		// unload requested while the stream thread still owns the cell
+		bool cancel_load = false;
+		std::vector<TRefCountPtr<SActor>> actors;
+		int finalized_actor_count = 0;
+		size_t resident_bytes = 0;
+		// last measured size, from the actor count before the first load
+		size_t estimated_bytes = 0;
+		// estimated_bytes at the request, held against the budget until the cell is resident or dropped
+		size_t streaming_bytes = 0;
+	};
+	void StreamThreadMain();
+	void LoadCell(WorldCell& cell);
+	void FinalizeLoadedCells();
+	void UnloadCell(WorldCell& cell);
+	// mutex_ held
+	void ReleaseStreamingBytes(WorldCell& cell);
+	float GetCellDistance(const WorldCell& cell, const YVector& position) const;
+	// world bounds of the actor of actor_json, a point at its root when it has no geometry
+	static YBox GetActorBounds(const Json::Value& actor_json);
+	static size_t MeasureActorsSize(const std::vector<TRefCountPtr<SActor>>& actors, size_t file_size);
+
+	SWorld* world_ = nullptr;
+	SWorldPartitionSettings settings_;
+	std::vector<WorldCell> cells_;
+	std::unordered_map<uint64_t, int> cell_index_map_;
+	// furthest the bounds of a cell reach past its square, widens the window of cells visited for loading
+	float max_cell_overhang_ = 0.0f;
+	// game thread only
+	std::vector<int> resident_cells_;
+	// loaded cells whose actors are being added to the world over several frames
+	std::vector<int> finalizing_cells_;
+	size_t resident_bytes_ = 0;
+	// requested cells not resident yet, guarded by mutex_
+	size_t streaming_bytes_ = 0;
+	int budget_blocked_cell_count_ = 0;
+	bool release_meshes_pending_ = false;
+
+	std::thread stream_thread_;
+	mutable std::mutex mutex_;
+	std::condition_variable request_cv_;
+	std::deque<int> load_requests_;
+	std::vector<int> loaded_cells_;
+	bool exit_ = false;
+};
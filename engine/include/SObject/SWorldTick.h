@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <functional>
+
+class SWorld;
+
+enum ETickPhase
+{
+	TP_PrePhysics = 0,
+	TP_Physics,
+	TP_PostPhysics,
+	TP_FinalizeTransform,
+	TP_Num
+};
+
+inline uint32_t TickPhaseBit(ETickPhase phase)
+{
+	return 1u << (uint32_t)phase;
+}
+
+const char* GetTickPhaseName(ETickPhase phase);
+// "pre_physics" ==> TP_PrePhysics, return TP_Num if unknown
+ETickPhase GetTickPhaseFromName(const std::string& name);
+
+// actors ticked in parallel must not touch the world or other actors directly,
+// such writes are recorded here and executed on the game thread after the phase
+class SWorldCommandBuffer
+{
+public:
+	typedef std::function<void(SWorld* world)> Command;
+	void Enqueue(Command command) { commands_.push_back(std::move(command)); }
+	bool IsEmpty() const { return commands_.empty(); }
+	int Num() const { return (int)commands_.size(); }
+	void Execute(SWorld* world);
+protected:
+	std::vector<Command> commands_;
+};
+
+struct STickPhaseStats
+{
+	double time_ms = 0.0;
+	int actor_count = 0;
+	int batch_count = 0;
+	int command_count = 0;
+};
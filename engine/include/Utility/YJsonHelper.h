@@ -2,11 +2,25 @@
 #include "Math/YVector.h"
 #include "json.h"
 #include "Math/YRotator.h"
+#include "Utility/YJsonVisitor.h"
+#include "Utility/YJsonWriter.h"
+#include <functional>
 struct YJsonHelper
 {
 	static bool ConvertJsonToVector2(const Json::Value& value,YVector2& v);
 	static bool ConvertJsonToVector(const Json::Value& value,YVector& v);
 	static bool ConvertJsonToVector4(const Json::Value& value,YVector4& v);
 	static bool ConvertJsonToRotator(const Json::Value& value,YRotator& v);
-	static bool LoadJsonFromFile(const std::string& path, Json::Value& root);
+	// with an arena the document is allocated from it, root must be destroyed before the arena
+	// strings without escape sequence then stay in the file buffer, which the arena keeps alive
+	static bool LoadJsonFromFile(const std::string& path, Json::Value& root, Json::Arena* arena = nullptr);
+	// one pass over the file with Json::SaxReader, no document is built
+	static bool VisitJsonFromFile(const std::string& path, const YJsonObjectVisitor& root_visitor);
+	// values handed to OnValue/OnArrayValues callbacks are allocated from arena when it is not null
+	static bool VisitJson(const char* begin, const char* end, const YJsonObjectVisitor& root_visitor, std::string* out_error = nullptr, Json::Arena* arena = nullptr);
+	// VisitJson parsing in place, the text is modified and must outlive the values built from it
+	static bool VisitJsonInSitu(char* begin, char* end, const YJsonObjectVisitor& root_visitor, Json::Arena& arena, std::string* out_error = nullptr);
+	static bool SaveJsonToFile(const std::string& path, const Json::Value& root, YJsonWriter::EStyle style = YJsonWriter::JS_Pretty);
+	// write_func streams the document into the file, nothing is kept in memory beyond the writer buffer
+	static bool WriteJsonToFile(const std::string& path, const std::function<bool(YJsonWriter&)>& write_func, YJsonWriter::EStyle style);
 };
\ No newline at end of file
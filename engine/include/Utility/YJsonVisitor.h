@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include "json.h"
+#include "Math/YVector.h"
+
+// typed callbacks for the members of one json object, driven by YJsonHelper::VisitJsonFromFile in a single pass over the text
+// members without a callback are skipped without building anything, a member of the wrong type is skipped with a warning
+class YJsonObjectVisitor
+{
+public:
+	YJsonObjectVisitor& OnBool(const std::string& key, std::function<void(bool)> func);
+	// numbers are converted as Json::Value::asInt/asFloat would
+	YJsonObjectVisitor& OnInt(const std::string& key, std::function<void(int)> func);
+	YJsonObjectVisitor& OnFloat(const std::string& key, std::function<void(float)> func);
+	YJsonObjectVisitor& OnString(const std::string& key, std::function<void(std::string&&)> func);
+	// [x, y, z], as YJsonHelper::ConvertJsonToVector
+	YJsonObjectVisitor& OnVector(const std::string& key, std::function<void(const YVector&)> func);
+	// nested object visited with its own callbacks, visitor must outlive the visit
+	YJsonObjectVisitor& OnObject(const std::string& key, const YJsonObjectVisitor* visitor);
+	// the member built as a Json::Value straight from the text, for consumers that take a dom
+	YJsonObjectVisitor& OnValue(const std::string& key, std::function<void(Json::Value&&)> func);
+	// every element of an array member built as its own Json::Value, in order
+	YJsonObjectVisitor& OnArrayValues(const std::string& key, std::function<void(Json::Value&&)> func);
+protected:
+	friend class YJsonVisitHandler;
+	enum EMemberType
+	{
+		MT_Bool,
+		MT_Int,
+		MT_Float,
+		MT_String,
+		MT_Vector,
+		MT_Object,
+		MT_Value,
+		MT_ArrayValues,
+	};
+	struct Member
+	{
+		std::string key;
+		EMemberType type = MT_Value;
+		std::function<void(bool)> bool_func;
+		std::function<void(int)> int_func;
+		std::function<void(float)> float_func;
+		std::function<void(std::string&&)> string_func;
+		std::function<void(const YVector&)> vector_func;
+		std::function<void(Json::Value&&)> value_func;
+		const YJsonObjectVisitor* object_visitor = nullptr;
+	};
+	Member& AddMember(const std::string& key, EMemberType type);
+	// linear, a visitor has a handful of members
+	const Member* FindMember(const char* key_begin, const char* key_end) const;
+	std::vector<Member> members_;
+};
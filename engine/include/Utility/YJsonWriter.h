@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "json.h"
+#include "Math/YVector.h"
+#include "Math/YRotator.h"
+class MemoryFile;
+
+// streaming json output, text goes through a fixed buffer straight to a MemoryFile or an open file, no document or string is built
+// float policy: the shortest text that reads back to the same float (double for WriteDouble), integral values keep a ".0",
+// nan and infinity have no json form and are written as null
+// calls are not validated beyond asserts, a key goes before every value inside an object
+class YJsonWriter
+{
+public:
+	enum EStyle
+	{
+		JS_Compact,
+		// one member or element per line indented with tabs, arrays of scalars stay on one line
+		JS_Pretty,
+	};
+	// appends to mem_file, the text is complete after Flush or destruction
+	explicit YJsonWriter(MemoryFile& mem_file, EStyle style = JS_Compact);
+	// writes to file, which stays open, see YFile::OpenForWrite
+	explicit YJsonWriter(FILE* file, EStyle style = JS_Compact);
+	~YJsonWriter();
+	YJsonWriter(const YJsonWriter&) = delete;
+	YJsonWriter& operator=(const YJsonWriter&) = delete;
+
+	YJsonWriter& BeginObject();
+	YJsonWriter& EndObject();
+	// single_line keeps the elements on one line in JS_Pretty
+	YJsonWriter& BeginArray(bool single_line = false);
+	YJsonWriter& EndArray();
+	YJsonWriter& Key(const char* key, size_t length);
+	YJsonWriter& Key(const char* key) { return Key(key, strlen(key)); }
+	YJsonWriter& Key(const std::string& key) { return Key(key.data(), key.size()); }
+	YJsonWriter& WriteNull();
+	YJsonWriter& WriteBool(bool value);
+	YJsonWriter& WriteInt(int64_t value);
+	YJsonWriter& WriteUInt(uint64_t value);
+	YJsonWriter& WriteFloat(float value);
+	YJsonWriter& WriteDouble(double value);
+	// utf-8, quotes, backslashes and control characters are escaped
+	YJsonWriter& WriteString(const char* str, size_t length);
+	YJsonWriter& WriteString(const char* str) { return WriteString(str, strlen(str)); }
+	YJsonWriter& WriteString(const std::string& str) { return WriteString(str.data(), str.size()); }
+	// [x, y, z] as read by YJsonHelper::ConvertJsonToVector and friends
+	YJsonWriter& WriteVector(const YVector& v);
+	YJsonWriter& WriteVector4(const YVector4& v);
+	YJsonWriter& WriteRotator(const YRotator& v);
+	// a whole Json::Value, members in the order of the value
+	YJsonWriter& WriteValue(const Json::Value& value);
+
+	// hands the buffered text to the sink, false once a file write has failed
+	bool Flush();
+	bool IsGood() const { return good_; }
+protected:
+	struct Scope
+	{
+		bool is_object = false;
+		bool single_line = false;
+		int count = 0;
+	};
+	void BeginValue();
+	void NewLine(size_t depth);
+	void Put(char c)
+	{
+		if (buffer_pos_ == buffer_.size())
+		{
+			FlushBuffer();
+		}
+		buffer_[buffer_pos_++] = c;
+	}
+	void Put(const char* str, size_t length);
+	void PutString(const char* str, size_t length);
+	void FlushBuffer();
+	MemoryFile* mem_file_ = nullptr;
+	FILE* file_ = nullptr;
+	EStyle style_ = JS_Compact;
+	std::vector<char> buffer_;
+	size_t buffer_pos_ = 0;
+	std::vector<Scope> scopes_;
+	bool after_key_ = false;
+	bool good_ = true;
+	static const size_t buffer_size = 64 * 1024;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <typeinfo>
+
+struct YObjectPoolStats
+{
+	std::string name;
+	size_t block_size = 0;
+	int live_count = 0;
+	int peak_count = 0;
+	int slab_count = 0;
+	uint64_t alloc_count = 0;
+	uint64_t free_count = 0;
+};
+
+// fixed size slab allocator, one pool per object type so objects of a type stay contiguous
+// every block starts with a header pointing back to its pool, FreeObject finds the pool from the pointer
+class YObjectPool
+{
+public:
+	YObjectPool(const std::string& name, size_t object_size);
+	~YObjectPool();
+	YObjectPool(const YObjectPool&) = delete;
+	YObjectPool& operator=(const YObjectPool&) = delete;
+
+	void* Allocate(size_t object_size);
+	// release every slab at once when no object of this pool is alive
+	bool TrimIfEmpty();
+	YObjectPoolStats GetStats() const;
+	size_t GetObjectSize() const { return object_size_; }
+
+	// heap allocation with the same header and no pool, used by plain new
+	static void* AllocateFromHeap(size_t object_size);
+	// works for pointers from any pool and from AllocateFromHeap
+	static void FreeObject(void* object);
+
+	template<typename T>
+	static YObjectPool& Get()
+	{
+		static YObjectPool* pool = new YObjectPool(typeid(T).name(), sizeof(T));
+		return *pool;
+	}
+	static void TrimAll();
+	static std::vector<YObjectPoolStats> GetAllPoolStats();
+protected:
+	struct alignas(16) BlockHeader
+	{
+		YObjectPool* pool;
+		BlockHeader* next_free;
+	};
+	void Free(BlockHeader* header);
+	void AllocSlab();
+	std::string name_;
+	size_t object_size_ = 0;
+	size_t block_size_ = 0;
+	int blocks_per_slab_ = 0;
+	std::vector<unsigned char*> slabs_;
+	// bump pointer inside the last slab
+	int slab_used_blocks_ = 0;
+	BlockHeader* free_list_ = nullptr;
+	int live_count_ = 0;
+	int peak_count_ = 0;
+	uint64_t alloc_count_ = 0;
+	uint64_t free_count_ = 0;
+	mutable std::mutex mutex_;
+};
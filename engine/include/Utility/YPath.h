@@ -1,6 +1,7 @@
 #pragma  once
 #include <string>
 #include <vector>
+#include <cstdint>
 struct YPath
 {
 	// c:\user\admin\desktop\a.txt ==> [c:] [user] [admin] [desktop] [a.txt]
@@ -23,6 +24,12 @@ struct YPath
 	/** @return true if this file was found, false otherwise */
 	static bool FileExists(const std::string& InPath);
 
+	/** @return false if the file was not found, the time is only comparable with the times of other files */
+	static bool GetFileModifyTime(const std::string& InPath, uint64_t& out_time);
+
+	/** Moves from over to, replacing an existing file in one step. @return false if the move failed, to is untouched then */
+	static bool MoveFileReplace(const std::string& from, const std::string& to);
+
 	/** @return true if this directory was found, false otherwise */
 	static bool DirectoryExists(const std::string& InPath);
 
@@ -36,7 +43,7 @@ struct YPath
 	template<class T, class ...Args>
 	static std::string PathCombine(const T& head, Args... rest)
 	{
-		return PathCombine(head, PathCombine(rest));
+		return PathCombine(head, PathCombine(rest...));
 	}
 	static void CreateDirectoryRecursive(const std::string& dir_path);
 	static const char directory_seperater = '/';
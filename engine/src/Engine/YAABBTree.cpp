@@ -0,0 +1,329 @@
+#include "Engine/YAABBTree.h"
+#include <algorithm>
+#include <cassert>
+
+// a fat box this much larger than a fresh one is refit even when the proxy did not leave it
+static constexpr float aabb_tree_shrink_area_ratio = 4.0f;
+
+static YBox UnionBox(const YBox& a, const YBox& b)
+{
+	YBox box = a;
+	box += b;
+	return box;
+}
+
+YAABBTree::YAABBTree(float fat_ratio /*= 0.1f*/, float min_fat_margin /*= 0.0f*/)
+	:fat_ratio_(fat_ratio),
+	min_fat_margin_(min_fat_margin)
+{
+
+}
+
+int YAABBTree::CreateProxy(const YBox& box, void* user_data)
+{
+	const int proxy = AllocateNode();
+	YAABBTreeNode& node = nodes_[proxy];
+	node.box = GetFatBox(box);
+	node.user_data = user_data;
+	node.height = 0;
+	InsertLeaf(proxy);
+	++proxy_count_;
+	return proxy;
+}
+
+void YAABBTree::DestroyProxy(int proxy)
+{
+	assert(proxy >= 0 && proxy < (int)nodes_.size() && nodes_[proxy].IsLeaf() && nodes_[proxy].height == 0);
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	--proxy_count_;
+}
+
+bool YAABBTree::MoveProxy(int proxy, const YBox& box)
+{
+	assert(proxy >= 0 && proxy < (int)nodes_.size() && nodes_[proxy].IsLeaf() && nodes_[proxy].height == 0);
+	const YBox fat_box = GetFatBox(box);
+	const YBox& old_box = nodes_[proxy].box;
+	// a shrunk proxy would keep a large box that overlaps more queries than it should
+	if (old_box.IsInside(box) && old_box.GetSurfaceArea() <= fat_box.GetSurfaceArea() * aabb_tree_shrink_area_ratio)
+	{
+		return false;
+	}
+	RemoveLeaf(proxy);
+	nodes_[proxy].box = fat_box;
+	InsertLeaf(proxy);
+	return true;
+}
+
+void YAABBTree::Clear()
+{
+	nodes_.clear();
+	root_ = -1;
+	free_list_ = -1;
+	proxy_count_ = 0;
+}
+
+float YAABBTree::GetAreaRatio() const
+{
+	if (root_ < 0)
+	{
+		return 0.0f;
+	}
+	const float root_area = nodes_[root_].box.GetSurfaceArea();
+	if (root_area <= 0.0f)
+	{
+		return 0.0f;
+	}
+	float area = 0.0f;
+	for (const YAABBTreeNode& node : nodes_)
+	{
+		if (node.height > 0)
+		{
+			area += node.box.GetSurfaceArea();
+		}
+	}
+	return area / root_area;
+}
+
+bool YAABBTree::Validate() const
+{
+	if (root_ < 0)
+	{
+		return proxy_count_ == 0;
+	}
+	if (nodes_[root_].parent != -1)
+	{
+		return false;
+	}
+	int leaf_count = 0;
+	std::vector<int> stack;
+	stack.push_back(root_);
+	while (!stack.empty())
+	{
+		const int node_index = stack.back();
+		stack.pop_back();
+		const YAABBTreeNode& node = nodes_[node_index];
+		if (node.IsLeaf())
+		{
+			if (node.height != 0 || node.child2 != -1)
+			{
+				return false;
+			}
+			++leaf_count;
+			continue;
+		}
+		const YAABBTreeNode& child1 = nodes_[node.child1];
+		const YAABBTreeNode& child2 = nodes_[node.child2];
+		if (child1.parent != node_index || child2.parent != node_index)
+		{
+			return false;
+		}
+		if (node.height != 1 + std::max(child1.height, child2.height))
+		{
+			return false;
+		}
+		if (!node.box.IsInside(child1.box) || !node.box.IsInside(child2.box))
+		{
+			return false;
+		}
+		stack.push_back(node.child1);
+		stack.push_back(node.child2);
+	}
+	return leaf_count == proxy_count_;
+}
+
+int YAABBTree::AllocateNode()
+{
+	int node_index = free_list_;
+	if (node_index >= 0)
+	{
+		free_list_ = nodes_[node_index].parent;
+	}
+	else
+	{
+		node_index = (int)nodes_.size();
+		nodes_.emplace_back();
+	}
+	YAABBTreeNode& node = nodes_[node_index];
+	node = YAABBTreeNode();
+	node.height = 0;
+	return node_index;
+}
+
+void YAABBTree::FreeNode(int node_index)
+{
+	YAABBTreeNode& node = nodes_[node_index];
+	node = YAABBTreeNode();
+	node.parent = free_list_;
+	free_list_ = node_index;
+}
+
+void YAABBTree::InsertLeaf(int leaf)
+{
+	if (root_ < 0)
+	{
+		root_ = leaf;
+		nodes_[leaf].parent = -1;
+		return;
+	}
+	// walk down to the sibling that adds the least surface area, stopping when a new parent here is cheaper
+	const YBox leaf_box = nodes_[leaf].box;
+	int node_index = root_;
+	while (!nodes_[node_index].IsLeaf())
+	{
+		const YAABBTreeNode& node = nodes_[node_index];
+		const float area = node.box.GetSurfaceArea();
+		const float combined_area = UnionBox(node.box, leaf_box).GetSurfaceArea();
+		// a new parent of node and leaf
+		const float cost = 2.0f * combined_area;
+		// every ancestor of a descent grows by as much as node does
+		const float inheritance_cost = 2.0f * (combined_area - area);
+		auto descent_cost = [&](int child_index)
+		{
+			const YAABBTreeNode& child = nodes_[child_index];
+			const float child_combined_area = UnionBox(child.box, leaf_box).GetSurfaceArea();
+			return (child.IsLeaf() ? child_combined_area : child_combined_area - child.box.GetSurfaceArea()) + inheritance_cost;
+		};
+		const float cost1 = descent_cost(node.child1);
+		const float cost2 = descent_cost(node.child2);
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+		node_index = cost1 < cost2 ? node.child1 : node.child2;
+	}
+
+	const int sibling = node_index;
+	const int old_parent = nodes_[sibling].parent;
+	const int new_parent = AllocateNode();
+	{
+		YAABBTreeNode& parent = nodes_[new_parent];
+		parent.parent = old_parent;
+		parent.box = UnionBox(leaf_box, nodes_[sibling].box);
+		parent.height = nodes_[sibling].height + 1;
+		parent.child1 = sibling;
+		parent.child2 = leaf;
+	}
+	if (old_parent >= 0)
+	{
+		YAABBTreeNode& grand_parent = nodes_[old_parent];
+		(grand_parent.child1 == sibling ? grand_parent.child1 : grand_parent.child2) = new_parent;
+	}
+	else
+	{
+		root_ = new_parent;
+	}
+	nodes_[sibling].parent = new_parent;
+	nodes_[leaf].parent = new_parent;
+	RefitAncestors(nodes_[leaf].parent);
+}
+
+void YAABBTree::RemoveLeaf(int leaf)
+{
+	if (leaf == root_)
+	{
+		root_ = -1;
+		return;
+	}
+	const int parent = nodes_[leaf].parent;
+	const int grand_parent = nodes_[parent].parent;
+	const int sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+	// the sibling takes the place of the parent
+	if (grand_parent >= 0)
+	{
+		YAABBTreeNode& grand_parent_node = nodes_[grand_parent];
+		(grand_parent_node.child1 == parent ? grand_parent_node.child1 : grand_parent_node.child2) = sibling;
+		nodes_[sibling].parent = grand_parent;
+		FreeNode(parent);
+		RefitAncestors(grand_parent);
+	}
+	else
+	{
+		root_ = sibling;
+		nodes_[sibling].parent = -1;
+		FreeNode(parent);
+	}
+	nodes_[leaf].parent = -1;
+}
+
+void YAABBTree::RefitAncestors(int node_index)
+{
+	while (node_index >= 0)
+	{
+		node_index = Balance(node_index);
+		YAABBTreeNode& node = nodes_[node_index];
+		const YAABBTreeNode& child1 = nodes_[node.child1];
+		const YAABBTreeNode& child2 = nodes_[node.child2];
+		node.height = 1 + std::max(child1.height, child2.height);
+		node.box = UnionBox(child1.box, child2.box);
+		node_index = node.parent;
+	}
+}
+
+int YAABBTree::Balance(int node_index)
+{
+	YAABBTreeNode& a = nodes_[node_index];
+	if (a.IsLeaf() || a.height < 2)
+	{
+		return node_index;
+	}
+	const int b_index = a.child1;
+	const int c_index = a.child2;
+	YAABBTreeNode& b = nodes_[b_index];
+	YAABBTreeNode& c = nodes_[c_index];
+	const int balance = c.height - b.height;
+	if (balance > 1 || balance < -1)
+	{
+		// the higher child goes up to the place of a, a keeps the other child and the lower grandchild
+		const bool rotate_c = balance > 1;
+		const int up_index = rotate_c ? c_index : b_index;
+		YAABBTreeNode& up = rotate_c ? c : b;
+		YAABBTreeNode& stay = rotate_c ? b : c;
+		const int f_index = up.child1;
+		const int g_index = up.child2;
+		YAABBTreeNode& f = nodes_[f_index];
+		YAABBTreeNode& g = nodes_[g_index];
+
+		up.child1 = node_index;
+		up.parent = a.parent;
+		a.parent = up_index;
+		if (up.parent >= 0)
+		{
+			YAABBTreeNode& parent = nodes_[up.parent];
+			(parent.child1 == node_index ? parent.child1 : parent.child2) = up_index;
+		}
+		else
+		{
+			root_ = up_index;
+		}
+
+		const bool keep_f = f.height > g.height;
+		const int high_index = keep_f ? f_index : g_index;
+		const int low_index = keep_f ? g_index : f_index;
+		YAABBTreeNode& high = keep_f ? f : g;
+		YAABBTreeNode& low = keep_f ? g : f;
+		up.child2 = high_index;
+		if (rotate_c)
+		{
+			a.child2 = low_index;
+		}
+		else
+		{
+			a.child1 = low_index;
+		}
+		low.parent = node_index;
+		a.box = UnionBox(stay.box, low.box);
+		up.box = UnionBox(a.box, high.box);
+		a.height = 1 + std::max(stay.height, low.height);
+		up.height = 1 + std::max(a.height, high.height);
+		return up_index;
+	}
+	return node_index;
+}
+
+YBox YAABBTree::GetFatBox(const YBox& box) const
+{
+	const YVector size = box.GetSize();
+	const float largest_side = std::max(size.x, std::max(size.y, size.z));
+	return box.ExpandBy(std::max(largest_side * fat_ratio_, min_fat_margin_));
+}
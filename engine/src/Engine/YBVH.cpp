@@ -0,0 +1,270 @@
+#include "Engine/YBVH.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// split planes tried per node, between bins of equal width over the primitive centers
+static constexpr int bvh_bin_count = 16;
+// cost of visiting a node against testing one primitive
+static constexpr float bvh_traversal_cost = 1.0f;
+
+void YRayPacket::Set(const YRay* rays, const float* max_distances, int ray_count)
+{
+	ray_count = std::min(std::max(ray_count, 0), max_ray_count);
+	active_mask = (1 << ray_count) - 1;
+	for (int lane = 0; lane < max_ray_count; ++lane)
+	{
+		const int ray_index = std::min(lane, std::max(ray_count - 1, 0));
+		const YRay& ray = ray_count > 0 ? rays[ray_index] : YRay(YVector::zero_vector, YVector::forward_vector);
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float d = ray.direction[axis];
+			origin[axis][lane] = ray.origin[axis];
+			direction[axis][lane] = d;
+			inv_direction[axis][lane] = std::fabs(d) > 1e-20f ? 1.0f / d : std::copysign(1e30f, d);
+		}
+		max_distance[lane] = (max_distances && ray_count > 0) ? max_distances[ray_index] : FLT_MAX;
+	}
+}
+
+int YRayPacket::IntersectBox(const YVector& min_corner, const YVector& max_corner, float& out_near) const
+{
+	alignas(16) float near_lanes[max_ray_count];
+	int mask = 0;
+#if YMATH_SSE
+	__m128 t_near = _mm_setzero_ps();
+	__m128 t_far = _mm_load_ps(max_distance);
+	for (int axis = 0; axis < 3; ++axis)
+	{
+		const __m128 o = _mm_load_ps(origin[axis]);
+		const __m128 inv = _mm_load_ps(inv_direction[axis]);
+		const __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(min_corner[axis]), o), inv);
+		const __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(max_corner[axis]), o), inv);
+		t_near = _mm_max_ps(t_near, _mm_min_ps(t0, t1));
+		t_far = _mm_min_ps(t_far, _mm_max_ps(t0, t1));
+	}
+	mask = _mm_movemask_ps(_mm_cmple_ps(t_near, t_far)) & active_mask;
+	_mm_store_ps(near_lanes, t_near);
+#else
+	for (int lane = 0; lane < max_ray_count; ++lane)
+	{
+		float t_near = 0.0f;
+		float t_far = max_distance[lane];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			const float t0 = (min_corner[axis] - origin[axis][lane]) * inv_direction[axis][lane];
+			const float t1 = (max_corner[axis] - origin[axis][lane]) * inv_direction[axis][lane];
+			t_near = std::max(t_near, std::min(t0, t1));
+			t_far = std::min(t_far, std::max(t0, t1));
+		}
+		near_lanes[lane] = t_near;
+		mask |= t_near <= t_far ? (1 << lane) : 0;
+	}
+	mask &= active_mask;
+#endif
+	out_near = FLT_MAX;
+	for (int lane = 0; lane < max_ray_count; ++lane)
+	{
+		if (mask & (1 << lane))
+		{
+			out_near = std::min(out_near, near_lanes[lane]);
+		}
+	}
+	return mask;
+}
+
+struct YBVHBin
+{
+	YBox box;
+	int count = 0;
+};
+
+struct YBVHBuildContext
+{
+	const std::vector<YBox>* boxes = nullptr;
+	std::vector<YVector> centers;
+	std::vector<int>* order = nullptr;
+	std::vector<YBVHNode>* nodes = nullptr;
+	int max_leaf_size = 1;
+	// every node of at most max_leaf_size primitives is a leaf, whatever the surface area heuristic says
+	bool is_leaf_at_max_size = false;
+};
+
+static void BuildBVHNode(YBVHBuildContext& context, int node_index, int begin, int end, int depth)
+{
+	std::vector<int>& order = *context.order;
+	YBox bounds;
+	YBox center_bounds;
+	for (int i = begin; i < end; ++i)
+	{
+		bounds += (*context.boxes)[order[i]];
+		center_bounds += context.centers[order[i]];
+	}
+	{
+		YBVHNode& node = (*context.nodes)[node_index];
+		node.min_corner = bounds.min_corner;
+		node.max_corner = bounds.max_corner;
+		node.first = begin;
+		node.count = end - begin;
+	}
+	const int count = end - begin;
+	if (count <= 1 || depth >= YBVH::max_depth - 1 || (context.is_leaf_at_max_size && count <= context.max_leaf_size))
+	{
+		return;
+	}
+	const YVector center_size = center_bounds.GetSize();
+	int axis = 0;
+	if (center_size.y > center_size[axis])
+	{
+		axis = 1;
+	}
+	if (center_size.z > center_size[axis])
+	{
+		axis = 2;
+	}
+	int split = begin;
+	if (center_size[axis] > 0.0f)
+	{
+		const float axis_min = center_bounds.min_corner[axis];
+		const float scale = bvh_bin_count / center_size[axis];
+		auto bin_of = [&](int primitive)
+		{
+			return std::min((int)((context.centers[primitive][axis] - axis_min) * scale), bvh_bin_count - 1);
+		};
+		YBVHBin bins[bvh_bin_count];
+		for (int i = begin; i < end; ++i)
+		{
+			YBVHBin& bin = bins[bin_of(order[i])];
+			bin.box += (*context.boxes)[order[i]];
+			bin.count += 1;
+		}
+		// the cost of the plane before bin i is left area * left count + right area * right count
+		float left_area[bvh_bin_count];
+		int left_count[bvh_bin_count];
+		YBox left_box;
+		int left_sum = 0;
+		for (int i = 0; i < bvh_bin_count; ++i)
+		{
+			left_area[i] = left_box.GetSurfaceArea();
+			left_count[i] = left_sum;
+			left_box += bins[i].box;
+			left_sum += bins[i].count;
+		}
+		YBox right_box;
+		int right_sum = 0;
+		int best_plane = -1;
+		float best_cost = FLT_MAX;
+		for (int i = bvh_bin_count - 1; i > 0; --i)
+		{
+			right_box += bins[i].box;
+			right_sum += bins[i].count;
+			if (left_count[i] == 0 || right_sum == 0)
+			{
+				continue;
+			}
+			const float cost = left_area[i] * left_count[i] + right_box.GetSurfaceArea() * right_sum;
+			if (cost < best_cost)
+			{
+				best_cost = cost;
+				best_plane = i;
+			}
+		}
+		const float bounds_area = bounds.GetSurfaceArea();
+		if (count <= context.max_leaf_size && (best_plane < 0 || bvh_traversal_cost * bounds_area + best_cost >= bounds_area * count))
+		{
+			return;
+		}
+		if (best_plane >= 0)
+		{
+			split = (int)(std::partition(order.begin() + begin, order.begin() + end, [&](int primitive) { return bin_of(primitive) < best_plane; }) - order.begin());
+		}
+		if (split == begin || split == end)
+		{
+			split = begin + count / 2;
+			std::nth_element(order.begin() + begin, order.begin() + split, order.begin() + end,
+				[&](int a, int b) { return context.centers[a][axis] < context.centers[b][axis]; });
+		}
+	}
+	else
+	{
+		// the centers are all the same, only the count can be split
+		if (count <= context.max_leaf_size)
+		{
+			return;
+		}
+		split = begin + count / 2;
+	}
+	const int left_index = (int)context.nodes->size();
+	context.nodes->emplace_back();
+	context.nodes->emplace_back();
+	{
+		YBVHNode& node = (*context.nodes)[node_index];
+		node.first = left_index;
+		node.count = 0;
+	}
+	BuildBVHNode(context, left_index, begin, split, depth + 1);
+	BuildBVHNode(context, left_index + 1, split, end, depth + 1);
+}
+
+void YBVH::Build(const std::vector<YBox>& boxes, int max_leaf_size, std::vector<YBVHNode>& out_nodes, std::vector<int>& out_order)
+{
+	BuildNodes(boxes, max_leaf_size, false, out_nodes, out_order);
+}
+
+void YBVH::BuildClusters(const std::vector<YBox>& boxes, int cluster_size, std::vector<YBVHNode>& out_nodes, std::vector<int>& out_order)
+{
+	BuildNodes(boxes, cluster_size, true, out_nodes, out_order);
+}
+
+void YBVH::BuildNodes(const std::vector<YBox>& boxes, int max_leaf_size, bool is_leaf_at_max_size, std::vector<YBVHNode>& out_nodes, std::vector<int>& out_order)
+{
+	out_nodes.clear();
+	out_order.resize(boxes.size());
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		out_order[i] = (int)i;
+	}
+	if (boxes.empty())
+	{
+		return;
+	}
+	YBVHBuildContext context;
+	context.boxes = &boxes;
+	context.order = &out_order;
+	context.nodes = &out_nodes;
+	context.max_leaf_size = std::max(max_leaf_size, 1);
+	context.is_leaf_at_max_size = is_leaf_at_max_size;
+	context.centers.resize(boxes.size());
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		context.centers[i] = boxes[i].GetCenter();
+	}
+	out_nodes.reserve(boxes.size() * 2 / context.max_leaf_size + 1);
+	out_nodes.emplace_back();
+	BuildBVHNode(context, 0, 0, (int)boxes.size(), 0);
+	out_nodes.shrink_to_fit();
+}
+
+int YBVH::GetDepth(const std::vector<YBVHNode>& nodes)
+{
+	if (nodes.empty())
+	{
+		return 0;
+	}
+	int depth = 0;
+	std::vector<std::pair<int, int>> stack;
+	stack.emplace_back(0, 1);
+	while (!stack.empty())
+	{
+		const std::pair<int, int> entry = stack.back();
+		stack.pop_back();
+		depth = std::max(depth, entry.second);
+		const YBVHNode& node = nodes[entry.first];
+		if (node.count == 0)
+		{
+			stack.emplace_back(node.first, entry.second + 1);
+			stack.emplace_back(node.first + 1, entry.second + 1);
+		}
+	}
+	return depth;
+}
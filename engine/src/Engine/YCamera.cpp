@@ -122,6 +122,16 @@ YRotator CameraBase::GetRotator() const
 	return rotaion_;
 }
 
+YRay CameraBase::GetScreenRay(float x, float y, float viewport_width, float viewport_height) const
+{
+	// pixel center to ndc, y goes down on screen and up in ndc
+	const float ndc_x = (x + 0.5f) / viewport_width * 2.0f - 1.0f;
+	const float ndc_y = 1.0f - (y + 0.5f) / viewport_height * 2.0f;
+	const YVector near_point = inv_view_proj_matrix_.TransformPosition(YVector(ndc_x, ndc_y, 0.0f));
+	const YVector far_point = inv_view_proj_matrix_.TransformPosition(YVector(ndc_x, ndc_y, 1.0f));
+	return YRay(near_point, (far_point - near_point).GetSafeNormal());
+}
+
 void CameraBase::SetNearPlane(float near_plane)
 {
 	near_plane_ = near_plane;
@@ -163,7 +173,7 @@ void CameraBase::Update()
 std::unique_ptr<CameraElementProxy> CameraBase::GetProxy()
 {
 	std::unique_ptr<CameraElementProxy> proxy = std::make_unique<CameraElementProxy>();
-	proxy->position_ = position_;
+	proxy->position_ = YVectorRegister(position_, 1.0f);
 	proxy->rotation_ = rotaion_;
 	proxy->inv_view_matrix_ = inv_view_matrix_;
 	proxy->view_matrix_ = view_matrix_;
@@ -82,18 +82,9 @@ bool YFile::WriteFile( const MemoryFile* memory_file, bool create_directory_recu
 		return false;
 	}
 
-	if (create_directory_recurvie)
-	{
-		YPath::CreateDirectoryRecursive(YPath::GetPath(path_));
-	}
-	bool write_file_flag = (int)type_ && (int)FileType::FT_Write;
-	bool binary_content = (int)type_ && (int)FileType::FT_BINARY;
-	assert(write_file_flag);
-	FILE* write_file = nullptr;
-	write_file = fopen(path_.c_str(), binary_content ? "wb" : "w");
+	FILE* write_file = OpenForWrite(create_directory_recurvie);
 	if (!write_file)
 	{
-		LOG_INFO("write file failed: ", path_);
 		return false;
 	}
 	const std::vector<unsigned char>& content_to_write = memory_file->GetReadOnlyFileContent();
@@ -112,6 +103,24 @@ bool YFile::WriteFile( const MemoryFile* memory_file, bool create_directory_recu
 	return true;
 }
 
+FILE* YFile::OpenForWrite(bool create_directory_recurvie)
+{
+	if (create_directory_recurvie)
+	{
+		YPath::CreateDirectoryRecursive(YPath::GetPath(path_));
+	}
+	assert(((int)type_ & (int)FileType::FT_Write) != 0);
+	const bool binary_content = ((int)type_ & (int)FileType::FT_BINARY) != 0;
+	FILE* write_file = nullptr;
+	write_file = fopen(path_.c_str(), binary_content ? "wb" : "w");
+	if (!write_file)
+	{
+		LOG_INFO("write file failed: ", path_);
+		return nullptr;
+	}
+	return write_file;
+}
+
 YFile::~YFile()
 {
 
@@ -7,6 +7,22 @@ InputManger::InputManger()
 
 }
 
+void InputManger::OnEventLButtonDown(int x, int y)
+{
+	for (auto& func : mouse_LButton_down_funcs_)
+	{
+		func(x, y);
+	}
+}
+
+void InputManger::OnEventLButtonUp(int x, int y)
+{
+	for (auto& func : mouse_LButton_up_funcs_)
+	{
+		func(x, y);
+	}
+}
+
 void InputManger::OnEventRButtonDown(int x, int y)
 {
 	for (auto& func : mouse_RButton_down_funcs_)
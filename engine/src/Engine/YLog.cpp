@@ -2,3 +2,9 @@
 std::string g_verbo_log;
 std::string g_warning_log;
 std::string g_error_log;
+
+std::mutex& GetLogMutex()
+{
+	static std::mutex log_mutex;
+	return log_mutex;
+}
@@ -0,0 +1,227 @@
+#include "Engine/YMeshBVH.h"
+
+// moller trumbore for the four rays of packet against one triangle, both faces count
+// bit per active lane that hits before its max_distance, with the distance and barycentrics of each lane
+static int IntersectTriangleLanes(const YRayPacket& packet, const YVector& v0, const YVector& edge1, const YVector& edge2, float* out_t, float* out_u, float* out_v)
+{
+#if YMATH_SSE
+	const __m128 dx = _mm_load_ps(packet.direction[0]);
+	const __m128 dy = _mm_load_ps(packet.direction[1]);
+	const __m128 dz = _mm_load_ps(packet.direction[2]);
+	const __m128 e1x = _mm_set1_ps(edge1.x), e1y = _mm_set1_ps(edge1.y), e1z = _mm_set1_ps(edge1.z);
+	const __m128 e2x = _mm_set1_ps(edge2.x), e2y = _mm_set1_ps(edge2.y), e2z = _mm_set1_ps(edge2.z);
+	// p = d x edge2
+	const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+	const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+	const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+	const __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+	const __m128 inv_det = _mm_div_ps(_mm_set1_ps(1.0f), det);
+	// s = origin - v0
+	const __m128 sx = _mm_sub_ps(_mm_load_ps(packet.origin[0]), _mm_set1_ps(v0.x));
+	const __m128 sy = _mm_sub_ps(_mm_load_ps(packet.origin[1]), _mm_set1_ps(v0.y));
+	const __m128 sz = _mm_sub_ps(_mm_load_ps(packet.origin[2]), _mm_set1_ps(v0.z));
+	const __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), inv_det);
+	// q = s x edge1
+	const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+	const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+	const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+	const __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inv_det);
+	const __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inv_det);
+	const __m128 zero = _mm_setzero_ps();
+	// a nan from a 0 determinant fails every compare but the first
+	__m128 hit = _mm_cmpneq_ps(det, zero);
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+	hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), _mm_set1_ps(1.0f)));
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(t, zero));
+	hit = _mm_and_ps(hit, _mm_cmplt_ps(t, _mm_load_ps(packet.max_distance)));
+	const int mask = _mm_movemask_ps(hit) & packet.active_mask;
+	if (mask)
+	{
+		_mm_storeu_ps(out_t, t);
+		_mm_storeu_ps(out_u, u);
+		_mm_storeu_ps(out_v, v);
+	}
+	return mask;
+#else
+	int mask = 0;
+	for (int lane = 0; lane < YRayPacket::max_ray_count; ++lane)
+	{
+		if (!(packet.active_mask & (1 << lane)))
+		{
+			continue;
+		}
+		const YVector d(packet.direction[0][lane], packet.direction[1][lane], packet.direction[2][lane]);
+		const YVector p = d ^ edge2;
+		const float det = edge1 | p;
+		if (det == 0.0f)
+		{
+			continue;
+		}
+		const float inv_det = 1.0f / det;
+		const YVector s = YVector(packet.origin[0][lane], packet.origin[1][lane], packet.origin[2][lane]) - v0;
+		const float u = (s | p) * inv_det;
+		const YVector q = s ^ edge1;
+		const float v = (d | q) * inv_det;
+		const float t = (edge2 | q) * inv_det;
+		if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < packet.max_distance[lane])
+		{
+			out_t[lane] = t;
+			out_u[lane] = u;
+			out_v[lane] = v;
+			mask |= 1 << lane;
+		}
+	}
+	return mask;
+#endif
+}
+
+bool YMeshBVH::Build(const YLODMesh& lod_mesh)
+{
+	nodes_.clear();
+	triangles_.clear();
+	sources_.clear();
+	bounds_ = YBox();
+
+	std::vector<YBox> boxes;
+	std::vector<Triangle> triangles;
+	std::vector<TriangleSource> sources;
+	const int vertex_instance_count = (int)lod_mesh.vertex_instances.size();
+	const int vertex_count = (int)lod_mesh.vertex_position.size();
+	for (int group_index = 0; group_index < (int)lod_mesh.polygon_groups.size(); ++group_index)
+	{
+		for (int polygon_index : lod_mesh.polygon_groups[group_index].polygons)
+		{
+			if (polygon_index < 0 || polygon_index >= (int)lod_mesh.polygons.size())
+			{
+				continue;
+			}
+			// the first three vertex instances, as the renderer draws them
+			const YMeshPolygon& polygon = lod_mesh.polygons[polygon_index];
+			if (polygon.vertex_instance_ids.size() < 3)
+			{
+				continue;
+			}
+			TriangleSource source;
+			source.polygon = polygon_index;
+			source.polygon_group = group_index;
+			YVector positions[3];
+			bool valid = true;
+			for (int i = 0; i < 3; ++i)
+			{
+				const int vertex_instance_id = polygon.vertex_instance_ids[i];
+				const int vertex_id = (vertex_instance_id >= 0 && vertex_instance_id < vertex_instance_count) ? lod_mesh.vertex_instances[vertex_instance_id].vertex_id : INVALID_ID;
+				if (vertex_id < 0 || vertex_id >= vertex_count)
+				{
+					valid = false;
+					break;
+				}
+				source.vertex_instances[i] = vertex_instance_id;
+				positions[i] = lod_mesh.vertex_position[vertex_id].position;
+			}
+			if (!valid)
+			{
+				continue;
+			}
+			YBox box;
+			box += positions[0];
+			box += positions[1];
+			box += positions[2];
+			boxes.push_back(box);
+			triangles.push_back({ positions[0], positions[1] - positions[0], positions[2] - positions[0] });
+			sources.push_back(source);
+		}
+	}
+	if (boxes.empty())
+	{
+		return false;
+	}
+
+	std::vector<int> order;
+	YBVH::Build(boxes, max_leaf_size, nodes_, order);
+	triangles_.reserve(order.size());
+	sources_.reserve(order.size());
+	for (int triangle_index : order)
+	{
+		triangles_.push_back(triangles[triangle_index]);
+		sources_.push_back(sources[triangle_index]);
+	}
+	bounds_ = YBox(nodes_[0].min_corner, nodes_[0].max_corner);
+	return true;
+}
+
+void YMeshBVH::IntersectPacket(const YRay* rays, int ray_count, YMeshHit* hits) const
+{
+	if (nodes_.empty() || ray_count <= 0)
+	{
+		return;
+	}
+	ray_count = ray_count < YRayPacket::max_ray_count ? ray_count : YRayPacket::max_ray_count;
+	float max_distances[YRayPacket::max_ray_count];
+	for (int lane = 0; lane < ray_count; ++lane)
+	{
+		max_distances[lane] = hits[lane].distance;
+	}
+	YRayPacket packet;
+	packet.Set(rays, max_distances, ray_count);
+
+	int hit_slots[YRayPacket::max_ray_count] = { -1, -1, -1, -1 };
+	float hit_u[YRayPacket::max_ray_count];
+	float hit_v[YRayPacket::max_ray_count];
+	YBVH::TracePacket(nodes_, packet, [&](int first, int count)
+		{
+			for (int slot = first; slot < first + count; ++slot)
+			{
+				const Triangle& triangle = triangles_[slot];
+				float t[YRayPacket::max_ray_count];
+				float u[YRayPacket::max_ray_count];
+				float v[YRayPacket::max_ray_count];
+				const int mask = IntersectTriangleLanes(packet, triangle.v0, triangle.edge1, triangle.edge2, t, u, v);
+				if (!mask)
+				{
+					continue;
+				}
+				for (int lane = 0; lane < YRayPacket::max_ray_count; ++lane)
+				{
+					if (mask & (1 << lane))
+					{
+						packet.max_distance[lane] = t[lane];
+						hit_slots[lane] = slot;
+						hit_u[lane] = u[lane];
+						hit_v[lane] = v[lane];
+					}
+				}
+			}
+		});
+
+	for (int lane = 0; lane < ray_count; ++lane)
+	{
+		if (hit_slots[lane] < 0)
+		{
+			continue;
+		}
+		const TriangleSource& source = sources_[hit_slots[lane]];
+		YMeshHit& hit = hits[lane];
+		hit.distance = packet.max_distance[lane];
+		hit.u = hit_u[lane];
+		hit.v = hit_v[lane];
+		hit.polygon = source.polygon;
+		hit.polygon_group = source.polygon_group;
+		for (int i = 0; i < 3; ++i)
+		{
+			hit.vertex_instances[i] = source.vertex_instances[i];
+		}
+	}
+}
+
+bool YMeshBVH::Intersect(const YRay& ray, YMeshHit& hit) const
+{
+	const float distance = hit.distance;
+	IntersectPacket(&ray, 1, &hit);
+	return hit.distance < distance;
+}
+
+size_t YMeshBVH::GetResourceSize() const
+{
+	return sizeof(YMeshBVH) + nodes_.capacity() * sizeof(YBVHNode) + triangles_.capacity() * sizeof(Triangle) + sources_.capacity() * sizeof(TriangleSource);
+}
@@ -1,9 +1,73 @@
 #include "Engine/YRenderScene.h"
+#include <algorithm>
 YRenderScene::YRenderScene()
 {
 
 }
 
+void YRenderScene::MergeInstancedDraws(int min_batch_size /*= default_min_merge_batch_size*/)
+{
+	const int primitive_count = (int)primitive_elements_.size();
+	draw_merge_stats_ = YDrawMergeStats();
+	draw_merge_stats_.primitive_count = primitive_count;
+	draw_merge_stats_.draw_count_before = primitive_count + (int)instanced_elements_.size();
+	draw_merge_stats_.draw_count_after = draw_merge_stats_.draw_count_before;
+	if (primitive_count < std::max(min_batch_size, 2))
+	{
+		return;
+	}
+	// the primitives of a mesh end up next to each other in the order they were collected
+	std::vector<std::pair<YStaticMesh*, int>> sorted;
+	sorted.reserve(primitive_count);
+	for (int i = 0; i < primitive_count; ++i)
+	{
+		sorted.emplace_back(primitive_elements_[i].mesh_, i);
+	}
+	std::sort(sorted.begin(), sorted.end());
+
+	std::vector<bool> is_merged(primitive_count, false);
+	int first = 0;
+	while (first < primitive_count)
+	{
+		int last = first + 1;
+		while (last < primitive_count && sorted[last].first == sorted[first].first)
+		{
+			++last;
+		}
+		const int count = last - first;
+		if (count >= min_batch_size && sorted[first].first)
+		{
+			InstancedElementProxy instanced_elem;
+			instanced_elem.mesh_ = sorted[first].first;
+			instanced_elem.first_instance_ = (int)instance_matrices_.size();
+			instanced_elem.instance_count_ = count;
+			instanced_elements_.push_back(instanced_elem);
+			for (int i = first; i < last; ++i)
+			{
+				instance_matrices_.push_back(primitive_elements_[sorted[i].second].local_to_world_);
+				is_merged[sorted[i].second] = true;
+			}
+			++draw_merge_stats_.batch_count;
+			draw_merge_stats_.merged_primitive_count += count;
+		}
+		first = last;
+	}
+	if (draw_merge_stats_.batch_count == 0)
+	{
+		return;
+	}
+	int kept_count = 0;
+	for (int i = 0; i < primitive_count; ++i)
+	{
+		if (!is_merged[i])
+		{
+			primitive_elements_[kept_count++] = primitive_elements_[i];
+		}
+	}
+	primitive_elements_.resize(kept_count);
+	draw_merge_stats_.draw_count_after = draw_merge_stats_.draw_count_before - draw_merge_stats_.merged_primitive_count + draw_merge_stats_.batch_count;
+}
+
 YScene::YScene()
 {
 
@@ -12,26 +76,89 @@ YScene::YScene()
 std::unique_ptr<YRenderScene> YScene::GenerateOneFrame() const
 {
 	std::unique_ptr<YRenderScene> one_frame = std::make_unique<YRenderScene>();
+	assert(component_storage_);
 	//collect static mesh
-	one_frame->primitive_elements_.reserve(static_meshes_components_.size());
-	for (SStaticMeshComponent* mesh_component : static_meshes_components_)
+	const int mesh_count = component_storage_->GetComponentCount(SComponent::StaticMeshComponent);
+	one_frame->primitive_elements_.reserve(mesh_count);
+	std::vector<YTransform> transforms;
+	transforms.reserve(mesh_count);
+	auto add_mesh = [&one_frame, &transforms](SStaticMeshComponent* mesh_component)
 	{
 		PrimitiveElementProxy primitive_elem;
-		primitive_elem.local_to_world_ = mesh_component->GetComponentTransform().ToMatrix();
 		primitive_elem.mesh_ = mesh_component->GetMesh();
 		one_frame->primitive_elements_.push_back(primitive_elem);
+		transforms.push_back(mesh_component->GetComponentTransform());
+	};
+	// an instanced mesh adds one element per run of visible clusters
+	const YFrustum frustum = camera_ ? YFrustum::FromViewProjection(camera_->GetViewProjectionMatrix()) : YFrustum();
+	auto add_instanced_mesh = [this, &one_frame, &frustum](SInstancedStaticMeshComponent* instanced_component)
+	{
+		YStaticMesh* mesh = instanced_component->GetMesh();
+		if (!mesh)
+		{
+			return;
+		}
+		const std::vector<YMatrix>& instance_matrices = instanced_component->GetInstanceMatrices();
+		auto add_range = [&one_frame, mesh, &instance_matrices](int first_slot, int slot_count)
+		{
+			InstancedElementProxy instanced_elem;
+			instanced_elem.mesh_ = mesh;
+			instanced_elem.first_instance_ = (int)one_frame->instance_matrices_.size();
+			instanced_elem.instance_count_ = slot_count;
+			one_frame->instanced_elements_.push_back(instanced_elem);
+			one_frame->instance_matrices_.insert(one_frame->instance_matrices_.end(), instance_matrices.begin() + first_slot, instance_matrices.begin() + first_slot + slot_count);
+		};
+		if (camera_)
+		{
+			instanced_component->QueryVisibleRanges(frustum, add_range);
+		}
+		else
+		{
+			instanced_component->ForEachRange(add_range);
+		}
+	};
+	if (spatial_tree_ && camera_)
+	{
+		// meshes without bounds have nothing to draw and are not in the tree
+		spatial_tree_->QueryFrustum(frustum, [&add_mesh, &add_instanced_mesh](SSceneComponent* component)
+			{
+				if (component->GetComponentType() == SComponent::StaticMeshComponent)
+				{
+					add_mesh(static_cast<SStaticMeshComponent*>(component));
+				}
+				else if (component->GetComponentType() == SComponent::InstancedStaticMeshComponent)
+				{
+					add_instanced_mesh(static_cast<SInstancedStaticMeshComponent*>(component));
+				}
+			});
 	}
-
-	one_frame->dir_light_elements_.reserve(direct_light_components_.size());
-	for (SDirectionLightComponent* dir_light_componet : direct_light_components_)
+	else
 	{
-		DirectLightElementProxy dir_light_elem;
-		DirectLight* light =  dir_light_componet->dir_light_.get();
-		dir_light_elem.light_color = light->GetLightColor();
-		dir_light_elem.light_dir = light->GetLightdir();
-		dir_light_elem.light_strength = light->GetLightStrength();
-		one_frame->dir_light_elements_.push_back(dir_light_elem);
+		component_storage_->ForEachComponent<SStaticMeshComponent>(add_mesh);
+		component_storage_->ForEachComponent<SInstancedStaticMeshComponent>(add_instanced_mesh);
 	}
+	// the matrices are built in one batch instead of per component
+	std::vector<YMatrix> local_to_worlds(transforms.size());
+	YTransform::ToMatrices(local_to_worlds.data(), transforms.data(), transforms.size());
+	for (size_t i = 0; i < local_to_worlds.size(); ++i)
+	{
+		one_frame->primitive_elements_[i].local_to_world_ = local_to_worlds[i];
+	}
+	if (merge_instanced_draws_)
+	{
+		one_frame->MergeInstancedDraws();
+	}
+
+	one_frame->dir_light_elements_.reserve(component_storage_->GetComponentCount(SComponent::DirectLightComponent));
+	component_storage_->ForEachComponent<SDirectionLightComponent>([&one_frame](SDirectionLightComponent* dir_light_componet)
+		{
+			DirectLightElementProxy dir_light_elem;
+			DirectLight* light = dir_light_componet->dir_light_.get();
+			dir_light_elem.light_color = light->GetLightColor();
+			dir_light_elem.light_dir = YVectorRegister(light->GetLightdir());
+			dir_light_elem.light_strength = light->GetLightStrength();
+			one_frame->dir_light_elements_.push_back(dir_light_elem);
+		});
 	
 	if (one_frame->dir_light_elements_.size() == 0)
 	{
@@ -49,6 +49,71 @@ protected:
 	YStaticMesh* mesh_ = nullptr;
 };
 
+// the mesh streams and the world matrix of every instance as four per-instance rows
+class YStaticMeshInstancedVertexFactory :public YStaticMeshVertexFactory
+{
+public:
+	YStaticMeshInstancedVertexFactory(YStaticMesh* mesh)
+		:YStaticMeshVertexFactory(mesh)
+	{
+
+	}
+	// YMatrix per instance, set before SetupStreams
+	void SetInstanceBuffer(ID3D11Buffer* instance_buffer)
+	{
+		instance_buffer_ = instance_buffer;
+	}
+	void SetupStreams()override
+	{
+		if (vertex_input_layout_)
+		{
+			const TComPtr<ID3D11DeviceContext> dc = g_device->GetDC();
+			dc->IASetInputLayout(vertex_input_layout_);
+			for (VertexStreamDescription& desc : vertex_descriptions_) {
+				if (desc.slot == -1) {
+					continue;
+				}
+				ID3D11Buffer* buffer = instance_buffer_;
+				unsigned int stride = desc.stride;
+				unsigned int offset = 0;
+				if (desc.per_instance) {
+					// every row reads the same instance buffer at its own offset
+					offset = (desc.vertex_attribute - VertexAttribute::VA_ATTRIBUTE0) * sizeof(YVector4);
+				}
+				else {
+					buffer = mesh_->vertex_buffers_[desc.cpu_data_index];
+				}
+				dc->IASetVertexBuffers(desc.slot, 1, &buffer, &stride, &offset);
+			}
+		}
+	}
+	void SetupVertexDescriptionPolicy()
+	{
+		YStaticMeshVertexFactory::SetupVertexDescriptionPolicy();
+		const char* row_names[4] = { "instance_axis_x", "instance_axis_y", "instance_axis_z", "instance_origin" };
+		for (int row = 0; row < 4; ++row)
+		{
+			VertexStreamDescription row_desc((VertexAttribute)(VertexAttribute::VA_ATTRIBUTE0 + row), row_names[row], DataType::Float32, -1, 4, 0, -1, sizeof(YMatrix), false, false, true, true);
+			vertex_descriptions_.push_back(row_desc);
+		}
+	}
+protected:
+	ID3D11Buffer* instance_buffer_ = nullptr;
+};
+
+static bool ReadShaderSource(const std::string& shader_path, std::string& out_source)
+{
+	YFile shader_source(shader_path, YFile::FileType(YFile::FileType::FT_Read | YFile::FileType::FT_TXT));
+	std::unique_ptr<MemoryFile> mem_file = shader_source.ReadFile();
+	if (!mem_file)
+	{
+		ERROR_INFO("open shader ", shader_path, " failed!");
+		return false;
+	}
+	out_source.assign(mem_file->GetReadOnlyFileContent().begin(), mem_file->GetReadOnlyFileContent().end());
+	return true;
+}
+
 void YStaticMesh::Render(CameraBase* camera)
 {
 	ID3D11Device* device = g_device->GetDevice();
@@ -96,7 +161,7 @@ void YStaticMesh::Render(RenderParam* render_param)
 	vertex_shader_->BindResource("g_world", render_param->local_to_world_);
 	vertex_shader_->Update();
 	if (render_param->dir_lights_proxy->size()) {
-		YVector dir_light = -(*render_param->dir_lights_proxy)[0].light_dir;
+		YVector dir_light = -(*render_param->dir_lights_proxy)[0].light_dir.ToVector();
 		pixel_shader_->BindResource("light_dir", &dir_light.x, 3);
 	}
 	pixel_shader_->Update();
@@ -110,6 +175,37 @@ void YStaticMesh::Render(RenderParam* render_param)
 	}
 }
 
+void YStaticMesh::RenderInstanced(RenderParam* render_param, ID3D11Buffer* instance_buffer, int first_instance, int instance_count)
+{
+	ID3D11DeviceContext* dc = g_device->GetDC();
+	float BlendColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	dc->OMSetBlendState(bs_, BlendColor, 0xffffffff);
+	dc->RSSetState(rs_);
+	dc->OMSetDepthStencilState(ds_, 0);
+	dc->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	//bind im
+	static_cast<YStaticMeshInstancedVertexFactory*>(instanced_vertex_factory_.get())->SetInstanceBuffer(instance_buffer);
+	instanced_vertex_factory_->SetupStreams();
+	//bind ib
+	dc->IASetIndexBuffer(index_buffer_, DXGI_FORMAT_R32_UINT, 0);
+	instanced_vertex_shader_->BindResource("g_projection", render_param->camera_proxy->projection_matrix_);
+	instanced_vertex_shader_->BindResource("g_view", render_param->camera_proxy->view_matrix_);
+	instanced_vertex_shader_->Update();
+	if (render_param->dir_lights_proxy->size()) {
+		YVector dir_light = -(*render_param->dir_lights_proxy)[0].light_dir.ToVector();
+		pixel_shader_->BindResource("light_dir", &dir_light.x, 3);
+	}
+	pixel_shader_->Update();
+
+	int triangle_total = 0;
+	for (auto& polygon_group : raw_meshes[0].polygon_groups)
+	{
+		int triangle_count = (int)polygon_group.polygons.size();
+		dc->DrawIndexedInstanced(triangle_count * 3, instance_count, triangle_total, 0, first_instance);
+		triangle_total += triangle_count * 3;
+	}
+}
+
 YStaticMesh::YStaticMesh()
 {
 
@@ -268,6 +364,30 @@ bool YStaticMesh::AllocGpuResource()
 	return true;
 }
 
+bool YStaticMesh::AllocInstancedGpuResource()
+{
+	if (instanced_vertex_shader_)
+	{
+		return true;
+	}
+	// the buffers and states of AllocGpuResource are shared with the instanced draws
+	if (!allocated_gpu_resource)
+	{
+		return false;
+	}
+	std::unique_ptr<YStaticMeshInstancedVertexFactory> instanced_vertex_factory = std::make_unique<YStaticMeshInstancedVertexFactory>(this);
+	instanced_vertex_factory->SetupVertexDescriptionPolicy();
+	std::unique_ptr<D3DVertexShader> instanced_vertex_shader = std::make_unique<D3DVertexShader>();
+	std::string str;
+	if (!ReadShaderSource("Shader/StaticMesh.hlsl", str) || !instanced_vertex_shader->CreateShaderFromSource(str, "VSMainInstanced", instanced_vertex_factory.get()))
+	{
+		return false;
+	}
+	instanced_vertex_factory_ = std::move(instanced_vertex_factory);
+	instanced_vertex_shader_ = std::move(instanced_vertex_shader);
+	return true;
+}
+
 void YStaticMesh::ReleaseGPUReosurce()
 {
 	vertex_buffers_.clear();
@@ -276,6 +396,8 @@ void YStaticMesh::ReleaseGPUReosurce()
 	rs_ = nullptr;
 	ds_ = nullptr;
 	sampler_state_ = nullptr;
+	instanced_vertex_shader_ = nullptr;
+	instanced_vertex_factory_ = nullptr;
 	allocated_gpu_resource = false;
 }
 
@@ -300,17 +422,23 @@ bool YStaticMesh::SaveV0(const std::string& dir)
 
 bool YStaticMesh::LoadV0(const std::string& file_path)
 {
-	// read model.json
+	// read model.json, only model_asset is needed so the descriptor is streamed
 	const std::string model_json_path = file_path + SObject::json_extension_with_dot;
-	Json::Value json_root;
-	if (!YJsonHelper::LoadJsonFromFile(model_json_path, json_root))
+	std::string static_mesh_asset;
+	bool has_model_asset = false;
+	YJsonObjectVisitor model_visitor;
+	model_visitor.OnString("model_asset", [&static_mesh_asset, &has_model_asset](std::string&& model_asset)
+		{
+			static_mesh_asset = std::move(model_asset);
+			has_model_asset = true;
+		});
+	if (!YJsonHelper::VisitJsonFromFile(model_json_path, model_visitor))
 	{
 		return false;
 	}
 	
-	if (json_root.isMember("model_asset"))
+	if (has_model_asset)
 	{
-		std::string static_mesh_asset = json_root["model_asset"].asString();
 		std::string parent_dir_path = YPath::GetPath(file_path);
 		std::string static_mesh_asset_path = YPath::PathCombine(parent_dir_path, static_mesh_asset);
 		static_mesh_asset_path += SObject::asset_extension_with_dot;
@@ -321,6 +449,7 @@ bool YStaticMesh::LoadV0(const std::string& file_path)
 			int version = 0;
 			(*mem_file) << version;
 			(*mem_file) << raw_meshes;
+			UpdateBounds();
 			return true;
 		}
 		else
@@ -331,3 +460,51 @@ bool YStaticMesh::LoadV0(const std::string& file_path)
 	}
 	return true;
 }
+
+void YStaticMesh::UpdateBounds()
+{
+	bounds_ = YBox();
+	for (const YLODMesh& lod_mesh : raw_meshes)
+	{
+		for (const YMeshVertex& vertex : lod_mesh.vertex_position)
+		{
+			bounds_ += vertex.position;
+		}
+	}
+}
+
+const YMeshBVH* YStaticMesh::GetBVH(int lod_index /*= 0*/)
+{
+	if (lod_index < 0 || lod_index >= (int)raw_meshes.size())
+	{
+		return nullptr;
+	}
+	std::lock_guard<std::mutex> lock(bvh_mutex_);
+	if (bvhs_.size() < raw_meshes.size())
+	{
+		bvhs_.resize(raw_meshes.size());
+	}
+	std::unique_ptr<YMeshBVH>& bvh = bvhs_[lod_index];
+	if (!bvh)
+	{
+		bvh = std::make_unique<YMeshBVH>();
+		if (!bvh->Build(raw_meshes[lod_index]))
+		{
+			WARNING_INFO("mesh ", model_name, " lod ", lod_index, " has no triangles to trace");
+		}
+	}
+	return bvh->GetNodeCount() > 0 ? bvh.get() : nullptr;
+}
+
+size_t YStaticMesh::GetResourceSize() const
+{
+	size_t resource_size = sizeof(YStaticMesh);
+	for (const YLODMesh& lod_mesh : raw_meshes)
+	{
+		resource_size += lod_mesh.vertex_position.size() * sizeof(YMeshVertex);
+		resource_size += lod_mesh.vertex_instances.size() * sizeof(YMeshVertexInstance);
+		resource_size += lod_mesh.polygons.size() * sizeof(YMeshPolygon);
+		resource_size += lod_mesh.edges.size() * sizeof(YMeshEdge);
+	}
+	return resource_size;
+}
@@ -0,0 +1,95 @@
+#include "Engine/YStaticMeshCache.h"
+#include "Utility/YPath.h"
+#include "Engine/YLog.h"
+#include <algorithm>
+#include <cctype>
+
+YStaticMeshCache g_static_mesh_cache;
+
+TRefCountPtr<YStaticMesh> YStaticMeshCache::LoadStaticMesh(const std::string& model_path)
+{
+	const std::string key = GetCacheKey(model_path);
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		auto find_result = meshes_.find(key);
+		if (find_result != meshes_.end())
+		{
+			load_finish_cv_.wait(lock, [this, &key]()
+				{
+					auto iter = meshes_.find(key);
+					return iter == meshes_.end() || !iter->second.loading;
+				});
+			auto iter = meshes_.find(key);
+			// the load we waited for failed
+			if (iter == meshes_.end())
+			{
+				return nullptr;
+			}
+			return iter->second.mesh;
+		}
+		// placeholder so later requests wait for this load instead of starting their own
+		meshes_[key].loading = true;
+	}
+
+	TRefCountPtr<YStaticMesh> mesh = new YStaticMesh();
+	bool load_success = mesh->LoadV0(model_path);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (load_success)
+		{
+			CacheEntry& entry = meshes_[key];
+			entry.mesh = mesh;
+			entry.loading = false;
+		}
+		else
+		{
+			meshes_.erase(key);
+		}
+	}
+	load_finish_cv_.notify_all();
+	if (!load_success)
+	{
+		return nullptr;
+	}
+	return mesh;
+}
+
+int YStaticMeshCache::ReleaseUnused()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	int release_count = 0;
+	for (auto iter = meshes_.begin(); iter != meshes_.end();)
+	{
+		if (!iter->second.loading && iter->second.mesh.GetRefCount() == 1)
+		{
+			iter = meshes_.erase(iter);
+			release_count++;
+		}
+		else
+		{
+			iter++;
+		}
+	}
+	return release_count;
+}
+
+int YStaticMeshCache::GetCachedMeshCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return (int)meshes_.size();
+}
+
+std::string YStaticMeshCache::GetCacheKey(const std::string& model_path)
+{
+	std::string key = model_path;
+	YPath::NormalizeFilename(key);
+	// windows file system is case insensitive
+	std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+	return key;
+}
+
+YStaticMeshCache& YStaticMeshCache::Get()
+{
+	return g_static_mesh_cache;
+}
@@ -0,0 +1,173 @@
+#include "Engine/YTaskSystem.h"
+#include "Engine/YLog.h"
+#include <algorithm>
+
+static thread_local bool t_in_worker_thread = false;
+YTaskSystem g_task_system;
+
+YTaskSystem::YTaskSystem()
+{
+
+}
+
+YTaskSystem::~YTaskSystem()
+{
+	Shutdown();
+}
+
+void YTaskSystem::Init(int worker_count /*= -1*/)
+{
+	// Get may init lazily from the game thread and the loader thread at once
+	std::lock_guard<std::mutex> init_lock(init_mutex_);
+	if (initialized_.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+	if (worker_count < 0)
+	{
+		worker_count = std::max(0, (int)std::thread::hardware_concurrency() - 1);
+	}
+	exit_ = false;
+	workers_.reserve(worker_count);
+	for (int i = 0; i < worker_count; ++i)
+	{
+		workers_.emplace_back([this]() { WorkerMain(); });
+	}
+	initialized_.store(true, std::memory_order_release);
+}
+
+void YTaskSystem::Shutdown()
+{
+	std::lock_guard<std::mutex> init_lock(init_mutex_);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		exit_ = true;
+	}
+	wake_cv_.notify_all();
+	for (std::thread& worker : workers_)
+	{
+		worker.join();
+	}
+	workers_.clear();
+	jobs_.clear();
+	initialized_.store(false, std::memory_order_release);
+}
+
+int YTaskSystem::GetBatchCount(int count, int batch_size)
+{
+	if (count <= 0)
+	{
+		return 0;
+	}
+	batch_size = std::max(1, batch_size);
+	return (count + batch_size - 1) / batch_size;
+}
+
+void YTaskSystem::ParallelFor(int count, int batch_size, const std::function<void(int batch_index, int begin, int end)>& func)
+{
+	batch_size = std::max(1, batch_size);
+	const int batch_count = GetBatchCount(count, batch_size);
+	if (batch_count == 0)
+	{
+		return;
+	}
+
+	if (batch_count == 1 || workers_.empty() || t_in_worker_thread)
+	{
+		for (int batch_index = 0; batch_index < batch_count; ++batch_index)
+		{
+			int begin = batch_index * batch_size;
+			func(batch_index, begin, std::min(count, begin + batch_size));
+		}
+		return;
+	}
+
+	std::shared_ptr<ParallelJob> job = std::make_shared<ParallelJob>();
+	job->func = &func;
+	job->count = count;
+	job->batch_size = batch_size;
+	job->batch_count = batch_count;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		jobs_.push_back(job);
+	}
+	wake_cv_.notify_all();
+
+	// the calling thread works on the job too
+	t_in_worker_thread = true;
+	RunBatches(job.get());
+	t_in_worker_thread = false;
+
+	std::unique_lock<std::mutex> lock(mutex_);
+	done_cv_.wait(lock, [&job]() { return job->finished_batch.load(std::memory_order_acquire) == job->batch_count; });
+	jobs_.erase(std::find(jobs_.begin(), jobs_.end(), job));
+}
+
+bool YTaskSystem::IsInWorkerThread()
+{
+	return t_in_worker_thread;
+}
+
+YTaskSystem& YTaskSystem::Get()
+{
+	if (!g_task_system.initialized_.load(std::memory_order_acquire))
+	{
+		g_task_system.Init();
+	}
+	return g_task_system;
+}
+
+void YTaskSystem::WorkerMain()
+{
+	t_in_worker_thread = true;
+	while (true)
+	{
+		std::shared_ptr<ParallelJob> job;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			wake_cv_.wait(lock, [this, &job]()
+				{
+					if (exit_)
+					{
+						return true;
+					}
+					job = FindPendingJob();
+					return job != nullptr;
+				});
+			if (exit_)
+			{
+				return;
+			}
+		}
+		RunBatches(job.get());
+	}
+}
+
+std::shared_ptr<YTaskSystem::ParallelJob> YTaskSystem::FindPendingJob() const
+{
+	for (const std::shared_ptr<ParallelJob>& job : jobs_)
+	{
+		if (job->next_batch.load(std::memory_order_relaxed) < job->batch_count)
+		{
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+void YTaskSystem::RunBatches(ParallelJob* job)
+{
+	int batch_index = job->next_batch.fetch_add(1, std::memory_order_relaxed);
+	while (batch_index < job->batch_count)
+	{
+		int begin = batch_index * job->batch_size;
+		int end = std::min(job->count, begin + job->batch_size);
+		(*job->func)(batch_index, begin, end);
+		if (job->finished_batch.fetch_add(1, std::memory_order_acq_rel) + 1 == job->batch_count)
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			done_cv_.notify_all();
+		}
+		batch_index = job->next_batch.fetch_add(1, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,95 @@
+#include "Math/YBatchMath.h"
+#include "Math/YMathKernels.h"
+#include <cassert>
+
+void YBatchMath::TransformPositions(YVector* out, const YMatrix& matrix, const YVector* positions, size_t count)
+{
+	YMathKernels::vector.transform_positions(out, matrix, positions, count);
+}
+
+void YBatchMath::TransformPositions(const YVectorSoA& out, const YMatrix& matrix, const YVectorSoA& positions, size_t count)
+{
+	YMathKernels::vector.transform_positions_soa(out, matrix, positions, count);
+}
+
+void YBatchMath::TransformVectors(YVector* out, const YMatrix& matrix, const YVector* directions, size_t count)
+{
+	YMathKernels::vector.transform_vectors(out, matrix, directions, count);
+}
+
+void YBatchMath::TransformVectors(const YVectorSoA& out, const YMatrix& matrix, const YVectorSoA& directions, size_t count)
+{
+	YMathKernels::vector.transform_vectors_soa(out, matrix, directions, count);
+}
+
+void YBatchMath::TransformVectors4(YVectorRegister* out, const YMatrix& matrix, const YVectorRegister* v, size_t count)
+{
+	YMathKernels::vector.transform_vectors4(out, matrix, v, count);
+}
+
+void YBatchMath::Normalize(YVector* out, const YVector* v, size_t count, float tolerance /*= SMALL_NUMBER*/)
+{
+	YMathKernels::vector.normalize(out, v, count, tolerance);
+}
+
+void YBatchMath::Normalize(const YVectorSoA& out, const YVectorSoA& v, size_t count, float tolerance /*= SMALL_NUMBER*/)
+{
+	YMathKernels::vector.normalize_soa(out, v, count, tolerance);
+}
+
+void YBatchMath::Cross(YVector* out, const YVector* a, const YVector* b, size_t count)
+{
+	YMathKernels::vector.cross(out, a, b, count);
+}
+
+void YBatchMath::Cross(const YVectorSoA& out, const YVectorSoA& a, const YVectorSoA& b, size_t count)
+{
+	YMathKernels::vector.cross_soa(out, a, b, count);
+}
+
+void YBatchMath::MinMax(YVector& out_min, YVector& out_max, const YVector* v, size_t count)
+{
+	assert(count > 0);
+	YMathKernels::vector.min_max(out_min, out_max, v, count);
+}
+
+void YBatchMath::MinMax(YVector& out_min, YVector& out_max, const YVectorSoA& v, size_t count)
+{
+	assert(count > 0);
+	YMathKernels::vector.min_max_soa(out_min, out_max, v, count);
+}
+
+void YBatchMath::SinCos(float* out_sin, float* out_cos, const float* radians, size_t count)
+{
+	YMathKernels::rotation.sin_cos(out_sin, out_cos, radians, count);
+}
+
+void YBatchMath::RotatorsToQuats(YQuat* out, const YRotator* rotators, size_t count)
+{
+	YMathKernels::rotation.rotators_to_quats(out, rotators, count);
+}
+
+void YBatchMath::RotatorsToMatrices(YMatrix* out, const YRotator* rotators, size_t count)
+{
+	YMathKernels::rotation.rotators_to_matrices(out, rotators, count);
+}
+
+void YBatchMath::QuatsToMatrices(YMatrix* out, const YQuat* quats, size_t count)
+{
+	YMathKernels::rotation.quats_to_matrices(out, quats, count);
+}
+
+void YBatchMath::QuatsToRotators(YRotator* out, const YQuat* quats, size_t count)
+{
+	YMathKernels::rotation.quats_to_rotators(out, quats, count);
+}
+
+void YBatchMath::RotateVectors(YVector* out, const YQuat& quat, const YVector* v, size_t count)
+{
+	YMathKernels::rotation.rotate_vectors(out, quat, v, count);
+}
+
+void YBatchMath::RotateVectors(const YVectorSoA& out, const YQuat& quat, const YVectorSoA& v, size_t count)
+{
+	YMathKernels::rotation.rotate_vectors_soa(out, quat, v, count);
+}
@@ -0,0 +1,140 @@
+#include "Math/YBox.h"
+#include "Math/YMatrix.h"
+#include <utility>
+
+YBox::YBox()
+	:min_corner(FLT_MAX, FLT_MAX, FLT_MAX),
+	max_corner(-FLT_MAX, -FLT_MAX, -FLT_MAX)
+{
+
+}
+
+YBox::YBox(const YVector& in_min, const YVector& in_max)
+	:min_corner(in_min),
+	max_corner(in_max)
+{
+
+}
+
+bool YBox::IsValid() const
+{
+	return min_corner.x <= max_corner.x && min_corner.y <= max_corner.y && min_corner.z <= max_corner.z;
+}
+
+YBox& YBox::operator+=(const YVector& point)
+{
+	min_corner = YVector(YMath::Min(min_corner.x, point.x), YMath::Min(min_corner.y, point.y), YMath::Min(min_corner.z, point.z));
+	max_corner = YVector(YMath::Max(max_corner.x, point.x), YMath::Max(max_corner.y, point.y), YMath::Max(max_corner.z, point.z));
+	return *this;
+}
+
+YBox& YBox::operator+=(const YBox& box)
+{
+	min_corner = YVector(YMath::Min(min_corner.x, box.min_corner.x), YMath::Min(min_corner.y, box.min_corner.y), YMath::Min(min_corner.z, box.min_corner.z));
+	max_corner = YVector(YMath::Max(max_corner.x, box.max_corner.x), YMath::Max(max_corner.y, box.max_corner.y), YMath::Max(max_corner.z, box.max_corner.z));
+	return *this;
+}
+
+YVector YBox::GetCenter() const
+{
+	return (min_corner + max_corner) * 0.5f;
+}
+
+YVector YBox::GetExtent() const
+{
+	return (max_corner - min_corner) * 0.5f;
+}
+
+YVector YBox::GetSize() const
+{
+	return max_corner - min_corner;
+}
+
+float YBox::GetSurfaceArea() const
+{
+	if (!IsValid())
+	{
+		return 0.0f;
+	}
+	const YVector size = GetSize();
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool YBox::Intersect(const YBox& other) const
+{
+	return min_corner.x <= other.max_corner.x && other.min_corner.x <= max_corner.x
+		&& min_corner.y <= other.max_corner.y && other.min_corner.y <= max_corner.y
+		&& min_corner.z <= other.max_corner.z && other.min_corner.z <= max_corner.z;
+}
+
+bool YBox::IsInside(const YVector& point) const
+{
+	return point.x >= min_corner.x && point.x <= max_corner.x
+		&& point.y >= min_corner.y && point.y <= max_corner.y
+		&& point.z >= min_corner.z && point.z <= max_corner.z;
+}
+
+bool YBox::IsInside(const YBox& other) const
+{
+	return other.min_corner.x >= min_corner.x && other.max_corner.x <= max_corner.x
+		&& other.min_corner.y >= min_corner.y && other.max_corner.y <= max_corner.y
+		&& other.min_corner.z >= min_corner.z && other.max_corner.z <= max_corner.z;
+}
+
+YBox YBox::ExpandBy(float amount) const
+{
+	const YVector offset(amount, amount, amount);
+	return YBox(min_corner - offset, max_corner + offset);
+}
+
+YBox YBox::TransformBy(const YMatrix& matrix) const
+{
+	if (!IsValid())
+	{
+		return YBox();
+	}
+	// the center moves with the matrix, the extent grows by the absolute rows
+	const YVector center = matrix.TransformPosition(GetCenter());
+	const YVector extent = GetExtent();
+	YVector new_extent;
+	for (int i = 0; i < 3; ++i)
+	{
+		new_extent[i] = YMath::Abs(matrix.m[0][i]) * extent.x + YMath::Abs(matrix.m[1][i]) * extent.y + YMath::Abs(matrix.m[2][i]) * extent.z;
+	}
+	return YBox(center - new_extent, center + new_extent);
+}
+
+bool YBox::IntersectRay(const YRay& ray, float& out_near, float& out_far) const
+{
+	float near_distance = 0.0f;
+	float far_distance = FLT_MAX;
+	for (int i = 0; i < 3; ++i)
+	{
+		const float origin = ray.origin[i];
+		const float direction = ray.direction[i];
+		if (direction == 0.0f)
+		{
+			if (origin < min_corner[i] || origin > max_corner[i])
+			{
+				return false;
+			}
+			continue;
+		}
+		const float inv_direction = 1.0f / direction;
+		float t0 = (min_corner[i] - origin) * inv_direction;
+		float t1 = (max_corner[i] - origin) * inv_direction;
+		if (t0 > t1)
+		{
+			std::swap(t0, t1);
+		}
+		near_distance = YMath::Max(near_distance, t0);
+		far_distance = YMath::Min(far_distance, t1);
+		if (near_distance > far_distance)
+		{
+			return false;
+		}
+	}
+	out_near = near_distance;
+	out_far = far_distance;
+	return true;
+}
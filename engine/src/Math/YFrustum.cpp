@@ -0,0 +1,58 @@
+#include "Math/YFrustum.h"
+#include "Math/YMatrix.h"
+
+YFrustum YFrustum::FromViewProjection(const YMatrix& view_proj)
+{
+	// row vectors, clip = p * view_proj, so every clip coordinate is p dotted with a column
+	YVector4 columns[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		columns[i] = YVector4(view_proj.m[0][i], view_proj.m[1][i], view_proj.m[2][i], view_proj.m[3][i]);
+	}
+	auto add = [](const YVector4& a, const YVector4& b) { return YVector4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w); };
+	auto sub = [](const YVector4& a, const YVector4& b) { return YVector4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w); };
+	YFrustum frustum;
+	// -w <= x <= w, -w <= y <= w, 0 <= z <= w
+	frustum.planes[0] = add(columns[3], columns[0]);
+	frustum.planes[1] = sub(columns[3], columns[0]);
+	frustum.planes[2] = add(columns[3], columns[1]);
+	frustum.planes[3] = sub(columns[3], columns[1]);
+	frustum.planes[4] = columns[2];
+	frustum.planes[5] = sub(columns[3], columns[2]);
+	for (YVector4& plane : frustum.planes)
+	{
+		const float length = YMath::Sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > SMALL_NUMBER)
+		{
+			const float inv_length = 1.0f / length;
+			plane = YVector4(plane.x * inv_length, plane.y * inv_length, plane.z * inv_length, plane.w * inv_length);
+		}
+	}
+	return frustum;
+}
+
+EFrustumContainment YFrustum::ClassifyBox(const YBox& box) const
+{
+	if (!box.IsValid())
+	{
+		return FC_Outside;
+	}
+	const YVector center = box.GetCenter();
+	const YVector extent = box.GetExtent();
+	EFrustumContainment result = FC_Inside;
+	for (const YVector4& plane : planes)
+	{
+		// signed distance of the center against the projected radius of the box on the normal
+		const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		const float radius = YMath::Abs(plane.x) * extent.x + YMath::Abs(plane.y) * extent.y + YMath::Abs(plane.z) * extent.z;
+		if (distance + radius < 0.0f)
+		{
+			return FC_Outside;
+		}
+		if (distance - radius < 0.0f)
+		{
+			result = FC_Intersect;
+		}
+	}
+	return result;
+}
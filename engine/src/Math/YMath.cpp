@@ -1,6 +1,21 @@
 #include "Math/YMath.h"
 #include "Math/YVector.h"
 #include "Math/YMatrix.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+int YMath::CountTrailingZeros(uint32_t value)
+{
+#if defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanForward(&index, value);
+	return (int)index;
+#else
+	return __builtin_ctz(value);
+#endif
+}
+
 float YMath::Atan2(float y, float x)
 {
 	//return atan2f(Y,X);
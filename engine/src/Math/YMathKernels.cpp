@@ -0,0 +1,1357 @@
+#include "Math/YMathKernels.h"
+#include "Math/YMatrix.h"
+#include "Math/YVector.h"
+#include "Math/YTransform.h"
+#include "Math/YQuaterion.h"
+#include "Math/YRotator.h"
+#include "Math/YBatchMath.h"
+#include <cstring>
+
+/*-----------------------------------------------------------------------------
+	scalar reference
+-----------------------------------------------------------------------------*/
+
+static void MultiplyScalar(YMatrix& out, const YMatrix& matrix1, const YMatrix& matrix2)
+{
+	YMatrix tmp;
+	tmp.m[0][0] = matrix1.m[0][0] * matrix2.m[0][0] + matrix1.m[0][1] * matrix2.m[1][0] + matrix1.m[0][2] * matrix2.m[2][0] + matrix1.m[0][3] * matrix2.m[3][0];
+	tmp.m[0][1] = matrix1.m[0][0] * matrix2.m[0][1] + matrix1.m[0][1] * matrix2.m[1][1] + matrix1.m[0][2] * matrix2.m[2][1] + matrix1.m[0][3] * matrix2.m[3][1];
+	tmp.m[0][2] = matrix1.m[0][0] * matrix2.m[0][2] + matrix1.m[0][1] * matrix2.m[1][2] + matrix1.m[0][2] * matrix2.m[2][2] + matrix1.m[0][3] * matrix2.m[3][2];
+	tmp.m[0][3] = matrix1.m[0][0] * matrix2.m[0][3] + matrix1.m[0][1] * matrix2.m[1][3] + matrix1.m[0][2] * matrix2.m[2][3] + matrix1.m[0][3] * matrix2.m[3][3];
+
+	tmp.m[1][0] = matrix1.m[1][0] * matrix2.m[0][0] + matrix1.m[1][1] * matrix2.m[1][0] + matrix1.m[1][2] * matrix2.m[2][0] + matrix1.m[1][3] * matrix2.m[3][0];
+	tmp.m[1][1] = matrix1.m[1][0] * matrix2.m[0][1] + matrix1.m[1][1] * matrix2.m[1][1] + matrix1.m[1][2] * matrix2.m[2][1] + matrix1.m[1][3] * matrix2.m[3][1];
+	tmp.m[1][2] = matrix1.m[1][0] * matrix2.m[0][2] + matrix1.m[1][1] * matrix2.m[1][2] + matrix1.m[1][2] * matrix2.m[2][2] + matrix1.m[1][3] * matrix2.m[3][2];
+	tmp.m[1][3] = matrix1.m[1][0] * matrix2.m[0][3] + matrix1.m[1][1] * matrix2.m[1][3] + matrix1.m[1][2] * matrix2.m[2][3] + matrix1.m[1][3] * matrix2.m[3][3];
+
+	tmp.m[2][0] = matrix1.m[2][0] * matrix2.m[0][0] + matrix1.m[2][1] * matrix2.m[1][0] + matrix1.m[2][2] * matrix2.m[2][0] + matrix1.m[2][3] * matrix2.m[3][0];
+	tmp.m[2][1] = matrix1.m[2][0] * matrix2.m[0][1] + matrix1.m[2][1] * matrix2.m[1][1] + matrix1.m[2][2] * matrix2.m[2][1] + matrix1.m[2][3] * matrix2.m[3][1];
+	tmp.m[2][2] = matrix1.m[2][0] * matrix2.m[0][2] + matrix1.m[2][1] * matrix2.m[1][2] + matrix1.m[2][2] * matrix2.m[2][2] + matrix1.m[2][3] * matrix2.m[3][2];
+	tmp.m[2][3] = matrix1.m[2][0] * matrix2.m[0][3] + matrix1.m[2][1] * matrix2.m[1][3] + matrix1.m[2][2] * matrix2.m[2][3] + matrix1.m[2][3] * matrix2.m[3][3];
+
+	tmp.m[3][0] = matrix1.m[3][0] * matrix2.m[0][0] + matrix1.m[3][1] * matrix2.m[1][0] + matrix1.m[3][2] * matrix2.m[2][0] + matrix1.m[3][3] * matrix2.m[3][0];
+	tmp.m[3][1] = matrix1.m[3][0] * matrix2.m[0][1] + matrix1.m[3][1] * matrix2.m[1][1] + matrix1.m[3][2] * matrix2.m[2][1] + matrix1.m[3][3] * matrix2.m[3][1];
+	tmp.m[3][2] = matrix1.m[3][0] * matrix2.m[0][2] + matrix1.m[3][1] * matrix2.m[1][2] + matrix1.m[3][2] * matrix2.m[2][2] + matrix1.m[3][3] * matrix2.m[3][2];
+	tmp.m[3][3] = matrix1.m[3][0] * matrix2.m[0][3] + matrix1.m[3][1] * matrix2.m[1][3] + matrix1.m[3][2] * matrix2.m[2][3] + matrix1.m[3][3] * matrix2.m[3][3];
+	memcpy(out.m, tmp.m, sizeof(float) * 16);
+}
+
+static float DeterminantScalar(const YMatrix& matrix)
+{
+	const float(*m)[4] = matrix.m;
+	return	m[0][0] * (
+		m[1][1] * (m[2][2] * m[3][3] - m[2][3] * m[3][2]) -
+		m[2][1] * (m[1][2] * m[3][3] - m[1][3] * m[3][2]) +
+		m[3][1] * (m[1][2] * m[2][3] - m[1][3] * m[2][2])
+		) -
+		m[1][0] * (
+			m[0][1] * (m[2][2] * m[3][3] - m[2][3] * m[3][2]) -
+			m[2][1] * (m[0][2] * m[3][3] - m[0][3] * m[3][2]) +
+			m[3][1] * (m[0][2] * m[2][3] - m[0][3] * m[2][2])
+			) +
+		m[2][0] * (
+			m[0][1] * (m[1][2] * m[3][3] - m[1][3] * m[3][2]) -
+			m[1][1] * (m[0][2] * m[3][3] - m[0][3] * m[3][2]) +
+			m[3][1] * (m[0][2] * m[1][3] - m[0][3] * m[1][2])
+			) -
+		m[3][0] * (
+			m[0][1] * (m[1][2] * m[2][3] - m[1][3] * m[2][2]) -
+			m[1][1] * (m[0][2] * m[2][3] - m[0][3] * m[2][2]) +
+			m[2][1] * (m[0][2] * m[1][3] - m[0][3] * m[1][2])
+			);
+}
+
+static bool InverseScalar(YMatrix& result_matrix, const YMatrix& matrix)
+{
+	if (DeterminantScalar(matrix) == 0.0f)
+	{
+		return false;
+	}
+	const float(*m)[4] = matrix.m;
+	YMatrix tmp_matrix;
+	float det[4];
+	tmp_matrix.m[0][0] = m[2][2] * m[3][3] - m[2][3] * m[3][2];
+	tmp_matrix.m[0][1] = m[1][2] * m[3][3] - m[1][3] * m[3][2];
+	tmp_matrix.m[0][2] = m[1][2] * m[2][3] - m[1][3] * m[2][2];
+
+	tmp_matrix.m[1][0] = m[2][2] * m[3][3] - m[2][3] * m[3][2];
+	tmp_matrix.m[1][1] = m[0][2] * m[3][3] - m[0][3] * m[3][2];
+	tmp_matrix.m[1][2] = m[0][2] * m[2][3] - m[0][3] * m[2][2];
+
+	tmp_matrix.m[2][0] = m[1][2] * m[3][3] - m[1][3] * m[3][2];
+	tmp_matrix.m[2][1] = m[0][2] * m[3][3] - m[0][3] * m[3][2];
+	tmp_matrix.m[2][2] = m[0][2] * m[1][3] - m[0][3] * m[1][2];
+
+	tmp_matrix.m[3][0] = m[1][2] * m[2][3] - m[1][3] * m[2][2];
+	tmp_matrix.m[3][1] = m[0][2] * m[2][3] - m[0][3] * m[2][2];
+	tmp_matrix.m[3][2] = m[0][2] * m[1][3] - m[0][3] * m[1][2];
+
+	det[0] = m[1][1] * tmp_matrix.m[0][0] - m[2][1] * tmp_matrix.m[0][1] + m[3][1] * tmp_matrix.m[0][2];
+	det[1] = m[0][1] * tmp_matrix.m[1][0] - m[2][1] * tmp_matrix.m[1][1] + m[3][1] * tmp_matrix.m[1][2];
+	det[2] = m[0][1] * tmp_matrix.m[2][0] - m[1][1] * tmp_matrix.m[2][1] + m[3][1] * tmp_matrix.m[2][2];
+	det[3] = m[0][1] * tmp_matrix.m[3][0] - m[1][1] * tmp_matrix.m[3][1] + m[2][1] * tmp_matrix.m[3][2];
+
+	float determinant = m[0][0] * det[0] - m[1][0] * det[1] + m[2][0] * det[2] - m[3][0] * det[3];
+	const float	r_det = 1.0f / determinant;
+
+	result_matrix.m[0][0] = r_det * det[0];
+	result_matrix.m[0][1] = -r_det * det[1];
+	result_matrix.m[0][2] = r_det * det[2];
+	result_matrix.m[0][3] = -r_det * det[3];
+	result_matrix.m[1][0] = -r_det * (m[1][0] * tmp_matrix.m[0][0] - m[2][0] * tmp_matrix.m[0][1] + m[3][0] * tmp_matrix.m[0][2]);
+	result_matrix.m[1][1] = r_det * (m[0][0] * tmp_matrix.m[1][0] - m[2][0] * tmp_matrix.m[1][1] + m[3][0] * tmp_matrix.m[1][2]);
+	result_matrix.m[1][2] = -r_det * (m[0][0] * tmp_matrix.m[2][0] - m[1][0] * tmp_matrix.m[2][1] + m[3][0] * tmp_matrix.m[2][2]);
+	result_matrix.m[1][3] = r_det * (m[0][0] * tmp_matrix.m[3][0] - m[1][0] * tmp_matrix.m[3][1] + m[2][0] * tmp_matrix.m[3][2]);
+	result_matrix.m[2][0] = r_det * (
+		m[1][0] * (m[2][1] * m[3][3] - m[2][3] * m[3][1]) -
+		m[2][0] * (m[1][1] * m[3][3] - m[1][3] * m[3][1]) +
+		m[3][0] * (m[1][1] * m[2][3] - m[1][3] * m[2][1])
+		);
+	result_matrix.m[2][1] = -r_det * (
+		m[0][0] * (m[2][1] * m[3][3] - m[2][3] * m[3][1]) -
+		m[2][0] * (m[0][1] * m[3][3] - m[0][3] * m[3][1]) +
+		m[3][0] * (m[0][1] * m[2][3] - m[0][3] * m[2][1])
+		);
+	result_matrix.m[2][2] = r_det * (
+		m[0][0] * (m[1][1] * m[3][3] - m[1][3] * m[3][1]) -
+		m[1][0] * (m[0][1] * m[3][3] - m[0][3] * m[3][1]) +
+		m[3][0] * (m[0][1] * m[1][3] - m[0][3] * m[1][1])
+		);
+	result_matrix.m[2][3] = -r_det * (
+		m[0][0] * (m[1][1] * m[2][3] - m[1][3] * m[2][1]) -
+		m[1][0] * (m[0][1] * m[2][3] - m[0][3] * m[2][1]) +
+		m[2][0] * (m[0][1] * m[1][3] - m[0][3] * m[1][1])
+		);
+	result_matrix.m[3][0] = -r_det * (
+		m[1][0] * (m[2][1] * m[3][2] - m[2][2] * m[3][1]) -
+		m[2][0] * (m[1][1] * m[3][2] - m[1][2] * m[3][1]) +
+		m[3][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+		);
+	result_matrix.m[3][1] = r_det * (
+		m[0][0] * (m[2][1] * m[3][2] - m[2][2] * m[3][1]) -
+		m[2][0] * (m[0][1] * m[3][2] - m[0][2] * m[3][1]) +
+		m[3][0] * (m[0][1] * m[2][2] - m[0][2] * m[2][1])
+		);
+	result_matrix.m[3][2] = -r_det * (
+		m[0][0] * (m[1][1] * m[3][2] - m[1][2] * m[3][1]) -
+		m[1][0] * (m[0][1] * m[3][2] - m[0][2] * m[3][1]) +
+		m[3][0] * (m[0][1] * m[1][2] - m[0][2] * m[1][1])
+		);
+	result_matrix.m[3][3] = r_det * (
+		m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+		m[1][0] * (m[0][1] * m[2][2] - m[0][2] * m[2][1]) +
+		m[2][0] * (m[0][1] * m[1][2] - m[0][2] * m[1][1])
+		);
+	return true;
+}
+
+static void TransformVector4Scalar(YVector4& out, const YMatrix& matrix, const YVector4& v)
+{
+	const float(*m)[4] = matrix.m;
+	float f[4];
+	const float* tmp = reinterpret_cast<const float*>(&v);
+	f[0] = tmp[0] * m[0][0] + tmp[1] * m[1][0] + tmp[2] * m[2][0] + tmp[3] * m[3][0];
+	f[1] = tmp[0] * m[0][1] + tmp[1] * m[1][1] + tmp[2] * m[2][1] + tmp[3] * m[3][1];
+	f[2] = tmp[0] * m[0][2] + tmp[1] * m[1][2] + tmp[2] * m[2][2] + tmp[3] * m[3][2];
+	f[3] = tmp[0] * m[0][3] + tmp[1] * m[1][3] + tmp[2] * m[2][3] + tmp[3] * m[3][3];
+	out = YVector4(f);
+}
+
+static void TransposeScalar(YMatrix& result, const YMatrix& matrix)
+{
+	YMatrix tmp;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			tmp.m[i][j] = matrix.m[j][i];
+		}
+	}
+	result = tmp;
+}
+
+static void TransformsToMatricesScalar(YMatrix* out, const YTransform* transforms, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = transforms[i].ToMatrix();
+	}
+}
+
+// the streams from element offset on, for the tails of the simd loops
+static inline YVectorSoA OffsetSoA(const YVectorSoA& v, size_t offset)
+{
+	YVectorSoA result;
+	result.x = v.x + offset;
+	result.y = v.y + offset;
+	result.z = v.z + offset;
+	return result;
+}
+
+template<bool translate>
+static inline YVector TransformScalar(const YMatrix& matrix, const YVector& v)
+{
+	const float(*m)[4] = matrix.m;
+	if (translate)
+	{
+		return YVector(v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0] + m[3][0],
+			v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1] + m[3][1],
+			v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2] + m[3][2]);
+	}
+	return YVector(v.x * m[0][0] + v.y * m[1][0] + v.z * m[2][0],
+		v.x * m[0][1] + v.y * m[1][1] + v.z * m[2][1],
+		v.x * m[0][2] + v.y * m[1][2] + v.z * m[2][2]);
+}
+
+template<bool translate>
+static void TransformAoSScalar(YVector* out, const YMatrix& matrix, const YVector* in, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = TransformScalar<translate>(matrix, in[i]);
+	}
+}
+
+template<bool translate>
+static void TransformSoAScalar(const YVectorSoA& out, const YMatrix& matrix, const YVectorSoA& in, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		const YVector v = TransformScalar<translate>(matrix, YVector(in.x[i], in.y[i], in.z[i]));
+		out.x[i] = v.x;
+		out.y[i] = v.y;
+		out.z[i] = v.z;
+	}
+}
+
+static void NormalizeScalar(YVector* out, const YVector* v, size_t count, float tolerance)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = v[i].GetSafeNormal(tolerance);
+	}
+}
+
+static void NormalizeSoAScalar(const YVectorSoA& out, const YVectorSoA& v, size_t count, float tolerance)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		const YVector normal = YVector(v.x[i], v.y[i], v.z[i]).GetSafeNormal(tolerance);
+		out.x[i] = normal.x;
+		out.y[i] = normal.y;
+		out.z[i] = normal.z;
+	}
+}
+
+static void CrossScalar(YVector* out, const YVector* a, const YVector* b, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = a[i] ^ b[i];
+	}
+}
+
+static void CrossSoAScalar(const YVectorSoA& out, const YVectorSoA& a, const YVectorSoA& b, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		const YVector cross = YVector(a.x[i], a.y[i], a.z[i]) ^ YVector(b.x[i], b.y[i], b.z[i]);
+		out.x[i] = cross.x;
+		out.y[i] = cross.y;
+		out.z[i] = cross.z;
+	}
+}
+
+// merges into out_min and out_max, the same comparison as _mm_min_ps / _mm_max_ps
+static inline void MinMaxMerge(YVector& out_min, YVector& out_max, float x, float y, float z)
+{
+	out_min.x = out_min.x < x ? out_min.x : x;
+	out_min.y = out_min.y < y ? out_min.y : y;
+	out_min.z = out_min.z < z ? out_min.z : z;
+	out_max.x = out_max.x > x ? out_max.x : x;
+	out_max.y = out_max.y > y ? out_max.y : y;
+	out_max.z = out_max.z > z ? out_max.z : z;
+}
+
+static void MinMaxScalar(YVector& out_min, YVector& out_max, const YVector* v, size_t count)
+{
+	out_min = v[0];
+	out_max = v[0];
+	for (size_t i = 1; i < count; ++i)
+	{
+		MinMaxMerge(out_min, out_max, v[i].x, v[i].y, v[i].z);
+	}
+}
+
+static void MinMaxSoAScalar(YVector& out_min, YVector& out_max, const YVectorSoA& v, size_t count)
+{
+	out_min = YVector(v.x[0], v.y[0], v.z[0]);
+	out_max = out_min;
+	for (size_t i = 1; i < count; ++i)
+	{
+		MinMaxMerge(out_min, out_max, v.x[i], v.y[i], v.z[i]);
+	}
+}
+
+static void TransformVectors4Scalar(YVectorRegister* out, const YMatrix& matrix, const YVectorRegister* v, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		YVector4 result;
+		TransformVector4Scalar(result, matrix, v[i].ToVector4());
+		out[i] = YVectorRegister(result);
+	}
+}
+
+static void SinCosScalar(float* out_sin, float* out_cos, const float* radians, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		const float radian = radians[i];
+		out_sin[i] = YMath::Sin(radian);
+		out_cos[i] = YMath::Cos(radian);
+	}
+}
+
+static void RotatorsToQuatsScalar(YQuat* out, const YRotator* rotators, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = rotators[i].ToQuat();
+	}
+}
+
+static void RotatorsToMatricesScalar(YMatrix* out, const YRotator* rotators, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = rotators[i].ToMatrix();
+	}
+}
+
+static void QuatsToMatricesScalar(YMatrix* out, const YQuat* quats, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = quats[i].ToMatrix();
+	}
+}
+
+static void QuatsToRotatorsScalar(YRotator* out, const YQuat* quats, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = quats[i].Rotator();
+	}
+}
+
+static void RotateVectorsScalar(YVector* out, const YQuat& quat, const YVector* v, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		out[i] = quat.RotateVector(v[i]);
+	}
+}
+
+static void RotateVectorsSoAScalar(const YVectorSoA& out, const YQuat& quat, const YVectorSoA& v, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		const YVector rotated = quat.RotateVector(YVector(v.x[i], v.y[i], v.z[i]));
+		out.x[i] = rotated.x;
+		out.y[i] = rotated.y;
+		out.z[i] = rotated.z;
+	}
+}
+
+static constexpr YMatrixKernels matrix_kernels_scalar = { &MultiplyScalar, &DeterminantScalar, &InverseScalar, &TransformVector4Scalar, &TransposeScalar };
+static constexpr YTransformKernels transform_kernels_scalar = { &TransformsToMatricesScalar };
+static constexpr YVectorKernels vector_kernels_scalar = { &TransformAoSScalar<true>, &TransformSoAScalar<true>, &TransformAoSScalar<false>, &TransformSoAScalar<false>,
+	&NormalizeScalar, &NormalizeSoAScalar, &CrossScalar, &CrossSoAScalar, &MinMaxScalar, &MinMaxSoAScalar,
+	&TransformVectors4Scalar };
+static constexpr YRotationKernels rotation_kernels_scalar = { &SinCosScalar, &RotatorsToQuatsScalar, &RotatorsToMatricesScalar, &QuatsToMatricesScalar,
+	&QuatsToRotatorsScalar, &RotateVectorsScalar, &RotateVectorsSoAScalar };
+
+#if YMATH_SSE
+/*-----------------------------------------------------------------------------
+	sse2, the products and sums run in the scalar order so the bits match it
+-----------------------------------------------------------------------------*/
+
+// YMatrix is 16 byte aligned, its rows are read and written with aligned moves
+
+static void MultiplySSE2(YMatrix& out, const YMatrix& matrix1, const YMatrix& matrix2)
+{
+	const __m128 row0 = _mm_load_ps(matrix2.m[0]);
+	const __m128 row1 = _mm_load_ps(matrix2.m[1]);
+	const __m128 row2 = _mm_load_ps(matrix2.m[2]);
+	const __m128 row3 = _mm_load_ps(matrix2.m[3]);
+	__m128 result[4];
+	for (int i = 0; i < 4; ++i)
+	{
+		const __m128 a = _mm_load_ps(matrix1.m[i]);
+		__m128 r = _mm_mul_ps(YMATH_SWIZZLE(a, 0, 0, 0, 0), row0);
+		r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(a, 1, 1, 1, 1), row1));
+		r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(a, 2, 2, 2, 2), row2));
+		result[i] = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(a, 3, 3, 3, 3), row3));
+	}
+	// out may be one of the inputs
+	for (int i = 0; i < 4; ++i)
+	{
+		_mm_store_ps(out.m[i], result[i]);
+	}
+}
+
+static float DeterminantSSE2(const YMatrix& matrix)
+{
+	__m128 col0 = _mm_load_ps(matrix.m[0]);
+	__m128 col1 = _mm_load_ps(matrix.m[1]);
+	__m128 col2 = _mm_load_ps(matrix.m[2]);
+	__m128 col3 = _mm_load_ps(matrix.m[3]);
+	_MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+	// 2x2 minors of the last two columns, minor(i, j) = m[i][2] * m[j][3] - m[i][3] * m[j][2]
+	// minors = (2,3) (1,3) (1,2) (0,3), minors_0 = (0,2) (0,1)
+	const __m128 minors = _mm_sub_ps(_mm_mul_ps(YMATH_SWIZZLE(col2, 2, 1, 1, 0), YMATH_SWIZZLE(col3, 3, 3, 2, 3)),
+		_mm_mul_ps(YMATH_SWIZZLE(col3, 2, 1, 1, 0), YMATH_SWIZZLE(col2, 3, 3, 2, 3)));
+	const __m128 minors_0 = _mm_sub_ps(_mm_mul_ps(YMATH_SWIZZLE(col2, 0, 0, 0, 0), YMATH_SWIZZLE(col3, 2, 1, 2, 1)),
+		_mm_mul_ps(YMATH_SWIZZLE(col3, 0, 0, 0, 0), YMATH_SWIZZLE(col2, 2, 1, 2, 1)));
+	// cofactor of m[k][0] = p * x - q * y + r * z, as the scalar expansion
+	const __m128 x = YMATH_SWIZZLE(minors, 0, 0, 1, 2);
+	const __m128 y = YMATH_SHUFFLE(minors, YMATH_SHUFFLE(minors, minors_0, 3, 3, 0, 0), 1, 3, 1, 2);
+	const __m128 z = YMATH_SHUFFLE(YMATH_SHUFFLE(minors, minors_0, 2, 2, 0, 1), minors_0, 0, 2, 1, 1);
+	__m128 cofactor = _mm_mul_ps(YMATH_SWIZZLE(col1, 1, 0, 0, 0), x);
+	cofactor = _mm_sub_ps(cofactor, _mm_mul_ps(YMATH_SWIZZLE(col1, 2, 2, 1, 1), y));
+	cofactor = _mm_add_ps(cofactor, _mm_mul_ps(YMATH_SWIZZLE(col1, 3, 3, 3, 2), z));
+	float terms[4];
+	_mm_storeu_ps(terms, _mm_mul_ps(col0, cofactor));
+	return terms[0] - terms[1] + terms[2] - terms[3];
+}
+
+// 2x2 blocks of a row major matrix in one register, (a0 a1 / a2 a3)
+static inline __m128 Mat2Mul(__m128 a, __m128 b)
+{
+	return _mm_add_ps(_mm_mul_ps(a, YMATH_SWIZZLE(b, 0, 3, 0, 3)), _mm_mul_ps(YMATH_SWIZZLE(a, 1, 0, 3, 2), YMATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// adjugate(a) * b
+static inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(YMATH_SWIZZLE(a, 3, 3, 0, 0), b), _mm_mul_ps(YMATH_SWIZZLE(a, 1, 1, 2, 2), YMATH_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+// a * adjugate(b)
+static inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+{
+	return _mm_sub_ps(_mm_mul_ps(a, YMATH_SWIZZLE(b, 3, 0, 3, 0)), _mm_mul_ps(YMATH_SWIZZLE(a, 1, 0, 3, 2), YMATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+// block inverse with 2x2 sub matrices, not the same operation order as the scalar one
+static bool InverseSSE2(YMatrix& out, const YMatrix& matrix)
+{
+	const __m128 row0 = _mm_load_ps(matrix.m[0]);
+	const __m128 row1 = _mm_load_ps(matrix.m[1]);
+	const __m128 row2 = _mm_load_ps(matrix.m[2]);
+	const __m128 row3 = _mm_load_ps(matrix.m[3]);
+	// | A B |
+	// | C D |
+	const __m128 a = _mm_movelh_ps(row0, row1);
+	const __m128 b = _mm_movehl_ps(row1, row0);
+	const __m128 c = _mm_movelh_ps(row2, row3);
+	const __m128 d = _mm_movehl_ps(row3, row2);
+	// |A| |B| |C| |D|
+	const __m128 det_sub = _mm_sub_ps(_mm_mul_ps(YMATH_SHUFFLE(row0, row2, 0, 2, 0, 2), YMATH_SHUFFLE(row1, row3, 1, 3, 1, 3)),
+		_mm_mul_ps(YMATH_SHUFFLE(row0, row2, 1, 3, 1, 3), YMATH_SHUFFLE(row1, row3, 0, 2, 0, 2)));
+	const __m128 det_a = YMATH_SWIZZLE(det_sub, 0, 0, 0, 0);
+	const __m128 det_b = YMATH_SWIZZLE(det_sub, 1, 1, 1, 1);
+	const __m128 det_c = YMATH_SWIZZLE(det_sub, 2, 2, 2, 2);
+	const __m128 det_d = YMATH_SWIZZLE(det_sub, 3, 3, 3, 3);
+
+	const __m128 d_c = Mat2AdjMul(d, c);
+	const __m128 a_b = Mat2AdjMul(a, b);
+	__m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), Mat2Mul(b, d_c));
+	__m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), Mat2Mul(c, a_b));
+	__m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), Mat2MulAdj(d, a_b));
+	__m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), Mat2MulAdj(a, d_c));
+
+	// |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+	__m128 trace = _mm_mul_ps(a_b, YMATH_SWIZZLE(d_c, 0, 2, 1, 3));
+	trace = _mm_add_ps(trace, YMATH_SWIZZLE(trace, 2, 3, 0, 1));
+	trace = _mm_add_ps(trace, YMATH_SWIZZLE(trace, 1, 0, 3, 2));
+	const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), trace);
+	if (_mm_cvtss_f32(det) == 0.0f)
+	{
+		return false;
+	}
+	const __m128 r_det = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+	x = _mm_mul_ps(x, r_det);
+	y = _mm_mul_ps(y, r_det);
+	z = _mm_mul_ps(z, r_det);
+	w = _mm_mul_ps(w, r_det);
+	// the adjugate shuffle and the store shuffle in one
+	_mm_store_ps(out.m[0], YMATH_SHUFFLE(x, y, 3, 1, 3, 1));
+	_mm_store_ps(out.m[1], YMATH_SHUFFLE(x, y, 2, 0, 2, 0));
+	_mm_store_ps(out.m[2], YMATH_SHUFFLE(z, w, 3, 1, 3, 1));
+	_mm_store_ps(out.m[3], YMATH_SHUFFLE(z, w, 2, 0, 2, 0));
+	return true;
+}
+
+static void TransformVector4SSE2(YVector4& out, const YMatrix& matrix, const YVector4& v)
+{
+	const __m128 vec = _mm_loadu_ps(&v.x);
+	__m128 r = _mm_mul_ps(YMATH_SWIZZLE(vec, 0, 0, 0, 0), _mm_load_ps(matrix.m[0]));
+	r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(vec, 1, 1, 1, 1), _mm_load_ps(matrix.m[1])));
+	r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(vec, 2, 2, 2, 2), _mm_load_ps(matrix.m[2])));
+	r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(vec, 3, 3, 3, 3), _mm_load_ps(matrix.m[3])));
+	_mm_storeu_ps(&out.x, r);
+}
+
+static void TransposeSSE2(YMatrix& out, const YMatrix& matrix)
+{
+	__m128 row0 = _mm_load_ps(matrix.m[0]);
+	__m128 row1 = _mm_load_ps(matrix.m[1]);
+	__m128 row2 = _mm_load_ps(matrix.m[2]);
+	__m128 row3 = _mm_load_ps(matrix.m[3]);
+	_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+	_mm_store_ps(out.m[0], row0);
+	_mm_store_ps(out.m[1], row1);
+	_mm_store_ps(out.m[2], row2);
+	_mm_store_ps(out.m[3], row3);
+}
+
+// the loads below read four floats at translation, rotator and rotator.w
+static_assert(offsetof(YTransform, translation) == 0 && offsetof(YTransform, rotator) == 12 && offsetof(YTransform, scale) == 28 && sizeof(YTransform) == 40, "YTransform layout");
+
+// the rotation rows of YQuat::ToMatrix, one quaternion per lane
+static inline void QuatRotationLanes(__m128 x, __m128 y, __m128 z, __m128 w, __m128 (&r)[3][3])
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+	const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+	const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+	r[0][0] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+	r[0][1] = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+	r[0][2] = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+	r[1][0] = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+	r[1][1] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+	r[1][2] = _mm_mul_ps(two, _mm_add_ps(wx, yz));
+	r[2][0] = _mm_mul_ps(two, _mm_add_ps(wy, xz));
+	r[2][1] = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+	r[2][2] = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+}
+
+// four transforms at a time, one lane each, the same operations as YTransform::ToMatrix
+static void TransformsToMatricesSSE2(YMatrix* out, const YTransform* transforms, size_t count)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const float* t0 = reinterpret_cast<const float*>(transforms + i);
+		const float* t1 = reinterpret_cast<const float*>(transforms + i + 1);
+		const float* t2 = reinterpret_cast<const float*>(transforms + i + 2);
+		const float* t3 = reinterpret_cast<const float*>(transforms + i + 3);
+		// (tx ty tz qx) (qx qy qz qw) (qw sx sy sz) to one register per member
+		__m128 tx = _mm_loadu_ps(t0), ty = _mm_loadu_ps(t1), tz = _mm_loadu_ps(t2), tw = _mm_loadu_ps(t3);
+		_MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+		__m128 x = _mm_loadu_ps(t0 + 3), y = _mm_loadu_ps(t1 + 3), z = _mm_loadu_ps(t2 + 3), w = _mm_loadu_ps(t3 + 3);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		__m128 sw = _mm_loadu_ps(t0 + 6), sx = _mm_loadu_ps(t1 + 6), sy = _mm_loadu_ps(t2 + 6), sz = _mm_loadu_ps(t3 + 6);
+		_MM_TRANSPOSE4_PS(sw, sx, sy, sz);
+
+		__m128 r[3][3];
+		QuatRotationLanes(x, y, z, w, r);
+		__m128 m00 = _mm_mul_ps(r[0][0], sx), m01 = _mm_mul_ps(r[0][1], sx), m02 = _mm_mul_ps(r[0][2], sx), m03 = _mm_setzero_ps();
+		__m128 m10 = _mm_mul_ps(r[1][0], sy), m11 = _mm_mul_ps(r[1][1], sy), m12 = _mm_mul_ps(r[1][2], sy), m13 = _mm_setzero_ps();
+		__m128 m20 = _mm_mul_ps(r[2][0], sz), m21 = _mm_mul_ps(r[2][1], sz), m22 = _mm_mul_ps(r[2][2], sz), m23 = _mm_setzero_ps();
+		tw = one;
+
+		// back to one register per matrix row
+		_MM_TRANSPOSE4_PS(m00, m01, m02, m03);
+		_MM_TRANSPOSE4_PS(m10, m11, m12, m13);
+		_MM_TRANSPOSE4_PS(m20, m21, m22, m23);
+		_MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+		const __m128 rows[4][4] = { { m00, m10, m20, tx }, { m01, m11, m21, ty }, { m02, m12, m22, tz }, { m03, m13, m23, tw } };
+		for (int j = 0; j < 4; ++j)
+		{
+			for (int k = 0; k < 4; ++k)
+			{
+				_mm_store_ps(out[i + j].m[k], rows[j][k]);
+			}
+		}
+	}
+	TransformsToMatricesScalar(out + i, transforms + i, count - i);
+}
+
+static constexpr YMatrixKernels matrix_kernels_sse2 = { &MultiplySSE2, &DeterminantSSE2, &InverseSSE2, &TransformVector4SSE2, &TransposeSSE2 };
+static constexpr YTransformKernels transform_kernels_sse2 = { &TransformsToMatricesSSE2 };
+
+// four YVector (12 floats) to one register per component and back
+static inline void LoadVectors4(const YVector* in, __m128& x, __m128& y, __m128& z)
+{
+	const float* f = &in->x;
+	// (x0 y0 z0 x1) (y1 z1 x2 y2) (z2 x3 y3 z3)
+	const __m128 a = _mm_loadu_ps(f);
+	const __m128 b = _mm_loadu_ps(f + 4);
+	const __m128 c = _mm_loadu_ps(f + 8);
+	x = YMATH_SHUFFLE(a, YMATH_SHUFFLE(b, c, 2, 2, 1, 1), 0, 3, 0, 2);
+	y = YMATH_SHUFFLE(YMATH_SHUFFLE(a, b, 1, 1, 0, 0), YMATH_SHUFFLE(b, c, 3, 3, 2, 2), 0, 2, 0, 2);
+	z = YMATH_SHUFFLE(YMATH_SHUFFLE(a, b, 2, 2, 1, 1), YMATH_SWIZZLE(c, 0, 0, 3, 3), 0, 2, 0, 2);
+}
+
+static inline void StoreVectors4(YVector* out, __m128 x, __m128 y, __m128 z)
+{
+	float* f = &out->x;
+	_mm_storeu_ps(f, YMATH_SHUFFLE(YMATH_SHUFFLE(x, y, 0, 0, 0, 0), YMATH_SHUFFLE(z, x, 0, 0, 1, 1), 0, 2, 0, 2));
+	_mm_storeu_ps(f + 4, YMATH_SHUFFLE(YMATH_SHUFFLE(y, z, 1, 1, 1, 1), YMATH_SHUFFLE(x, y, 2, 2, 2, 2), 0, 2, 0, 2));
+	_mm_storeu_ps(f + 8, YMATH_SHUFFLE(YMATH_SHUFFLE(z, x, 2, 2, 3, 3), YMATH_SHUFFLE(y, z, 3, 3, 3, 3), 0, 2, 0, 2));
+}
+
+// the matrix entries a transform reads, one broadcast register each
+struct YMatrixLanes
+{
+	__m128 m[4][3];
+	explicit YMatrixLanes(const YMatrix& matrix)
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				m[i][j] = _mm_set1_ps(matrix.m[i][j]);
+			}
+		}
+	}
+};
+
+template<bool translate>
+static inline void TransformLanes(const YMatrixLanes& lanes, __m128& x, __m128& y, __m128& z)
+{
+	__m128 r[3];
+	for (int j = 0; j < 3; ++j)
+	{
+		r[j] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, lanes.m[0][j]), _mm_mul_ps(y, lanes.m[1][j])), _mm_mul_ps(z, lanes.m[2][j]));
+		if (translate)
+		{
+			r[j] = _mm_add_ps(r[j], lanes.m[3][j]);
+		}
+	}
+	x = r[0];
+	y = r[1];
+	z = r[2];
+}
+
+template<bool translate>
+static void TransformAoSSSE2(YVector* out, const YMatrix& matrix, const YVector* in, size_t count)
+{
+	const YMatrixLanes lanes(matrix);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z;
+		LoadVectors4(in + i, x, y, z);
+		TransformLanes<translate>(lanes, x, y, z);
+		StoreVectors4(out + i, x, y, z);
+	}
+	TransformAoSScalar<translate>(out + i, matrix, in + i, count - i);
+}
+
+template<bool translate>
+static void TransformSoASSE2(const YVectorSoA& out, const YMatrix& matrix, const YVectorSoA& in, size_t count)
+{
+	const YMatrixLanes lanes(matrix);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(in.x + i), y = _mm_loadu_ps(in.y + i), z = _mm_loadu_ps(in.z + i);
+		TransformLanes<translate>(lanes, x, y, z);
+		_mm_storeu_ps(out.x + i, x);
+		_mm_storeu_ps(out.y + i, y);
+		_mm_storeu_ps(out.z + i, z);
+	}
+	TransformSoAScalar<translate>(OffsetSoA(out, i), matrix, OffsetSoA(in, i), count - i);
+}
+
+// GetSafeNormal, lanes with a square sum of 1 are kept and the ones below the tolerance are zeroed
+static inline void NormalizeLanes(__m128& x, __m128& y, __m128& z, __m128 tolerance)
+{
+	const __m128 square_sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+	const __m128 scale = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(square_sum));
+	const __m128 keep = _mm_cmpeq_ps(square_sum, _mm_set1_ps(1.0f));
+	const __m128 valid = _mm_cmpge_ps(square_sum, tolerance);
+	x = _mm_and_ps(valid, _mm_or_ps(_mm_and_ps(keep, x), _mm_andnot_ps(keep, _mm_mul_ps(x, scale))));
+	y = _mm_and_ps(valid, _mm_or_ps(_mm_and_ps(keep, y), _mm_andnot_ps(keep, _mm_mul_ps(y, scale))));
+	z = _mm_and_ps(valid, _mm_or_ps(_mm_and_ps(keep, z), _mm_andnot_ps(keep, _mm_mul_ps(z, scale))));
+}
+
+static void NormalizeSSE2(YVector* out, const YVector* v, size_t count, float tolerance)
+{
+	const __m128 tolerance_lanes = _mm_set1_ps(tolerance);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z;
+		LoadVectors4(v + i, x, y, z);
+		NormalizeLanes(x, y, z, tolerance_lanes);
+		StoreVectors4(out + i, x, y, z);
+	}
+	NormalizeScalar(out + i, v + i, count - i, tolerance);
+}
+
+static void NormalizeSoASSE2(const YVectorSoA& out, const YVectorSoA& v, size_t count, float tolerance)
+{
+	const __m128 tolerance_lanes = _mm_set1_ps(tolerance);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(v.x + i), y = _mm_loadu_ps(v.y + i), z = _mm_loadu_ps(v.z + i);
+		NormalizeLanes(x, y, z, tolerance_lanes);
+		_mm_storeu_ps(out.x + i, x);
+		_mm_storeu_ps(out.y + i, y);
+		_mm_storeu_ps(out.z + i, z);
+	}
+	NormalizeSoAScalar(OffsetSoA(out, i), OffsetSoA(v, i), count - i, tolerance);
+}
+
+static inline void CrossLanes(__m128 ax, __m128 ay, __m128 az, __m128 bx, __m128 by, __m128 bz, __m128& x, __m128& y, __m128& z)
+{
+	x = _mm_sub_ps(_mm_mul_ps(ay, bz), _mm_mul_ps(az, by));
+	y = _mm_sub_ps(_mm_mul_ps(az, bx), _mm_mul_ps(ax, bz));
+	z = _mm_sub_ps(_mm_mul_ps(ax, by), _mm_mul_ps(ay, bx));
+}
+
+static void CrossSSE2(YVector* out, const YVector* a, const YVector* b, size_t count)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 ax, ay, az, bx, by, bz, x, y, z;
+		LoadVectors4(a + i, ax, ay, az);
+		LoadVectors4(b + i, bx, by, bz);
+		CrossLanes(ax, ay, az, bx, by, bz, x, y, z);
+		StoreVectors4(out + i, x, y, z);
+	}
+	CrossScalar(out + i, a + i, b + i, count - i);
+}
+
+static void CrossSoASSE2(const YVectorSoA& out, const YVectorSoA& a, const YVectorSoA& b, size_t count)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z;
+		CrossLanes(_mm_loadu_ps(a.x + i), _mm_loadu_ps(a.y + i), _mm_loadu_ps(a.z + i), _mm_loadu_ps(b.x + i), _mm_loadu_ps(b.y + i), _mm_loadu_ps(b.z + i), x, y, z);
+		_mm_storeu_ps(out.x + i, x);
+		_mm_storeu_ps(out.y + i, y);
+		_mm_storeu_ps(out.z + i, z);
+	}
+	CrossSoAScalar(OffsetSoA(out, i), OffsetSoA(a, i), OffsetSoA(b, i), count - i);
+}
+
+// folds the four lanes of the accumulators into out_min and out_max
+static inline void MinMaxReduce(YVector& out_min, YVector& out_max, const __m128 (&min_lanes)[3], const __m128 (&max_lanes)[3])
+{
+	float min_values[3][4];
+	float max_values[3][4];
+	for (int c = 0; c < 3; ++c)
+	{
+		_mm_storeu_ps(min_values[c], min_lanes[c]);
+		_mm_storeu_ps(max_values[c], max_lanes[c]);
+	}
+	for (int lane = 0; lane < 4; ++lane)
+	{
+		out_min.x = out_min.x < min_values[0][lane] ? out_min.x : min_values[0][lane];
+		out_min.y = out_min.y < min_values[1][lane] ? out_min.y : min_values[1][lane];
+		out_min.z = out_min.z < min_values[2][lane] ? out_min.z : min_values[2][lane];
+		out_max.x = out_max.x > max_values[0][lane] ? out_max.x : max_values[0][lane];
+		out_max.y = out_max.y > max_values[1][lane] ? out_max.y : max_values[1][lane];
+		out_max.z = out_max.z > max_values[2][lane] ? out_max.z : max_values[2][lane];
+	}
+}
+
+static void MinMaxSSE2(YVector& out_min, YVector& out_max, const YVector* v, size_t count)
+{
+	if (count < 4)
+	{
+		MinMaxScalar(out_min, out_max, v, count);
+		return;
+	}
+	__m128 min_lanes[3];
+	LoadVectors4(v, min_lanes[0], min_lanes[1], min_lanes[2]);
+	__m128 max_lanes[3] = { min_lanes[0], min_lanes[1], min_lanes[2] };
+	size_t i = 4;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z;
+		LoadVectors4(v + i, x, y, z);
+		min_lanes[0] = _mm_min_ps(min_lanes[0], x);
+		min_lanes[1] = _mm_min_ps(min_lanes[1], y);
+		min_lanes[2] = _mm_min_ps(min_lanes[2], z);
+		max_lanes[0] = _mm_max_ps(max_lanes[0], x);
+		max_lanes[1] = _mm_max_ps(max_lanes[1], y);
+		max_lanes[2] = _mm_max_ps(max_lanes[2], z);
+	}
+	out_min = v[0];
+	out_max = v[0];
+	MinMaxReduce(out_min, out_max, min_lanes, max_lanes);
+	for (; i < count; ++i)
+	{
+		MinMaxMerge(out_min, out_max, v[i].x, v[i].y, v[i].z);
+	}
+}
+
+static void MinMaxSoASSE2(YVector& out_min, YVector& out_max, const YVectorSoA& v, size_t count)
+{
+	if (count < 4)
+	{
+		MinMaxSoAScalar(out_min, out_max, v, count);
+		return;
+	}
+	__m128 min_lanes[3] = { _mm_loadu_ps(v.x), _mm_loadu_ps(v.y), _mm_loadu_ps(v.z) };
+	__m128 max_lanes[3] = { min_lanes[0], min_lanes[1], min_lanes[2] };
+	size_t i = 4;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 x = _mm_loadu_ps(v.x + i), y = _mm_loadu_ps(v.y + i), z = _mm_loadu_ps(v.z + i);
+		min_lanes[0] = _mm_min_ps(min_lanes[0], x);
+		min_lanes[1] = _mm_min_ps(min_lanes[1], y);
+		min_lanes[2] = _mm_min_ps(min_lanes[2], z);
+		max_lanes[0] = _mm_max_ps(max_lanes[0], x);
+		max_lanes[1] = _mm_max_ps(max_lanes[1], y);
+		max_lanes[2] = _mm_max_ps(max_lanes[2], z);
+	}
+	out_min = YVector(v.x[0], v.y[0], v.z[0]);
+	out_max = out_min;
+	MinMaxReduce(out_min, out_max, min_lanes, max_lanes);
+	for (; i < count; ++i)
+	{
+		MinMaxMerge(out_min, out_max, v.x[i], v.y[i], v.z[i]);
+	}
+}
+
+static void TransformVectors4SSE2(YVectorRegister* out, const YMatrix& matrix, const YVectorRegister* v, size_t count)
+{
+	const __m128 row0 = _mm_load_ps(matrix.m[0]);
+	const __m128 row1 = _mm_load_ps(matrix.m[1]);
+	const __m128 row2 = _mm_load_ps(matrix.m[2]);
+	const __m128 row3 = _mm_load_ps(matrix.m[3]);
+	for (size_t i = 0; i < count; ++i)
+	{
+		const __m128 vec = v[i].Load();
+		__m128 r = _mm_mul_ps(YMATH_SWIZZLE(vec, 0, 0, 0, 0), row0);
+		r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(vec, 1, 1, 1, 1), row1));
+		r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(vec, 2, 2, 2, 2), row2));
+		r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(vec, 3, 3, 3, 3), row3));
+		_mm_store_ps(&out[i].x, r);
+	}
+}
+
+static constexpr YVectorKernels vector_kernels_sse2 = { &TransformAoSSSE2<true>, &TransformSoASSE2<true>, &TransformAoSSSE2<false>, &TransformSoASSE2<false>,
+	&NormalizeSSE2, &NormalizeSoASSE2, &CrossSSE2, &CrossSoASSE2, &MinMaxSSE2, &MinMaxSoASSE2,
+	&TransformVectors4SSE2 };
+
+/*-----------------------------------------------------------------------------
+	rotations
+-----------------------------------------------------------------------------*/
+
+// sin and cos of the cephes single precision library, the angle is reduced by multiples of pi/4
+// in three parts so the reduction stays exact for large angles, then one of two polynomials is used per octant
+static const float sincos_reduce[3] = { 0.78515625f, 2.4187564849853515625e-4f, 3.77489497744594108e-8f };
+static const float sincos_sin_coefficients[3] = { -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f };
+static const float sincos_cos_coefficients[3] = { 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f };
+
+static inline void SinCosLanes(__m128 x, __m128& out_sin, __m128& out_cos)
+{
+	const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+	__m128 sin_sign = _mm_and_ps(x, sign_mask);
+	x = _mm_andnot_ps(sign_mask, x);
+	// octant rounded up to even, sin(-x) = -sin(x) and cos(-x) = cos(x)
+	__m128i octant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+	octant = _mm_and_si128(_mm_add_epi32(octant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+	const __m128 y = _mm_cvtepi32_ps(octant);
+	sin_sign = _mm_xor_ps(sin_sign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(octant, _mm_set1_epi32(4)), 29)));
+	const __m128 cos_sign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(octant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+	// octants where sin uses the sin polynomial
+	const __m128 sin_poly_mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(octant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+
+	x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(sincos_reduce[0])));
+	x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(sincos_reduce[1])));
+	x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(sincos_reduce[2])));
+	const __m128 z = _mm_mul_ps(x, x);
+
+	__m128 cos_poly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(sincos_cos_coefficients[0]), z), _mm_set1_ps(sincos_cos_coefficients[1]));
+	cos_poly = _mm_add_ps(_mm_mul_ps(cos_poly, z), _mm_set1_ps(sincos_cos_coefficients[2]));
+	cos_poly = _mm_mul_ps(_mm_mul_ps(cos_poly, z), z);
+	cos_poly = _mm_add_ps(_mm_sub_ps(cos_poly, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+	__m128 sin_poly = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(sincos_sin_coefficients[0]), z), _mm_set1_ps(sincos_sin_coefficients[1]));
+	sin_poly = _mm_add_ps(_mm_mul_ps(sin_poly, z), _mm_set1_ps(sincos_sin_coefficients[2]));
+	sin_poly = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sin_poly, z), x), x);
+
+	const __m128 sin_value = _mm_or_ps(_mm_and_ps(sin_poly_mask, sin_poly), _mm_andnot_ps(sin_poly_mask, cos_poly));
+	const __m128 cos_value = _mm_or_ps(_mm_and_ps(sin_poly_mask, cos_poly), _mm_andnot_ps(sin_poly_mask, sin_poly));
+	out_sin = _mm_xor_ps(sin_value, sin_sign);
+	out_cos = _mm_xor_ps(cos_value, cos_sign);
+}
+
+static void SinCosSSE2(float* out_sin, float* out_cos, const float* radians, size_t count)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 s, c;
+		SinCosLanes(_mm_loadu_ps(radians + i), s, c);
+		_mm_storeu_ps(out_sin + i, s);
+		_mm_storeu_ps(out_cos + i, c);
+	}
+	if (i < count)
+	{
+		// the tail through the same polynomial so every element of a batch agrees
+		float tail[3][4] = {};
+		memcpy(tail[0], radians + i, (count - i) * sizeof(float));
+		SinCosSSE2(tail[1], tail[2], tail[0], 4);
+		memcpy(out_sin + i, tail[1], (count - i) * sizeof(float));
+		memcpy(out_cos + i, tail[2], (count - i) * sizeof(float));
+	}
+}
+
+static inline __m128 NegateLanes(__m128 v)
+{
+	return _mm_xor_ps(v, _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000)));
+}
+
+static inline __m128 SelectLanes(__m128 mask, __m128 if_true, __m128 if_false)
+{
+	return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+}
+
+// sin and cos of pitch, yaw and roll in degrees times scale
+static inline void RotatorSinCosLanes(const YRotator* rotators, float scale, __m128 (&s)[3], __m128 (&c)[3])
+{
+	static_assert(sizeof(YRotator) == sizeof(YVector), "YRotator is loaded as YVector");
+	__m128 angles[3];
+	LoadVectors4(reinterpret_cast<const YVector*>(rotators), angles[0], angles[1], angles[2]);
+	const __m128 scale_lanes = _mm_set1_ps(scale);
+	const __m128 deg_to_rad = _mm_set1_ps(PI / 180.f);
+	for (int k = 0; k < 3; ++k)
+	{
+		SinCosLanes(_mm_mul_ps(_mm_mul_ps(angles[k], scale_lanes), deg_to_rad), s[k], c[k]);
+	}
+}
+
+static void RotatorsToQuatsSSE2(YQuat* out, const YRotator* rotators, size_t count)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 s[3], c[3];
+		RotatorSinCosLanes(rotators + i, 0.5f, s, c);
+		const __m128 sp = s[0], cp = c[0], sy = s[1], cy = c[1], sr = s[2], cr = c[2];
+		__m128 x = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(sp, cy), cr), _mm_mul_ps(_mm_mul_ps(cp, sy), sr));
+		__m128 y = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cp, sy), cr), _mm_mul_ps(_mm_mul_ps(sp, cy), sr));
+		__m128 z = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(NegateLanes(sp), sy), cr), _mm_mul_ps(_mm_mul_ps(cp, cy), sr));
+		__m128 w = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(cp, cy), cr), _mm_mul_ps(_mm_mul_ps(sp, sy), sr));
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(&out[i].x, x);
+		_mm_storeu_ps(&out[i + 1].x, y);
+		_mm_storeu_ps(&out[i + 2].x, z);
+		_mm_storeu_ps(&out[i + 3].x, w);
+	}
+	if (i < count)
+	{
+		YRotator tail_rotators[4] = {};
+		YQuat tail_quats[4];
+		memcpy(tail_rotators, rotators + i, (count - i) * sizeof(YRotator));
+		RotatorsToQuatsSSE2(tail_quats, tail_rotators, 4);
+		memcpy(out + i, tail_quats, (count - i) * sizeof(YQuat));
+	}
+}
+
+// rotation rows with one matrix per lane to four matrices, the last row and column of identity
+static inline void StoreRotationLanes(YMatrix* out, __m128 (&r)[3][3])
+{
+	__m128 row_w[3] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+	for (int row = 0; row < 3; ++row)
+	{
+		_MM_TRANSPOSE4_PS(r[row][0], r[row][1], r[row][2], row_w[row]);
+	}
+	const __m128 last_row = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+	const __m128 rows[4][3] = { { r[0][0], r[1][0], r[2][0] }, { r[0][1], r[1][1], r[2][1] }, { r[0][2], r[1][2], r[2][2] }, { row_w[0], row_w[1], row_w[2] } };
+	for (int j = 0; j < 4; ++j)
+	{
+		for (int k = 0; k < 3; ++k)
+		{
+			_mm_store_ps(out[j].m[k], rows[j][k]);
+		}
+		_mm_store_ps(out[j].m[3], last_row);
+	}
+}
+
+static void RotatorsToMatricesSSE2(YMatrix* out, const YRotator* rotators, size_t count)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 s[3], c[3];
+		RotatorSinCosLanes(rotators + i, 1.0f, s, c);
+		const __m128 sp = s[0], cp = c[0], sy = s[1], cy = c[1], sr = s[2], cr = c[2];
+		__m128 r[3][3];
+		r[0][0] = _mm_mul_ps(cy, cr);
+		r[0][1] = _mm_mul_ps(cy, sr);
+		r[0][2] = NegateLanes(sy);
+		r[1][0] = _mm_add_ps(_mm_mul_ps(NegateLanes(cp), sr), _mm_mul_ps(_mm_mul_ps(sp, sy), cr));
+		r[1][1] = _mm_add_ps(_mm_mul_ps(cp, cr), _mm_mul_ps(_mm_mul_ps(sp, sy), sr));
+		r[1][2] = _mm_mul_ps(sp, cy);
+		r[2][0] = _mm_add_ps(_mm_mul_ps(sp, sr), _mm_mul_ps(_mm_mul_ps(cp, sy), cr));
+		r[2][1] = _mm_add_ps(_mm_mul_ps(NegateLanes(sp), cr), _mm_mul_ps(_mm_mul_ps(cp, sy), sr));
+		r[2][2] = _mm_mul_ps(cp, cy);
+		StoreRotationLanes(out + i, r);
+	}
+	if (i < count)
+	{
+		YRotator tail_rotators[4] = {};
+		YMatrix tail_matrices[4];
+		memcpy(tail_rotators, rotators + i, (count - i) * sizeof(YRotator));
+		RotatorsToMatricesSSE2(tail_matrices, tail_rotators, 4);
+		memcpy(out + i, tail_matrices, (count - i) * sizeof(YMatrix));
+	}
+}
+
+static inline void LoadQuats4(const YQuat* quats, __m128& x, __m128& y, __m128& z, __m128& w)
+{
+	x = _mm_loadu_ps(&quats[0].x);
+	y = _mm_loadu_ps(&quats[1].x);
+	z = _mm_loadu_ps(&quats[2].x);
+	w = _mm_loadu_ps(&quats[3].x);
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+static void QuatsToMatricesSSE2(YMatrix* out, const YQuat* quats, size_t count)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z, w;
+		LoadQuats4(quats + i, x, y, z, w);
+		__m128 r[3][3];
+		QuatRotationLanes(x, y, z, w, r);
+		StoreRotationLanes(out + i, r);
+	}
+	QuatsToMatricesScalar(out + i, quats + i, count - i);
+}
+
+// YMath::Atan2 per lane, the same minimax polynomial and operations
+static inline __m128 Atan2Lanes(__m128 y, __m128 x)
+{
+	const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+	const __m128 abs_x = _mm_andnot_ps(sign_mask, x);
+	const __m128 abs_y = _mm_andnot_ps(sign_mask, y);
+	const __m128 y_abs_bigger = _mm_cmpgt_ps(abs_y, abs_x);
+	const __m128 t0 = SelectLanes(y_abs_bigger, abs_y, abs_x);
+	const __m128 t1 = SelectLanes(y_abs_bigger, abs_x, abs_y);
+	const __m128 zero = _mm_setzero_ps();
+	// 0 / 0 lanes are dropped at the end
+	__m128 t3 = _mm_div_ps(t1, t0);
+	const __m128 t4 = _mm_mul_ps(t3, t3);
+	__m128 poly = _mm_set1_ps(+7.2128853633444123e-03f);
+	poly = _mm_add_ps(_mm_mul_ps(poly, t4), _mm_set1_ps(-3.5059680836411644e-02f));
+	poly = _mm_add_ps(_mm_mul_ps(poly, t4), _mm_set1_ps(+8.1675882859940430e-02f));
+	poly = _mm_add_ps(_mm_mul_ps(poly, t4), _mm_set1_ps(-1.3374657325451267e-01f));
+	poly = _mm_add_ps(_mm_mul_ps(poly, t4), _mm_set1_ps(+1.9856563505717162e-01f));
+	poly = _mm_add_ps(_mm_mul_ps(poly, t4), _mm_set1_ps(-3.3324998579202170e-01f));
+	poly = _mm_add_ps(_mm_mul_ps(poly, t4), _mm_set1_ps(1.0f));
+	t3 = _mm_mul_ps(poly, t3);
+	t3 = SelectLanes(y_abs_bigger, _mm_sub_ps(_mm_set1_ps(0.5f * PI), t3), t3);
+	t3 = SelectLanes(_mm_cmplt_ps(x, zero), _mm_sub_ps(_mm_set1_ps(PI), t3), t3);
+	t3 = SelectLanes(_mm_cmplt_ps(y, zero), NegateLanes(t3), t3);
+	return _mm_andnot_ps(_mm_cmpeq_ps(t0, zero), t3);
+}
+
+// YMath::FastAsin per lane
+static inline __m128 FastAsinLanes(__m128 value)
+{
+	const __m128 half_pi = _mm_set1_ps(1.5707963050f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 nonnegative = _mm_cmpge_ps(value, zero);
+	const __m128 x = _mm_andnot_ps(_mm_castsi128_ps(_mm_set1_epi32((int)0x80000000)), value);
+	__m128 omx = _mm_sub_ps(_mm_set1_ps(1.0f), x);
+	omx = _mm_andnot_ps(_mm_cmplt_ps(omx, zero), omx);
+	const __m128 root = _mm_sqrt_ps(omx);
+	__m128 result = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.0012624911f), x), _mm_set1_ps(0.0066700901f));
+	result = _mm_sub_ps(_mm_mul_ps(result, x), _mm_set1_ps(0.0170881256f));
+	result = _mm_add_ps(_mm_mul_ps(result, x), _mm_set1_ps(0.0308918810f));
+	result = _mm_sub_ps(_mm_mul_ps(result, x), _mm_set1_ps(0.0501743046f));
+	result = _mm_add_ps(_mm_mul_ps(result, x), _mm_set1_ps(0.0889789874f));
+	result = _mm_sub_ps(_mm_mul_ps(result, x), _mm_set1_ps(0.2145988016f));
+	result = _mm_add_ps(_mm_mul_ps(result, x), half_pi);
+	result = _mm_mul_ps(result, root);
+	return SelectLanes(nonnegative, _mm_sub_ps(half_pi, result), _mm_sub_ps(result, half_pi));
+}
+
+// YQuat::Rotator, lanes near the gimbal lock singularity go through the scalar function
+static void QuatsToRotatorsSSE2(YRotator* out, const YQuat* quats, size_t count)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 threshold = _mm_set1_ps(0.4999995f);
+	const __m128 rad_to_deg = _mm_set1_ps((180.f) / PI);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z, w;
+		LoadQuats4(quats + i, x, y, z, w);
+		const __m128 singularity_test = _mm_sub_ps(_mm_mul_ps(w, y), _mm_mul_ps(x, z));
+		const __m128 pitch_sin = _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(w, x), _mm_mul_ps(y, z)));
+		const __m128 pitch_cos = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+		const __m128 pitch = _mm_mul_ps(Atan2Lanes(pitch_sin, pitch_cos), rad_to_deg);
+		const __m128 yaw = _mm_mul_ps(FastAsinLanes(_mm_mul_ps(two, singularity_test)), rad_to_deg);
+		const __m128 roll = _mm_mul_ps(Atan2Lanes(_mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(x, y), _mm_mul_ps(w, z))),
+			_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(_mm_mul_ps(y, y), _mm_mul_ps(z, z))))), rad_to_deg);
+		StoreVectors4(reinterpret_cast<YVector*>(out + i), pitch, yaw, roll);
+		const int singular = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(singularity_test, NegateLanes(threshold)), _mm_cmpgt_ps(singularity_test, threshold)));
+		for (int lane = 0; singular && lane < 4; ++lane)
+		{
+			if (singular & (1 << lane))
+			{
+				out[i + lane] = quats[i + lane].Rotator();
+			}
+		}
+	}
+	QuatsToRotatorsScalar(out + i, quats + i, count - i);
+}
+
+// YQuat::RotateVector, v' = v + w * t + q x t with t = 2 * (q x v)
+struct YQuatLanes
+{
+	__m128 x, y, z, w;
+	explicit YQuatLanes(const YQuat& quat)
+		:x(_mm_set1_ps(quat.x)), y(_mm_set1_ps(quat.y)), z(_mm_set1_ps(quat.z)), w(_mm_set1_ps(quat.w))
+	{
+	}
+};
+
+static inline void RotateLanes(const YQuatLanes& q, __m128& vx, __m128& vy, __m128& vz)
+{
+	const __m128 two = _mm_set1_ps(2.0f);
+	__m128 tx, ty, tz, cx, cy, cz;
+	CrossLanes(q.x, q.y, q.z, vx, vy, vz, tx, ty, tz);
+	tx = _mm_mul_ps(tx, two);
+	ty = _mm_mul_ps(ty, two);
+	tz = _mm_mul_ps(tz, two);
+	CrossLanes(q.x, q.y, q.z, tx, ty, tz, cx, cy, cz);
+	vx = _mm_add_ps(_mm_add_ps(vx, _mm_mul_ps(tx, q.w)), cx);
+	vy = _mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(ty, q.w)), cy);
+	vz = _mm_add_ps(_mm_add_ps(vz, _mm_mul_ps(tz, q.w)), cz);
+}
+
+static void RotateVectorsSSE2(YVector* out, const YQuat& quat, const YVector* v, size_t count)
+{
+	const YQuatLanes q(quat);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x, y, z;
+		LoadVectors4(v + i, x, y, z);
+		RotateLanes(q, x, y, z);
+		StoreVectors4(out + i, x, y, z);
+	}
+	RotateVectorsScalar(out + i, quat, v + i, count - i);
+}
+
+static void RotateVectorsSoASSE2(const YVectorSoA& out, const YQuat& quat, const YVectorSoA& v, size_t count)
+{
+	const YQuatLanes q(quat);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 x = _mm_loadu_ps(v.x + i), y = _mm_loadu_ps(v.y + i), z = _mm_loadu_ps(v.z + i);
+		RotateLanes(q, x, y, z);
+		_mm_storeu_ps(out.x + i, x);
+		_mm_storeu_ps(out.y + i, y);
+		_mm_storeu_ps(out.z + i, z);
+	}
+	RotateVectorsSoAScalar(OffsetSoA(out, i), quat, OffsetSoA(v, i), count - i);
+}
+
+static constexpr YRotationKernels rotation_kernels_sse2 = { &SinCosSSE2, &RotatorsToQuatsSSE2, &RotatorsToMatricesSSE2, &QuatsToMatricesSSE2,
+	&QuatsToRotatorsSSE2, &RotateVectorsSSE2, &RotateVectorsSoASSE2 };
+
+/*-----------------------------------------------------------------------------
+	avx2, two rows per register and fma
+-----------------------------------------------------------------------------*/
+
+YMATH_TARGET_AVX2 static void MultiplyAVX2(YMatrix& out, const YMatrix& matrix1, const YMatrix& matrix2)
+{
+	const __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix2.m[0]));
+	const __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix2.m[1]));
+	const __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix2.m[2]));
+	const __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix2.m[3]));
+	const __m256 a01 = _mm256_loadu_ps(matrix1.m[0]);
+	const __m256 a23 = _mm256_loadu_ps(matrix1.m[2]);
+	__m256 r01 = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), row0);
+	__m256 r23 = _mm256_mul_ps(_mm256_shuffle_ps(a23, a23, 0x00), row0);
+	r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0x55), row1, r01);
+	r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0x55), row1, r23);
+	r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xaa), row2, r01);
+	r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xaa), row2, r23);
+	r01 = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xff), row3, r01);
+	r23 = _mm256_fmadd_ps(_mm256_shuffle_ps(a23, a23, 0xff), row3, r23);
+	_mm256_storeu_ps(out.m[0], r01);
+	_mm256_storeu_ps(out.m[2], r23);
+	// msvc does not insert it for code built without /arch:AVX
+	_mm256_zeroupper();
+}
+
+static constexpr YMatrixKernels matrix_kernels_avx2 = { &MultiplyAVX2, &DeterminantSSE2, &InverseSSE2, &TransformVector4SSE2, &TransposeSSE2 };
+
+template<bool translate>
+YMATH_TARGET_AVX2_NO_FMA static void TransformSoAAVX2(const YVectorSoA& out, const YMatrix& matrix, const YVectorSoA& in, size_t count)
+{
+	__m256 m[4][3];
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			m[i][j] = _mm256_set1_ps(matrix.m[i][j]);
+		}
+	}
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m256 x = _mm256_loadu_ps(in.x + i), y = _mm256_loadu_ps(in.y + i), z = _mm256_loadu_ps(in.z + i);
+		float* out_streams[3] = { out.x + i, out.y + i, out.z + i };
+		__m256 r[3];
+		for (int j = 0; j < 3; ++j)
+		{
+			r[j] = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, m[0][j]), _mm256_mul_ps(y, m[1][j])), _mm256_mul_ps(z, m[2][j]));
+			if (translate)
+			{
+				r[j] = _mm256_add_ps(r[j], m[3][j]);
+			}
+		}
+		for (int j = 0; j < 3; ++j)
+		{
+			_mm256_storeu_ps(out_streams[j], r[j]);
+		}
+	}
+	_mm256_zeroupper();
+	TransformSoASSE2<translate>(OffsetSoA(out, i), matrix, OffsetSoA(in, i), count - i);
+}
+
+YMATH_TARGET_AVX2_NO_FMA static void NormalizeSoAAVX2(const YVectorSoA& out, const YVectorSoA& v, size_t count, float tolerance)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 tolerance_lanes = _mm256_set1_ps(tolerance);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m256 x = _mm256_loadu_ps(v.x + i), y = _mm256_loadu_ps(v.y + i), z = _mm256_loadu_ps(v.z + i);
+		const __m256 square_sum = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+		const __m256 scale = _mm256_div_ps(one, _mm256_sqrt_ps(square_sum));
+		const __m256 keep = _mm256_cmp_ps(square_sum, one, _CMP_EQ_OQ);
+		const __m256 valid = _mm256_cmp_ps(square_sum, tolerance_lanes, _CMP_GE_OQ);
+		_mm256_storeu_ps(out.x + i, _mm256_and_ps(valid, _mm256_blendv_ps(_mm256_mul_ps(x, scale), x, keep)));
+		_mm256_storeu_ps(out.y + i, _mm256_and_ps(valid, _mm256_blendv_ps(_mm256_mul_ps(y, scale), y, keep)));
+		_mm256_storeu_ps(out.z + i, _mm256_and_ps(valid, _mm256_blendv_ps(_mm256_mul_ps(z, scale), z, keep)));
+	}
+	_mm256_zeroupper();
+	NormalizeSoASSE2(OffsetSoA(out, i), OffsetSoA(v, i), count - i, tolerance);
+}
+
+// two registers per iteration, the same rows in both halves
+YMATH_TARGET_AVX2_NO_FMA static void TransformVectors4AVX2(YVectorRegister* out, const YMatrix& matrix, const YVectorRegister* v, size_t count)
+{
+	const __m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix.m[0]));
+	const __m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix.m[1]));
+	const __m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix.m[2]));
+	const __m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(matrix.m[3]));
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		// the pair is 16 byte aligned only
+		const __m256 vec = _mm256_loadu_ps(&v[i].x);
+		__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(vec, vec, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(vec, vec, _MM_SHUFFLE(1, 1, 1, 1)), row1));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(vec, vec, _MM_SHUFFLE(2, 2, 2, 2)), row2));
+		r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(vec, vec, _MM_SHUFFLE(3, 3, 3, 3)), row3));
+		_mm256_storeu_ps(&out[i].x, r);
+	}
+	_mm256_zeroupper();
+	TransformVectors4SSE2(out + i, matrix, v + i, count - i);
+}
+
+// the aos kernels stay on sse2, deinterleaving eight vectors costs more than the wider lanes save
+static constexpr YVectorKernels vector_kernels_avx2 = { &TransformAoSSSE2<true>, &TransformSoAAVX2<true>, &TransformAoSSSE2<false>, &TransformSoAAVX2<false>,
+	&NormalizeSSE2, &NormalizeSoAAVX2, &CrossSSE2, &CrossSoASSE2, &MinMaxSSE2, &MinMaxSoASSE2,
+	&TransformVectors4AVX2 };
+
+YMatrixKernels YMathKernels::matrix = matrix_kernels_sse2;
+YTransformKernels YMathKernels::transform = transform_kernels_sse2;
+YVectorKernels YMathKernels::vector = vector_kernels_sse2;
+YRotationKernels YMathKernels::rotation = rotation_kernels_sse2;
+#else
+YMatrixKernels YMathKernels::matrix = matrix_kernels_scalar;
+YTransformKernels YMathKernels::transform = transform_kernels_scalar;
+YVectorKernels YMathKernels::vector = vector_kernels_scalar;
+YRotationKernels YMathKernels::rotation = rotation_kernels_scalar;
+#endif
+
+const YMatrixKernels& YMathKernels::GetMatrixKernels(ESimdLevel level)
+{
+#if YMATH_SSE
+	if (level >= SL_AVX2 && YSimd::GetMaxSimdLevel() >= SL_AVX2)
+	{
+		return matrix_kernels_avx2;
+	}
+	if (level >= SL_SSE2)
+	{
+		return matrix_kernels_sse2;
+	}
+#endif
+	return matrix_kernels_scalar;
+}
+
+const YTransformKernels& YMathKernels::GetTransformKernels(ESimdLevel level)
+{
+#if YMATH_SSE
+	// avx2 would only widen the lanes, the transposes dominate
+	if (level >= SL_SSE2)
+	{
+		return transform_kernels_sse2;
+	}
+#endif
+	return transform_kernels_scalar;
+}
+
+const YVectorKernels& YMathKernels::GetVectorKernels(ESimdLevel level)
+{
+#if YMATH_SSE
+	if (level >= SL_AVX2 && YSimd::GetMaxSimdLevel() >= SL_AVX2)
+	{
+		return vector_kernels_avx2;
+	}
+	if (level >= SL_SSE2)
+	{
+		return vector_kernels_sse2;
+	}
+#endif
+	return vector_kernels_scalar;
+}
+
+const YRotationKernels& YMathKernels::GetRotationKernels(ESimdLevel level)
+{
+#if YMATH_SSE
+	// the sincos and atan2 polynomials are short next to the transposes, avx2 keeps the sse2 table
+	if (level >= SL_SSE2)
+	{
+		return rotation_kernels_sse2;
+	}
+#endif
+	return rotation_kernels_scalar;
+}
+
+void YMathKernels::Select(ESimdLevel level)
+{
+	matrix = GetMatrixKernels(level);
+	transform = GetTransformKernels(level);
+	vector = GetVectorKernels(level);
+	rotation = GetRotationKernels(level);
+}
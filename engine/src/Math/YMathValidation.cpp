@@ -0,0 +1,1087 @@
+#include "Math/YMathValidation.h"
+#include "Math/YBatchMath.h"
+#include "Math/YMatrix.h"
+#include "Math/YQuaterion.h"
+#include "Math/YRotator.h"
+#include "Math/YSimd.h"
+#include "Math/YTransform.h"
+#include "Math/YVector.h"
+#include "Math/YVectorRegister.h"
+#include "Engine/YLog.h"
+#include "Utility/YJsonHelper.h"
+#include "Utility/YJsonWriter.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+/*-----------------------------------------------------------------------------
+	double precision references, the same conventions as the float types
+-----------------------------------------------------------------------------*/
+
+static const double validation_pi = 3.14159265358979323846;
+
+struct YDoubleMatrix
+{
+	double m[4][4];
+};
+
+static YDoubleMatrix ToDouble(const YMatrix& matrix)
+{
+	YDoubleMatrix result;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			result.m[i][j] = matrix.m[i][j];
+		}
+	}
+	return result;
+}
+
+static YDoubleMatrix DoubleIdentity()
+{
+	YDoubleMatrix result = {};
+	for (int i = 0; i < 4; ++i)
+	{
+		result.m[i][i] = 1.0;
+	}
+	return result;
+}
+
+static YDoubleMatrix DoubleMultiply(const YDoubleMatrix& a, const YDoubleMatrix& b)
+{
+	YDoubleMatrix result;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			result.m[i][j] = a.m[i][0] * b.m[0][j] + a.m[i][1] * b.m[1][j] + a.m[i][2] * b.m[2][j] + a.m[i][3] * b.m[3][j];
+		}
+	}
+	return result;
+}
+
+// gauss jordan with partial pivoting, false for a singular matrix
+static bool DoubleInverse(YDoubleMatrix& out, const YDoubleMatrix& matrix)
+{
+	double a[4][8];
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			a[i][j] = matrix.m[i][j];
+			a[i][j + 4] = i == j ? 1.0 : 0.0;
+		}
+	}
+	for (int column = 0; column < 4; ++column)
+	{
+		int pivot = column;
+		for (int i = column + 1; i < 4; ++i)
+		{
+			if (fabs(a[i][column]) > fabs(a[pivot][column]))
+			{
+				pivot = i;
+			}
+		}
+		if (a[pivot][column] == 0.0)
+		{
+			return false;
+		}
+		for (int j = 0; j < 8; ++j)
+		{
+			std::swap(a[column][j], a[pivot][j]);
+		}
+		const double scale = 1.0 / a[column][column];
+		for (int j = 0; j < 8; ++j)
+		{
+			a[column][j] *= scale;
+		}
+		for (int i = 0; i < 4; ++i)
+		{
+			if (i != column && a[i][column] != 0.0)
+			{
+				const double factor = a[i][column];
+				for (int j = 0; j < 8; ++j)
+				{
+					a[i][j] -= factor * a[column][j];
+				}
+			}
+		}
+	}
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			out.m[i][j] = a[i][j + 4];
+		}
+	}
+	return true;
+}
+
+static double DoubleDeterminant(const YDoubleMatrix& matrix)
+{
+	double a[4][4];
+	memcpy(a, matrix.m, sizeof(a));
+	double determinant = 1.0;
+	for (int column = 0; column < 4; ++column)
+	{
+		int pivot = column;
+		for (int i = column + 1; i < 4; ++i)
+		{
+			if (fabs(a[i][column]) > fabs(a[pivot][column]))
+			{
+				pivot = i;
+			}
+		}
+		if (a[pivot][column] == 0.0)
+		{
+			return 0.0;
+		}
+		if (pivot != column)
+		{
+			for (int j = 0; j < 4; ++j)
+			{
+				std::swap(a[column][j], a[pivot][j]);
+			}
+			determinant = -determinant;
+		}
+		determinant *= a[column][column];
+		for (int i = column + 1; i < 4; ++i)
+		{
+			const double factor = a[i][column] / a[column][column];
+			for (int j = column; j < 4; ++j)
+			{
+				a[i][j] -= factor * a[column][j];
+			}
+		}
+	}
+	return determinant;
+}
+
+// largest row sum
+static double NormInf(const YDoubleMatrix& matrix)
+{
+	double norm = 0.0;
+	for (int i = 0; i < 4; ++i)
+	{
+		norm = std::max(norm, fabs(matrix.m[i][0]) + fabs(matrix.m[i][1]) + fabs(matrix.m[i][2]) + fabs(matrix.m[i][3]));
+	}
+	return norm;
+}
+
+static double MaxAbs(const YDoubleMatrix& matrix)
+{
+	double result = 0.0;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			result = std::max(result, fabs(matrix.m[i][j]));
+		}
+	}
+	return result;
+}
+
+static double MaxDifference(const YMatrix& matrix, const YDoubleMatrix& reference)
+{
+	double result = 0.0;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			result = std::max(result, fabs(matrix.m[i][j] - reference.m[i][j]));
+		}
+	}
+	return result;
+}
+
+// error of dot products over the error rounding may give them, (sum of |a_k * b_k|) * FLT_EPSILON
+// product is matrix1 * matrix2
+static double ProductError(const YMatrix& product, const YMatrix& matrix1, const YMatrix& matrix2)
+{
+	double result = 0.0;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			double value = 0.0, magnitude = 0.0;
+			for (int k = 0; k < 4; ++k)
+			{
+				value += (double)matrix1.m[i][k] * matrix2.m[k][j];
+				magnitude += fabs((double)matrix1.m[i][k] * matrix2.m[k][j]);
+			}
+			result = std::max(result, fabs(product.m[i][j] - value) / std::max(magnitude * FLT_EPSILON, DBL_MIN));
+		}
+	}
+	return result;
+}
+
+// the row vector v times matrix, count components of each
+static double TransformError(const float* transformed, const float* v, int count, const YMatrix& matrix)
+{
+	double result = 0.0;
+	for (int j = 0; j < count; ++j)
+	{
+		double value = 0.0, magnitude = 0.0;
+		for (int k = 0; k < 4; ++k)
+		{
+			// positions have an implicit w of 1
+			const double component = k < count ? v[k] : 1.0;
+			value += component * matrix.m[k][j];
+			magnitude += fabs(component * matrix.m[k][j]);
+		}
+		result = std::max(result, fabs(transformed[j] - value) / std::max(magnitude * FLT_EPSILON, DBL_MIN));
+	}
+	return result;
+}
+
+// error of an affine matrix, each axis row over its own length and the origin over the longer of itself and the axes,
+// so neither a large translation nor a large scale on one axis hides the error of the others
+static double AffineDifference(const YMatrix& matrix, const YDoubleMatrix& reference)
+{
+	double result = 0.0;
+	double largest_axis = 0.0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const double axis = sqrt(reference.m[i][0] * reference.m[i][0] + reference.m[i][1] * reference.m[i][1] + reference.m[i][2] * reference.m[i][2]);
+		largest_axis = std::max(largest_axis, axis);
+		for (int j = 0; j < 3; ++j)
+		{
+			result = std::max(result, fabs(matrix.m[i][j] - reference.m[i][j]) / axis);
+		}
+	}
+	const double origin = std::max({ fabs(reference.m[3][0]), fabs(reference.m[3][1]), fabs(reference.m[3][2]), largest_axis });
+	for (int j = 0; j < 3; ++j)
+	{
+		result = std::max(result, fabs(matrix.m[3][j] - reference.m[3][j]) / origin);
+	}
+	return result;
+}
+
+// YQuat::ToMatrix
+static YDoubleMatrix DoubleQuatMatrix(const YQuat& quat)
+{
+	const double x = quat.x, y = quat.y, z = quat.z, w = quat.w;
+	YDoubleMatrix result = DoubleIdentity();
+	result.m[0][0] = 1.0 - 2.0 * (y * y + z * z);
+	result.m[0][1] = 2.0 * (x * y + w * z);
+	result.m[0][2] = 2.0 * (x * z - w * y);
+	result.m[1][0] = 2.0 * (x * y - w * z);
+	result.m[1][1] = 1.0 - 2.0 * (x * x + z * z);
+	result.m[1][2] = 2.0 * (w * x + y * z);
+	result.m[2][0] = 2.0 * (w * y + x * z);
+	result.m[2][1] = 2.0 * (y * z - w * x);
+	result.m[2][2] = 1.0 - 2.0 * (x * x + y * y);
+	return result;
+}
+
+// YRotator::ToMatrix
+static YDoubleMatrix DoubleRotatorMatrix(double pitch, double yaw, double roll)
+{
+	const double to_radians = validation_pi / 180.0;
+	const double sp = sin(pitch * to_radians), cp = cos(pitch * to_radians);
+	const double sy = sin(yaw * to_radians), cy = cos(yaw * to_radians);
+	const double sr = sin(roll * to_radians), cr = cos(roll * to_radians);
+	YDoubleMatrix result = DoubleIdentity();
+	result.m[0][0] = cy * cr;
+	result.m[0][1] = cy * sr;
+	result.m[0][2] = -sy;
+	result.m[1][0] = -cp * sr + sp * sy * cr;
+	result.m[1][1] = cp * cr + sp * sy * sr;
+	result.m[1][2] = sp * cy;
+	result.m[2][0] = sp * sr + cp * sy * cr;
+	result.m[2][1] = -sp * cr + cp * sy * sr;
+	result.m[2][2] = cp * cy;
+	return result;
+}
+
+// YRotator::ToQuat, x y z w
+static void DoubleRotatorQuat(const YRotator& rotator, double (&quat)[4])
+{
+	const double to_radians = validation_pi / 180.0;
+	const double sp = sin(rotator.pitch * 0.5 * to_radians), cp = cos(rotator.pitch * 0.5 * to_radians);
+	const double sy = sin(rotator.yaw * 0.5 * to_radians), cy = cos(rotator.yaw * 0.5 * to_radians);
+	const double sr = sin(rotator.roll * 0.5 * to_radians), cr = cos(rotator.roll * 0.5 * to_radians);
+	quat[0] = sp * cy * cr - cp * sy * sr;
+	quat[1] = cp * sy * cr + sp * cy * sr;
+	quat[2] = -sp * sy * cr + cp * cy * sr;
+	quat[3] = cp * cy * cr + sp * sy * sr;
+}
+
+// YTransform::ToMatrix, scale then rotation then translation
+static YDoubleMatrix DoubleTransformMatrix(const YTransform& transform)
+{
+	YDoubleMatrix result = DoubleQuatMatrix(transform.rotator);
+	const double scale[3] = { transform.scale.x, transform.scale.y, transform.scale.z };
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			result.m[i][j] *= scale[i];
+		}
+	}
+	result.m[3][0] = transform.translation.x;
+	result.m[3][1] = transform.translation.y;
+	result.m[3][2] = transform.translation.z;
+	return result;
+}
+
+// YQuat::RotateVector
+static void DoubleRotateVector(const YQuat& quat, const YVector& v, double (&out)[3])
+{
+	const double q[3] = { quat.x, quat.y, quat.z };
+	const double w = quat.w;
+	const double p[3] = { v.x, v.y, v.z };
+	const double t[3] = { 2.0 * (q[1] * p[2] - q[2] * p[1]), 2.0 * (q[2] * p[0] - q[0] * p[2]), 2.0 * (q[0] * p[1] - q[1] * p[0]) };
+	const double c[3] = { q[1] * t[2] - q[2] * t[1], q[2] * t[0] - q[0] * t[2], q[0] * t[1] - q[1] * t[0] };
+	for (int i = 0; i < 3; ++i)
+	{
+		out[i] = p[i] + w * t[i] + c[i];
+	}
+}
+
+static double MaxDifference(const YDoubleMatrix& matrix, const YDoubleMatrix& reference)
+{
+	double result = 0.0;
+	for (int i = 0; i < 4; ++i)
+	{
+		for (int j = 0; j < 4; ++j)
+		{
+			result = std::max(result, fabs(matrix.m[i][j] - reference.m[i][j]));
+		}
+	}
+	return result;
+}
+
+static double MaxDifference(const YVector& v, const double (&reference)[3])
+{
+	return std::max({ fabs(v.x - reference[0]), fabs(v.y - reference[1]), fabs(v.z - reference[2]) });
+}
+
+static double MaxAbs(const double (&v)[3])
+{
+	return std::max({ fabs(v[0]), fabs(v[1]), fabs(v[2]) });
+}
+
+/*-----------------------------------------------------------------------------
+	inputs
+-----------------------------------------------------------------------------*/
+
+struct YValidationRandom
+{
+	std::mt19937 engine;
+	explicit YValidationRandom(uint32_t seed) :engine(seed) {}
+	float Uniform(float min_value, float max_value)
+	{
+		return std::uniform_real_distribution<float>(min_value, max_value)(engine);
+	}
+	// log uniform, for scales over several orders of magnitude
+	float LogUniform(float min_value, float max_value)
+	{
+		return expf(Uniform(logf(min_value), logf(max_value)));
+	}
+	YVector Vector(float min_value, float max_value)
+	{
+		return YVector(Uniform(min_value, max_value), Uniform(min_value, max_value), Uniform(min_value, max_value));
+	}
+	YRotator Rotator()
+	{
+		return YRotator(Uniform(-180.0f, 180.0f), Uniform(-180.0f, 180.0f), Uniform(-180.0f, 180.0f));
+	}
+	// uniform over the rotations
+	YQuat Quat()
+	{
+		std::normal_distribution<double> normal;
+		double q[4];
+		double length_squared = 0.0;
+		do
+		{
+			length_squared = 0.0;
+			for (double& component : q)
+			{
+				component = normal(engine);
+				length_squared += component * component;
+			}
+		} while (length_squared < 1e-6);
+		const double scale = 1.0 / sqrt(length_squared);
+		return YQuat((float)(q[0] * scale), (float)(q[1] * scale), (float)(q[2] * scale), (float)(q[3] * scale));
+	}
+	// scale from min_scale to max_scale, each axis negative with negative_chance
+	YTransform Transform(float min_scale, float max_scale, float negative_chance)
+	{
+		YVector scale(LogUniform(min_scale, max_scale), LogUniform(min_scale, max_scale), LogUniform(min_scale, max_scale));
+		for (int i = 0; i < 3; ++i)
+		{
+			if (Uniform(0.0f, 1.0f) < negative_chance)
+			{
+				scale[i] = -scale[i];
+			}
+		}
+		return YTransform(Vector(-1000.0f, 1000.0f), Quat(), scale);
+	}
+};
+
+/*-----------------------------------------------------------------------------
+	report
+-----------------------------------------------------------------------------*/
+
+struct YErrorStats
+{
+	double max = 0.0;
+	double sum = 0.0;
+	size_t samples = 0;
+	void Add(double error)
+	{
+		// nan has to fail the bound
+		max = (error > max || error != error) ? error : max;
+		sum += error;
+		++samples;
+	}
+};
+
+// one accuracy entry, true when max is within bound
+static bool WriteAccuracy(YJsonWriter& writer, const char* name, const char* metric, const YErrorStats& stats, double bound)
+{
+	const bool pass = stats.max <= bound;
+	writer.BeginObject();
+	writer.Key("name").WriteString(name);
+	writer.Key("metric").WriteString(metric);
+	writer.Key("samples").WriteUInt(stats.samples);
+	writer.Key("max").WriteDouble(stats.max);
+	writer.Key("mean").WriteDouble(stats.samples ? stats.sum / (double)stats.samples : 0.0);
+	writer.Key("bound").WriteDouble(bound);
+	writer.Key("pass").WriteBool(pass);
+	writer.EndObject();
+	if (!pass)
+	{
+		WARNING_INFO("math validation ", name, " at ", YSimd::GetSimdLevelName(YSimd::GetSimdLevel()), " is over its bound, ", stats.max, " > ", bound);
+	}
+	return pass;
+}
+
+// the fastest of repeat runs of count operations
+static void WriteBenchmark(YJsonWriter& writer, const char* name, size_t count, int repeat, const std::function<void()>& run)
+{
+	double best_ns = 0.0;
+	for (int i = 0; i < std::max(repeat, 1); ++i)
+	{
+		const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+		run();
+		const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+		best_ns = i == 0 ? ns : std::min(best_ns, ns);
+	}
+	best_ns = std::max(best_ns, 1.0);
+	writer.BeginObject();
+	writer.Key("name").WriteString(name);
+	writer.Key("count").WriteUInt(count);
+	writer.Key("ns_per_op").WriteDouble(best_ns / (double)count);
+	writer.Key("mops").WriteDouble((double)count * 1000.0 / best_ns);
+	writer.EndObject();
+}
+
+/*-----------------------------------------------------------------------------
+	benchmarks, array_size elements each
+-----------------------------------------------------------------------------*/
+
+static void WriteBenchmarks(YJsonWriter& writer, const YMathValidationOptions& options)
+{
+	const size_t count = std::max<size_t>(options.array_size, 1);
+	const int repeat = options.repeat;
+	YValidationRandom random(options.seed);
+	// the second operands cycle through a small set that stays in cache
+	const size_t operand_mask = 1023;
+
+	std::vector<YTransform> transforms(count);
+	std::vector<YMatrix> matrices(count);
+	std::vector<YMatrix> out_matrices(count);
+	std::vector<YMatrix> operands(operand_mask + 1);
+	for (size_t i = 0; i < count; ++i)
+	{
+		transforms[i] = random.Transform(0.1f, 10.0f, 0.0f);
+	}
+	YTransform::ToMatrices(matrices.data(), transforms.data(), count);
+	for (YMatrix& operand : operands)
+	{
+		operand = random.Transform(0.1f, 10.0f, 0.0f).ToMatrix();
+	}
+
+	writer.Key("benchmarks").BeginArray();
+	WriteBenchmark(writer, "matrix_multiply", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				YMatrix::MatrixMuliply(out_matrices[i], matrices[i], operands[i & operand_mask]);
+			}
+		});
+	WriteBenchmark(writer, "matrix_inverse", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_matrices[i] = matrices[i].Inverse();
+			}
+		});
+	WriteBenchmark(writer, "matrix_transpose", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_matrices[i] = matrices[i].GetTransposed();
+			}
+		});
+	{
+		std::vector<float> determinants(count);
+		WriteBenchmark(writer, "matrix_determinant", count, repeat, [&]()
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					determinants[i] = matrices[i].Determinant();
+				}
+			});
+	}
+	{
+		std::vector<YTransform> out_transforms(count);
+		WriteBenchmark(writer, "matrix_decompose", count, repeat, [&]()
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					matrices[i].Decompose(out_transforms[i].translation, out_transforms[i].rotator, out_transforms[i].scale);
+				}
+			});
+		WriteBenchmark(writer, "transform_multiply", count, repeat, [&]()
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					out_transforms[i] = transforms[i] * transforms[(i * 7) & operand_mask];
+				}
+			});
+	}
+	WriteBenchmark(writer, "transform_to_matrix", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_matrices[i] = transforms[i].ToMatrix();
+			}
+		});
+	WriteBenchmark(writer, "transform_to_matrices", count, repeat, [&]()
+		{
+			YTransform::ToMatrices(out_matrices.data(), transforms.data(), count);
+		});
+	std::vector<YMatrix>().swap(matrices);
+
+	std::vector<YRotator> rotators(count);
+	std::vector<YQuat> quats(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		rotators[i] = random.Rotator();
+		quats[i] = transforms[i].rotator;
+	}
+	std::vector<YTransform>().swap(transforms);
+	{
+		std::vector<YQuat> out_quats(count);
+		WriteBenchmark(writer, "rotator_to_quat", count, repeat, [&]()
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					out_quats[i] = rotators[i].ToQuat();
+				}
+			});
+		WriteBenchmark(writer, "batch_rotators_to_quats", count, repeat, [&]()
+			{
+				YBatchMath::RotatorsToQuats(out_quats.data(), rotators.data(), count);
+			});
+	}
+	WriteBenchmark(writer, "rotator_to_matrix", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_matrices[i] = rotators[i].ToMatrix();
+			}
+		});
+	WriteBenchmark(writer, "batch_rotators_to_matrices", count, repeat, [&]()
+		{
+			YBatchMath::RotatorsToMatrices(out_matrices.data(), rotators.data(), count);
+		});
+	WriteBenchmark(writer, "quat_to_matrix", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_matrices[i] = quats[i].ToMatrix();
+			}
+		});
+	WriteBenchmark(writer, "batch_quats_to_matrices", count, repeat, [&]()
+		{
+			YBatchMath::QuatsToMatrices(out_matrices.data(), quats.data(), count);
+		});
+	WriteBenchmark(writer, "quat_to_rotator", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				rotators[i] = quats[i].Rotator();
+			}
+		});
+	WriteBenchmark(writer, "batch_quats_to_rotators", count, repeat, [&]()
+		{
+			YBatchMath::QuatsToRotators(rotators.data(), quats.data(), count);
+		});
+	std::vector<YMatrix>().swap(out_matrices);
+	std::vector<YRotator>().swap(rotators);
+
+	std::vector<YVector> vectors(count);
+	std::vector<YVector> other_vectors(count);
+	std::vector<YVector> out_vectors(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		vectors[i] = random.Vector(-100.0f, 100.0f);
+		other_vectors[i] = random.Vector(-100.0f, 100.0f);
+	}
+	const YQuat quat = quats[0];
+	const YMatrix matrix = operands[0];
+	WriteBenchmark(writer, "quat_rotate_vector", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_vectors[i] = quat.RotateVector(vectors[i]);
+			}
+		});
+	WriteBenchmark(writer, "batch_rotate_vectors", count, repeat, [&]()
+		{
+			YBatchMath::RotateVectors(out_vectors.data(), quat, vectors.data(), count);
+		});
+	WriteBenchmark(writer, "matrix_transform_position", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_vectors[i] = matrix.TransformPosition(vectors[i]);
+			}
+		});
+	WriteBenchmark(writer, "batch_transform_positions", count, repeat, [&]()
+		{
+			YBatchMath::TransformPositions(out_vectors.data(), matrix, vectors.data(), count);
+		});
+	{
+		std::vector<YVector4> out_vectors4(count);
+		WriteBenchmark(writer, "matrix_transform_vector4", count, repeat, [&]()
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					out_vectors4[i] = matrix.TransformVector4(YVector4(vectors[i], 1.0f));
+				}
+			});
+	}
+	{
+		std::vector<YVectorRegister> registers(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			registers[i] = YVectorRegister(vectors[i], 1.0f);
+		}
+		std::vector<YVectorRegister> out_registers(count);
+		WriteBenchmark(writer, "register_transform_vector4", count, repeat, [&]()
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					out_registers[i] = matrix.TransformVector4(registers[i]);
+				}
+			});
+		WriteBenchmark(writer, "batch_transform_vectors4", count, repeat, [&]()
+			{
+				YBatchMath::TransformVectors4(out_registers.data(), matrix, registers.data(), count);
+			});
+	}
+	WriteBenchmark(writer, "vector_safe_normal", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_vectors[i] = vectors[i].GetSafeNormal();
+			}
+		});
+	WriteBenchmark(writer, "batch_normalize", count, repeat, [&]()
+		{
+			YBatchMath::Normalize(out_vectors.data(), vectors.data(), count);
+		});
+	WriteBenchmark(writer, "vector_cross", count, repeat, [&]()
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				out_vectors[i] = vectors[i] ^ other_vectors[i];
+			}
+		});
+	WriteBenchmark(writer, "batch_cross", count, repeat, [&]()
+		{
+			YBatchMath::Cross(out_vectors.data(), vectors.data(), other_vectors.data(), count);
+		});
+	{
+		// the same vectors as streams
+		std::vector<float> streams(count * 6);
+		for (size_t i = 0; i < count; ++i)
+		{
+			streams[i] = vectors[i].x;
+			streams[count + i] = vectors[i].y;
+			streams[count * 2 + i] = vectors[i].z;
+		}
+		YVectorSoA soa;
+		soa.x = streams.data();
+		soa.y = soa.x + count;
+		soa.z = soa.y + count;
+		YVectorSoA out_soa;
+		out_soa.x = soa.z + count;
+		out_soa.y = out_soa.x + count;
+		out_soa.z = out_soa.y + count;
+		WriteBenchmark(writer, "batch_transform_positions_soa", count, repeat, [&]()
+			{
+				YBatchMath::TransformPositions(out_soa, matrix, soa, count);
+			});
+		WriteBenchmark(writer, "batch_rotate_vectors_soa", count, repeat, [&]()
+			{
+				YBatchMath::RotateVectors(out_soa, quat, soa, count);
+			});
+	}
+	{
+		std::vector<float> radians(count * 3);
+		for (size_t i = 0; i < count; ++i)
+		{
+			radians[i] = random.Uniform(-(float)validation_pi, (float)validation_pi);
+		}
+		float* out_sin = radians.data() + count;
+		float* out_cos = out_sin + count;
+		WriteBenchmark(writer, "sin_cos", count, repeat, [&]()
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					out_sin[i] = YMath::Sin(radians[i]);
+					out_cos[i] = YMath::Cos(radians[i]);
+				}
+			});
+		WriteBenchmark(writer, "batch_sin_cos", count, repeat, [&]()
+			{
+				YBatchMath::SinCos(out_sin, out_cos, radians.data(), count);
+			});
+	}
+	writer.EndArray();
+}
+
+/*-----------------------------------------------------------------------------
+	accuracy, bounds are a few times the errors measured on sse2 and avx2
+-----------------------------------------------------------------------------*/
+
+// relative error of Inverse over the error the condition number allows
+static bool CheckInverse(YJsonWriter& writer, const char* name, const std::vector<YMatrix>& matrices, double bound)
+{
+	YErrorStats stats;
+	for (const YMatrix& matrix : matrices)
+	{
+		const YDoubleMatrix reference_input = ToDouble(matrix);
+		YDoubleMatrix reference;
+		if (!DoubleInverse(reference, reference_input))
+		{
+			continue;
+		}
+		const double condition = NormInf(reference_input) * NormInf(reference);
+		stats.Add(MaxDifference(matrix.Inverse(), reference) / MaxAbs(reference) / (condition * FLT_EPSILON));
+	}
+	return WriteAccuracy(writer, name, "cond_eps", stats, bound);
+}
+
+// Decompose then ToMatrix has to give the matrix back, the decomposition itself is not unique for negative scales
+static bool CheckDecompose(YJsonWriter& writer, const char* name, const std::vector<YTransform>& transforms, double bound)
+{
+	YErrorStats stats;
+	for (const YTransform& transform : transforms)
+	{
+		const YMatrix matrix = transform.ToMatrix();
+		YTransform decomposed;
+		matrix.Decompose(decomposed.translation, decomposed.rotator, decomposed.scale);
+		stats.Add(AffineDifference(decomposed.ToMatrix(), ToDouble(matrix)));
+	}
+	return WriteAccuracy(writer, name, "rel", stats, bound);
+}
+
+static bool WriteAccuracyChecks(YJsonWriter& writer, const YMathValidationOptions& options)
+{
+	const size_t count = std::max<size_t>(options.accuracy_samples, 1);
+	bool pass = true;
+	writer.Key("accuracy").BeginArray();
+
+	// matrices
+	{
+		YValidationRandom random(options.seed);
+		std::vector<YMatrix> trs(count), ill_conditioned(count), negative_scale(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			trs[i] = random.Transform(0.1f, 10.0f, 0.0f).ToMatrix();
+			negative_scale[i] = random.Transform(0.1f, 10.0f, 0.5f).ToMatrix();
+			// scales over six orders of magnitude under a shear
+			YMatrix shear = YMatrix::Identity;
+			shear.m[1][0] = random.Uniform(-2.0f, 2.0f);
+			shear.m[2][0] = random.Uniform(-2.0f, 2.0f);
+			shear.m[2][1] = random.Uniform(-2.0f, 2.0f);
+			YMatrix::MatrixMuliply(ill_conditioned[i], shear, random.Transform(1e-3f, 1e3f, 0.5f).ToMatrix());
+		}
+
+		YErrorStats multiply_stats, determinant_stats, transpose_stats, transform_vector_stats;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const YMatrix& a = trs[i];
+			const YMatrix& b = negative_scale[i];
+			YMatrix product;
+			YMatrix::MatrixMuliply(product, a, b);
+			multiply_stats.Add(ProductError(product, a, b));
+
+			// over the hadamard bound, the product of the row lengths
+			const YDoubleMatrix input = ToDouble(ill_conditioned[i]);
+			double hadamard = 1.0;
+			for (int row = 0; row < 4; ++row)
+			{
+				hadamard *= sqrt(input.m[row][0] * input.m[row][0] + input.m[row][1] * input.m[row][1] + input.m[row][2] * input.m[row][2] + input.m[row][3] * input.m[row][3]);
+			}
+			determinant_stats.Add(fabs(ill_conditioned[i].Determinant() - DoubleDeterminant(input)) / hadamard);
+
+			const YMatrix transposed = a.GetTransposed();
+			double transpose_error = 0.0;
+			for (int row = 0; row < 4; ++row)
+			{
+				for (int column = 0; column < 4; ++column)
+				{
+					transpose_error = std::max(transpose_error, (double)fabsf(transposed.m[row][column] - a.m[column][row]));
+				}
+			}
+			transpose_stats.Add(transpose_error);
+
+			const YVector4 v(random.Uniform(-100.0f, 100.0f), random.Uniform(-100.0f, 100.0f), random.Uniform(-100.0f, 100.0f), 1.0f);
+			const YVector4 transformed = a.TransformVector4(v);
+			transform_vector_stats.Add(TransformError(&transformed.x, &v.x, 4, a));
+		}
+		pass &= WriteAccuracy(writer, "matrix_multiply", "sum_eps", multiply_stats, 4.0);
+		pass &= WriteAccuracy(writer, "matrix_determinant", "rel", determinant_stats, 1e-6);
+		pass &= WriteAccuracy(writer, "matrix_transpose", "abs", transpose_stats, 0.0);
+		pass &= WriteAccuracy(writer, "matrix_transform_vector4", "sum_eps", transform_vector_stats, 4.0);
+		pass &= CheckInverse(writer, "matrix_inverse_trs", trs, 1.0);
+		// the cofactor inverses are not backward stable, sheared inputs reach a few hundred times cond * eps
+		pass &= CheckInverse(writer, "matrix_inverse_ill_conditioned", ill_conditioned, 2e3);
+		pass &= CheckInverse(writer, "matrix_inverse_negative_scale", negative_scale, 1.0);
+	}
+
+	// transforms
+	{
+		YValidationRandom random(options.seed + 1);
+		std::vector<YTransform> uniform(count), non_uniform(count), negative_scale(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const float scale = random.LogUniform(0.01f, 100.0f);
+			uniform[i] = YTransform(random.Vector(-1000.0f, 1000.0f), random.Quat(), YVector(scale, scale, scale));
+			non_uniform[i] = random.Transform(0.01f, 100.0f, 0.0f);
+			negative_scale[i] = random.Transform(0.01f, 100.0f, 0.5f);
+		}
+		pass &= CheckDecompose(writer, "matrix_decompose_uniform", uniform, 4e-6);
+		pass &= CheckDecompose(writer, "matrix_decompose_non_uniform", non_uniform, 4e-6);
+		pass &= CheckDecompose(writer, "matrix_decompose_negative_scale", negative_scale, 4e-6);
+
+		YErrorStats to_matrix_stats, multiply_stats, negative_multiply_stats;
+		std::vector<YMatrix> batched(count);
+		YTransform::ToMatrices(batched.data(), non_uniform.data(), count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const YDoubleMatrix reference = DoubleTransformMatrix(non_uniform[i]);
+			to_matrix_stats.Add(std::max(AffineDifference(non_uniform[i].ToMatrix(), reference), AffineDifference(batched[i], reference)));
+
+			// composing matrices is the reference for composing transforms
+			const YTransform& parent = uniform[(i + 1) % count];
+			const YDoubleMatrix product_reference = DoubleMultiply(DoubleTransformMatrix(uniform[i]), DoubleTransformMatrix(parent));
+			multiply_stats.Add(AffineDifference((uniform[i] * parent).ToMatrix(), product_reference));
+			// a negative child under a uniform parent stays representable as a transform
+			const YDoubleMatrix negative_reference = DoubleMultiply(DoubleTransformMatrix(negative_scale[i]), DoubleTransformMatrix(parent));
+			negative_multiply_stats.Add(AffineDifference((negative_scale[i] * parent).ToMatrix(), negative_reference));
+		}
+		pass &= WriteAccuracy(writer, "transform_to_matrix", "rel", to_matrix_stats, 1e-6);
+		pass &= WriteAccuracy(writer, "transform_multiply", "rel", multiply_stats, 1e-5);
+		pass &= WriteAccuracy(writer, "transform_multiply_negative_scale", "rel", negative_multiply_stats, 1e-5);
+	}
+
+	// rotations
+	{
+		YValidationRandom random(options.seed + 2);
+		std::vector<YRotator> rotators(count);
+		std::vector<YQuat> quats(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			rotators[i] = random.Rotator();
+			quats[i] = random.Quat();
+		}
+		// the gimbal lock of Rotator
+		for (size_t i = 0; i < count; i += 64)
+		{
+			rotators[i].yaw = (i & 64) ? 90.0f : -90.0f;
+			quats[i] = rotators[i].ToQuat();
+		}
+
+		std::vector<YQuat> batched_quats(count);
+		std::vector<YMatrix> batched_matrices(count);
+		std::vector<YRotator> batched_rotators(count);
+		YBatchMath::RotatorsToQuats(batched_quats.data(), rotators.data(), count);
+		YBatchMath::RotatorsToMatrices(batched_matrices.data(), rotators.data(), count);
+		YErrorStats to_quat_stats, batch_to_quat_stats, to_matrix_stats, batch_to_matrix_stats;
+		for (size_t i = 0; i < count; ++i)
+		{
+			double reference[4];
+			DoubleRotatorQuat(rotators[i], reference);
+			const YQuat quat = rotators[i].ToQuat();
+			to_quat_stats.Add(std::max({ fabs(quat.x - reference[0]), fabs(quat.y - reference[1]), fabs(quat.z - reference[2]), fabs(quat.w - reference[3]) }));
+			const YQuat& batched = batched_quats[i];
+			batch_to_quat_stats.Add(std::max({ fabs(batched.x - reference[0]), fabs(batched.y - reference[1]), fabs(batched.z - reference[2]), fabs(batched.w - reference[3]) }));
+			const YDoubleMatrix reference_matrix = DoubleRotatorMatrix(rotators[i].pitch, rotators[i].yaw, rotators[i].roll);
+			to_matrix_stats.Add(MaxDifference(rotators[i].ToMatrix(), reference_matrix));
+			batch_to_matrix_stats.Add(MaxDifference(batched_matrices[i], reference_matrix));
+		}
+		pass &= WriteAccuracy(writer, "rotator_to_quat", "abs", to_quat_stats, 5e-7);
+		pass &= WriteAccuracy(writer, "batch_rotators_to_quats", "abs", batch_to_quat_stats, 5e-7);
+		pass &= WriteAccuracy(writer, "rotator_to_matrix", "abs", to_matrix_stats, 5e-7);
+		pass &= WriteAccuracy(writer, "batch_rotators_to_matrices", "abs", batch_to_matrix_stats, 5e-7);
+
+		YBatchMath::QuatsToMatrices(batched_matrices.data(), quats.data(), count);
+		YBatchMath::QuatsToRotators(batched_rotators.data(), quats.data(), count);
+		YErrorStats quat_to_matrix_stats, to_rotator_stats, batch_to_rotator_stats;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const YDoubleMatrix reference = DoubleQuatMatrix(quats[i]);
+			quat_to_matrix_stats.Add(std::max(MaxDifference(quats[i].ToMatrix(), reference), MaxDifference(batched_matrices[i], reference)));
+			// the rotator is not unique, the rotation it stands for is compared
+			const YRotator rotator = quats[i].Rotator();
+			to_rotator_stats.Add(MaxDifference(DoubleRotatorMatrix(rotator.pitch, rotator.yaw, rotator.roll), reference));
+			const YRotator& batched = batched_rotators[i];
+			batch_to_rotator_stats.Add(MaxDifference(DoubleRotatorMatrix(batched.pitch, batched.yaw, batched.roll), reference));
+		}
+		pass &= WriteAccuracy(writer, "quat_to_matrix", "abs", quat_to_matrix_stats, 5e-7);
+		// the gimbal lock branch snaps yaw to 90 from sin(yaw) > 0.999999, 1.4e-3 radians away
+		pass &= WriteAccuracy(writer, "quat_to_rotator", "abs", to_rotator_stats, 1.5e-3);
+		pass &= WriteAccuracy(writer, "batch_quats_to_rotators", "abs", batch_to_rotator_stats, 1.5e-3);
+
+		std::vector<YVector> vectors(count), batched_vectors(count);
+		for (YVector& v : vectors)
+		{
+			v = random.Vector(-100.0f, 100.0f);
+		}
+		YErrorStats rotate_stats, batch_rotate_stats;
+		for (size_t i = 0; i < count; i += 256)
+		{
+			const size_t batch_count = std::min<size_t>(256, count - i);
+			YBatchMath::RotateVectors(batched_vectors.data() + i, quats[i], vectors.data() + i, batch_count);
+			for (size_t j = i; j < i + batch_count; ++j)
+			{
+				double reference[3];
+				DoubleRotateVector(quats[i], vectors[j], reference);
+				const double magnitude = std::max(MaxAbs(reference), 1e-3);
+				rotate_stats.Add(MaxDifference(quats[i].RotateVector(vectors[j]), reference) / magnitude);
+				batch_rotate_stats.Add(MaxDifference(batched_vectors[j], reference) / magnitude);
+			}
+		}
+		pass &= WriteAccuracy(writer, "quat_rotate_vector", "rel", rotate_stats, 2e-6);
+		pass &= WriteAccuracy(writer, "batch_rotate_vectors", "rel", batch_rotate_stats, 2e-6);
+	}
+
+	// vectors
+	{
+		YValidationRandom random(options.seed + 3);
+		std::vector<YVector> vectors(count), batched(count);
+		for (YVector& v : vectors)
+		{
+			v = random.Vector(-100.0f, 100.0f);
+		}
+		const YMatrix matrix = random.Transform(0.1f, 10.0f, 0.5f).ToMatrix();
+		YErrorStats normal_stats, batch_normal_stats, position_stats, batch_position_stats;
+		YBatchMath::Normalize(batched.data(), vectors.data(), count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const YVector& v = vectors[i];
+			const double length = sqrt((double)v.x * v.x + (double)v.y * v.y + (double)v.z * v.z);
+			const double reference[3] = { v.x / length, v.y / length, v.z / length };
+			normal_stats.Add(MaxDifference(v.GetSafeNormal(), reference));
+			batch_normal_stats.Add(MaxDifference(batched[i], reference));
+		}
+		YBatchMath::TransformPositions(batched.data(), matrix, vectors.data(), count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const YVector transformed = matrix.TransformPosition(vectors[i]);
+			position_stats.Add(TransformError(&transformed.x, &vectors[i].x, 3, matrix));
+			batch_position_stats.Add(TransformError(&batched[i].x, &vectors[i].x, 3, matrix));
+		}
+		pass &= WriteAccuracy(writer, "vector_safe_normal", "abs", normal_stats, 3e-7);
+		pass &= WriteAccuracy(writer, "batch_normalize", "abs", batch_normal_stats, 3e-7);
+		pass &= WriteAccuracy(writer, "matrix_transform_position", "sum_eps", position_stats, 4.0);
+		pass &= WriteAccuracy(writer, "batch_transform_positions", "sum_eps", batch_position_stats, 4.0);
+
+		// the batched polynomial against the documented bound, the c library for comparison
+		std::vector<float> radians(count), sines(count), cosines(count);
+		for (float& radian : radians)
+		{
+			radian = random.Uniform(-8192.0f, 8192.0f);
+		}
+		YBatchMath::SinCos(sines.data(), cosines.data(), radians.data(), count);
+		YErrorStats sin_cos_stats, batch_sin_cos_stats;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const double reference_sin = sin((double)radians[i]), reference_cos = cos((double)radians[i]);
+			sin_cos_stats.Add(std::max(fabs(YMath::Sin(radians[i]) - reference_sin), fabs(YMath::Cos(radians[i]) - reference_cos)));
+			batch_sin_cos_stats.Add(std::max(fabs(sines[i] - reference_sin), fabs(cosines[i] - reference_cos)));
+		}
+		pass &= WriteAccuracy(writer, "sin_cos", "abs", sin_cos_stats, 8e-8);
+		pass &= WriteAccuracy(writer, "batch_sin_cos", "abs", batch_sin_cos_stats, 8e-8);
+	}
+
+	writer.EndArray();
+	return pass;
+}
+
+/*-----------------------------------------------------------------------------
+	YMathValidation
+-----------------------------------------------------------------------------*/
+
+bool YMathValidation::Run(YJsonWriter& writer, const YMathValidationOptions& options)
+{
+	const ESimdLevel current_level = YSimd::GetSimdLevel();
+	const YCpuFeatures& features = YSimd::GetCpuFeatures();
+	writer.BeginObject();
+	writer.Key("cpu").BeginObject();
+	writer.Key("sse2").WriteBool(features.sse2);
+	writer.Key("avx2").WriteBool(features.avx2);
+	writer.Key("fma").WriteBool(features.fma);
+	writer.Key("max_level").WriteString(YSimd::GetSimdLevelName(YSimd::GetMaxSimdLevel()));
+	writer.EndObject();
+	writer.Key("array_size").WriteUInt(options.array_size);
+	writer.Key("accuracy_samples").WriteUInt(options.accuracy_samples);
+	writer.Key("repeat").WriteInt(options.repeat);
+	writer.Key("seed").WriteUInt(options.seed);
+
+	bool pass = true;
+	writer.Key("levels").BeginArray();
+	const int first_level = options.all_levels ? (int)SL_Scalar : (int)current_level;
+	const int last_level = options.all_levels ? (int)YSimd::GetMaxSimdLevel() : (int)current_level;
+	for (int level = first_level; level <= last_level; ++level)
+	{
+		YSimd::SetSimdLevel((ESimdLevel)level);
+		writer.BeginObject();
+		writer.Key("level").WriteString(YSimd::GetSimdLevelName((ESimdLevel)level));
+		WriteBenchmarks(writer, options);
+		pass &= WriteAccuracyChecks(writer, options);
+		writer.EndObject();
+	}
+	writer.EndArray();
+	YSimd::SetSimdLevel(current_level);
+
+	writer.Key("pass").WriteBool(pass);
+	writer.EndObject();
+	return pass;
+}
+
+bool YMathValidation::RunToFile(const std::string& path, const YMathValidationOptions& options)
+{
+	bool pass = true;
+	const bool write_success = YJsonHelper::WriteJsonToFile(path, [&pass, &options](YJsonWriter& writer)
+		{
+			pass = Run(writer, options);
+			return true;
+		}, YJsonWriter::JS_Pretty);
+	return write_success && pass;
+}
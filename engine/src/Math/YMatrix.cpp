@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstring>
 #include "Math/YQuaterion.h"
+#include "Math/YMathKernels.h"
 
 YMatrix3x3::YMatrix3x3()
 {
@@ -41,26 +42,7 @@ YMatrix YMatrix::operator*(const YMatrix& other)
 
 float YMatrix::Determinant() const
 {
-	return	m[0][0] * (
-		m[1][1] * (m[2][2] * m[3][3] - m[2][3] * m[3][2]) -
-		m[2][1] * (m[1][2] * m[3][3] - m[1][3] * m[3][2]) +
-		m[3][1] * (m[1][2] * m[2][3] - m[1][3] * m[2][2])
-		) -
-		m[1][0] * (
-			m[0][1] * (m[2][2] * m[3][3] - m[2][3] * m[3][2]) -
-			m[2][1] * (m[0][2] * m[3][3] - m[0][3] * m[3][2]) +
-			m[3][1] * (m[0][2] * m[2][3] - m[0][3] * m[2][2])
-			) +
-		m[2][0] * (
-			m[0][1] * (m[1][2] * m[3][3] - m[1][3] * m[3][2]) -
-			m[1][1] * (m[0][2] * m[3][3] - m[0][3] * m[3][2]) +
-			m[3][1] * (m[0][2] * m[1][3] - m[0][3] * m[1][2])
-			) -
-		m[3][0] * (
-			m[0][1] * (m[1][2] * m[2][3] - m[1][3] * m[2][2]) -
-			m[1][1] * (m[0][2] * m[2][3] - m[0][3] * m[2][2]) +
-			m[2][1] * (m[0][2] * m[1][3] - m[0][3] * m[1][2])
-			);
+	return YMathKernels::matrix.determinant(*this);
 }
 
 float YMatrix::RotDeterminant() const
@@ -81,27 +63,7 @@ void YMatrix::SetIdentity()
 
 void YMatrix::MatrixMuliply(YMatrix& out, const YMatrix& matrix1, const YMatrix& matrix2)
 {
-	YMatrix tmp;
-	tmp.m[0][0] = matrix1.m[0][0] * matrix2.m[0][0] + matrix1.m[0][1] * matrix2.m[1][0] + matrix1.m[0][2] * matrix2.m[2][0] + matrix1.m[0][3] * matrix2.m[3][0];
-	tmp.m[0][1] = matrix1.m[0][0] * matrix2.m[0][1] + matrix1.m[0][1] * matrix2.m[1][1] + matrix1.m[0][2] * matrix2.m[2][1] + matrix1.m[0][3] * matrix2.m[3][1];
-	tmp.m[0][2] = matrix1.m[0][0] * matrix2.m[0][2] + matrix1.m[0][1] * matrix2.m[1][2] + matrix1.m[0][2] * matrix2.m[2][2] + matrix1.m[0][3] * matrix2.m[3][2];
-	tmp.m[0][3] = matrix1.m[0][0] * matrix2.m[0][3] + matrix1.m[0][1] * matrix2.m[1][3] + matrix1.m[0][2] * matrix2.m[2][3] + matrix1.m[0][3] * matrix2.m[3][3];
-
-	tmp.m[1][0] = matrix1.m[1][0] * matrix2.m[0][0] + matrix1.m[1][1] * matrix2.m[1][0] + matrix1.m[1][2] * matrix2.m[2][0] + matrix1.m[1][3] * matrix2.m[3][0];
-	tmp.m[1][1] = matrix1.m[1][0] * matrix2.m[0][1] + matrix1.m[1][1] * matrix2.m[1][1] + matrix1.m[1][2] * matrix2.m[2][1] + matrix1.m[1][3] * matrix2.m[3][1];
-	tmp.m[1][2] = matrix1.m[1][0] * matrix2.m[0][2] + matrix1.m[1][1] * matrix2.m[1][2] + matrix1.m[1][2] * matrix2.m[2][2] + matrix1.m[1][3] * matrix2.m[3][2];
-	tmp.m[1][3] = matrix1.m[1][0] * matrix2.m[0][3] + matrix1.m[1][1] * matrix2.m[1][3] + matrix1.m[1][2] * matrix2.m[2][3] + matrix1.m[1][3] * matrix2.m[3][3];
-
-	tmp.m[2][0] = matrix1.m[2][0] * matrix2.m[0][0] + matrix1.m[2][1] * matrix2.m[1][0] + matrix1.m[2][2] * matrix2.m[2][0] + matrix1.m[2][3] * matrix2.m[3][0];
-	tmp.m[2][1] = matrix1.m[2][0] * matrix2.m[0][1] + matrix1.m[2][1] * matrix2.m[1][1] + matrix1.m[2][2] * matrix2.m[2][1] + matrix1.m[2][3] * matrix2.m[3][1];
-	tmp.m[2][2] = matrix1.m[2][0] * matrix2.m[0][2] + matrix1.m[2][1] * matrix2.m[1][2] + matrix1.m[2][2] * matrix2.m[2][2] + matrix1.m[2][3] * matrix2.m[3][2];
-	tmp.m[2][3] = matrix1.m[2][0] * matrix2.m[0][3] + matrix1.m[2][1] * matrix2.m[1][3] + matrix1.m[2][2] * matrix2.m[2][3] + matrix1.m[2][3] * matrix2.m[3][3];
-
-	tmp.m[3][0] = matrix1.m[3][0] * matrix2.m[0][0] + matrix1.m[3][1] * matrix2.m[1][0] + matrix1.m[3][2] * matrix2.m[2][0] + matrix1.m[3][3] * matrix2.m[3][0];
-	tmp.m[3][1] = matrix1.m[3][0] * matrix2.m[0][1] + matrix1.m[3][1] * matrix2.m[1][1] + matrix1.m[3][2] * matrix2.m[2][1] + matrix1.m[3][3] * matrix2.m[3][1];
-	tmp.m[3][2] = matrix1.m[3][0] * matrix2.m[0][2] + matrix1.m[3][1] * matrix2.m[1][2] + matrix1.m[3][2] * matrix2.m[2][2] + matrix1.m[3][3] * matrix2.m[3][2];
-	tmp.m[3][3] = matrix1.m[3][0] * matrix2.m[0][3] + matrix1.m[3][1] * matrix2.m[1][3] + matrix1.m[3][2] * matrix2.m[2][3] + matrix1.m[3][3] * matrix2.m[3][3];
-	memcpy(out.m, tmp.m, sizeof(float) * 16);
+	YMathKernels::matrix.multiply(out, matrix1, matrix2);
 }
 
 YMatrix YMatrix::Inverse() const
@@ -111,103 +73,18 @@ YMatrix YMatrix::Inverse() const
 	{
 		result_matrix = YMatrix::Identity;
 	}
-	else
+	else if (!YMathKernels::matrix.inverse(result_matrix, *this))
 	{
-		const float det = Determinant();
-		if (det == 0.0)
-		{
-			result_matrix = YMatrix::Identity;
-		}
-		else
-		{
-			YMatrix tmp_matrix;
-			float det[4];
-			tmp_matrix.m[0][0] = m[2][2] * m[3][3] - m[2][3] * m[3][2];
-			tmp_matrix.m[0][1] = m[1][2] * m[3][3] - m[1][3] * m[3][2];
-			tmp_matrix.m[0][2] = m[1][2] * m[2][3] - m[1][3] * m[2][2];
-
-			tmp_matrix.m[1][0] = m[2][2] * m[3][3] - m[2][3] * m[3][2];
-			tmp_matrix.m[1][1] = m[0][2] * m[3][3] - m[0][3] * m[3][2];
-			tmp_matrix.m[1][2] = m[0][2] * m[2][3] - m[0][3] * m[2][2];
-
-			tmp_matrix.m[2][0] = m[1][2] * m[3][3] - m[1][3] * m[3][2];
-			tmp_matrix.m[2][1] = m[0][2] * m[3][3] - m[0][3] * m[3][2];
-			tmp_matrix.m[2][2] = m[0][2] * m[1][3] - m[0][3] * m[1][2];
-
-			tmp_matrix.m[3][0] = m[1][2] * m[2][3] - m[1][3] * m[2][2];
-			tmp_matrix.m[3][1] = m[0][2] * m[2][3] - m[0][3] * m[2][2];
-			tmp_matrix.m[3][2] = m[0][2] * m[1][3] - m[0][3] * m[1][2];
-
-			det[0] = m[1][1] * tmp_matrix.m[0][0] - m[2][1] * tmp_matrix.m[0][1] + m[3][1] * tmp_matrix.m[0][2];
-			det[1] = m[0][1] * tmp_matrix.m[1][0] - m[2][1] * tmp_matrix.m[1][1] + m[3][1] * tmp_matrix.m[1][2];
-			det[2] = m[0][1] * tmp_matrix.m[2][0] - m[1][1] * tmp_matrix.m[2][1] + m[3][1] * tmp_matrix.m[2][2];
-			det[3] = m[0][1] * tmp_matrix.m[3][0] - m[1][1] * tmp_matrix.m[3][1] + m[2][1] * tmp_matrix.m[3][2];
-
-			float determinant = m[0][0] * det[0] - m[1][0] * det[1] + m[2][0] * det[2] - m[3][0] * det[3];
-			const float	r_det = 1.0f / determinant;
-
-			result_matrix.m[0][0] = r_det * det[0];
-			result_matrix.m[0][1] = -r_det * det[1];
-			result_matrix.m[0][2] = r_det * det[2];
-			result_matrix.m[0][3] = -r_det * det[3];
-			result_matrix.m[1][0] = -r_det * (m[1][0] * tmp_matrix.m[0][0] - m[2][0] * tmp_matrix.m[0][1] + m[3][0] * tmp_matrix.m[0][2]);
-			result_matrix.m[1][1] = r_det * (m[0][0] * tmp_matrix.m[1][0] - m[2][0] * tmp_matrix.m[1][1] + m[3][0] * tmp_matrix.m[1][2]);
-			result_matrix.m[1][2] = -r_det * (m[0][0] * tmp_matrix.m[2][0] - m[1][0] * tmp_matrix.m[2][1] + m[3][0] * tmp_matrix.m[2][2]);
-			result_matrix.m[1][3] = r_det * (m[0][0] * tmp_matrix.m[3][0] - m[1][0] * tmp_matrix.m[3][1] + m[2][0] * tmp_matrix.m[3][2]);
-			result_matrix.m[2][0] = r_det * (
-				m[1][0] * (m[2][1] * m[3][3] - m[2][3] * m[3][1]) -
-				m[2][0] * (m[1][1] * m[3][3] - m[1][3] * m[3][1]) +
-				m[3][0] * (m[1][1] * m[2][3] - m[1][3] * m[2][1])
-				);
-			result_matrix.m[2][1] = -r_det * (
-				m[0][0] * (m[2][1] * m[3][3] - m[2][3] * m[3][1]) -
-				m[2][0] * (m[0][1] * m[3][3] - m[0][3] * m[3][1]) +
-				m[3][0] * (m[0][1] * m[2][3] - m[0][3] * m[2][1])
-				);
-			result_matrix.m[2][2] = r_det * (
-				m[0][0] * (m[1][1] * m[3][3] - m[1][3] * m[3][1]) -
-				m[1][0] * (m[0][1] * m[3][3] - m[0][3] * m[3][1]) +
-				m[3][0] * (m[0][1] * m[1][3] - m[0][3] * m[1][1])
-				);
-			result_matrix.m[2][3] = -r_det * (
-				m[0][0] * (m[1][1] * m[2][3] - m[1][3] * m[2][1]) -
-				m[1][0] * (m[0][1] * m[2][3] - m[0][3] * m[2][1]) +
-				m[2][0] * (m[0][1] * m[1][3] - m[0][3] * m[1][1])
-				);
-			result_matrix.m[3][0] = -r_det * (
-				m[1][0] * (m[2][1] * m[3][2] - m[2][2] * m[3][1]) -
-				m[2][0] * (m[1][1] * m[3][2] - m[1][2] * m[3][1]) +
-				m[3][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
-				);
-			result_matrix.m[3][1] = r_det * (
-				m[0][0] * (m[2][1] * m[3][2] - m[2][2] * m[3][1]) -
-				m[2][0] * (m[0][1] * m[3][2] - m[0][2] * m[3][1]) +
-				m[3][0] * (m[0][1] * m[2][2] - m[0][2] * m[2][1])
-				);
-			result_matrix.m[3][2] = -r_det * (
-				m[0][0] * (m[1][1] * m[3][2] - m[1][2] * m[3][1]) -
-				m[1][0] * (m[0][1] * m[3][2] - m[0][2] * m[3][1]) +
-				m[3][0] * (m[0][1] * m[1][2] - m[0][2] * m[1][1])
-				);
-			result_matrix.m[3][3] = r_det * (
-				m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
-				m[1][0] * (m[0][1] * m[2][2] - m[0][2] * m[2][1]) +
-				m[2][0] * (m[0][1] * m[1][2] - m[0][2] * m[1][1])
-				);
-		}
+		result_matrix = YMatrix::Identity;
 	}
 	return result_matrix;
 }
 
 YVector4 YMatrix::TransformVector4(const YVector4& v) const
 {
-	float f[4];
-	const float* tmp = reinterpret_cast<const float*>(&v);
-	f[0] = tmp[0] * m[0][0] + tmp[1] * m[1][0] + tmp[2] * m[2][0] + tmp[3] * m[3][0];
-	f[1] = tmp[0] * m[0][1] + tmp[1] * m[1][1] + tmp[2] * m[2][1] + tmp[3] * m[3][1];
-	f[2] = tmp[0] * m[0][2] + tmp[1] * m[1][2] + tmp[2] * m[2][2] + tmp[3] * m[3][2];
-	f[3] = tmp[0] * m[0][3] + tmp[1] * m[1][3] + tmp[2] * m[2][3] + tmp[3] * m[3][3];
-	return YVector4(f);
+	YVector4 result;
+	YMathKernels::matrix.transform_vector4(result, *this, v);
+	return result;
 }
 
 YVector YMatrix::TransformPosition(const YVector& v) const
@@ -220,27 +97,7 @@ YVector YMatrix::TransformPosition(const YVector& v) const
 YMatrix YMatrix::GetTransposed() const
 {
 	YMatrix	result;
-
-	result.m[0][0] = m[0][0];
-	result.m[0][1] = m[1][0];
-	result.m[0][2] = m[2][0];
-	result.m[0][3] = m[3][0];
-
-	result.m[1][0] = m[0][1];
-	result.m[1][1] = m[1][1];
-	result.m[1][2] = m[2][1];
-	result.m[1][3] = m[3][1];
-
-	result.m[2][0] = m[0][2];
-	result.m[2][1] = m[1][2];
-	result.m[2][2] = m[2][2];
-	result.m[2][3] = m[3][2];
-
-	result.m[3][0] = m[0][3];
-	result.m[3][1] = m[1][3];
-	result.m[3][2] = m[2][3];
-	result.m[3][3] = m[3][3];
-
+	YMathKernels::matrix.transpose(result, *this);
 	return result;
 }
 
@@ -250,6 +107,41 @@ YVector YMatrix::TransformVector(const YVector& v) const
 	return YVector(result.x, result.y, result.z);
 }
 
+YVectorRegister YMatrix::TransformVector4(const YVectorRegister& v) const
+{
+#if YMATH_SSE
+	// the order of YMathKernels::matrix.transform_vector4, with the aligned loads of both types
+	const __m128 vec = v.Load();
+	__m128 r = _mm_mul_ps(YMATH_SWIZZLE(vec, 0, 0, 0, 0), _mm_load_ps(m[0]));
+	r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(vec, 1, 1, 1, 1), _mm_load_ps(m[1])));
+	r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(vec, 2, 2, 2, 2), _mm_load_ps(m[2])));
+	r = _mm_add_ps(r, _mm_mul_ps(YMATH_SWIZZLE(vec, 3, 3, 3, 3), _mm_load_ps(m[3])));
+	return YVectorRegister(r);
+#else
+	return YVectorRegister(TransformVector4(v.ToVector4()));
+#endif
+}
+
+YVectorRegister YMatrix::TransformPosition(const YVectorRegister& v) const
+{
+	YVectorRegister pos = TransformVector4(YVectorRegister(v.x, v.y, v.z, 1.0f));
+#if YMATH_SSE
+	const __m128 r = pos.Load();
+	pos = YVectorRegister(_mm_div_ps(r, YMATH_SWIZZLE(r, 3, 3, 3, 3)));
+	pos.w = 1.0f;
+	return pos;
+#else
+	return YVectorRegister(pos.x / pos.w, pos.y / pos.w, pos.z / pos.w, 1.0f);
+#endif
+}
+
+YVectorRegister YMatrix::TransformVector(const YVectorRegister& v) const
+{
+	YVectorRegister result = TransformVector4(YVectorRegister(v.x, v.y, v.z, 0.0f));
+	result.w = 0.0f;
+	return result;
+}
+
 YVector YMatrix::GetScaledAxis(int axis) const
 {
 	if (axis == 0)
@@ -1,6 +1,7 @@
 #include "Math/YQuaterion.h"
 #include "Math/YRotator.h"
 #include "Math/YVector.h"
+#include "Math/YVectorRegister.h"
 #include<cassert>
 YQuat::YQuat(float in_x, float in_y, float in_z, float in_w)
 	:x(in_x),
@@ -202,9 +203,9 @@ YQuat YQuat::Multiply(const YQuat& p, const YQuat& q)
 {
 	return YQuat(
 		p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y,
-		q.w * q.y - p.x * q.z + p.y * q.w + p.z * q.x,
+		p.w * q.y - p.x * q.z + p.y * q.w + p.z * q.x,
 		p.w * q.z + p.x * q.y - p.y * q.x + p.z * q.w,
-		p.w * p.w - p.x * q.x - p.y * q.y - p.z * q.z
+		p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z
 	);
 }
 
@@ -243,3 +244,12 @@ YVector YQuat::RotateVector(const YVector& V) const
 	const YVector Result = V + (w * T) + YVector::CrossProduct(Q, T);
 	return Result;
 }
+
+YVectorRegister YQuat::RotateVector(const YVectorRegister& V) const
+{
+	// the steps of the YVector version above
+	const YVectorRegister Q(x, y, z, 0.0f);
+	const YVectorRegister T = 2.f * (Q ^ V);
+	const YVectorRegister Result = V + (w * T) + (Q ^ T);
+	return Result;
+}
@@ -0,0 +1,107 @@
+#include "Math/YSimd.h"
+#include "Math/YMathKernels.h"
+#if YMATH_SSE
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+static YCpuFeatures DetectCpuFeatures()
+{
+	YCpuFeatures features;
+#if YMATH_SSE
+	int info[4] = { 0, 0, 0, 0 };
+	auto cpuid = [&info](int leaf, int sub_leaf)
+	{
+#if defined(_MSC_VER)
+		__cpuidex(info, leaf, sub_leaf);
+#else
+		unsigned int a = 0, b = 0, c = 0, d = 0;
+		__cpuid_count(leaf, sub_leaf, a, b, c, d);
+		info[0] = (int)a; info[1] = (int)b; info[2] = (int)c; info[3] = (int)d;
+#endif
+	};
+	cpuid(0, 0);
+	const int max_leaf = info[0];
+	cpuid(1, 0);
+	features.sse2 = (info[3] & (1 << 26)) != 0;
+	features.fma = (info[2] & (1 << 12)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	// the os has to save the ymm registers on context switches
+	bool ymm_enabled = false;
+	if (osxsave && avx)
+	{
+#if defined(_MSC_VER)
+		ymm_enabled = (_xgetbv(0) & 0x6) == 0x6;
+#else
+		unsigned int xcr0_lo = 0, xcr0_hi = 0;
+		__asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+		ymm_enabled = (xcr0_lo & 0x6) == 0x6;
+#endif
+	}
+	if (max_leaf >= 7)
+	{
+		cpuid(7, 0);
+		features.avx2 = ymm_enabled && (info[1] & (1 << 5)) != 0;
+	}
+	features.fma = features.fma && ymm_enabled;
+#endif
+	return features;
+}
+
+static ESimdLevel GetSupportedLevel(const YCpuFeatures& features)
+{
+	if (features.avx2 && features.fma)
+	{
+		return SL_AVX2;
+	}
+	return features.sse2 ? SL_SSE2 : SL_Scalar;
+}
+
+// dynamic initialization, the kernel tables are constant initialized to the sse2 level before it runs
+static ESimdLevel g_simd_level = YSimd::SetSimdLevel(SL_AVX2);
+
+const YCpuFeatures& YSimd::GetCpuFeatures()
+{
+	static const YCpuFeatures features = DetectCpuFeatures();
+	return features;
+}
+
+ESimdLevel YSimd::GetSimdLevel()
+{
+	return g_simd_level;
+}
+
+ESimdLevel YSimd::SetSimdLevel(ESimdLevel level)
+{
+	if (level > GetMaxSimdLevel())
+	{
+		level = GetMaxSimdLevel();
+	}
+	g_simd_level = level;
+	YMathKernels::Select(level);
+	return level;
+}
+
+ESimdLevel YSimd::GetMaxSimdLevel()
+{
+	return GetSupportedLevel(GetCpuFeatures());
+}
+
+const char* YSimd::GetSimdLevelName(ESimdLevel level)
+{
+	switch (level)
+	{
+	case SL_Scalar:
+		return "scalar";
+	case SL_SSE2:
+		return "sse2";
+	case SL_AVX2:
+		return "avx2";
+	default:
+		return "unknown";
+	}
+}
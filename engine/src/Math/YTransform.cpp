@@ -1,4 +1,5 @@
 #include "Math/YTransform.h"
+#include "Math/YMathKernels.h"
 
 YTransform::YTransform()
 	:translation(YVector::zero_vector),
@@ -32,18 +33,63 @@ const YTransform YTransform::identity(YVector::zero_vector, YQuat::Identity, YVe
 
 YMatrix YTransform::ToMatrix() const
 {
-	YMatrix scale_mat = YMatrix::Identity;
-	scale_mat.m[0][0] = scale[0];
-	scale_mat.m[1][1] = scale[1];
-	scale_mat.m[2][2] = scale[2];
-
-	YMatrix rotation_mat = rotator.ToMatrix();
-	YMatrix trans_mat = YMatrix::Identity;
-	trans_mat.m[3][0] = translation.x;
-	trans_mat.m[3][1] = translation.y;
-	trans_mat.m[3][2] = translation.z;
-	return  scale_mat * rotation_mat * trans_mat;
+	// scale * rotation * translation written out, the rows of the rotation scaled and the origin set
+	YMatrix result;
+	const float x = rotator.x;
+	const float y = rotator.y;
+	const float z = rotator.z;
+	const float w = rotator.w;
+	result.m[0][0] = (1.f - 2.f * (y * y + z * z)) * scale.x;
+	result.m[0][1] = (2.f * (x * y + w * z)) * scale.x;
+	result.m[0][2] = (2.f * (x * z - w * y)) * scale.x;
+	result.m[0][3] = 0.f;
+
+	result.m[1][0] = (2.f * (x * y - w * z)) * scale.y;
+	result.m[1][1] = (1.f - 2.f * (x * x + z * z)) * scale.y;
+	result.m[1][2] = (2.f * (w * x + y * z)) * scale.y;
+	result.m[1][3] = 0.f;
+
+	result.m[2][0] = (2.f * (w * y + x * z)) * scale.z;
+	result.m[2][1] = (2.f * (y * z - w * x)) * scale.z;
+	result.m[2][2] = (1.f - 2.f * (x * x + y * y)) * scale.z;
+	result.m[2][3] = 0.f;
+
+	result.m[3][0] = translation.x;
+	result.m[3][1] = translation.y;
+	result.m[3][2] = translation.z;
+	result.m[3][3] = 1.f;
+	return result;
+}
+
+void YTransform::ToMatrices(YMatrix* out, const YTransform* transforms, size_t count)
+{
+	YMathKernels::transform.to_matrices(out, transforms, count);
 }
+
+void YTransform::MultiplyUsingMatrix(YTransform* out_transform, const YTransform* a, const YTransform* b)
+{
+	YMatrix matrix;
+	YMatrix::MatrixMuliply(matrix, a->ToMatrix(), b->ToMatrix());
+	// the scale of the product is known, only the rotation has to be taken from the matrix
+	// each axis is normalized and flipped by the sign of its scale, which leaves a proper rotation
+	const YVector desired_scale = a->scale * b->scale;
+	for (int i = 0; i < 3; ++i)
+	{
+		YVector axis = matrix.GetScaledAxis(i);
+		const float square_sum = axis.x * axis.x + axis.y * axis.y + axis.z * axis.z;
+		if (square_sum > SMALL_NUMBER)
+		{
+			const float inv_length = YMath::InvSqrt(square_sum);
+			axis = axis * (desired_scale[i] < 0.f ? -inv_length : inv_length);
+			matrix.SetAxis(i, axis);
+		}
+	}
+	out_transform->rotator = YQuat(matrix);
+	out_transform->rotator.Normalize();
+	out_transform->scale = desired_scale;
+	out_transform->translation = matrix.GetOrigin();
+}
+
 void YTransform::Multiply(YTransform* OutTransform, const YTransform* A, const YTransform* B)
 {
 	//	When Q = quaternion, S = single scalar scale, and T = translation
@@ -65,7 +111,7 @@ void YTransform::Multiply(YTransform* OutTransform, const YTransform* A, const Y
 	if (bHaveNegativeScale)
 	{
 		// @note, if you have 0 scale with negative, you're going to lose rotation as it can't convert back to quat
-		new(OutTransform) YTransform(A->ToMatrix() * B->ToMatrix());
+		MultiplyUsingMatrix(OutTransform, A, B);
 	}
 	else
 	{
@@ -0,0 +1,74 @@
+#include "Platform/Windows/YSysUtility.h"
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdio>
+#include <vector>
+#include "Utility/YPath.h"
+#include "Engine/YLog.h"
+// for the tools built without the renderer, such as math_validation
+void YSysUtility::AllocWindowsConsole()
+{
+
+}
+
+std::string YSysUtility::UTF8ToString(const std::string& str)
+{
+	return str;
+}
+
+bool YSysUtility::IsDirectoryExist(const std::string& str)
+{
+	struct stat file_stat;
+	return stat(str.c_str(), &file_stat) == 0 && S_ISDIR(file_stat.st_mode);
+}
+
+bool YSysUtility::FileExists(const std::string& str)
+{
+	struct stat file_stat;
+	return stat(str.c_str(), &file_stat) == 0 && !S_ISDIR(file_stat.st_mode);
+}
+
+bool YSysUtility::GetFileModifyTime(const std::string& str, uint64_t& out_time)
+{
+	struct stat file_stat;
+	if (stat(str.c_str(), &file_stat) != 0)
+	{
+		return false;
+	}
+	out_time = (uint64_t)file_stat.st_mtim.tv_sec * 1000000000ull + (uint64_t)file_stat.st_mtim.tv_nsec;
+	return true;
+}
+
+bool YSysUtility::MoveFileReplace(const std::string& from, const std::string& to)
+{
+	return rename(from.c_str(), to.c_str()) == 0;
+}
+
+void YSysUtility::CreateDirectoryRecursive(const std::string& directory)
+{
+	if (directory.empty())
+	{
+		return;
+	}
+	if (YPath::DirectoryExists(directory))
+	{
+		return;
+	}
+	std::vector<std::string> base_paths = YPath::GetFilePathsSeperate(directory);
+	std::string created_path = directory[0] == '/' ? "/" : "";
+	for (const std::string& relative_child_path : base_paths)
+	{
+		if (relative_child_path.empty())
+		{
+			continue;
+		}
+		created_path = created_path.empty() || created_path.back() == '/' ? created_path + relative_child_path : YPath::PathCombine(created_path, relative_child_path);
+		if (mkdir(created_path.c_str(), 0755) != 0 && errno != EEXIST)
+		{
+			WARNING_INFO("path: ", directory, " create failed at ", created_path);
+			break;
+		}
+	}
+}
+#endif
@@ -1,4 +1,5 @@
 #include "Platform/Windows/YSysUtility.h"
+#if defined(_WIN32)
 #include <stdio.h>
 #include <locale.h>
 #include <iostream>
@@ -50,6 +51,22 @@ bool YSysUtility::FileExists(const std::string& str)
 	return false;
 }
 
+bool YSysUtility::GetFileModifyTime(const std::string& str, uint64_t& out_time)
+{
+	WIN32_FILE_ATTRIBUTE_DATA file_data;
+	if (!GetFileAttributesExA(str.c_str(), GetFileExInfoStandard, &file_data))
+	{
+		return false;
+	}
+	out_time = ((uint64_t)file_data.ftLastWriteTime.dwHighDateTime << 32) | file_data.ftLastWriteTime.dwLowDateTime;
+	return true;
+}
+
+bool YSysUtility::MoveFileReplace(const std::string& from, const std::string& to)
+{
+	return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
 void YSysUtility::CreateDirectoryRecursive(const std::string& directory)
 {
 	if (directory.empty())
@@ -81,3 +98,4 @@ void YSysUtility::CreateDirectoryRecursive(const std::string& directory)
 		}
 	}
 }
+#endif
@@ -906,6 +906,11 @@ bool D3DVertexShader::CreateInputLayout(TComPtr<ID3DBlob> blob, IVertexFactory*
 				if (tell_desc_the_same(vertex_stream_descs[j], reflected_input_layout_desc[i])) {
 					find_same_name = true;
 					vertex_stream_descs[j].slot = reflected_input_layout_desc[i].InputSlot;
+					if (vertex_stream_descs[j].per_instance)
+					{
+						reflected_input_layout_desc[i].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+						reflected_input_layout_desc[i].InstanceDataStepRate = 1;
+					}
 					if (reflected_input_layout_desc[i].Format == DXGI_FORMAT_R32G32B32A32_FLOAT && vertex_stream_descs[j].data_type == DataType::Uint8)
 					{
 						reflected_input_layout_desc[i].Format = DXGI_FORMAT_R8G8B8A8_UNORM;
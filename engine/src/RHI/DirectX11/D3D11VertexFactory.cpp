@@ -44,9 +44,9 @@ DXVertexFactory::~DXVertexFactory() {}
 
 void DXVertexFactory::SetInputLayout(const TComPtr<ID3D11InputLayout>& input_layout) { vertex_input_layout_ = input_layout; }
 
-VertexStreamDescription::VertexStreamDescription(VertexAttribute in_vertex_attribe, const std::string& in_name, DataType in_type, int in_cpu_data_index, int in_com_num, int in_buffer_size, int in_slot, int in_stride, bool in_normalized, bool in_release, bool in_dynamic) :
+VertexStreamDescription::VertexStreamDescription(VertexAttribute in_vertex_attribe, const std::string& in_name, DataType in_type, int in_cpu_data_index, int in_com_num, int in_buffer_size, int in_slot, int in_stride, bool in_normalized, bool in_release, bool in_dynamic, bool in_per_instance) :
 	vertex_attribute(in_vertex_attribe), name(in_name), data_type(in_type), cpu_data_index(in_cpu_data_index), com_num(in_com_num), buffer_size(in_buffer_size),
-	slot(in_slot), stride(in_stride), normalized(in_normalized), release(in_release), dynamic(in_dynamic)
+	slot(in_slot), stride(in_stride), normalized(in_normalized), release(in_release), dynamic(in_dynamic), per_instance(in_per_instance)
 {
 
 }
@@ -2,6 +2,8 @@
 #include "Engine/YCanvas.h"
 #include "RHI/DirectX11/D3D11Device.h"
 #include "Render/YRenderInterface.h"
+#include "Engine/YLog.h"
+#include <algorithm>
 
 
 bool YForwardRenderer::Init()
@@ -34,12 +36,69 @@ bool YForwardRenderer::Render(std::unique_ptr<YRenderScene> render_scene)
 		ele.mesh_->Render(&render_param);
 	}
 
+	if (!render_scene_->instanced_elements_.empty())
+	{
+		const bool is_uploaded = UploadInstanceMatrices(render_scene_->instance_matrices_);
+		for (InstancedElementProxy& ele : render_scene_->instanced_elements_)
+		{
+			// a mesh merged by the render scene compiles its instanced shader on its first batch
+			if (is_uploaded && ele.mesh_->AllocInstancedGpuResource())
+			{
+				ele.mesh_->RenderInstanced(&render_param, instance_buffer_, ele.first_instance_, ele.instance_count_);
+				continue;
+			}
+			for (int i = ele.first_instance_; i < ele.first_instance_ + ele.instance_count_; ++i)
+			{
+				render_param.local_to_world_ = render_scene_->instance_matrices_[i];
+				ele.mesh_->Render(&render_param);
+			}
+		}
+	}
+	ReportDrawMerge(render_scene_->draw_merge_stats_);
+
 	g_Canvas->Render(&render_param);
 	return true;
 }
 
 bool YForwardRenderer::Clearup()
 {
+	instance_buffer_ = nullptr;
+	instance_buffer_capacity_ = 0;
 	return true;
 }
 
+void YForwardRenderer::ReportDrawMerge(const YDrawMergeStats& stats)
+{
+	// logged when the number of batches changes, not every frame
+	const bool is_changed = stats.batch_count != draw_merge_stats_.batch_count;
+	draw_merge_stats_ = stats;
+	if (is_changed)
+	{
+		LOG_INFO("merged ", stats.merged_primitive_count, " of ", stats.primitive_count, " static meshes into ", stats.batch_count,
+			" instanced draws, ", stats.draw_count_after, " mesh draws instead of ", stats.draw_count_before);
+	}
+}
+
+bool YForwardRenderer::UploadInstanceMatrices(const std::vector<YMatrix>& instance_matrices)
+{
+	const int instance_count = (int)instance_matrices.size();
+	if (instance_count > instance_buffer_capacity_)
+	{
+		// doubled so a growing scene reallocates a few times only
+		int capacity = std::max(instance_buffer_capacity_ * 2, 1024);
+		while (capacity < instance_count)
+		{
+			capacity *= 2;
+		}
+		instance_buffer_ = nullptr;
+		instance_buffer_capacity_ = 0;
+		if (!g_device->CreateVertexBufferDynamic(capacity * sizeof(YMatrix), nullptr, instance_buffer_))
+		{
+			ERROR_INFO("Create instance buffer failed!!");
+			return false;
+		}
+		instance_buffer_capacity_ = capacity;
+	}
+	return g_device->UpdateVBDynaimc(instance_buffer_, 0, (void*)instance_matrices.data(), instance_count * sizeof(YMatrix));
+}
+
@@ -1,7 +1,10 @@
 #include "SObject/SActor.h"
+#include "SObject/SCookedWorld.h"
 #include "SObject/SComponent.h"
 #include "SObject/SObjectManager.h"
+#include "SObject/SWorld.h"
 #include "Engine/YRenderScene.h"
+#include "Utility/YJsonWriter.h"
 
 SActor::SActor()
 {
@@ -18,13 +21,14 @@ bool SActor::LoadFromJson(const Json::Value& root_json)
 	if (root_json.isMember("root_component"))
 	{
 		//actors
-		Json::Value root_component_value = root_json["root_component"];
+		const Json::Value& root_component_value = root_json["root_component"];
 		{
 			TRefCountPtr new_root_component = SComponent::ComponentFactory(root_component_value);
 			if (new_root_component)
 			{
 				root_component_ = new_root_component;
 			}
+			UpdateComponentList();
 		}
 		if (root_json.isMember("id"))
 		{
@@ -35,6 +39,23 @@ bool SActor::LoadFromJson(const Json::Value& root_json)
 		{
 			name_ = root_json["name"].asString();
 		}
+		critical_ = root_json["critical"].asBool();
+
+		if (root_json.isMember("tick_phases"))
+		{
+			const Json::Value& tick_phases = root_json["tick_phases"];
+			tick_phase_mask_ = 0;
+			for (int i = 0; i < (int)tick_phases.size(); ++i)
+			{
+				ETickPhase phase = GetTickPhaseFromName(tick_phases[i].asString());
+				if (phase == TP_Num)
+				{
+					WARNING_INFO("Actor ", name_, " unknown tick phase ", tick_phases[i].asString());
+					continue;
+				}
+				tick_phase_mask_ |= TickPhaseBit(phase);
+			}
+		}
 		LOG_INFO("Actor ", name_, " load success");
 		return true;
 	}
@@ -45,6 +66,78 @@ bool SActor::LoadFromJson(const Json::Value& root_json)
 	}
 }
 
+bool SActor::LoadFromCooked(const SCookedWorld& cooked_world, int actor_index)
+{
+	const SCookedActor& cooked_actor = cooked_world.GetActor(actor_index);
+	// parents come before their children, a component whose parent failed is dropped with it
+	std::vector<TRefCountPtr<SSceneComponent>> components(cooked_actor.component_count);
+	for (uint32_t i = 0; i < cooked_actor.component_count; ++i)
+	{
+		const uint32_t component_index = cooked_actor.first_component + i;
+		const SCookedComponent& cooked_component = cooked_world.GetComponent(component_index);
+		if (cooked_component.parent >= 0 && !components[cooked_component.parent])
+		{
+			continue;
+		}
+		TRefCountPtr<SSceneComponent> component = SComponent::CreateComponent(cooked_world.GetString(cooked_component.type_name));
+		if (!component || !component->LoadFromCooked(cooked_world, component_index))
+		{
+			continue;
+		}
+		if (cooked_component.parent >= 0)
+		{
+			components[cooked_component.parent]->AttachChild(component);
+		}
+		else
+		{
+			root_component_ = component;
+		}
+		components[i] = component;
+	}
+	UpdateComponentList();
+	id_ = cooked_actor.id;
+	name_ = cooked_world.GetString(cooked_actor.name);
+	if (cooked_actor.flags & SCookedActor::AF_TickPhases)
+	{
+		tick_phase_mask_ = cooked_actor.tick_phase_mask;
+	}
+	critical_ = (cooked_actor.flags & SCookedActor::AF_Critical) != 0;
+	return true;
+}
+
+bool SActor::SaveToJson(YJsonWriter& writer) const
+{
+	// components_ starts with the root
+	if (components_.empty() || !components_[0]->GetTypeName())
+	{
+		return false;
+	}
+	writer.BeginObject();
+	writer.Key("name").WriteString(name_);
+	writer.Key("id").WriteInt(id_);
+	if (critical_)
+	{
+		writer.Key("critical").WriteBool(true);
+	}
+	// the default mask is what a missing "tick_phases" loads as
+	if (tick_phase_mask_ != TickPhaseBit(TP_FinalizeTransform))
+	{
+		writer.Key("tick_phases").BeginArray(true);
+		for (int phase = 0; phase < TP_Num; ++phase)
+		{
+			if (tick_phase_mask_ & TickPhaseBit((ETickPhase)phase))
+			{
+				writer.WriteString(GetTickPhaseName((ETickPhase)phase));
+			}
+		}
+		writer.EndArray();
+	}
+	writer.Key("root_component");
+	components_[0]->SaveToJson(writer);
+	writer.EndObject();
+	return true;
+}
+
 bool SActor::PostLoadOp()
 {
 	if (root_component_)
@@ -62,10 +155,54 @@ void SActor::Update(double deta_time)
 	}
 }
 
+void SActor::TickPhase(ETickPhase phase, double deta_time, SWorldCommandBuffer& command_buffer)
+{
+	if (phase == TP_FinalizeTransform)
+	{
+		Update(deta_time);
+		// the spatial tree is shared by the world, it takes the moved bounds on the game thread after the phase
+		for (SSceneComponent* component : components_)
+		{
+			if (component->IsBoundsDirty())
+			{
+				command_buffer.Enqueue([this](SWorld* world) { world->UpdateComponentBounds(this); });
+				break;
+			}
+		}
+	}
+}
+
+void SActor::GatherComponents(SSceneComponent* component)
+{
+	component->actor_parent_ = this;
+	components_.push_back(component);
+	for (TRefCountPtr<SSceneComponent>& child : component->GetChildComponents())
+	{
+		GatherComponents(child.GetReference());
+	}
+}
+
+void SActor::UpdateComponentList()
+{
+	components_.clear();
+	if (SSceneComponent* root_scene_component = dynamic_cast<SSceneComponent*>(root_component_.GetReference()))
+	{
+		GatherComponents(root_scene_component);
+	}
+}
+
 void SActor::RegisterToScene(YScene* scene)
 {
-	if (root_component_)
+	for (SSceneComponent* component : components_)
+	{
+		component->RegisterToScene(scene);
+	}
+}
+
+void SActor::UnregisterFromScene(YScene* scene)
+{
+	for (SSceneComponent* component : components_)
 	{
-		root_component_->RegisterToScene(scene);
+		component->UnregisterFromScene(scene);
 	}
 }
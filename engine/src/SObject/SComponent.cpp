@@ -3,9 +3,12 @@
 #include <functional>
 #include "Engine/YReferenceCount.h"
 #include "SObject/SStaticMeshComponent.h"
+#include "SObject/SInstancedStaticMeshComponent.h"
 #include "Engine/YLight.h"
 #include "Utility/YJsonHelper.h"
 #include "Engine/YRenderScene.h"
+#include "SObject/SCookedWorld.h"
+#include "Utility/YJsonWriter.h"
 
 SSceneComponent::SSceneComponent(EComponentType type)
 	:SComponent(type)
@@ -44,7 +47,7 @@ void SSceneComponent::UpdateComponentToWorldWithParentRecursive()
 	is_component_to_world_update_ = true;
 	YTransform NewTransform;
 	{
-		YTransform RelativeTransform(local_translation_, local_rotation_.ToQuat(), local_scale_);
+		YTransform RelativeTransform(local_translation_, GetLocalRotationQuat(), local_scale_);
 		if (parent_component_)
 		{
 			NewTransform = RelativeTransform * parent_component_->GetComponentTransform();
@@ -60,9 +63,21 @@ void SSceneComponent::UpdateComponentToWorldWithParentRecursive()
 	OnTransformChange();
 }
 
+const YQuat& SSceneComponent::GetLocalRotationQuat()
+{
+	// most components never rotate after load, the sin and cos of the conversion dominate the relative transform
+	if (local_rotation_.pitch != local_rotation_quat_source_.pitch || local_rotation_.yaw != local_rotation_quat_source_.yaw || local_rotation_.roll != local_rotation_quat_source_.roll)
+	{
+		local_rotation_quat_source_ = local_rotation_;
+		local_rotation_quat_ = local_rotation_.ToQuat();
+	}
+	return local_rotation_quat_;
+}
+
 void SSceneComponent::PropagateTransformUpdate()
 {
 	UpdateBound();
+	is_bounds_dirty_ = true;
 	UpdateChildTransforms();
 }
 
@@ -115,6 +130,84 @@ bool SSceneComponent::LoadFromJson(const Json::Value& root_json)
 	return true;
 }
 
+bool SSceneComponent::CookFromJson(const Json::Value& root_json, SCookedWorldWriter& writer) const
+{
+	SCookedTransform& transform = writer.GetTransform();
+	YVector translation;
+	if (root_json.isMember("local_translation") && YJsonHelper::ConvertJsonToVector(root_json["local_translation"], translation))
+	{
+		transform.flags |= SCookedTransform::TF_Translation;
+		transform.translation[0] = translation.x;
+		transform.translation[1] = translation.y;
+		transform.translation[2] = translation.z;
+	}
+	YRotator rotation;
+	if (root_json.isMember("local_rotation") && YJsonHelper::ConvertJsonToRotator(root_json["local_rotation"], rotation))
+	{
+		transform.flags |= SCookedTransform::TF_Rotation;
+		transform.rotation[0] = rotation.pitch;
+		transform.rotation[1] = rotation.yaw;
+		transform.rotation[2] = rotation.roll;
+	}
+	YVector scale;
+	if (root_json.isMember("local_scale") && YJsonHelper::ConvertJsonToVector(root_json["local_scale"], scale))
+	{
+		transform.flags |= SCookedTransform::TF_Scale;
+		transform.scale[0] = scale.x;
+		transform.scale[1] = scale.y;
+		transform.scale[2] = scale.z;
+	}
+	return true;
+}
+
+bool SSceneComponent::LoadFromCooked(const SCookedWorld& cooked_world, uint32_t component_index)
+{
+	const SCookedTransform& transform = cooked_world.GetTransform(component_index);
+	if (transform.flags & SCookedTransform::TF_Translation)
+	{
+		local_translation_ = YVector(transform.translation[0], transform.translation[1], transform.translation[2]);
+	}
+	if (transform.flags & SCookedTransform::TF_Rotation)
+	{
+		local_rotation_ = YRotator(transform.rotation[0], transform.rotation[1], transform.rotation[2]);
+	}
+	if (transform.flags & SCookedTransform::TF_Scale)
+	{
+		local_scale_ = YVector(transform.scale[0], transform.scale[1], transform.scale[2]);
+	}
+	return true;
+}
+
+bool SSceneComponent::SaveToJson(YJsonWriter& writer) const
+{
+	const char* type_name = GetTypeName();
+	if (!type_name)
+	{
+		return false;
+	}
+	writer.BeginObject();
+	writer.Key("type").WriteString(type_name);
+	SaveMembersToJson(writer);
+	if (!child_components_.empty())
+	{
+		writer.Key("children").BeginArray();
+		for (const TRefCountPtr<SSceneComponent>& child : child_components_)
+		{
+			child->SaveToJson(writer);
+		}
+		writer.EndArray();
+	}
+	writer.EndObject();
+	return true;
+}
+
+void SSceneComponent::SaveMembersToJson(YJsonWriter& writer) const
+{
+	writer.Key("local_translation").WriteVector(local_translation_);
+	writer.Key("local_rotation").WriteRotator(local_rotation_);
+	writer.Key("local_scale").WriteVector(local_scale_);
+}
+
 bool SSceneComponent::PostLoadOp()
 {
 	UpdateComponentToWorld();
@@ -136,6 +229,29 @@ void SSceneComponent::RegisterToScene(YScene* scene)
 
 }
 
+void SSceneComponent::AttachChild(TRefCountPtr<SSceneComponent> child)
+{
+	assert(child && !child->parent_component_);
+	child->parent_component_ = this;
+	child->is_component_to_world_update_ = false;
+	child_components_.push_back(child);
+}
+
+TRefCountPtr<SSceneComponent> SSceneComponent::DetachChild(SSceneComponent* child)
+{
+	for (auto iter = child_components_.begin(); iter != child_components_.end(); ++iter)
+	{
+		if (iter->GetReference() == child)
+		{
+			TRefCountPtr<SSceneComponent> detached_child = *iter;
+			child_components_.erase(iter);
+			detached_child->parent_component_ = nullptr;
+			return detached_child;
+		}
+	}
+	return nullptr;
+}
+
 void SSceneComponent::OnTransformChange()
 {
 
@@ -143,19 +259,19 @@ void SSceneComponent::OnTransformChange()
 
 std::unordered_map<std::string, std::function<SSceneComponent*()> > register_component_map =
 {
-	{"StaticMesh",[]() { return new SStaticMeshComponent(); }},
-	{"DirectionLight",[]() { return new SDirectionLightComponent(); }}
+	{SStaticMeshComponent::type_name,[]() { return new (YObjectPool::Get<SStaticMeshComponent>()) SStaticMeshComponent(); }},
+	{SDirectionLightComponent::type_name,[]() { return new (YObjectPool::Get<SDirectionLightComponent>()) SDirectionLightComponent(); }},
+	{SInstancedStaticMeshComponent::type_name,[]() { return new (YObjectPool::Get<SInstancedStaticMeshComponent>()) SInstancedStaticMeshComponent(); }}
 };
 TRefCountPtr<SSceneComponent> SComponent::ComponentFactory(const Json::Value& RootJson)
 {
 	if (RootJson.isMember("type"))
 	{
-		std::string compoennt_type_name = RootJson["type"].asString();
-		if (!register_component_map.count(compoennt_type_name))
+		TRefCountPtr<SSceneComponent> new_component = CreateComponent(RootJson["type"].asString());
+		if (!new_component)
 		{
 			return nullptr;
 		}
-		TRefCountPtr<SSceneComponent> new_component = register_component_map[compoennt_type_name]();
 		if (!new_component->LoadFromJson(RootJson))
 		{
 			return nullptr;
@@ -168,6 +284,17 @@ TRefCountPtr<SSceneComponent> SComponent::ComponentFactory(const Json::Value& Ro
 	}
 }
 
+TRefCountPtr<SSceneComponent> SComponent::CreateComponent(const std::string& type_name)
+{
+	// find only, actors are loaded on task system workers
+	auto find_result = register_component_map.find(type_name);
+	if (find_result == register_component_map.end())
+	{
+		return nullptr;
+	}
+	return find_result->second();
+}
+
 SComponent::EComponentType SComponent::GetComponentType() const
 {
 	return component_type_;
@@ -178,6 +305,11 @@ void SComponent::RegisterToScene(YScene* scene)
 	
 }
 
+void SComponent::UnregisterFromScene(YScene* scene)
+{
+
+}
+
 SActor* SComponent::GetParentActor() const
 {
 	 return actor_parent_; 
@@ -206,11 +338,8 @@ void SRenderComponent::Update(double deta_time)
 
 void SRenderComponent::RegisterToScene(YScene* scene)
 {
+	// children are registered by SActor from its flat component list
 	assert(scene);
-	for (auto& child : child_components_)
-	{
-		child->RegisterToScene(scene);
-	}
 }
 
 bool SRenderComponent::LoadFromJson(const Json::Value& RootJson)
@@ -298,9 +427,71 @@ bool SDirectionLightComponent::LoadFromJson(const Json::Value& RootJson)
 	return true;
 }
 
-void SDirectionLightComponent::RegisterToScene(YScene* scene)
+
+struct SCookedDirectionLight
+{
+	enum EFlag
+	{
+		DLF_Strength = 1 << 0,
+		DLF_Color = 1 << 1,
+	};
+	uint32_t flags = 0;
+	float strength = 0.0f;
+	float color[4] = { 0.0f,0.0f,0.0f,0.0f };
+};
+
+bool SDirectionLightComponent::CookFromJson(const Json::Value& root_json, SCookedWorldWriter& writer) const
+{
+	if (!SLightComponent::CookFromJson(root_json, writer))
+	{
+		return false;
+	}
+	SCookedDirectionLight cooked_light;
+	if (root_json.isMember("strength"))
+	{
+		cooked_light.flags |= SCookedDirectionLight::DLF_Strength;
+		cooked_light.strength = root_json["strength"].asFloat();
+	}
+	YVector4 color = YVector4::zero_vector;
+	if (root_json.isMember("color") && YJsonHelper::ConvertJsonToVector4(root_json["color"], color))
+	{
+		cooked_light.flags |= SCookedDirectionLight::DLF_Color;
+		cooked_light.color[0] = color.x;
+		cooked_light.color[1] = color.y;
+		cooked_light.color[2] = color.z;
+		cooked_light.color[3] = color.w;
+	}
+	writer.SetPayload(cooked_light);
+	return true;
+}
+
+bool SDirectionLightComponent::LoadFromCooked(const SCookedWorld& cooked_world, uint32_t component_index)
 {
-	scene->direct_light_components_.insert(this);
+	SCookedDirectionLight cooked_light;
+	if (!SLightComponent::LoadFromCooked(cooked_world, component_index) || !cooked_world.GetPayload(component_index, cooked_light))
+	{
+		return false;
+	}
+	dir_light_ = std::make_unique<DirectLight>();
+	if (cooked_light.flags & SCookedDirectionLight::DLF_Strength)
+	{
+		dir_light_->SetLightStrength(cooked_light.strength);
+	}
+	if (cooked_light.flags & SCookedDirectionLight::DLF_Color)
+	{
+		dir_light_->SetLightColor(YVector4(cooked_light.color[0], cooked_light.color[1], cooked_light.color[2], cooked_light.color[3]));
+	}
+	return true;
+}
+
+void SDirectionLightComponent::SaveMembersToJson(YJsonWriter& writer) const
+{
+	SLightComponent::SaveMembersToJson(writer);
+	if (dir_light_)
+	{
+		writer.Key("strength").WriteFloat(dir_light_->GetLightStrength());
+		writer.Key("color").WriteVector4(dir_light_->GetLightColor());
+	}
 }
 
 bool SDirectionLightComponent::PostLoadOp()
@@ -0,0 +1,69 @@
+#include "SObject/SComponentStorage.h"
+
+void SComponentStorage::AddActorComponents(SActor* actor)
+{
+	for (SSceneComponent* component : actor->GetComponents())
+	{
+		AddComponent(component);
+	}
+}
+
+void SComponentStorage::RemoveActorComponents(SActor* actor)
+{
+	for (SSceneComponent* component : actor->GetComponents())
+	{
+		RemoveComponent(component);
+	}
+}
+
+void SComponentStorage::AddComponent(SComponent* component)
+{
+	assert(component);
+	if (component->storage_index_ >= 0)
+	{
+		return;
+	}
+	std::vector<SComponent*>& components = components_[component->GetComponentType()];
+	component->storage_index_ = (int)components.size();
+	components.push_back(component);
+}
+
+void SComponentStorage::RemoveComponent(SComponent* component)
+{
+	assert(component);
+	const int index = component->storage_index_;
+	if (index < 0)
+	{
+		return;
+	}
+	std::vector<SComponent*>& components = components_[component->GetComponentType()];
+	assert(index < (int)components.size() && components[index] == component);
+	SComponent* last_component = components.back();
+	components[index] = last_component;
+	last_component->storage_index_ = index;
+	components.pop_back();
+	component->storage_index_ = -1;
+}
+
+void SComponentStorage::Clear()
+{
+	for (std::vector<SComponent*>& components : components_)
+	{
+		for (SComponent* component : components)
+		{
+			component->storage_index_ = -1;
+		}
+		components.clear();
+	}
+}
+
+const std::vector<SComponent*>& SComponentStorage::GetComponents(SComponent::EComponentType type) const
+{
+	assert(type >= 0 && type < SComponent::ComNum);
+	return components_[type];
+}
+
+int SComponentStorage::GetComponentCount(SComponent::EComponentType type) const
+{
+	return (int)GetComponents(type).size();
+}
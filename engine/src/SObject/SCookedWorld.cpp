@@ -0,0 +1,329 @@
+#include "SObject/SCookedWorld.h"
+#include "SObject/SObjectManager.h"
+#include "Utility/YJsonHelper.h"
+#include "Utility/YPath.h"
+#include "Engine/YLog.h"
+
+uint32_t SCookedWorldWriter::InternString(const std::string& str)
+{
+	auto find_result = string_map_.find(str);
+	if (find_result != string_map_.end())
+	{
+		return find_result->second;
+	}
+	uint32_t index = (uint32_t)strings_.size();
+	strings_.push_back(str);
+	string_map_[str] = index;
+	return index;
+}
+
+bool SCookedWorldWriter::CookActor(const Json::Value& actor_json)
+{
+	// same rule as SActor::LoadFromJson, an actor without root component is not loaded at all
+	if (!actor_json.isMember("root_component"))
+	{
+		WARNING_INFO("cook actor ", actor_json["name"].asString(), " skipped, no root_component");
+		return false;
+	}
+	SCookedActor actor;
+	actor.first_component = (uint32_t)components_.size();
+	CookComponent(actor_json["root_component"], -1, actor.first_component);
+	actor.component_count = (uint32_t)components_.size() - actor.first_component;
+	if (actor_json.isMember("id"))
+	{
+		actor.id = actor_json["id"].asInt();
+	}
+	actor.name = InternString(actor_json["name"].asString());
+	if (actor_json.isMember("tick_phases"))
+	{
+		const Json::Value& tick_phases = actor_json["tick_phases"];
+		actor.flags |= SCookedActor::AF_TickPhases;
+		for (int i = 0; i < (int)tick_phases.size(); ++i)
+		{
+			ETickPhase phase = GetTickPhaseFromName(tick_phases[i].asString());
+			if (phase == TP_Num)
+			{
+				WARNING_INFO("cook actor ", actor_json["name"].asString(), " unknown tick phase ", tick_phases[i].asString());
+				continue;
+			}
+			actor.tick_phase_mask |= TickPhaseBit(phase);
+		}
+	}
+	if (actor_json["critical"].asBool())
+	{
+		actor.flags |= SCookedActor::AF_Critical;
+	}
+	actors_.push_back(actor);
+	return true;
+}
+
+bool SCookedWorldWriter::CookComponent(const Json::Value& component_json, int parent, uint32_t first_component)
+{
+	if (!component_json.isMember("type"))
+	{
+		return false;
+	}
+	const std::string type_name = component_json["type"].asString();
+	// throwaway instance, only the virtual CookFromJson of the type is needed
+	TRefCountPtr<SSceneComponent> component = SComponent::CreateComponent(type_name);
+	if (!component)
+	{
+		WARNING_INFO("cook component skipped, unknown type ", type_name);
+		return false;
+	}
+	const size_t payload_size = payload_.size();
+	SCookedComponent cooked_component;
+	cooked_component.type_name = InternString(type_name);
+	cooked_component.parent = parent;
+	components_.push_back(cooked_component);
+	transforms_.push_back(SCookedTransform());
+	if (!component->CookFromJson(component_json, *this))
+	{
+		components_.pop_back();
+		transforms_.pop_back();
+		payload_.resize(payload_size);
+		return false;
+	}
+	const int component_index = (int)(components_.size() - 1 - first_component);
+	const Json::Value& children = component_json["children"];
+	for (int i = 0; i < (int)children.size(); ++i)
+	{
+		CookComponent(children[i], component_index, first_component);
+	}
+	return true;
+}
+
+void SCookedWorldWriter::WriteToMemoryFile(MemoryFile& mem_file)
+{
+	std::vector<uint32_t> string_offsets;
+	std::vector<char> string_data;
+	string_offsets.reserve(strings_.size());
+	for (const std::string& str : strings_)
+	{
+		string_offsets.push_back((uint32_t)string_data.size());
+		string_data.insert(string_data.end(), str.begin(), str.end());
+		string_data.push_back('\0');
+	}
+	header_.magic = SCookedWorld::cooked_world_magic;
+	header_.version = SCookedWorld::cooked_world_version;
+	header_.string_count = (uint32_t)string_offsets.size();
+	header_.string_data_size = (uint32_t)string_data.size();
+	header_.actor_count = (uint32_t)actors_.size();
+	header_.component_count = (uint32_t)components_.size();
+	header_.payload_size = (uint32_t)payload_.size();
+	header_.partition_cell_count = (uint32_t)partition_cells_.size();
+
+	mem_file.WriteElemts(&header_, 1);
+	mem_file.WriteElemts(string_offsets.data(), (int)string_offsets.size());
+	mem_file.WriteElemts(string_data.data(), (int)string_data.size());
+	mem_file.WriteElemts(actors_.data(), (int)actors_.size());
+	mem_file.WriteElemts(components_.data(), (int)components_.size());
+	mem_file.WriteElemts(transforms_.data(), (int)transforms_.size());
+	mem_file.WriteElemts(payload_.data(), (int)payload_.size());
+	mem_file.WriteElemts(&partition_settings_, 1);
+	mem_file.WriteElemts(partition_cells_.data(), (int)partition_cells_.size());
+}
+
+bool SCookedWorld::Cook(const Json::Value& world_json, MemoryFile& out_mem_file)
+{
+	SCookedWorldWriter writer;
+	if (world_json.isMember("tick_batch_size"))
+	{
+		writer.header_.flags |= WF_TickBatchSize;
+		writer.header_.tick_batch_size = world_json["tick_batch_size"].asInt();
+	}
+	if (world_json.isMember("partition"))
+	{
+		const Json::Value& partition_json = world_json["partition"];
+		// defaults and validation are applied here, the loader takes the settings as they are
+		SWorldPartitionSettings settings;
+		settings.LoadFromJson(partition_json);
+		writer.header_.flags |= WF_Partition;
+		writer.partition_settings_.cell_size = settings.cell_size;
+		writer.partition_settings_.loading_radius = settings.loading_radius;
+		writer.partition_settings_.unloading_radius = settings.unloading_radius;
+		writer.partition_settings_.memory_budget_mb = settings.memory_budget_mb;
+		writer.partition_settings_.finalize_budget_ms = settings.finalize_budget_ms;
+		const Json::Value& cells = partition_json["cells"];
+		for (int i = 0; i < (int)cells.size(); ++i)
+		{
+			SWorldCellDesc cell_desc;
+			cell_desc.LoadFromJson(cells[i]);
+			SCookedPartitionCell cell;
+			cell.x = cell_desc.coord.x;
+			cell.z = cell_desc.coord.z;
+			cell.file = writer.InternString(cell_desc.file_path);
+			cell.actor_count = cell_desc.actor_count;
+			memcpy(cell.bounds_min, &cell_desc.bounds.min_corner.x, sizeof(cell.bounds_min));
+			memcpy(cell.bounds_max, &cell_desc.bounds.max_corner.x, sizeof(cell.bounds_max));
+			writer.partition_cells_.push_back(cell);
+		}
+	}
+	const Json::Value& actors = world_json["actors"];
+	for (int i = 0; i < (int)actors.size(); ++i)
+	{
+		writer.CookActor(actors[i]);
+	}
+	writer.WriteToMemoryFile(out_mem_file);
+	return true;
+}
+
+bool SCookedWorld::CookWorldFile(const std::string& json_path)
+{
+	Json::Arena arena;
+	Json::Value world_json;
+	if (!YJsonHelper::LoadJsonFromFile(json_path, world_json, &arena))
+	{
+		return false;
+	}
+	MemoryFile mem_file(MemoryFile::FT_Write);
+	if (!Cook(world_json, mem_file))
+	{
+		return false;
+	}
+	const std::string cooked_path = GetCookedPath(json_path);
+	YFile cooked_file(cooked_path, YFile::FileType(YFile::FT_Write | YFile::FT_BINARY));
+	if (!cooked_file.WriteFile(&mem_file, true))
+	{
+		ERROR_INFO("cook world ", json_path, " failed! write ", cooked_path, " error");
+		return false;
+	}
+	bool cells_cooked = true;
+	const Json::Value& cells = world_json["partition"]["cells"];
+	for (int i = 0; i < (int)cells.size(); ++i)
+	{
+		cells_cooked &= CookWorldFile(cells[i]["file"].asString());
+	}
+	LOG_INFO("cook world ", json_path, " to ", cooked_path, " ", mem_file.GetSize(), " bytes");
+	return cells_cooked;
+}
+
+std::string SCookedWorld::GetCookedPath(const std::string& path)
+{
+	return YPath::GetBaseFilename(path, false) + SObject::asset_extension_with_dot;
+}
+
+template<typename T>
+static bool ReadCookedTable(MemoryFile& mem_file, std::vector<T>& table, uint32_t count)
+{
+	// one memcpy per table, the size check against the file comes first so a corrupt count does not allocate
+	if ((uint64_t)count * sizeof(T) > mem_file.GetSize())
+	{
+		return false;
+	}
+	table.resize(count);
+	return count == 0 || mem_file.ReadElemts(table.data(), (int)count);
+}
+
+bool SCookedWorld::Load(std::unique_ptr<MemoryFile> mem_file)
+{
+	if (!mem_file || !mem_file->ReadElemts(&header_, 1))
+	{
+		ERROR_INFO("cooked world is truncated");
+		return false;
+	}
+	if (header_.magic != cooked_world_magic || header_.version != cooked_world_version)
+	{
+		ERROR_INFO("cooked world version ", header_.version, " is not supported, cook the world again");
+		return false;
+	}
+	if (!ReadCookedTable(*mem_file, string_offsets_, header_.string_count)
+		|| !ReadCookedTable(*mem_file, string_data_, header_.string_data_size)
+		|| !ReadCookedTable(*mem_file, actors_, header_.actor_count)
+		|| !ReadCookedTable(*mem_file, components_, header_.component_count)
+		|| !ReadCookedTable(*mem_file, transforms_, header_.component_count)
+		|| !ReadCookedTable(*mem_file, payload_, header_.payload_size)
+		|| !mem_file->ReadElemts(&partition_settings_, 1)
+		|| !ReadCookedTable(*mem_file, partition_cells_, header_.partition_cell_count))
+	{
+		ERROR_INFO("cooked world is truncated");
+		return false;
+	}
+
+	// validate once, LoadActor runs on workers and trusts every index
+	if (!string_data_.empty() && string_data_.back() != '\0')
+	{
+		ERROR_INFO("cooked world string table is corrupt");
+		return false;
+	}
+	auto is_valid_string = [this](uint32_t index) { return index < string_offsets_.size() && string_offsets_[index] < string_data_.size(); };
+	for (uint32_t offset : string_offsets_)
+	{
+		if (offset >= string_data_.size())
+		{
+			ERROR_INFO("cooked world string table is corrupt");
+			return false;
+		}
+	}
+	for (const SCookedComponent& component : components_)
+	{
+		if (!is_valid_string(component.type_name) || (uint64_t)component.payload_offset + component.payload_size > payload_.size())
+		{
+			ERROR_INFO("cooked world component table is corrupt");
+			return false;
+		}
+	}
+	for (const SCookedActor& actor : actors_)
+	{
+		if (!is_valid_string(actor.name) || (uint64_t)actor.first_component + actor.component_count > components_.size())
+		{
+			ERROR_INFO("cooked world actor table is corrupt");
+			return false;
+		}
+		for (uint32_t i = 0; i < actor.component_count; ++i)
+		{
+			const int parent = components_[actor.first_component + i].parent;
+			if ((i == 0) != (parent < 0) || parent >= (int)i)
+			{
+				ERROR_INFO("cooked world component tree is corrupt");
+				return false;
+			}
+		}
+	}
+	for (const SCookedPartitionCell& cell : partition_cells_)
+	{
+		if (!is_valid_string(cell.file))
+		{
+			ERROR_INFO("cooked world partition table is corrupt");
+			return false;
+		}
+	}
+	return true;
+}
+
+TRefCountPtr<SActor> SCookedWorld::LoadActor(int actor_index) const
+{
+	TRefCountPtr<SActor> actor_ins = SObjectManager::ConstructInstance<SActor>();
+	if (!actor_ins->LoadFromCooked(*this, actor_index))
+	{
+		ERROR_INFO("load cooked SActor ", GetString(actors_[actor_index].name), " failed!");
+		return nullptr;
+	}
+	return actor_ins;
+}
+
+SWorldPartitionSettings SCookedWorld::GetPartitionSettings() const
+{
+	SWorldPartitionSettings settings;
+	settings.cell_size = partition_settings_.cell_size;
+	settings.loading_radius = partition_settings_.loading_radius;
+	settings.unloading_radius = partition_settings_.unloading_radius;
+	settings.memory_budget_mb = partition_settings_.memory_budget_mb;
+	settings.finalize_budget_ms = partition_settings_.finalize_budget_ms;
+	return settings;
+}
+
+std::vector<SWorldCellDesc> SCookedWorld::GetPartitionCells() const
+{
+	std::vector<SWorldCellDesc> cells(partition_cells_.size());
+	for (size_t i = 0; i < partition_cells_.size(); ++i)
+	{
+		cells[i].coord.x = partition_cells_[i].x;
+		cells[i].coord.z = partition_cells_[i].z;
+		cells[i].file_path = GetString(partition_cells_[i].file);
+		cells[i].actor_count = partition_cells_[i].actor_count;
+		cells[i].bounds = YBox(YVector(partition_cells_[i].bounds_min[0], partition_cells_[i].bounds_min[1], partition_cells_[i].bounds_min[2]),
+			YVector(partition_cells_[i].bounds_max[0], partition_cells_[i].bounds_max[1], partition_cells_[i].bounds_max[2]));
+	}
+	return cells;
+}
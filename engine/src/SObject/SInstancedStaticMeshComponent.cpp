@@ -0,0 +1,480 @@
+#include "SObject/SInstancedStaticMeshComponent.h"
+#include "Engine/YStaticMeshCache.h"
+#include "SObject/SCookedWorld.h"
+#include "Utility/YJsonHelper.h"
+#include "Utility/YJsonWriter.h"
+#include <algorithm>
+
+SInstancedStaticMeshComponent::SInstancedStaticMeshComponent() :
+	SRenderComponent(EComponentType::InstancedStaticMeshComponent)
+{
+
+}
+
+SInstancedStaticMeshComponent::~SInstancedStaticMeshComponent()
+{
+
+}
+
+// members missing from the json keep the identity, as those of a component
+static YTransform ConvertJsonToInstance(const Json::Value& instance_json)
+{
+	YVector translation(0.0f, 0.0f, 0.0f);
+	YRotator rotation(0.0f, 0.0f, 0.0f);
+	YVector scale(1.0f, 1.0f, 1.0f);
+	if (instance_json.isMember("translation"))
+	{
+		YJsonHelper::ConvertJsonToVector(instance_json["translation"], translation);
+	}
+	if (instance_json.isMember("rotation"))
+	{
+		YJsonHelper::ConvertJsonToRotator(instance_json["rotation"], rotation);
+	}
+	if (instance_json.isMember("scale"))
+	{
+		YJsonHelper::ConvertJsonToVector(instance_json["scale"], scale);
+	}
+	return YTransform(translation, rotation.ToQuat(), scale);
+}
+
+bool SInstancedStaticMeshComponent::LoadFromJson(const Json::Value& RootJson)
+{
+	SRenderComponent::LoadFromJson(RootJson);
+	if (RootJson.isMember("cluster_size"))
+	{
+		cluster_size_ = std::max(1, RootJson["cluster_size"].asInt());
+	}
+	if (RootJson.isMember("instances"))
+	{
+		const Json::Value& instances_json = RootJson["instances"];
+		instances_.reserve(instances_json.size());
+		for (int i = 0; i < (int)instances_json.size(); ++i)
+		{
+			AddInstance(ConvertJsonToInstance(instances_json[i]));
+		}
+	}
+	if (RootJson.isMember("model"))
+	{
+		model_path_ = RootJson["model"].asString();
+		static_mesh_ = YStaticMeshCache::Get().LoadStaticMesh(model_path_);
+		if (static_mesh_)
+		{
+			LOG_INFO("Instanced static mesh load success! ", model_path_, " instances ", instances_.size());
+			return true;
+		}
+	}
+	static_mesh_ = nullptr;
+	LOG_INFO("Instanced static mesh load failed! ");
+	return false;
+}
+
+struct SCookedInstancedStaticMesh
+{
+	uint32_t model = 0;
+	int cluster_size = 0;
+};
+
+// follows the SCookedInstancedStaticMesh, the rotation is kept as the quat so loading converts nothing
+struct SCookedInstance
+{
+	float translation[3] = { 0.0f,0.0f,0.0f };
+	float rotation[4] = { 0.0f,0.0f,0.0f,1.0f };
+	float scale[3] = { 1.0f,1.0f,1.0f };
+};
+
+bool SInstancedStaticMeshComponent::CookFromJson(const Json::Value& root_json, SCookedWorldWriter& writer) const
+{
+	if (!SRenderComponent::CookFromJson(root_json, writer) || !root_json.isMember("model"))
+	{
+		return false;
+	}
+	SCookedInstancedStaticMesh cooked_mesh;
+	cooked_mesh.model = writer.InternString(root_json["model"].asString());
+	cooked_mesh.cluster_size = root_json.isMember("cluster_size") ? std::max(1, root_json["cluster_size"].asInt()) : default_cluster_size;
+	std::vector<SCookedInstance> cooked_instances;
+	if (root_json.isMember("instances"))
+	{
+		const Json::Value& instances_json = root_json["instances"];
+		cooked_instances.resize(instances_json.size());
+		for (int i = 0; i < (int)instances_json.size(); ++i)
+		{
+			const YTransform instance = ConvertJsonToInstance(instances_json[i]);
+			SCookedInstance& cooked_instance = cooked_instances[i];
+			cooked_instance.translation[0] = instance.translation.x;
+			cooked_instance.translation[1] = instance.translation.y;
+			cooked_instance.translation[2] = instance.translation.z;
+			cooked_instance.rotation[0] = instance.rotator.x;
+			cooked_instance.rotation[1] = instance.rotator.y;
+			cooked_instance.rotation[2] = instance.rotator.z;
+			cooked_instance.rotation[3] = instance.rotator.w;
+			cooked_instance.scale[0] = instance.scale.x;
+			cooked_instance.scale[1] = instance.scale.y;
+			cooked_instance.scale[2] = instance.scale.z;
+		}
+	}
+	writer.SetPayload(cooked_mesh, cooked_instances);
+	return true;
+}
+
+bool SInstancedStaticMeshComponent::LoadFromCooked(const SCookedWorld& cooked_world, uint32_t component_index)
+{
+	SCookedInstancedStaticMesh cooked_mesh;
+	std::vector<SCookedInstance> cooked_instances;
+	if (!SRenderComponent::LoadFromCooked(cooked_world, component_index) || !cooked_world.GetPayload(component_index, cooked_mesh, cooked_instances))
+	{
+		return false;
+	}
+	cluster_size_ = std::max(1, cooked_mesh.cluster_size);
+	instances_.reserve(cooked_instances.size());
+	for (const SCookedInstance& cooked_instance : cooked_instances)
+	{
+		AddInstance(YTransform(YVector(cooked_instance.translation[0], cooked_instance.translation[1], cooked_instance.translation[2]),
+			YQuat(cooked_instance.rotation[0], cooked_instance.rotation[1], cooked_instance.rotation[2], cooked_instance.rotation[3]),
+			YVector(cooked_instance.scale[0], cooked_instance.scale[1], cooked_instance.scale[2])));
+	}
+	model_path_ = cooked_world.GetString(cooked_mesh.model);
+	static_mesh_ = YStaticMeshCache::Get().LoadStaticMesh(model_path_);
+	if (!static_mesh_)
+	{
+		ERROR_INFO("Instanced static mesh load failed! ", model_path_);
+		return false;
+	}
+	return true;
+}
+
+bool SInstancedStaticMeshComponent::PostLoadOp()
+{
+	SRenderComponent::PostLoadOp();
+	if (static_mesh_)
+	{
+		// shared mesh, only the first component to get here creates the buffers
+		return static_mesh_->AllocGpuResource() && static_mesh_->AllocInstancedGpuResource();
+	}
+	return true;
+}
+
+void SInstancedStaticMeshComponent::Update(double deta_time)
+{
+	SRenderComponent::Update(deta_time);
+	FlushInstanceUpdates();
+}
+
+YStaticMesh* SInstancedStaticMeshComponent::GetMesh()
+{
+	return static_mesh_.GetReference();
+}
+
+int SInstancedStaticMeshComponent::AddInstance(const YTransform& transform)
+{
+	const int instance_index = (int)instances_.size();
+	const int slot = (int)slot_matrices_.size();
+	instances_.push_back(transform);
+	instance_to_slot_.push_back(slot);
+	slot_to_instance_.push_back(instance_index);
+	slot_matrices_.push_back((transform * component_to_world_).ToMatrix());
+	// into the last cluster added after the build while it has room
+	if (clusters_.empty() || clusters_.back().node >= 0 || clusters_.back().count >= cluster_size_)
+	{
+		SInstanceCluster cluster;
+		cluster.first = slot;
+		clusters_.push_back(cluster);
+	}
+	++clusters_.back().count;
+	slot_to_cluster_.push_back((int)clusters_.size() - 1);
+	MarkClusterDirty((int)clusters_.size() - 1);
+	has_pending_update_ = true;
+	return instance_index;
+}
+
+void SInstancedStaticMeshComponent::UpdateInstance(int instance_index, const YTransform& transform)
+{
+	assert(instance_index >= 0 && instance_index < (int)instances_.size());
+	instances_[instance_index] = transform;
+	const int slot = instance_to_slot_[instance_index];
+	slot_matrices_[slot] = (transform * component_to_world_).ToMatrix();
+	MarkClusterDirty(slot_to_cluster_[slot]);
+	has_pending_update_ = true;
+}
+
+void SInstancedStaticMeshComponent::RemoveInstance(int instance_index)
+{
+	assert(instance_index >= 0 && instance_index < (int)instances_.size());
+	// the instance of the last slot moves into the freed one, so the slots stay packed and only the last cluster shrinks
+	const int slot = instance_to_slot_[instance_index];
+	const int last_slot = (int)slot_matrices_.size() - 1;
+	const int last_cluster = slot_to_cluster_[last_slot];
+	if (slot != last_slot)
+	{
+		const int moved_instance = slot_to_instance_[last_slot];
+		slot_to_instance_[slot] = moved_instance;
+		instance_to_slot_[moved_instance] = slot;
+		slot_matrices_[slot] = slot_matrices_[last_slot];
+		MarkClusterDirty(slot_to_cluster_[slot]);
+	}
+	slot_to_instance_.pop_back();
+	slot_to_cluster_.pop_back();
+	slot_matrices_.pop_back();
+	if (last_slot < built_slot_count_)
+	{
+		built_slot_count_ = last_slot;
+	}
+	++removed_since_build_;
+	SInstanceCluster& cluster = clusters_[last_cluster];
+	--cluster.count;
+	if (cluster.node < 0 && cluster.count == 0)
+	{
+		// the clusters added after the build are the last ones
+		assert(last_cluster == (int)clusters_.size() - 1);
+		clusters_.pop_back();
+	}
+	else
+	{
+		MarkClusterDirty(last_cluster);
+	}
+
+	// the last instance takes the index of the removed one
+	const int last_instance = (int)instances_.size() - 1;
+	if (instance_index != last_instance)
+	{
+		instances_[instance_index] = instances_[last_instance];
+		const int moved_slot = instance_to_slot_[last_instance];
+		instance_to_slot_[instance_index] = moved_slot;
+		slot_to_instance_[moved_slot] = instance_index;
+	}
+	instances_.pop_back();
+	instance_to_slot_.pop_back();
+	has_pending_update_ = true;
+}
+
+void SInstancedStaticMeshComponent::ClearInstances()
+{
+	instances_.clear();
+	instance_to_slot_.clear();
+	slot_to_instance_.clear();
+	slot_to_cluster_.clear();
+	slot_matrices_.clear();
+	clusters_.clear();
+	cluster_nodes_.clear();
+	node_to_cluster_.clear();
+	dirty_clusters_.clear();
+	built_slot_count_ = 0;
+	removed_since_build_ = 0;
+	has_pending_update_ = true;
+}
+
+void SInstancedStaticMeshComponent::FlushInstanceUpdates()
+{
+	if (!has_pending_update_)
+	{
+		return;
+	}
+	if (NeedsClusterTreeBuild())
+	{
+		BuildClusterTree();
+	}
+	else
+	{
+		RefitClusters(false);
+	}
+	has_pending_update_ = false;
+	is_bounds_dirty_ = true;
+}
+
+void SInstancedStaticMeshComponent::SaveMembersToJson(YJsonWriter& writer) const
+{
+	SRenderComponent::SaveMembersToJson(writer);
+	writer.Key("model").WriteString(model_path_);
+	if (cluster_size_ != default_cluster_size)
+	{
+		writer.Key("cluster_size").WriteInt(cluster_size_);
+	}
+	// in instance order, the rotation goes back through a rotator
+	writer.Key("instances").BeginArray();
+	for (const YTransform& instance : instances_)
+	{
+		writer.BeginObject();
+		writer.Key("translation").WriteVector(instance.translation);
+		writer.Key("rotation").WriteRotator(instance.rotator.Rotator());
+		writer.Key("scale").WriteVector(instance.scale);
+		writer.EndObject();
+	}
+	writer.EndArray();
+}
+
+void SInstancedStaticMeshComponent::UpdateBound()
+{
+	// the instances follow the component, every matrix and cluster box changes with it
+	std::vector<YTransform> world_transforms(slot_to_instance_.size());
+	for (size_t slot = 0; slot < slot_to_instance_.size(); ++slot)
+	{
+		world_transforms[slot] = instances_[slot_to_instance_[slot]] * component_to_world_;
+	}
+	YTransform::ToMatrices(slot_matrices_.data(), world_transforms.data(), world_transforms.size());
+	if (has_pending_update_ && NeedsClusterTreeBuild())
+	{
+		BuildClusterTree();
+	}
+	else
+	{
+		RefitClusters(true);
+	}
+	has_pending_update_ = false;
+}
+
+bool SInstancedStaticMeshComponent::NeedsClusterTreeBuild() const
+{
+	// a quarter of the instances outside of the tree or removed from it culls worse than a rebuild costs
+	const int changed_count = (int)slot_matrices_.size() - built_slot_count_ + removed_since_build_;
+	return changed_count > std::max(cluster_size_, built_slot_count_ / 4);
+}
+
+void SInstancedStaticMeshComponent::BuildClusterTree()
+{
+	const int instance_count = (int)instances_.size();
+	clusters_.clear();
+	cluster_nodes_.clear();
+	node_to_cluster_.clear();
+	dirty_clusters_.clear();
+	built_slot_count_ = instance_count;
+	removed_since_build_ = 0;
+	bounds_ = YBox();
+	if (instance_count == 0)
+	{
+		return;
+	}
+	std::vector<YBox> instance_boxes(instance_count);
+	for (int instance_index = 0; instance_index < instance_count; ++instance_index)
+	{
+		instance_boxes[instance_index] = GetSlotBox(instance_to_slot_[instance_index]);
+	}
+	std::vector<int> order;
+	YBVH::BuildClusters(instance_boxes, cluster_size_, cluster_nodes_, order);
+
+	// the slots take the order of the leaves
+	std::vector<YMatrix> slot_matrices(instance_count);
+	for (int slot = 0; slot < instance_count; ++slot)
+	{
+		slot_matrices[slot] = slot_matrices_[instance_to_slot_[order[slot]]];
+		instance_to_slot_[order[slot]] = slot;
+	}
+	slot_matrices_.swap(slot_matrices);
+	slot_to_instance_.swap(order);
+
+	// leaves in slot order, the left child holds the lower slots
+	node_to_cluster_.assign(cluster_nodes_.size(), -1);
+	slot_to_cluster_.resize(instance_count);
+	int stack[YBVH::max_depth * 2];
+	int stack_size = 0;
+	stack[stack_size++] = 0;
+	while (stack_size > 0)
+	{
+		const int node_index = stack[--stack_size];
+		const YBVHNode& node = cluster_nodes_[node_index];
+		if (node.count == 0)
+		{
+			stack[stack_size++] = node.first + 1;
+			stack[stack_size++] = node.first;
+			continue;
+		}
+		SInstanceCluster cluster;
+		cluster.first = node.first;
+		cluster.count = node.count;
+		cluster.box = YBox(node.min_corner, node.max_corner);
+		cluster.node = node_index;
+		node_to_cluster_[node_index] = (int)clusters_.size();
+		std::fill(slot_to_cluster_.begin() + node.first, slot_to_cluster_.begin() + node.first + node.count, (int)clusters_.size());
+		clusters_.push_back(cluster);
+		bounds_ += cluster.box;
+	}
+}
+
+void SInstancedStaticMeshComponent::RefitClusters(bool refit_all)
+{
+	bool refit_tree = refit_all;
+	auto refit_cluster = [this](SInstanceCluster& cluster)
+	{
+		cluster.is_dirty = false;
+		cluster.box = YBox();
+		for (int slot = cluster.first; slot < cluster.first + cluster.count; ++slot)
+		{
+			cluster.box += GetSlotBox(slot);
+		}
+	};
+	if (refit_all)
+	{
+		for (SInstanceCluster& cluster : clusters_)
+		{
+			refit_cluster(cluster);
+		}
+	}
+	else
+	{
+		for (int cluster_index : dirty_clusters_)
+		{
+			// a cluster added after the build may have been removed again
+			if (cluster_index < (int)clusters_.size() && clusters_[cluster_index].is_dirty)
+			{
+				refit_cluster(clusters_[cluster_index]);
+				refit_tree |= clusters_[cluster_index].node >= 0;
+			}
+		}
+	}
+	dirty_clusters_.clear();
+
+	if (refit_tree)
+	{
+		for (const SInstanceCluster& cluster : clusters_)
+		{
+			if (cluster.node >= 0)
+			{
+				cluster_nodes_[cluster.node].min_corner = cluster.box.min_corner;
+				cluster_nodes_[cluster.node].max_corner = cluster.box.max_corner;
+			}
+		}
+		// children come after their parent
+		for (int node_index = (int)cluster_nodes_.size() - 1; node_index >= 0; --node_index)
+		{
+			YBVHNode& node = cluster_nodes_[node_index];
+			if (node.count == 0)
+			{
+				const YBVHNode& left = cluster_nodes_[node.first];
+				const YBVHNode& right = cluster_nodes_[node.first + 1];
+				YBox box(left.min_corner, left.max_corner);
+				box += YBox(right.min_corner, right.max_corner);
+				node.min_corner = box.min_corner;
+				node.max_corner = box.max_corner;
+			}
+		}
+	}
+
+	bounds_ = YBox();
+	for (const SInstanceCluster& cluster : clusters_)
+	{
+		if (cluster.count > 0)
+		{
+			bounds_ += cluster.box;
+		}
+	}
+}
+
+YBox SInstancedStaticMeshComponent::GetSlotBox(int slot) const
+{
+	const YMatrix& matrix = slot_matrices_[slot];
+	if (static_mesh_ && static_mesh_->GetBounds().IsValid())
+	{
+		return static_mesh_->GetBounds().TransformBy(matrix);
+	}
+	// without a mesh the instance is a point
+	const YVector origin(matrix.m[3][0], matrix.m[3][1], matrix.m[3][2]);
+	return YBox(origin, origin);
+}
+
+void SInstancedStaticMeshComponent::MarkClusterDirty(int cluster_index)
+{
+	SInstanceCluster& cluster = clusters_[cluster_index];
+	if (!cluster.is_dirty)
+	{
+		cluster.is_dirty = true;
+		dirty_clusters_.push_back(cluster_index);
+	}
+}
@@ -4,6 +4,7 @@
 #include "Engine/YFile.h"
 #include "reader.h"
 #include "Utility/YJsonHelper.h"
+#include "SObject/SObjectManager.h"
 
 SObject::~SObject()
 {
@@ -15,12 +16,40 @@ SObject::SObject()
 
 }
 
+uint32_t SObject::Release() const
+{
+	// read the handle first, this may be deleted by the release
+	SObjectHandle handle = handle_;
+	uint32_t refs = YThreadSafeRefCountedObject::Release();
+	if (refs == 1 && handle.IsValid())
+	{
+		SObjectManager::GetManager().EnqueuePendingDestroy(handle);
+	}
+	return refs;
+}
+
+bool SObject::IsBinaryPackageUpToDate(const std::string& binary_path, const std::string& json_path)
+{
+	uint64_t binary_time = 0;
+	if (!YPath::GetFileModifyTime(binary_path, binary_time))
+	{
+		return false;
+	}
+	uint64_t json_time = 0;
+	return !YPath::GetFileModifyTime(json_path, json_time) || binary_time >= json_time;
+}
+
 bool SObject::LoadFromPackage(const std::string& Path)
 {
 	std::string asset_binary_path = Path + asset_extension_with_dot;
 	std::string asset_json_path = Path + json_extension_with_dot;
-	bool asset_binary_exist = YPath::FileExists(asset_binary_path);
 	bool asset_json_exist = YPath::FileExists(asset_json_path);
+	// a binary older than the json was cooked before the last edit and would hide it
+	bool asset_binary_exist = IsBinaryPackageUpToDate(asset_binary_path, asset_json_path);
+	if (!asset_binary_exist && asset_json_exist && YPath::FileExists(asset_binary_path))
+	{
+		WARNING_INFO("binary package ", asset_binary_path, " is older than ", asset_json_path, ", the json is loaded");
+	}
 	if (asset_binary_exist)
 	{
 		YFile asset_file(asset_binary_path, YFile::FileType(YFile::FT_BINARY | YFile::FT_Read));
@@ -39,12 +68,7 @@ bool SObject::LoadFromPackage(const std::string& Path)
 	}
 	else if (asset_json_exist)
 	{
-		Json::Value json_root;
-		if (!YJsonHelper::LoadJsonFromFile(asset_json_path, json_root))
-		{
-			return false;
-		}
-		if (!LoadFromJson(json_root))
+		if (!LoadFromJsonFile(asset_json_path))
 		{
 			ERROR_INFO("load json package ", Path, "failed!, serialize failed!");
 			return false;
@@ -59,9 +83,35 @@ bool SObject::LoadFromPackage(const std::string& Path)
 	return true;
 }
 
-void SObject::SaveToPackage(const std::string& Path)
+bool SObject::LoadFromJsonFile(const std::string& json_path)
 {
+	Json::Arena arena;
+	Json::Value json_root;
+	if (!YJsonHelper::LoadJsonFromFile(json_path, json_root, &arena))
+	{
+		return false;
+	}
+	return LoadFromJson(json_root);
+}
+
+bool SObject::SaveToPackage(const std::string& Path)
+{
+	std::string asset_json_path = Path + json_extension_with_dot;
+	if (!YJsonHelper::WriteJsonToFile(asset_json_path, [this](YJsonWriter& writer) { return SaveToJson(writer); }, YJsonWriter::JS_Compact))
+	{
+		ERROR_INFO("save package ", Path, " failed!");
+		return false;
+	}
+	if (YPath::FileExists(Path + asset_extension_with_dot))
+	{
+		WARNING_INFO("save package ", Path, ", the binary package is loaded before the json, cook it again");
+	}
+	return true;
+}
 
+bool SObject::SaveToJson(YJsonWriter& writer) const
+{
+	return false;
 }
 
 bool SObject::LoadFromJson(const Json::Value& RootJson)
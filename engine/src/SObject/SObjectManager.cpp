@@ -7,76 +7,123 @@ SObjectManager::SObjectManager()
 
 }
 
-void SObjectManager::Destroy()
+SObjectManager::~SObjectManager()
 {
-	int DestroyUnitfyCount = 0;
-	int UnifyLeft = 0;
-	int DestroyInstanceCount = 0;
-	int InstanceLeft = 0;
-	do
-	{
-		UnifyLeft = 0;
-		DestroyUnitfyCount = 0;
-		for (auto iter = unify_objects_.begin(); iter != unify_objects_.end();)
-		{
-			if (iter->second.GetRefCount() == 1)
-			{
-				iter = unify_objects_.erase(iter);
-				DestroyUnitfyCount++;
-			}
-			else
-			{
-				UnifyLeft++;
-				iter++;
-			}
-		}
+	// objects still alive at exit release their children into pending_destroy_, drop them while it still exists
+	std::vector<ObjectSlot> slots;
+	slots.swap(slots_);
+	slots.clear();
+}
 
-		DestroyInstanceCount = 0;
-		InstanceLeft = 0;
-		for (auto iter = instanced_objects_.begin(); iter != instanced_objects_.end();)
-		{
-			if ((*iter).GetRefCount() == 1)
-			{
-				iter = instanced_objects_.erase(iter);
-				DestroyInstanceCount++;
-			}
-			else
-			{
-				iter++;
-				InstanceLeft++;
-			}
-		}
+SObjectHandle SObjectManager::Register(SObject* object, const std::string& unify_name /*= ""*/)
+{
+	assert(object && !object->handle_.IsValid());
+	std::lock_guard<std::mutex> lock(slots_mutex_);
+	uint32_t index = 0;
+	if (!free_slots_.empty())
+	{
+		index = free_slots_.back();
+		free_slots_.pop_back();
+	}
+	else
+	{
+		index = (uint32_t)slots_.size();
+		slots_.emplace_back();
+	}
+	ObjectSlot& slot = slots_[index];
+	SObjectHandle handle;
+	handle.index = index;
+	handle.generation = slot.generation;
+	object->handle_ = handle;
+	slot.object = object;
+	slot.unify_name = unify_name;
+	live_object_count_++;
+	return handle;
+}
 
-	} while (DestroyUnitfyCount || DestroyInstanceCount);
-	assert(!UnifyLeft);
-	assert(!InstanceLeft);
+TRefCountPtr<SObject> SObjectManager::Resolve(SObjectHandle handle) const
+{
+	std::lock_guard<std::mutex> lock(slots_mutex_);
+	// DestroyPending only deletes objects whose count is 1 under this lock, the extra reference keeps it alive
+	return TRefCountPtr<SObject>(ResolveLocked(handle), true);
 }
 
-void SObjectManager::FrameDestroy()
+SObject* SObjectManager::ResolveLocked(SObjectHandle handle) const
 {
-	for (auto iter = unify_objects_.begin(); iter != unify_objects_.end();)
+	if (!handle.IsValid() || handle.index >= (uint32_t)slots_.size())
 	{
-		if (iter->second.GetRefCount() == 1)
-		{
-			iter = unify_objects_.erase(iter);
-		}
-		else
-		{
-			iter++;
-		}
+		return nullptr;
+	}
+	const ObjectSlot& slot = slots_[handle.index];
+	if (slot.generation != handle.generation)
+	{
+		return nullptr;
 	}
+	return slot.object.GetReference();
+}
+
+void SObjectManager::EnqueuePendingDestroy(SObjectHandle handle)
+{
+	std::lock_guard<std::mutex> lock(pending_destroy_mutex_);
+	pending_destroy_.push_back(handle);
+}
 
-	for (std::unordered_set< TRefCountPtr<SObject>>::iterator iter = instanced_objects_.begin(); iter != instanced_objects_.end();)
+int SObjectManager::DestroyPending()
+{
+	int destroy_count = 0;
+	while (true)
 	{
-		if ((*iter).GetRefCount() == 1)
 		{
-			iter = instanced_objects_.erase(iter);
+			std::lock_guard<std::mutex> lock(pending_destroy_mutex_);
+			if (pending_destroy_.empty())
+			{
+				break;
+			}
+			destroying_.swap(pending_destroy_);
 		}
-		else
+		// destroying an object releases its children, which queue themselves for the next round
+		for (SObjectHandle handle : destroying_)
 		{
-			iter++;
+			TRefCountPtr<SObject> object_to_destroy;
+			{
+				std::lock_guard<std::mutex> lock(slots_mutex_);
+				SObject* object = ResolveLocked(handle);
+				// stale entry, the object has been referenced again or already destroyed
+				if (!object || object->GetRefCount() != 1)
+				{
+					continue;
+				}
+				ObjectSlot& slot = slots_[handle.index];
+				if (!slot.unify_name.empty())
+				{
+					unify_objects_.erase(slot.unify_name);
+					slot.unify_name.clear();
+				}
+				slot.generation++;
+				object->handle_ = SObjectHandle();
+				object_to_destroy.Swap(slot.object);
+				free_slots_.push_back(handle.index);
+				live_object_count_--;
+			}
+			// delete outside the lock, workers may be registering new objects
+			object_to_destroy.SafeRelease();
+			destroy_count++;
 		}
+		destroying_.clear();
 	}
+	return destroy_count;
+}
+
+void SObjectManager::Destroy()
+{
+	DestroyPending();
+	assert(!live_object_count_);
+	assert(unify_objects_.empty());
+}
+
+void SObjectManager::FrameDestroy()
+{
+	DestroyPending();
 }
 
 SObjectManager& SObjectManager::GetManager()
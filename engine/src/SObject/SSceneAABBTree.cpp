@@ -0,0 +1,97 @@
+#include "SObject/SSceneAABBTree.h"
+#include "SObject/SActor.h"
+
+void SSceneAABBTree::AddComponent(SSceneComponent* component)
+{
+	assert(component);
+	if (component->spatial_proxy_ >= 0)
+	{
+		return;
+	}
+	component->is_bounds_dirty_ = false;
+	if (component->bounds_.IsValid())
+	{
+		component->spatial_proxy_ = tree_.CreateProxy(component->bounds_, component);
+	}
+}
+
+void SSceneAABBTree::RemoveComponent(SSceneComponent* component)
+{
+	assert(component);
+	if (component->spatial_proxy_ < 0)
+	{
+		return;
+	}
+	assert(GetComponent(component->spatial_proxy_) == component);
+	tree_.DestroyProxy(component->spatial_proxy_);
+	component->spatial_proxy_ = -1;
+}
+
+void SSceneAABBTree::UpdateComponent(SSceneComponent* component)
+{
+	assert(component);
+	component->is_bounds_dirty_ = false;
+	const bool has_bounds = component->bounds_.IsValid();
+	if (component->spatial_proxy_ < 0)
+	{
+		if (has_bounds)
+		{
+			component->spatial_proxy_ = tree_.CreateProxy(component->bounds_, component);
+			++reinsert_count_;
+		}
+		return;
+	}
+	if (!has_bounds)
+	{
+		RemoveComponent(component);
+		return;
+	}
+	if (tree_.MoveProxy(component->spatial_proxy_, component->bounds_))
+	{
+		++reinsert_count_;
+	}
+}
+
+void SSceneAABBTree::AddActorComponents(SActor* actor)
+{
+	for (SSceneComponent* component : actor->GetComponents())
+	{
+		AddComponent(component);
+	}
+}
+
+void SSceneAABBTree::RemoveActorComponents(SActor* actor)
+{
+	for (SSceneComponent* component : actor->GetComponents())
+	{
+		RemoveComponent(component);
+	}
+}
+
+void SSceneAABBTree::UpdateActorComponents(SActor* actor)
+{
+	for (SSceneComponent* component : actor->GetComponents())
+	{
+		if (component->IsBoundsDirty())
+		{
+			UpdateComponent(component);
+		}
+	}
+}
+
+void SSceneAABBTree::Clear()
+{
+	tree_.ForEachProxy([](int, void* user_data)
+		{
+			static_cast<SSceneComponent*>(user_data)->spatial_proxy_ = -1;
+		});
+	tree_.Clear();
+	reinsert_count_ = 0;
+}
+
+int SSceneAABBTree::ResetReinsertCount()
+{
+	const int reinsert_count = reinsert_count_;
+	reinsert_count_ = 0;
+	return reinsert_count;
+}
@@ -0,0 +1,145 @@
+#include "SObject/SSceneBVH.h"
+#include "SObject/SComponentStorage.h"
+#include "SObject/SStaticMeshComponent.h"
+#include <cstring>
+
+bool SSceneBVH::IsSourceChanged(const std::vector<Source>& sources) const
+{
+	if (sources.size() != sources_.size())
+	{
+		return true;
+	}
+	for (size_t i = 0; i < sources.size(); ++i)
+	{
+		const Source& a = sources[i];
+		const Source& b = sources_[i];
+		if (a.component != b.component || a.mesh != b.mesh || memcmp(&a.component_to_world, &b.component_to_world, sizeof(YTransform)) != 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void SSceneBVH::Update(const SComponentStorage& component_storage)
+{
+	std::vector<Source> sources;
+	sources.reserve(component_storage.GetComponentCount(SComponent::StaticMeshComponent));
+	component_storage.ForEachComponent<SStaticMeshComponent>([&sources](SStaticMeshComponent* component)
+		{
+			Source source;
+			source.component = component;
+			source.mesh = component->GetMesh();
+			source.component_to_world = component->GetComponentTransform();
+			sources.push_back(source);
+		});
+	if (!IsSourceChanged(sources))
+	{
+		return;
+	}
+	sources_ = std::move(sources);
+	nodes_.clear();
+	instances_.clear();
+
+	std::vector<YTransform> transforms;
+	transforms.reserve(sources_.size());
+	for (const Source& source : sources_)
+	{
+		transforms.push_back(source.component_to_world);
+	}
+	std::vector<YMatrix> local_to_worlds(transforms.size());
+	YTransform::ToMatrices(local_to_worlds.data(), transforms.data(), transforms.size());
+
+	std::vector<Instance> instances;
+	std::vector<YBox> boxes;
+	instances.reserve(sources_.size());
+	boxes.reserve(sources_.size());
+	for (size_t i = 0; i < sources_.size(); ++i)
+	{
+		const Source& source = sources_[i];
+		const YMeshBVH* mesh_bvh = source.mesh ? source.mesh->GetBVH() : nullptr;
+		// a 0 scale leaves nothing to hit
+		if (!mesh_bvh || local_to_worlds[i].Determinant() == 0.0f)
+		{
+			continue;
+		}
+		Instance instance;
+		instance.world_to_local = local_to_worlds[i].Inverse();
+		instance.component = source.component;
+		instance.mesh_bvh = mesh_bvh;
+		instance.world_bounds = mesh_bvh->GetBounds().TransformBy(local_to_worlds[i]);
+		boxes.push_back(instance.world_bounds);
+		instances.push_back(instance);
+	}
+	std::vector<int> order;
+	YBVH::Build(boxes, 1, nodes_, order);
+	instances_.reserve(order.size());
+	for (int instance_index : order)
+	{
+		instances_.push_back(instances[instance_index]);
+	}
+}
+
+void SSceneBVH::Clear()
+{
+	nodes_.clear();
+	instances_.clear();
+	sources_.clear();
+}
+
+void SSceneBVH::IntersectPacket(const YRay* rays, int ray_count, SSceneHit* hits) const
+{
+	if (nodes_.empty() || ray_count <= 0)
+	{
+		return;
+	}
+	ray_count = ray_count < YRayPacket::max_ray_count ? ray_count : YRayPacket::max_ray_count;
+	float max_distances[YRayPacket::max_ray_count];
+	for (int lane = 0; lane < ray_count; ++lane)
+	{
+		max_distances[lane] = hits[lane].mesh_hit.distance;
+	}
+	YRayPacket packet;
+	packet.Set(rays, max_distances, ray_count);
+	bool replaced[YRayPacket::max_ray_count] = { false, false, false, false };
+	YBVH::TracePacket(nodes_, packet, [&](int first, int count)
+		{
+			for (int slot = first; slot < first + count; ++slot)
+			{
+				const Instance& instance = instances_[slot];
+				// the distances stay the same in mesh space as long as the direction is not normalized again
+				YRay local_rays[YRayPacket::max_ray_count];
+				YMeshHit mesh_hits[YRayPacket::max_ray_count];
+				for (int lane = 0; lane < ray_count; ++lane)
+				{
+					local_rays[lane] = YRay(instance.world_to_local.TransformPosition(rays[lane].origin), instance.world_to_local.TransformVector(rays[lane].direction));
+					mesh_hits[lane].distance = packet.max_distance[lane];
+				}
+				instance.mesh_bvh->IntersectPacket(local_rays, ray_count, mesh_hits);
+				for (int lane = 0; lane < ray_count; ++lane)
+				{
+					if (mesh_hits[lane].IsValid())
+					{
+						hits[lane].component = instance.component;
+						hits[lane].mesh_hit = mesh_hits[lane];
+						packet.max_distance[lane] = mesh_hits[lane].distance;
+						replaced[lane] = true;
+					}
+				}
+			}
+		});
+	for (int lane = 0; lane < ray_count; ++lane)
+	{
+		if (replaced[lane])
+		{
+			hits[lane].position = rays[lane].GetPoint(hits[lane].mesh_hit.distance);
+		}
+	}
+}
+
+bool SSceneBVH::Intersect(const YRay& ray, SSceneHit& hit) const
+{
+	const float distance = hit.mesh_hit.distance;
+	IntersectPacket(&ray, 1, &hit);
+	return hit.mesh_hit.distance < distance;
+}
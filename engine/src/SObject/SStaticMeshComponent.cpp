@@ -1,5 +1,8 @@
 #include "SObject/SStaticMeshComponent.h"
 #include "Engine/YRenderScene.h"
+#include "Engine/YStaticMeshCache.h"
+#include "SObject/SCookedWorld.h"
+#include "Utility/YJsonWriter.h"
 
 SStaticMeshComponent::SStaticMeshComponent():
 	SRenderComponent(EComponentType::StaticMeshComponent)
@@ -17,11 +20,11 @@ bool SStaticMeshComponent::LoadFromJson(const Json::Value& RootJson)
 	SRenderComponent::LoadFromJson(RootJson);
 	if (RootJson.isMember("model"))
 	{
-		std::string model_path = RootJson["model"].asString();
-		static_mesh_ = std::make_unique<YStaticMesh>();
-		if (static_mesh_->LoadV0(model_path))
+		model_path_ = RootJson["model"].asString();
+		static_mesh_ = YStaticMeshCache::Get().LoadStaticMesh(model_path_);
+		if (static_mesh_)
 		{
-			LOG_INFO("Static mesh load success! ",model_path);
+			LOG_INFO("Static mesh load success! ",model_path_);
 			return true;
 		}
 	}
@@ -30,11 +33,46 @@ bool SStaticMeshComponent::LoadFromJson(const Json::Value& RootJson)
 	return false;
 }
 
+struct SCookedStaticMesh
+{
+	uint32_t model = 0;
+};
+
+bool SStaticMeshComponent::CookFromJson(const Json::Value& root_json, SCookedWorldWriter& writer) const
+{
+	if (!SRenderComponent::CookFromJson(root_json, writer) || !root_json.isMember("model"))
+	{
+		return false;
+	}
+	SCookedStaticMesh cooked_mesh;
+	cooked_mesh.model = writer.InternString(root_json["model"].asString());
+	writer.SetPayload(cooked_mesh);
+	return true;
+}
+
+bool SStaticMeshComponent::LoadFromCooked(const SCookedWorld& cooked_world, uint32_t component_index)
+{
+	SCookedStaticMesh cooked_mesh;
+	if (!SRenderComponent::LoadFromCooked(cooked_world, component_index) || !cooked_world.GetPayload(component_index, cooked_mesh))
+	{
+		return false;
+	}
+	model_path_ = cooked_world.GetString(cooked_mesh.model);
+	static_mesh_ = YStaticMeshCache::Get().LoadStaticMesh(model_path_);
+	if (!static_mesh_)
+	{
+		ERROR_INFO("Static mesh load failed! ", model_path_);
+		return false;
+	}
+	return true;
+}
+
 bool SStaticMeshComponent::PostLoadOp()
 {
 	SRenderComponent::PostLoadOp();
 	if (static_mesh_)
 	{
+		// shared mesh, only the first component to get here creates the buffers
 		if (static_mesh_->AllocGpuResource())
 		{
 			return true;
@@ -52,14 +90,19 @@ void SStaticMeshComponent::Update(double deta_time)
 	SRenderComponent::Update(deta_time);
 }
 
-void SStaticMeshComponent::RegisterToScene(class YScene* scene)
+void SStaticMeshComponent::SaveMembersToJson(YJsonWriter& writer) const
+{
+	SRenderComponent::SaveMembersToJson(writer);
+	writer.Key("model").WriteString(model_path_);
+}
+
+void SStaticMeshComponent::UpdateBound()
 {
-	SRenderComponent::RegisterToScene(scene);
-	scene->static_meshes_components_.insert(this);
+	bounds_ = static_mesh_ ? static_mesh_->GetBounds().TransformBy(component_to_world_.ToMatrix()) : YBox();
 }
 
 YStaticMesh* SStaticMeshComponent::GetMesh()
 {
-	return static_mesh_.get();
+	return static_mesh_.GetReference();
 }
 
@@ -1,6 +1,14 @@
 #include "SObject/SWorld.h"
 #include "SObject/SObjectManager.h"
 #include "json.h"
+#include "Engine/YTaskSystem.h"
+#include "Engine/YStaticMeshCache.h"
+#include "Engine/YFile.h"
+#include "Utility/YJsonHelper.h"
+#include "Utility/YJsonWriter.h"
+#include <chrono>
+#include <algorithm>
+#include <unordered_set>
 
 
 SWorld::SWorld()
@@ -10,33 +18,185 @@ SWorld::SWorld()
 
 SWorld::~SWorld()
 {
-
+	// stop streaming before the actors go away
+	partition_ = nullptr;
 }
 
 bool SWorld::LoadFromJson(const Json::Value& RootJson)
 {
+	LoadSettingsFromJson(RootJson);
 	//actors
 	const Json::Value& actors = RootJson["actors"];
 	if (actors.isArray())
 	{
-		for (int actor_index = 0; actor_index < (int)actors.size(); ++actor_index)
+		LoadActorsParallel((int)actors.size(), [&actors](int actor_index) { return LoadActorFromJson(actors[actor_index]); }, Actors);
+	}
+	return true;
+}
+
+bool SWorld::SaveToJson(YJsonWriter& writer) const
+{
+	writer.BeginObject();
+	writer.Key("tick_batch_size").WriteInt(tick_batch_size_);
+	std::unordered_set<const SActor*> streamed_actors;
+	if (partition_)
+	{
+		writer.Key("partition");
+		partition_->SaveToJson(writer);
+		partition_->GetStreamedActors(streamed_actors);
+	}
+	writer.Key("actors").BeginArray();
+	for (const TRefCountPtr<SActor>& actor : Actors)
+	{
+		if (!streamed_actors.count(actor.GetReference()))
 		{
-			const Json::Value actor_json = actors[actor_index];
-			TRefCountPtr<SActor> actor_ins = SObjectManager::ConstructInstance<SActor>();
-			if (!actor_ins->LoadFromJson(actor_json))
-			{
-				ERROR_INFO("load SActor failed! json file \n", actor_json.toStyledString());
-			}
-			else
+			actor->SaveToJson(writer);
+		}
+	}
+	writer.EndArray();
+	writer.EndObject();
+	return true;
+}
+
+bool SWorld::LoadFromMemoryFile(std::unique_ptr<MemoryFile> mem_file)
+{
+	SCookedWorld cooked_world;
+	if (!cooked_world.Load(std::move(mem_file)))
+	{
+		return false;
+	}
+	LoadSettingsFromCooked(cooked_world);
+	LoadActorsParallel(cooked_world.GetActorCount(), [&cooked_world](int actor_index) { return cooked_world.LoadActor(actor_index); }, Actors);
+	return true;
+}
+
+void SWorld::LoadActorsParallel(int actor_count, const std::function<TRefCountPtr<SActor>(int)>& load_actor, std::vector<TRefCountPtr<SActor>>& out_actors)
+{
+	std::vector<TRefCountPtr<SActor>> loaded_actors(actor_count);
+	YTaskSystem::Get().ParallelFor(actor_count, actor_load_batch_size, [&load_actor, &loaded_actors](int batch_index, int begin, int end)
+		{
+			for (int actor_index = begin; actor_index < end; ++actor_index)
 			{
-				Actors.push_back(actor_ins);
+				loaded_actors[actor_index] = load_actor(actor_index);
 			}
+		});
+	for (TRefCountPtr<SActor>& actor : loaded_actors)
+	{
+		if (actor)
+		{
+			out_actors.push_back(actor);
 		}
-		return true;
+	}
+}
+
+bool SWorld::LoadSettingsFromJson(const Json::Value& RootJson)
+{
+	if (RootJson.isMember("tick_batch_size"))
+	{
+		SetTickBatchSize(RootJson["tick_batch_size"].asInt());
+	}
+	if (RootJson.isMember("partition"))
+	{
+		return LoadPartitionFromJson(RootJson["partition"]);
+	}
+	return true;
+}
+
+bool SWorld::LoadPartitionFromJson(const Json::Value& partition_json)
+{
+	partition_ = std::make_unique<SWorldPartition>(this);
+	if (!partition_->LoadFromJson(partition_json))
+	{
+		partition_ = nullptr;
+		return false;
 	}
 	return true;
 }
 
+bool SWorld::LoadFromJsonFile(const std::string& json_path)
+{
+	// declared first, the actors are destroyed before their arena
+	Json::Arena arena;
+	std::vector<Json::Value> actors;
+	if (!StreamWorldJson(json_path, this, actors, nullptr, &arena))
+	{
+		return false;
+	}
+	LoadActorsParallel((int)actors.size(), [&actors](int actor_index) { return LoadActorFromJson(actors[actor_index]); }, Actors);
+	return true;
+}
+
+bool SWorld::StreamWorldJson(const std::string& json_path, SWorld* world, std::vector<Json::Value>& out_actors, size_t* out_file_size /*= nullptr*/, Json::Arena* arena /*= nullptr*/)
+{
+	YFile json_file(json_path, YFile::FileType(YFile::FT_TXT | YFile::FT_Read));
+	std::unique_ptr<MemoryFile> mem_file = json_file.ReadFile();
+	if (!mem_file)
+	{
+		ERROR_INFO("load world json ", json_path, " failed!, read file error");
+		return false;
+	}
+	YJsonObjectVisitor world_visitor;
+	bool partition_success = true;
+	if (world)
+	{
+		world_visitor.OnInt("tick_batch_size", [world](int batch_size) { world->SetTickBatchSize(batch_size); })
+			.OnValue("partition", [world, &partition_success](Json::Value&& partition_json) { partition_success = world->LoadPartitionFromJson(partition_json); });
+	}
+	world_visitor.OnArrayValues("actors", [&out_actors](Json::Value&& actor_json) { out_actors.push_back(std::move(actor_json)); });
+	std::string error;
+	char* begin = (char*)mem_file->GetData();
+	char* end = (char*)(mem_file->GetData() + mem_file->GetSize());
+	if (!(arena ? YJsonHelper::VisitJsonInSitu(begin, end, world_visitor, *arena, &error) : YJsonHelper::VisitJson(begin, end, world_visitor, &error)))
+	{
+		ERROR_INFO("load world json ", json_path, " failed!, json parse failed, reason ", error);
+		return false;
+	}
+	if (!partition_success)
+	{
+		ERROR_INFO("load world json ", json_path, " failed!, partition load failed");
+		return false;
+	}
+	if (out_file_size)
+	{
+		*out_file_size = mem_file->GetSize();
+	}
+	if (arena)
+	{
+		// the actor strings point into the file
+		arena->keepAlive(std::shared_ptr<MemoryFile>(std::move(mem_file)));
+	}
+	return true;
+}
+
+bool SWorld::LoadSettingsFromCooked(const SCookedWorld& cooked_world)
+{
+	if (cooked_world.HasTickBatchSize())
+	{
+		SetTickBatchSize(cooked_world.GetTickBatchSize());
+	}
+	if (cooked_world.HasPartition())
+	{
+		partition_ = std::make_unique<SWorldPartition>(this);
+		if (!partition_->InitCells(cooked_world.GetPartitionSettings(), cooked_world.GetPartitionCells()))
+		{
+			partition_ = nullptr;
+			return false;
+		}
+	}
+	return true;
+}
+
+TRefCountPtr<SActor> SWorld::LoadActorFromJson(const Json::Value& actor_json)
+{
+	TRefCountPtr<SActor> actor_ins = SObjectManager::ConstructInstance<SActor>();
+	if (!actor_ins->LoadFromJson(actor_json))
+	{
+		ERROR_INFO("load SActor failed! json file \n", actor_json.toStyledString());
+		return nullptr;
+	}
+	return actor_ins;
+}
+
 bool SWorld::PostLoadOp()
 {
 	bool bSuccess = true;
@@ -44,14 +204,26 @@ bool SWorld::PostLoadOp()
 	{
 		bSuccess &= Actor->PostLoadOp();
 	}
-	scene_ = std::make_unique<YScene>();
+	CreateScene();
 	for (TRefCountPtr<SActor>& actor : Actors)
 	{
+		component_storage_.AddActorComponents(actor.GetReference());
+		spatial_tree_.AddActorComponents(actor.GetReference());
 		actor->RegisterToScene(scene_.get());
 	}
 	return bSuccess;
 }
 
+void SWorld::CreateScene()
+{
+	if (!scene_)
+	{
+		scene_ = std::make_unique<YScene>();
+		scene_->component_storage_ = &component_storage_;
+		scene_->spatial_tree_ = &spatial_tree_;
+	}
+}
+
 std::unique_ptr<YRenderScene> SWorld::GenerateRenderScene()
 {
 	return scene_->GenerateOneFrame();
@@ -60,18 +232,256 @@ std::unique_ptr<YRenderScene> SWorld::GenerateRenderScene()
 
 void SWorld::Update(double deta_time)
 {
-	// animation system update
+	if (partition_ && camera_)
+	{
+		partition_->UpdateStreaming(camera_->GetPosition());
+	}
+	// pre physics(animation) -> physics -> post physics -> finalize transform
+	if (tick_lists_dirty_)
+	{
+		RebuildTickLists();
+	}
+	for (int phase = 0; phase < TP_Num; ++phase)
+	{
+		TickPhase((ETickPhase)phase, deta_time);
+	}
+}
 
-	// physical system update
+void SWorld::TickPhase(ETickPhase phase, double deta_time)
+{
+	std::chrono::time_point<std::chrono::high_resolution_clock> start_time = std::chrono::high_resolution_clock::now();
+	STickPhaseStats& stats = tick_stats_[phase];
+	const std::vector<SActor*>& tick_list = tick_lists_[phase];
+	const int actor_count = (int)tick_list.size();
+	const int batch_count = YTaskSystem::GetBatchCount(actor_count, tick_batch_size_);
+	if ((int)command_buffers_.size() < batch_count)
+	{
+		command_buffers_.resize(batch_count);
+	}
 
-	// physical system update apply to animation
-	for (TRefCountPtr<SActor>& Actor : Actors)
+	// actors only write their own component tree, so every batch is independent
+	YTaskSystem::Get().ParallelFor(actor_count, tick_batch_size_, [this, phase, deta_time, &tick_list](int batch_index, int begin, int end)
+		{
+			SWorldCommandBuffer& command_buffer = command_buffers_[batch_index];
+			for (int i = begin; i < end; ++i)
+			{
+				tick_list[i]->TickPhase(phase, deta_time, command_buffer);
+			}
+		});
+
+	// flush in batch order so the result does not depend on thread scheduling
+	int command_count = 0;
+	for (int batch_index = 0; batch_index < batch_count; ++batch_index)
+	{
+		command_count += command_buffers_[batch_index].Num();
+		command_buffers_[batch_index].Execute(this);
+	}
+	if (tick_lists_dirty_)
+	{
+		RebuildTickLists();
+	}
+
+	stats.actor_count = actor_count;
+	stats.batch_count = batch_count;
+	stats.command_count = command_count;
+	stats.time_ms = (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start_time).count() * 0.001;
+}
+
+void SWorld::RebuildTickLists()
+{
+	for (int phase = 0; phase < TP_Num; ++phase)
 	{
-		Actor->Update(deta_time);
+		tick_lists_[phase].clear();
 	}
+	for (TRefCountPtr<SActor>& actor : Actors)
+	{
+		uint32_t mask = actor->GetTickPhaseMask();
+		for (int phase = 0; phase < TP_Num; ++phase)
+		{
+			if (mask & TickPhaseBit((ETickPhase)phase))
+			{
+				tick_lists_[phase].push_back(actor.GetReference());
+			}
+		}
+	}
+	tick_lists_dirty_ = false;
+}
 
+void SWorld::AddActor(TRefCountPtr<SActor> actor)
+{
+	assert(!YTaskSystem::IsInWorkerThread());
+	if (!actor)
+	{
+		return;
+	}
+	if (scene_)
+	{
+		actor->PostLoadOp();
+		component_storage_.AddActorComponents(actor.GetReference());
+		spatial_tree_.AddActorComponents(actor.GetReference());
+		actor->RegisterToScene(scene_.get());
+	}
+	Actors.push_back(actor);
+	tick_lists_dirty_ = true;
+}
 
+void SWorld::RemoveActors(const std::vector<TRefCountPtr<SActor>>& actors)
+{
+	assert(!YTaskSystem::IsInWorkerThread());
+	if (actors.empty())
+	{
+		return;
+	}
+	std::unordered_set<SActor*> actors_to_remove;
+	for (const TRefCountPtr<SActor>& actor : actors)
+	{
+		if (scene_)
+		{
+			actor->UnregisterFromScene(scene_.get());
+		}
+		component_storage_.RemoveActorComponents(actor.GetReference());
+		spatial_tree_.RemoveActorComponents(actor.GetReference());
+		actors_to_remove.insert(actor.GetReference());
+	}
+	Actors.erase(std::remove_if(Actors.begin(), Actors.end(), [&actors_to_remove](const TRefCountPtr<SActor>& actor)
+		{
+			return actors_to_remove.count(actor.GetReference()) != 0;
+		}), Actors.end());
+	tick_lists_dirty_ = true;
 }
+
+bool SWorld::AttachComponent(SActor* actor, TRefCountPtr<SSceneComponent> component, SSceneComponent* parent /*= nullptr*/)
+{
+	assert(!YTaskSystem::IsInWorkerThread());
+	if (!actor || !component)
+	{
+		return false;
+	}
+	if (!parent)
+	{
+		parent = dynamic_cast<SSceneComponent*>(actor->GetRootComponent());
+		if (!parent)
+		{
+			WARNING_INFO("attach component failed, actor has no scene root component");
+			return false;
+		}
+	}
+	if (parent->GetParentActor() != actor)
+	{
+		WARNING_INFO("attach component failed, parent belongs to another actor");
+		return false;
+	}
+	// only actors already in the scene have their components in the storage
+	const bool in_world = parent->storage_index_ >= 0;
+	parent->AttachChild(component);
+	actor->UpdateComponentList();
+	if (in_world)
+	{
+		component->PostLoadOp();
+		for (SSceneComponent* actor_component : actor->GetComponents())
+		{
+			if (actor_component->storage_index_ < 0)
+			{
+				component_storage_.AddComponent(actor_component);
+				spatial_tree_.AddComponent(actor_component);
+				if (scene_)
+				{
+					actor_component->RegisterToScene(scene_.get());
+				}
+			}
+		}
+	}
+	return true;
+}
+
+bool SWorld::DetachComponent(SSceneComponent* component)
+{
+	assert(!YTaskSystem::IsInWorkerThread());
+	SActor* actor = component ? component->GetParentActor() : nullptr;
+	SSceneComponent* parent = component ? component->GetParentComponent() : nullptr;
+	if (!actor || !parent)
+	{
+		WARNING_INFO("detach component failed, only non root components of an actor can be detached");
+		return false;
+	}
+	// keep the subtree alive until it has left the storage
+	TRefCountPtr<SSceneComponent> detached_component = parent->DetachChild(component);
+	std::vector<SSceneComponent*> old_components = actor->GetComponents();
+	actor->UpdateComponentList();
+	const std::vector<SSceneComponent*>& new_components = actor->GetComponents();
+	for (SSceneComponent* old_component : old_components)
+	{
+		if (std::find(new_components.begin(), new_components.end(), old_component) == new_components.end())
+		{
+			if (scene_ && old_component->storage_index_ >= 0)
+			{
+				old_component->UnregisterFromScene(scene_.get());
+			}
+			component_storage_.RemoveComponent(old_component);
+			spatial_tree_.RemoveComponent(old_component);
+			old_component->actor_parent_ = nullptr;
+		}
+	}
+	return true;
+}
+
+void SWorld::UpdateComponentBounds(SActor* actor)
+{
+	assert(!YTaskSystem::IsInWorkerThread());
+	if (actor)
+	{
+		spatial_tree_.UpdateActorComponents(actor);
+	}
+}
+
+const STickPhaseStats& SWorld::GetTickPhaseStats(ETickPhase phase) const
+{
+	assert(phase >= 0 && phase < TP_Num);
+	return tick_stats_[phase];
+}
+
+void SWorld::SetTickBatchSize(int batch_size)
+{
+	tick_batch_size_ = batch_size > 0 ? batch_size : 1;
+}
+void SWorldCommandBuffer::Execute(SWorld* world)
+{
+	for (Command& command : commands_)
+	{
+		command(world);
+	}
+	commands_.clear();
+}
+
+const char* GetTickPhaseName(ETickPhase phase)
+{
+	switch (phase)
+	{
+	case TP_PrePhysics:
+		return "pre_physics";
+	case TP_Physics:
+		return "physics";
+	case TP_PostPhysics:
+		return "post_physics";
+	case TP_FinalizeTransform:
+		return "finalize_transform";
+	default:
+		return "unknown";
+	}
+}
+
+ETickPhase GetTickPhaseFromName(const std::string& name)
+{
+	for (int phase = 0; phase < TP_Num; ++phase)
+	{
+		if (name == GetTickPhaseName((ETickPhase)phase))
+		{
+			return (ETickPhase)phase;
+		}
+	}
+	return TP_Num;
+}
+
 TRefCountPtr<SWorld> g_world;
 SWorld* SWorld::GetWorld()
 {
@@ -80,7 +490,43 @@ SWorld* SWorld::GetWorld()
 
 void SWorld::SetWorld(TRefCountPtr<SWorld>& world)
 {
+	bool unload_world = g_world && g_world != world;
 	g_world = world;
+	if (unload_world)
+	{
+		// actors and components of the old world die here, give their slabs back in one go
+		SObjectManager::GetManager().FrameDestroy();
+		YObjectPool::TrimAll();
+		int released_mesh_count = YStaticMeshCache::Get().ReleaseUnused();
+		LOG_INFO("released ", released_mesh_count, " static meshes of the old world");
+	}
+}
+
+bool SWorld::RayCast(const YRay& ray, SSceneHit& out_hit)
+{
+	out_hit = SSceneHit();
+	scene_bvh_.Update(component_storage_);
+	return scene_bvh_.Intersect(ray, out_hit);
+}
+
+void SWorld::RayCastPacket(const YRay* rays, int ray_count, SSceneHit* out_hits)
+{
+	for (int i = 0; i < ray_count; ++i)
+	{
+		out_hits[i] = SSceneHit();
+	}
+	scene_bvh_.Update(component_storage_);
+	for (int first = 0; first < ray_count; first += YRayPacket::max_ray_count)
+	{
+		const int packet_ray_count = std::min(ray_count - first, YRayPacket::max_ray_count);
+		scene_bvh_.IntersectPacket(rays + first, packet_ray_count, out_hits + first);
+	}
+}
+
+const SSceneBVH& SWorld::GetSceneBVH()
+{
+	scene_bvh_.Update(component_storage_);
+	return scene_bvh_;
 }
 
 void SWorld::SetCamera(CameraBase* camera)
@@ -88,4 +534,9 @@ void SWorld::SetCamera(CameraBase* camera)
 	//todo
 	camera_ = camera;
 	scene_->camera_ = camera_;
+	if (partition_ && camera_)
+	{
+		// start streaming the cells around the new view right away
+		partition_->UpdateStreaming(camera_->GetPosition());
+	}
 }
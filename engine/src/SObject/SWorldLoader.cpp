@@ -0,0 +1,326 @@
+#include "SObject/SWorldLoader.h"
+#include "SObject/SObjectManager.h"
+#include "SObject/SCookedWorld.h"
+#include "Engine/YTaskSystem.h"
+#include "Utility/YJsonHelper.h"
+#include "Utility/YPath.h"
+#include "Engine/YLog.h"
+#include <algorithm>
+
+const char* GetWorldLoadStageName(EWorldLoadStage stage)
+{
+	switch (stage)
+	{
+	case WLS_None:
+		return "none";
+	case WLS_ReadFile:
+		return "read file";
+	case WLS_LoadActors:
+		return "load actors";
+	case WLS_Finalize:
+		return "finalize";
+	case WLS_Finished:
+		return "finished";
+	case WLS_Failed:
+		return "failed";
+	default:
+		return "unknown";
+	}
+}
+
+float SWorldLoadProgress::GetFraction() const
+{
+	if (stage == WLS_Finished)
+	{
+		return 1.0f;
+	}
+	if (total_actor_count == 0)
+	{
+		return 0.0f;
+	}
+	return (float)(loaded_actor_count + finalized_actor_count) / (float)(2 * total_actor_count);
+}
+
+SWorldLoader::SWorldLoader()
+{
+
+}
+
+SWorldLoader::~SWorldLoader()
+{
+	cancel_ = true;
+	if (load_thread_.joinable())
+	{
+		load_thread_.join();
+	}
+}
+
+bool SWorldLoader::BeginLoad(const std::string& world_path)
+{
+	assert(!world_ && !YTaskSystem::IsInWorkerThread());
+	// the cooked world is preferred as in SObject::LoadFromPackage, unless it is older than the json
+	world_cooked_path_ = SCookedWorld::GetCookedPath(world_path);
+	world_json_path_ = YPath::GetBaseFilename(world_path, false) + SObject::json_extension_with_dot;
+	if (!SObject::IsBinaryPackageUpToDate(world_cooked_path_, world_json_path_))
+	{
+		world_cooked_path_.clear();
+		if (!YPath::FileExists(world_json_path_))
+		{
+			ERROR_INFO("load world ", world_path, " failed! ", world_json_path_, " not exist");
+			return false;
+		}
+	}
+	start_time_ = std::chrono::high_resolution_clock::now();
+	world_ = SObjectManager::ConstructUnique<SWorld>();
+	// actors are registered to the scene one by one as they are finalized
+	world_->CreateScene();
+	SetStage(WLS_ReadFile);
+	load_thread_ = std::thread([this]() { LoadThreadMain(); });
+	return true;
+}
+
+void SWorldLoader::LoadThreadMain()
+{
+	if (!world_cooked_path_.empty())
+	{
+		YFile cooked_file(world_cooked_path_, YFile::FileType(YFile::FT_BINARY | YFile::FT_Read));
+		SCookedWorld cooked_world;
+		if (!cooked_world.Load(cooked_file.ReadFile()))
+		{
+			ERROR_INFO("load cooked world ", world_cooked_path_, " failed!");
+			SetStage(WLS_Failed);
+			return;
+		}
+		// the world is not handed to the owning thread before the first actor, no one else touches it yet
+		world_->LoadSettingsFromCooked(cooked_world);
+		LoadActors(cooked_world.GetActorCount(),
+			[&cooked_world](int actor_index) { return (cooked_world.GetActor(actor_index).flags & SCookedActor::AF_Critical) != 0; },
+			[&cooked_world](int actor_index) { return cooked_world.LoadActor(actor_index); });
+		return;
+	}
+
+	Json::Arena arena;
+	std::vector<Json::Value> actors;
+	if (!SWorld::StreamWorldJson(world_json_path_, world_.GetReference(), actors, nullptr, &arena))
+	{
+		SetStage(WLS_Failed);
+		return;
+	}
+	LoadActors((int)actors.size(),
+		[&actors](int actor_index)
+		{
+			// const, operator[] on the mutable value would add a null "critical" to every actor without one
+			const Json::Value& actor_json = actors[actor_index];
+			return actor_json.isMember("critical") && actor_json["critical"].asBool();
+		},
+		[&actors](int actor_index) { return SWorld::LoadActorFromJson(actors[actor_index]); });
+}
+
+void SWorldLoader::LoadActors(int actor_count, const std::function<bool(int)>& is_critical, const std::function<TRefCountPtr<SActor>(int)>& load_actor)
+{
+	std::vector<int> load_order;
+	load_order.reserve(actor_count);
+	for (int actor_index = 0; actor_index < actor_count; ++actor_index)
+	{
+		if (is_critical(actor_index))
+		{
+			load_order.push_back(actor_index);
+		}
+	}
+	int critical_actor_count = (int)load_order.size();
+	if (!critical_actor_count)
+	{
+		critical_actor_count = actor_count;
+	}
+	for (int actor_index = 0; actor_index < actor_count; ++actor_index)
+	{
+		if (!is_critical(actor_index))
+		{
+			load_order.push_back(actor_index);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		load_order_ = std::move(load_order);
+		slots_ = std::vector<ActorLoadSlot>(actor_count);
+		progress_.total_actor_count = actor_count;
+		progress_.critical_actor_count = critical_actor_count;
+		progress_.stage = WLS_LoadActors;
+	}
+	actor_loaded_cv_.notify_all();
+
+	// critical actors get all workers first
+	LoadActorRange(load_actor, 0, critical_actor_count);
+	LoadActorRange(load_actor, critical_actor_count, actor_count - critical_actor_count);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		progress_.stage = WLS_Finalize;
+		LOG_INFO("world ", world_json_path_, " deserialized ", progress_.loaded_actor_count, " actors in ",
+			std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time_).count(), " ms");
+	}
+	actor_loaded_cv_.notify_all();
+}
+
+void SWorldLoader::LoadActorRange(const std::function<TRefCountPtr<SActor>(int)>& load_actor, int first, int count)
+{
+	YTaskSystem::Get().ParallelFor(count, SWorld::actor_load_batch_size, [this, &load_actor, first](int batch_index, int begin, int end)
+		{
+			for (int i = first + begin; i < first + end; ++i)
+			{
+				if (cancel_)
+				{
+					return;
+				}
+				ActorLoadSlot& slot = slots_[i];
+				slot.actor = load_actor(load_order_[i]);
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					slot.state = slot.actor ? ALS_Loaded : ALS_Failed;
+					progress_.loaded_actor_count++;
+				}
+				actor_loaded_cv_.notify_all();
+			}
+		});
+}
+
+void SWorldLoader::CollectLoadedActors(int max_count, std::vector<TRefCountPtr<SActor>>& out_actors)
+{
+	while (finalize_cursor_ < (int)slots_.size() && (int)out_actors.size() < max_count)
+	{
+		ActorLoadSlot& slot = slots_[finalize_cursor_];
+		if (slot.state == ALS_Pending)
+		{
+			break;
+		}
+		if (slot.state == ALS_Loaded)
+		{
+			out_actors.push_back(std::move(slot.actor));
+		}
+		// failed actors count as finalized, they are reported by SWorld::LoadActorFromJson
+		progress_.finalized_actor_count++;
+		finalize_cursor_++;
+	}
+}
+
+void SWorldLoader::FinalizeActors(std::vector<TRefCountPtr<SActor>>& actors)
+{
+	for (TRefCountPtr<SActor>& actor : actors)
+	{
+		// PostLoadOp creates gpu resources, must stay on the owning thread
+		world_->AddActor(actor);
+	}
+	actors.clear();
+}
+
+bool SWorldLoader::Tick(double time_budget_ms)
+{
+	if (!world_)
+	{
+		return true;
+	}
+	std::chrono::time_point<std::chrono::high_resolution_clock> tick_start_time = std::chrono::high_resolution_clock::now();
+	std::vector<TRefCountPtr<SActor>> actors;
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (progress_.stage == WLS_Finished || progress_.stage == WLS_Failed)
+			{
+				return true;
+			}
+			CollectLoadedActors(1, actors);
+			if (actors.empty())
+			{
+				if (progress_.stage == WLS_Finalize && finalize_cursor_ == (int)slots_.size())
+				{
+					progress_.stage = WLS_Finished;
+					progress_.elapsed_ms = (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start_time_).count() * 0.001;
+					LOG_INFO("world ", world_json_path_, " finished loading in ", progress_.elapsed_ms, " ms");
+					return true;
+				}
+				return false;
+			}
+		}
+		FinalizeActors(actors);
+		double used_ms = (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - tick_start_time).count() * 0.001;
+		if (used_ms >= time_budget_ms)
+		{
+			return false;
+		}
+	}
+}
+
+bool SWorldLoader::WaitForCriticalActors()
+{
+	if (!world_)
+	{
+		return false;
+	}
+	std::vector<TRefCountPtr<SActor>> actors;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			actor_loaded_cv_.wait(lock, [this]()
+				{
+					if (progress_.stage == WLS_Failed || progress_.stage == WLS_Finished)
+					{
+						return true;
+					}
+					if (progress_.stage == WLS_ReadFile)
+					{
+						return false;
+					}
+					if (finalize_cursor_ >= progress_.critical_actor_count)
+					{
+						return true;
+					}
+					return slots_[finalize_cursor_].state != ALS_Pending;
+				});
+			if (progress_.stage == WLS_Failed)
+			{
+				return false;
+			}
+			if (progress_.stage == WLS_Finished || finalize_cursor_ >= progress_.critical_actor_count)
+			{
+				return true;
+			}
+			CollectLoadedActors(progress_.critical_actor_count - finalize_cursor_, actors);
+		}
+		FinalizeActors(actors);
+	}
+}
+
+bool SWorldLoader::IsCriticalReady() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return progress_.stage != WLS_ReadFile && progress_.stage != WLS_Failed && finalize_cursor_ >= progress_.critical_actor_count;
+}
+
+bool SWorldLoader::IsFinished() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return progress_.stage == WLS_Finished;
+}
+
+SWorldLoadProgress SWorldLoader::GetProgress() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	SWorldLoadProgress progress = progress_;
+	if (progress.stage != WLS_Finished && progress.stage != WLS_Failed)
+	{
+		progress.elapsed_ms = (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start_time_).count() * 0.001;
+	}
+	return progress;
+}
+
+void SWorldLoader::SetStage(EWorldLoadStage stage)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		progress_.stage = stage;
+	}
+	actor_loaded_cv_.notify_all();
+}
@@ -0,0 +1,733 @@
+#include "SObject/SWorldPartition.h"
+#include "SObject/SWorld.h"
+#include "SObject/SCookedWorld.h"
+#include "SObject/SStaticMeshComponent.h"
+#include "SObject/SInstancedStaticMeshComponent.h"
+#include "Engine/YTaskSystem.h"
+#include "Engine/YStaticMeshCache.h"
+#include "Engine/YFile.h"
+#include "Utility/YJsonHelper.h"
+#include "Utility/YJsonWriter.h"
+#include "Utility/YPath.h"
+#include "Engine/YLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <unordered_set>
+
+// size of an actor, meshes included, for the budget of a cell that has never been loaded
+static constexpr size_t estimated_actor_bytes = 64 * 1024;
+
+bool SWorldPartitionSettings::LoadFromJson(const Json::Value& root_json)
+{
+	if (root_json.isMember("cell_size"))
+	{
+		cell_size = root_json["cell_size"].asFloat();
+	}
+	if (root_json.isMember("loading_radius"))
+	{
+		loading_radius = root_json["loading_radius"].asFloat();
+	}
+	if (root_json.isMember("unloading_radius"))
+	{
+		unloading_radius = root_json["unloading_radius"].asFloat();
+	}
+	if (root_json.isMember("memory_budget_mb"))
+	{
+		memory_budget_mb = root_json["memory_budget_mb"].asInt();
+	}
+	if (root_json.isMember("finalize_budget_ms"))
+	{
+		finalize_budget_ms = root_json["finalize_budget_ms"].asDouble();
+	}
+	if (cell_size <= 0.0f)
+	{
+		WARNING_INFO("world partition cell_size ", cell_size, " is invalid, use 256");
+		cell_size = 256.0f;
+	}
+	// hysteresis, a cell on the loading border must not load and unload every other frame
+	unloading_radius = std::max(unloading_radius, loading_radius + cell_size * 0.5f);
+	return true;
+}
+
+void SWorldCellDesc::LoadFromJson(const Json::Value& cell_json)
+{
+	coord.x = cell_json["x"].asInt();
+	coord.z = cell_json["z"].asInt();
+	file_path = cell_json["file"].asString();
+	actor_count = cell_json["actor_count"].asInt();
+	YBox cell_bounds;
+	if (YJsonHelper::ConvertJsonToVector(cell_json["bounds_min"], cell_bounds.min_corner) && YJsonHelper::ConvertJsonToVector(cell_json["bounds_max"], cell_bounds.max_corner))
+	{
+		bounds = cell_bounds;
+	}
+}
+
+SWorldPartition::SWorldPartition(SWorld* world)
+	:world_(world)
+{
+	stream_thread_ = std::thread([this]() { StreamThreadMain(); });
+}
+
+SWorldPartition::~SWorldPartition()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		exit_ = true;
+	}
+	request_cv_.notify_all();
+	stream_thread_.join();
+}
+
+void SWorldPartitionSettings::SaveToJson(YJsonWriter& writer) const
+{
+	writer.Key("cell_size").WriteFloat(cell_size);
+	writer.Key("loading_radius").WriteFloat(loading_radius);
+	writer.Key("unloading_radius").WriteFloat(unloading_radius);
+	writer.Key("memory_budget_mb").WriteInt(memory_budget_mb);
+	writer.Key("finalize_budget_ms").WriteDouble(finalize_budget_ms);
+}
+
+bool SWorldPartition::LoadFromJson(const Json::Value& partition_json)
+{
+	if (!partition_json.isObject())
+	{
+		ERROR_INFO("world partition is not an object");
+		return false;
+	}
+	const Json::Value& cells_json = partition_json["cells"];
+	if (!cells_json.isNull() && !cells_json.isArray())
+	{
+		ERROR_INFO("world partition cells is not an array");
+		return false;
+	}
+	SWorldPartitionSettings settings;
+	settings.LoadFromJson(partition_json);
+	std::vector<SWorldCellDesc> cells(cells_json.size());
+	for (int i = 0; i < (int)cells_json.size(); ++i)
+	{
+		cells[i].LoadFromJson(cells_json[i]);
+	}
+	return InitCells(settings, cells);
+}
+
+void SWorldPartition::SaveToJson(YJsonWriter& writer) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	writer.BeginObject();
+	settings_.SaveToJson(writer);
+	writer.Key("cells").BeginArray();
+	for (const WorldCell& cell : cells_)
+	{
+		writer.BeginObject();
+		writer.Key("x").WriteInt(cell.coord.x);
+		writer.Key("z").WriteInt(cell.coord.z);
+		writer.Key("file").WriteString(cell.file_path);
+		writer.Key("actor_count").WriteInt(cell.actor_count);
+		if (cell.bounds.IsValid())
+		{
+			writer.Key("bounds_min").WriteVector(cell.bounds.min_corner);
+			writer.Key("bounds_max").WriteVector(cell.bounds.max_corner);
+		}
+		writer.EndObject();
+	}
+	writer.EndArray();
+	writer.EndObject();
+}
+
+void SWorldPartition::GetStreamedActors(std::unordered_set<const SActor*>& out_actors) const
+{
+	for (const std::vector<int>* cell_indices : { &resident_cells_, &finalizing_cells_ })
+	{
+		for (int cell_index : *cell_indices)
+		{
+			for (const TRefCountPtr<SActor>& actor : cells_[cell_index].actors)
+			{
+				out_actors.insert(actor.GetReference());
+			}
+		}
+	}
+}
+
+bool SWorldPartition::InitCells(const SWorldPartitionSettings& settings, const std::vector<SWorldCellDesc>& cells)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	settings_ = settings;
+	cells_.clear();
+	cell_index_map_.clear();
+	streaming_bytes_ = 0;
+	max_cell_overhang_ = 0.0f;
+	cells_.reserve(cells.size());
+	for (const SWorldCellDesc& cell_desc : cells)
+	{
+		if (cell_index_map_.count(cell_desc.coord.GetKey()))
+		{
+			WARNING_INFO("world partition cell ", cell_desc.coord.x, ",", cell_desc.coord.z, " is duplicated, ", cell_desc.file_path, " ignored");
+			continue;
+		}
+		WorldCell cell;
+		cell.coord = cell_desc.coord;
+		cell.file_path = cell_desc.file_path;
+		cell.actor_count = cell_desc.actor_count;
+		cell.bounds = cell_desc.bounds;
+		if (cell.bounds.IsValid())
+		{
+			const float min_x = cell.coord.x * settings_.cell_size;
+			const float min_z = cell.coord.z * settings_.cell_size;
+			const float overhang = std::max(std::max(min_x - cell.bounds.min_corner.x, cell.bounds.max_corner.x - (min_x + settings_.cell_size)),
+				std::max(min_z - cell.bounds.min_corner.z, cell.bounds.max_corner.z - (min_z + settings_.cell_size)));
+			max_cell_overhang_ = std::max(max_cell_overhang_, overhang);
+		}
+		// replaced by the measured size once the cell has loaded
+		cell.estimated_bytes = std::max(cell_desc.actor_count, 1) * estimated_actor_bytes;
+		cell_index_map_[cell.coord.GetKey()] = (int)cells_.size();
+		cells_.push_back(std::move(cell));
+	}
+	LOG_INFO("world partition ", cells_.size(), " cells, cell size ", settings_.cell_size);
+	return true;
+}
+
+SWorldCellCoord SWorldPartition::GetCellCoord(const YVector& position) const
+{
+	SWorldCellCoord coord;
+	coord.x = (int)std::floor(position.x / settings_.cell_size);
+	coord.z = (int)std::floor(position.z / settings_.cell_size);
+	return coord;
+}
+
+float SWorldPartition::GetCellDistance(const WorldCell& cell, const YVector& position) const
+{
+	// distance on the xz plane from the position to the cell square grown by the bounds of its actors
+	float min_x = cell.coord.x * settings_.cell_size;
+	float min_z = cell.coord.z * settings_.cell_size;
+	float max_x = min_x + settings_.cell_size;
+	float max_z = min_z + settings_.cell_size;
+	if (cell.bounds.IsValid())
+	{
+		min_x = std::min(min_x, cell.bounds.min_corner.x);
+		min_z = std::min(min_z, cell.bounds.min_corner.z);
+		max_x = std::max(max_x, cell.bounds.max_corner.x);
+		max_z = std::max(max_z, cell.bounds.max_corner.z);
+	}
+	const float dx = std::max(std::max(min_x - position.x, position.x - max_x), 0.0f);
+	const float dz = std::max(std::max(min_z - position.z, position.z - max_z), 0.0f);
+	return std::sqrt(dx * dx + dz * dz);
+}
+
+void SWorldPartition::UpdateStreaming(const YVector& view_position)
+{
+	assert(!YTaskSystem::IsInWorkerThread());
+	if (release_meshes_pending_)
+	{
+		// actors of the cells unloaded last frame have been destroyed by now
+		YStaticMeshCache::Get().ReleaseUnused();
+		release_meshes_pending_ = false;
+	}
+
+	// unload cells that left the unloading radius
+	for (int i = (int)resident_cells_.size() - 1; i >= 0; --i)
+	{
+		WorldCell& cell = cells_[resident_cells_[i]];
+		if (GetCellDistance(cell, view_position) > settings_.unloading_radius)
+		{
+			UnloadCell(cell);
+		}
+	}
+	for (int i = (int)finalizing_cells_.size() - 1; i >= 0; --i)
+	{
+		WorldCell& cell = cells_[finalizing_cells_[i]];
+		if (GetCellDistance(cell, view_position) > settings_.unloading_radius)
+		{
+			UnloadCell(cell);
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (int cell_index : load_requests_)
+		{
+			WorldCell& cell = cells_[cell_index];
+			if (GetCellDistance(cell, view_position) > settings_.unloading_radius)
+			{
+				cell.cancel_load = true;
+			}
+		}
+	}
+
+	// only the cells inside the loading window are visited, the cost does not grow with the map
+	const size_t budget_bytes = (size_t)settings_.memory_budget_mb * 1024 * 1024;
+	const int window = (int)std::ceil((settings_.loading_radius + max_cell_overhang_) / settings_.cell_size);
+	const SWorldCellCoord view_coord = GetCellCoord(view_position);
+	std::vector<std::pair<float, int>> candidates;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (int z = view_coord.z - window; z <= view_coord.z + window; ++z)
+		{
+			for (int x = view_coord.x - window; x <= view_coord.x + window; ++x)
+			{
+				SWorldCellCoord coord;
+				coord.x = x;
+				coord.z = z;
+				auto find_result = cell_index_map_.find(coord.GetKey());
+				if (find_result == cell_index_map_.end())
+				{
+					continue;
+				}
+				WorldCell& cell = cells_[find_result->second];
+				float distance = GetCellDistance(cell, view_position);
+				if (distance > settings_.loading_radius)
+				{
+					continue;
+				}
+				if (cell.state == CS_Loading)
+				{
+					// came back into range before the stream thread got to it
+					cell.cancel_load = false;
+				}
+				else if (cell.state == CS_Unloaded)
+				{
+					candidates.push_back({ distance, find_result->second });
+				}
+			}
+		}
+	}
+	std::sort(candidates.begin(), candidates.end());
+
+	// resident cells furthest first, given up for nearer cells that do not fit and while over the budget
+	// the cell the view stands in is never given up
+	std::vector<std::pair<float, int>> evict_candidates;
+	for (int cell_index : resident_cells_)
+	{
+		float distance = GetCellDistance(cells_[cell_index], view_position);
+		if (distance > 0.0f)
+		{
+			evict_candidates.push_back({ distance, cell_index });
+		}
+	}
+	std::sort(evict_candidates.rbegin(), evict_candidates.rend());
+	size_t next_evict = 0;
+	auto make_room = [this, budget_bytes, &evict_candidates, &next_evict](size_t bytes, bool count_streaming, float nearer_than)
+	{
+		while (true)
+		{
+			size_t used_bytes = resident_bytes_;
+			if (count_streaming)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				used_bytes += streaming_bytes_;
+			}
+			if (used_bytes + bytes <= budget_bytes)
+			{
+				return true;
+			}
+			if (next_evict >= evict_candidates.size() || evict_candidates[next_evict].first <= nearer_than)
+			{
+				return false;
+			}
+			UnloadCell(cells_[evict_candidates[next_evict++].second]);
+		}
+	};
+
+	// nearest first, the cell the view stands in is always allowed
+	budget_blocked_cell_count_ = 0;
+	for (const std::pair<float, int>& candidate : candidates)
+	{
+		WorldCell& cell = cells_[candidate.second];
+		if (candidate.first > 0.0f && !make_room(cell.estimated_bytes, true, candidate.first))
+		{
+			budget_blocked_cell_count_++;
+			continue;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			cell.state = CS_Loading;
+			cell.cancel_load = false;
+			cell.streaming_bytes = cell.estimated_bytes;
+			streaming_bytes_ += cell.streaming_bytes;
+			load_requests_.push_back(candidate.second);
+		}
+		request_cv_.notify_one();
+	}
+
+	// cells measured larger than their estimate can leave the resident set over the budget
+	make_room(0, false, 0.0f);
+
+	FinalizeLoadedCells();
+}
+
+void SWorldPartition::FinalizeLoadedCells()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (int cell_index : loaded_cells_)
+		{
+			WorldCell& cell = cells_[cell_index];
+			if (cell.cancel_load)
+			{
+				// left the range while loading, the actors were never added to the world
+				cell.actors.clear();
+				cell.cancel_load = false;
+				cell.state = CS_Unloaded;
+				ReleaseStreamingBytes(cell);
+				continue;
+			}
+			finalizing_cells_.push_back(cell_index);
+		}
+		loaded_cells_.clear();
+	}
+
+	std::chrono::time_point<std::chrono::high_resolution_clock> start_time = std::chrono::high_resolution_clock::now();
+	while (!finalizing_cells_.empty())
+	{
+		const int cell_index = finalizing_cells_.front();
+		WorldCell& cell = cells_[cell_index];
+		while (cell.finalized_actor_count < (int)cell.actors.size())
+		{
+			// PostLoadOp and scene registration, one actor at a time so the budget holds
+			world_->AddActor(cell.actors[cell.finalized_actor_count]);
+			cell.finalized_actor_count++;
+			double used_ms = (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start_time).count() * 0.001;
+			if (used_ms >= settings_.finalize_budget_ms)
+			{
+				return;
+			}
+		}
+		cell.resident_bytes = cell.estimated_bytes;
+		resident_bytes_ += cell.resident_bytes;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			cell.state = CS_Resident;
+			ReleaseStreamingBytes(cell);
+		}
+		resident_cells_.push_back(cell_index);
+		finalizing_cells_.erase(finalizing_cells_.begin());
+	}
+}
+
+void SWorldPartition::UnloadCell(WorldCell& cell)
+{
+	std::vector<TRefCountPtr<SActor>> unloaded_actors;
+	int finalized_actor_count = 0;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (cell.state == CS_Loading)
+		{
+			cell.cancel_load = true;
+			return;
+		}
+		if (cell.state == CS_Unloaded)
+		{
+			return;
+		}
+		const int cell_index = (int)(&cell - cells_.data());
+		if (cell.state == CS_Resident)
+		{
+			resident_bytes_ -= cell.resident_bytes;
+			resident_cells_.erase(std::find(resident_cells_.begin(), resident_cells_.end(), cell_index));
+		}
+		else
+		{
+			// CS_Loaded, the cell is either partly finalized or still in loaded_cells_
+			auto finalizing = std::find(finalizing_cells_.begin(), finalizing_cells_.end(), cell_index);
+			if (finalizing != finalizing_cells_.end())
+			{
+				finalizing_cells_.erase(finalizing);
+			}
+			loaded_cells_.erase(std::remove(loaded_cells_.begin(), loaded_cells_.end(), cell_index), loaded_cells_.end());
+			ReleaseStreamingBytes(cell);
+		}
+		unloaded_actors.swap(cell.actors);
+		finalized_actor_count = cell.finalized_actor_count;
+		cell.finalized_actor_count = 0;
+		cell.resident_bytes = 0;
+		cell.state = CS_Unloaded;
+		release_meshes_pending_ = true;
+	}
+	// removed from the world outside the lock, as the finalize path adds them
+	unloaded_actors.resize(finalized_actor_count);
+	world_->RemoveActors(unloaded_actors);
+}
+
+void SWorldPartition::ReleaseStreamingBytes(WorldCell& cell)
+{
+	streaming_bytes_ -= cell.streaming_bytes;
+	cell.streaming_bytes = 0;
+}
+
+void SWorldPartition::UnloadAll()
+{
+	while (!resident_cells_.empty())
+	{
+		UnloadCell(cells_[resident_cells_.back()]);
+	}
+	while (!finalizing_cells_.empty())
+	{
+		UnloadCell(cells_[finalizing_cells_.back()]);
+	}
+	std::vector<int> loaded_cells;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		loaded_cells = loaded_cells_;
+		for (int cell_index : load_requests_)
+		{
+			cells_[cell_index].cancel_load = true;
+		}
+	}
+	for (int cell_index : loaded_cells)
+	{
+		UnloadCell(cells_[cell_index]);
+	}
+}
+
+void SWorldPartition::StreamThreadMain()
+{
+	while (true)
+	{
+		int cell_index = -1;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			request_cv_.wait(lock, [this]() { return exit_ || !load_requests_.empty(); });
+			if (exit_)
+			{
+				return;
+			}
+			cell_index = load_requests_.front();
+			load_requests_.pop_front();
+			WorldCell& cell = cells_[cell_index];
+			if (cell.cancel_load)
+			{
+				cell.cancel_load = false;
+				cell.state = CS_Unloaded;
+				ReleaseStreamingBytes(cell);
+				continue;
+			}
+		}
+		LoadCell(cells_[cell_index]);
+	}
+}
+
+void SWorldPartition::LoadCell(WorldCell& cell)
+{
+	// the stream thread owns cell.actors while the cell is CS_Loading
+	size_t file_size = 0;
+	std::vector<TRefCountPtr<SActor>> actors;
+	const std::string cooked_path = SCookedWorld::GetCookedPath(cell.file_path);
+	if (SObject::IsBinaryPackageUpToDate(cooked_path, cell.file_path))
+	{
+		YFile cell_file(cooked_path, YFile::FileType(YFile::FT_BINARY | YFile::FT_Read));
+		std::unique_ptr<MemoryFile> mem_file = cell_file.ReadFile();
+		SCookedWorld cooked_cell;
+		if (!mem_file)
+		{
+			ERROR_INFO("world partition cell ", cooked_path, " read failed!");
+		}
+		else
+		{
+			file_size = mem_file->GetSize();
+			if (cooked_cell.Load(std::move(mem_file)))
+			{
+				SWorld::LoadActorsParallel(cooked_cell.GetActorCount(), [&cooked_cell](int actor_index) { return cooked_cell.LoadActor(actor_index); }, actors);
+			}
+			else
+			{
+				ERROR_INFO("world partition cell ", cooked_path, " is not a valid cooked world!");
+			}
+		}
+	}
+	else
+	{
+		Json::Arena arena;
+		std::vector<Json::Value> actors_json;
+		if (SWorld::StreamWorldJson(cell.file_path, nullptr, actors_json, &file_size, &arena))
+		{
+			SWorld::LoadActorsParallel((int)actors_json.size(), [&actors_json](int actor_index) { return SWorld::LoadActorFromJson(actors_json[actor_index]); }, actors);
+		}
+	}
+	size_t cell_bytes = MeasureActorsSize(actors, file_size);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	cell.actors = std::move(actors);
+	cell.finalized_actor_count = 0;
+	cell.estimated_bytes = cell_bytes;
+	cell.state = CS_Loaded;
+	loaded_cells_.push_back((int)(&cell - cells_.data()));
+}
+
+size_t SWorldPartition::MeasureActorsSize(const std::vector<TRefCountPtr<SActor>>& actors, size_t file_size)
+{
+	// meshes shared with other cells are counted once per cell, the estimate errs on the safe side
+	std::unordered_set<const YStaticMesh*> meshes;
+	std::vector<SStaticMeshComponent*> mesh_components;
+	std::vector<SInstancedStaticMeshComponent*> instanced_mesh_components;
+	size_t actors_size = file_size;
+	for (const TRefCountPtr<SActor>& actor : actors)
+	{
+		actors_size += sizeof(SActor);
+		mesh_components.clear();
+		actor->GetComponents(mesh_components);
+		for (SStaticMeshComponent* mesh_component : mesh_components)
+		{
+			if (const YStaticMesh* mesh = mesh_component->GetMesh())
+			{
+				meshes.insert(mesh);
+			}
+		}
+		instanced_mesh_components.clear();
+		actor->GetComponents(instanced_mesh_components);
+		for (SInstancedStaticMeshComponent* instanced_mesh_component : instanced_mesh_components)
+		{
+			// the transform, matrix and slot maps of every instance
+			actors_size += instanced_mesh_component->GetInstanceCount() * (sizeof(YTransform) + sizeof(YMatrix) + 3 * sizeof(int));
+			if (const YStaticMesh* mesh = instanced_mesh_component->GetMesh())
+			{
+				meshes.insert(mesh);
+			}
+		}
+	}
+	for (const YStaticMesh* mesh : meshes)
+	{
+		actors_size += mesh->GetResourceSize();
+	}
+	return actors_size;
+}
+
+SWorldPartitionStats SWorldPartition::GetStats() const
+{
+	SWorldPartitionStats stats;
+	std::lock_guard<std::mutex> lock(mutex_);
+	stats.cell_count = (int)cells_.size();
+	for (const WorldCell& cell : cells_)
+	{
+		if (cell.state == CS_Loading || cell.state == CS_Loaded)
+		{
+			stats.loading_cell_count++;
+		}
+		else if (cell.state == CS_Resident)
+		{
+			stats.resident_cell_count++;
+			stats.resident_actor_count += (int)cell.actors.size();
+		}
+	}
+	stats.resident_bytes = resident_bytes_;
+	stats.budget_blocked_cell_count = budget_blocked_cell_count_;
+	return stats;
+}
+
+YBox SWorldPartition::GetActorBounds(const Json::Value& actor_json)
+{
+	YBox bounds;
+	TRefCountPtr<SActor> actor = SWorld::LoadActorFromJson(actor_json);
+	if (actor && !actor->GetComponents().empty())
+	{
+		// the root updates the whole tree, no gpu resource is needed for the bounds
+		SSceneComponent* root_component = actor->GetComponents()[0];
+		root_component->UpdateComponentToWorld();
+		for (SSceneComponent* component : actor->GetComponents())
+		{
+			if (component->GetBounds().IsValid())
+			{
+				bounds += component->GetBounds();
+			}
+		}
+		if (!bounds.IsValid())
+		{
+			bounds += root_component->GetComponentTransform().translation;
+		}
+		return bounds;
+	}
+	YVector translation(0.0f, 0.0f, 0.0f);
+	YJsonHelper::ConvertJsonToVector(actor_json["root_component"]["local_translation"], translation);
+	bounds += translation;
+	return bounds;
+}
+
+bool SWorldPartition::BuildPartitionedWorld(const std::string& world_path, const std::string& out_world_path, const SWorldPartitionSettings& settings)
+{
+	Json::Arena arena;
+	Json::Value world_json;
+	if (!YJsonHelper::LoadJsonFromFile(world_path, world_json, &arena))
+	{
+		return false;
+	}
+	if (settings.cell_size <= 0.0f)
+	{
+		ERROR_INFO("build world partition ", world_path, " failed! invalid cell size ", settings.cell_size);
+		return false;
+	}
+
+	// bucket actors by the center of their world bounds
+	std::unordered_map<uint64_t, int> cell_index_map;
+	std::vector<SWorldCellCoord> cell_coords;
+	std::vector<Json::Value> cell_actors;
+	std::vector<YBox> cell_bounds;
+	const Json::Value& actors = world_json["actors"];
+	const int actor_count = (int)actors.size();
+	for (int i = 0; i < actor_count; ++i)
+	{
+		const Json::Value& actor_json = actors[i];
+		YBox actor_bounds = GetActorBounds(actor_json);
+		const YVector center = actor_bounds.GetCenter();
+		SWorldCellCoord coord;
+		coord.x = (int)std::floor(center.x / settings.cell_size);
+		coord.z = (int)std::floor(center.z / settings.cell_size);
+		auto find_result = cell_index_map.find(coord.GetKey());
+		int cell_index = 0;
+		if (find_result == cell_index_map.end())
+		{
+			cell_index = (int)cell_coords.size();
+			cell_index_map[coord.GetKey()] = cell_index;
+			cell_coords.push_back(coord);
+			cell_actors.push_back(Json::Value(Json::arrayValue));
+			cell_bounds.push_back(YBox());
+		}
+		else
+		{
+			cell_index = find_result->second;
+		}
+		cell_actors[cell_index].append(actor_json);
+		cell_bounds[cell_index] += actor_bounds;
+	}
+
+	// <out world path without extension>_cells/cell_x_z.json, map/world.json writes map/world_cells/cell_0_0.json
+	const std::string cell_dir = YPath::GetBaseFilename(out_world_path, false) + "_cells";
+	Json::Value partition_json;
+	partition_json["cell_size"] = settings.cell_size;
+	partition_json["loading_radius"] = settings.loading_radius;
+	partition_json["unloading_radius"] = settings.unloading_radius;
+	partition_json["memory_budget_mb"] = settings.memory_budget_mb;
+	partition_json["finalize_budget_ms"] = settings.finalize_budget_ms;
+	Json::Value& cells_json = partition_json["cells"];
+	cells_json = Json::Value(Json::arrayValue);
+	for (int cell_index = 0; cell_index < (int)cell_coords.size(); ++cell_index)
+	{
+		const SWorldCellCoord& coord = cell_coords[cell_index];
+		std::string cell_path = YPath::PathCombine(cell_dir, "cell_" + std::to_string(coord.x) + "_" + std::to_string(coord.z) + SObject::json_extension_with_dot);
+		Json::Value cell_json;
+		cell_json["actors"] = cell_actors[cell_index];
+		if (!YJsonHelper::SaveJsonToFile(cell_path, cell_json))
+		{
+			return false;
+		}
+		Json::Value cell_entry;
+		cell_entry["x"] = coord.x;
+		cell_entry["z"] = coord.z;
+		cell_entry["file"] = cell_path;
+		cell_entry["actor_count"] = (int)cell_actors[cell_index].size();
+		const YBox& bounds = cell_bounds[cell_index];
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			cell_entry["bounds_min"].append((&bounds.min_corner.x)[axis]);
+			cell_entry["bounds_max"].append((&bounds.max_corner.x)[axis]);
+		}
+		cells_json.append(cell_entry);
+	}
+
+	world_json.removeMember("actors");
+	world_json["partition"] = partition_json;
+	if (!YJsonHelper::SaveJsonToFile(out_world_path, world_json))
+	{
+		return false;
+	}
+	LOG_INFO("world ", world_path, " partitioned into ", cell_coords.size(), " cells, ", actor_count, " actors");
+	return true;
+}
@@ -47,6 +47,31 @@ VS_OUTPUT VSMain(VS_INPUT Input)
 	return Output;
 }
 
+struct VS_INSTANCED_INPUT
+{
+	float3    vPosition		: position;
+	float3    vNormal       : normal;
+	float2    vTexCoord     : uv;
+	// rows of the world matrix, one set per instance
+	float4    vAxisX        : instance_axis_x;
+	float4    vAxisY        : instance_axis_y;
+	float4    vAxisZ        : instance_axis_z;
+	float4    vOrigin       : instance_origin;
+};
+
+VS_OUTPUT VSMainInstanced(VS_INSTANCED_INPUT Input)
+{
+	VS_OUTPUT Output;
+	matrix world = matrix(Input.vAxisX, Input.vAxisY, Input.vAxisZ, Input.vOrigin);
+	matrix vp = mul(g_view, g_projection);
+	matrix wvp = mul(world, vp);
+	Output.vPosition = mul(float4(Input.vPosition, 1.0), wvp);
+	Output.vTexcoord = Input.vTexCoord;
+	Output.vColor = float4(1.0, 1.0, 1.0, 1.0);
+	Output.vNormal = Input.vNormal;
+	return Output;
+}
+
 
 // Texture2D txDiffuse;
 // Texture2D txNormal;
@@ -1,6 +1,8 @@
 #include "Utility/YJsonHelper.h"
 #include "Engine/YFile.h"
+#include "Utility/YPath.h"
 #include <memory>
+#include <cstdio>
 #include "Engine/YLog.h"
 bool YJsonHelper::ConvertJsonToVector2(const Json::Value& value, YVector2& v)
 {
@@ -32,7 +34,7 @@ bool YJsonHelper::ConvertJsonToVector4(const Json::Value& value, YVector4& v)
 		v.x = value[0].asFloat();
 		v.y = value[1].asFloat();
 		v.z = value[2].asFloat();
-		v.z = value[3].asFloat();
+		v.w = value[3].asFloat();
 		return true;
 	}
 	return false;
@@ -50,7 +52,7 @@ bool YJsonHelper::ConvertJsonToRotator(const Json::Value& value, YRotator& v)
 	return false;
 }
 
-bool YJsonHelper::LoadJsonFromFile(const std::string& path, Json::Value& root)
+bool YJsonHelper::LoadJsonFromFile(const std::string& path, Json::Value& root, Json::Arena* arena /*= nullptr*/)
 {
 	YFile json_file(path, YFile::FileType(YFile::FT_TXT | YFile::FT_Read));
 	std::unique_ptr<MemoryFile> mem_file = json_file.ReadFile();
@@ -60,11 +62,55 @@ bool YJsonHelper::LoadJsonFromFile(const std::string& path, Json::Value& root)
 		return false;
 	}
 	Json::Reader json_reader;
-	if (!json_reader.parse((const char*)mem_file->GetData(), (const char*)(mem_file->GetData() + mem_file->GetSize()), root, true))
+	char* begin = (char*)mem_file->GetData();
+	char* end = (char*)(mem_file->GetData() + mem_file->GetSize());
+	if (!(arena ? json_reader.parseInSitu(begin, end, root, *arena, true) : json_reader.parse(begin, end, root, true)))
 	{
 		ERROR_INFO("load json package ", path, "failed!, json parse failed, reason ", json_reader.getFormattedErrorMessages().c_str());
 		return false;
 	}
+	if (arena)
+	{
+		arena->keepAlive(std::shared_ptr<MemoryFile>(std::move(mem_file)));
+	}
 	return true;
 }
 
+bool YJsonHelper::SaveJsonToFile(const std::string& path, const Json::Value& root, YJsonWriter::EStyle style /*= YJsonWriter::JS_Pretty*/)
+{
+	return WriteJsonToFile(path, [&root](YJsonWriter& writer) { writer.WriteValue(root); return true; }, style);
+}
+
+bool YJsonHelper::WriteJsonToFile(const std::string& path, const std::function<bool(YJsonWriter&)>& write_func, YJsonWriter::EStyle style)
+{
+	// written beside the target first, a failed or interrupted save leaves the old file as it was
+	const std::string temp_path = path + ".tmp";
+	YFile json_file(temp_path, YFile::FileType(YFile::FT_TXT | YFile::FT_Write));
+	FILE* file = json_file.OpenForWrite(true);
+	if (!file)
+	{
+		ERROR_INFO("save json ", path, " failed!, open file error");
+		return false;
+	}
+	bool write_success = true;
+	{
+		YJsonWriter writer(file, style);
+		write_success = write_func(writer);
+		write_success &= writer.Flush();
+	}
+	write_success &= fclose(file) == 0;
+	if (!write_success)
+	{
+		std::remove(temp_path.c_str());
+		ERROR_INFO("save json ", path, " failed!");
+		return false;
+	}
+	// replaced in one step, there is no moment without the file
+	if (!YPath::MoveFileReplace(temp_path, path))
+	{
+		std::remove(temp_path.c_str());
+		ERROR_INFO("save json ", path, " failed!, rename ", temp_path, " error");
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,474 @@
+#include "Utility/YJsonVisitor.h"
+#include "Utility/YJsonHelper.h"
+#include "Engine/YFile.h"
+#include "Engine/YLog.h"
+#include <cstring>
+#include <limits>
+
+YJsonObjectVisitor::Member& YJsonObjectVisitor::AddMember(const std::string& key, EMemberType type)
+{
+	members_.emplace_back();
+	Member& member = members_.back();
+	member.key = key;
+	member.type = type;
+	return member;
+}
+
+YJsonObjectVisitor& YJsonObjectVisitor::OnBool(const std::string& key, std::function<void(bool)> func)
+{
+	AddMember(key, MT_Bool).bool_func = std::move(func);
+	return *this;
+}
+
+YJsonObjectVisitor& YJsonObjectVisitor::OnInt(const std::string& key, std::function<void(int)> func)
+{
+	AddMember(key, MT_Int).int_func = std::move(func);
+	return *this;
+}
+
+YJsonObjectVisitor& YJsonObjectVisitor::OnFloat(const std::string& key, std::function<void(float)> func)
+{
+	AddMember(key, MT_Float).float_func = std::move(func);
+	return *this;
+}
+
+YJsonObjectVisitor& YJsonObjectVisitor::OnString(const std::string& key, std::function<void(std::string&&)> func)
+{
+	AddMember(key, MT_String).string_func = std::move(func);
+	return *this;
+}
+
+YJsonObjectVisitor& YJsonObjectVisitor::OnVector(const std::string& key, std::function<void(const YVector&)> func)
+{
+	AddMember(key, MT_Vector).vector_func = std::move(func);
+	return *this;
+}
+
+YJsonObjectVisitor& YJsonObjectVisitor::OnObject(const std::string& key, const YJsonObjectVisitor* visitor)
+{
+	AddMember(key, MT_Object).object_visitor = visitor;
+	return *this;
+}
+
+YJsonObjectVisitor& YJsonObjectVisitor::OnValue(const std::string& key, std::function<void(Json::Value&&)> func)
+{
+	AddMember(key, MT_Value).value_func = std::move(func);
+	return *this;
+}
+
+YJsonObjectVisitor& YJsonObjectVisitor::OnArrayValues(const std::string& key, std::function<void(Json::Value&&)> func)
+{
+	AddMember(key, MT_ArrayValues).value_func = std::move(func);
+	return *this;
+}
+
+const YJsonObjectVisitor::Member* YJsonObjectVisitor::FindMember(const char* key_begin, const char* key_end) const
+{
+	const size_t key_length = key_end - key_begin;
+	for (const Member& member : members_)
+	{
+		if (member.key.size() == key_length && memcmp(member.key.data(), key_begin, key_length) == 0)
+		{
+			return &member;
+		}
+	}
+	return nullptr;
+}
+
+// turns the reader events into member callbacks, one frame per open object or array
+class YJsonVisitHandler :public Json::SaxHandler
+{
+public:
+	YJsonVisitHandler(const YJsonObjectVisitor& root_visitor, Json::Arena* arena) :root_visitor_(root_visitor), arena_(arena) {}
+	bool onNull() override
+	{
+		return OnScalar(Json::Value());
+	}
+	bool onBool(bool value) override
+	{
+		if (Frame* frame = GetMemberFrame(YJsonObjectVisitor::MT_Bool))
+		{
+			frame->member->bool_func(value);
+			return true;
+		}
+		return OnScalar(Json::Value(value));
+	}
+	bool onInt(Json::LargestInt value) override
+	{
+		return OnNumber((double)value, value >= std::numeric_limits<int>::min() && value <= std::numeric_limits<int>::max(), Json::Value(value));
+	}
+	bool onUInt(Json::LargestUInt value) override
+	{
+		return OnNumber((double)value, value <= (Json::LargestUInt)std::numeric_limits<int>::max(), Json::Value(value));
+	}
+	bool onDouble(double value) override
+	{
+		return OnNumber(value, value >= (double)std::numeric_limits<int>::min() && value <= (double)std::numeric_limits<int>::max(), Json::Value(value));
+	}
+	bool onString(const char* begin, const char* end) override
+	{
+		if (Frame* frame = GetMemberFrame(YJsonObjectVisitor::MT_String))
+		{
+			frame->member->string_func(std::string(begin, end));
+			return true;
+		}
+		if (!frames_.empty() && frames_.back().type == FT_Value)
+		{
+			return Forward([begin, end](Json::SaxValueBuilder& builder) { return builder.onString(begin, end); });
+		}
+		return OnScalar(Json::Value(begin, end));
+	}
+	bool onInSituString(const char* begin, const char* end) override
+	{
+		// only a built value keeps the view, typed callbacks copy anyway
+		if (!frames_.empty() && frames_.back().type == FT_Value)
+		{
+			return Forward([begin, end](Json::SaxValueBuilder& builder) { return builder.onInSituString(begin, end); });
+		}
+		return onString(begin, end);
+	}
+	bool onObjectBegin() override
+	{
+		if (frames_.empty())
+		{
+			frames_.push_back(Frame{ FT_Object, &root_visitor_, nullptr });
+			return true;
+		}
+		if (frames_.back().type == FT_Value)
+		{
+			return Forward([](Json::SaxValueBuilder& builder) { return builder.onObjectBegin(); });
+		}
+		if (Frame* frame = GetMemberFrame(YJsonObjectVisitor::MT_Object))
+		{
+			const YJsonObjectVisitor* visitor = frame->member->object_visitor;
+			frame->member = nullptr;
+			frames_.push_back(Frame{ FT_Object, visitor, nullptr });
+			return true;
+		}
+		if (BeginValue())
+		{
+			return Forward([](Json::SaxValueBuilder& builder) { return builder.onObjectBegin(); });
+		}
+		PushSkip();
+		return true;
+	}
+	bool onKey(const char* begin, const char* end) override
+	{
+		Frame& frame = frames_.back();
+		if (frame.type == FT_Value)
+		{
+			return builder_->onKey(begin, end);
+		}
+		if (frame.type == FT_Object)
+		{
+			frame.member = frame.visitor->FindMember(begin, end);
+		}
+		return true;
+	}
+	bool onObjectEnd() override
+	{
+		return OnContainerEnd([](Json::SaxValueBuilder& builder) { return builder.onObjectEnd(); });
+	}
+	bool onArrayBegin() override
+	{
+		if (frames_.empty())
+		{
+			// the root of a visited document is an object
+			PushSkip();
+			WARNING_INFO("json visit, the root is not an object");
+			return true;
+		}
+		if (frames_.back().type == FT_Value)
+		{
+			return Forward([](Json::SaxValueBuilder& builder) { return builder.onArrayBegin(); });
+		}
+		if (Frame* frame = GetMemberFrame(YJsonObjectVisitor::MT_Vector))
+		{
+			const YJsonObjectVisitor::Member* member = frame->member;
+			frame->member = nullptr;
+			frames_.push_back(Frame{ FT_Vector, nullptr, member });
+			return true;
+		}
+		if (Frame* frame = GetMemberFrame(YJsonObjectVisitor::MT_ArrayValues))
+		{
+			const YJsonObjectVisitor::Member* member = frame->member;
+			frame->member = nullptr;
+			frames_.push_back(Frame{ FT_ArrayValues, nullptr, member });
+			return true;
+		}
+		if (BeginValue())
+		{
+			return Forward([](Json::SaxValueBuilder& builder) { return builder.onArrayBegin(); });
+		}
+		PushSkip();
+		return true;
+	}
+	bool onArrayEnd() override
+	{
+		return OnContainerEnd([](Json::SaxValueBuilder& builder) { return builder.onArrayEnd(); });
+	}
+protected:
+	enum EFrameType
+	{
+		FT_Object,
+		// building a Json::Value, every event goes to builder_
+		FT_Value,
+		FT_ArrayValues,
+		FT_Vector,
+		FT_Skip,
+	};
+	struct Frame
+	{
+		EFrameType type;
+		const YJsonObjectVisitor* visitor;
+		// FT_Object: member of the last key, FT_Value/FT_ArrayValues/FT_Vector: the member being read
+		const YJsonObjectVisitor::Member* member;
+		// FT_Skip: containers open inside the skipped one, a whole skipped subtree is one frame
+		int depth = 0;
+		float vector_elements[3] = { 0.0f,0.0f,0.0f };
+		int vector_element_count = 0;
+	};
+
+	// the object frame whose pending member has the given type
+	Frame* GetMemberFrame(YJsonObjectVisitor::EMemberType type)
+	{
+		if (frames_.empty() || frames_.back().type != FT_Object || !frames_.back().member || frames_.back().member->type != type)
+		{
+			return nullptr;
+		}
+		return &frames_.back();
+	}
+
+	bool OnNumber(double value, bool is_int, Json::Value&& json_value)
+	{
+		if (Frame* frame = GetMemberFrame(YJsonObjectVisitor::MT_Float))
+		{
+			frame->member->float_func((float)value);
+			return true;
+		}
+		if (Frame* frame = GetMemberFrame(YJsonObjectVisitor::MT_Int))
+		{
+			if (is_int)
+			{
+				frame->member->int_func((int)value);
+			}
+			else
+			{
+				WARNING_INFO("json member ", frame->member->key, " ", value, " is out of int range");
+			}
+			return true;
+		}
+		if (!frames_.empty() && frames_.back().type == FT_Vector)
+		{
+			Frame& frame = frames_.back();
+			if (frame.vector_element_count < 3)
+			{
+				frame.vector_elements[frame.vector_element_count] = (float)value;
+			}
+			frame.vector_element_count++;
+			return true;
+		}
+		return OnScalar(std::move(json_value));
+	}
+
+	// a scalar no typed callback took, built into a value or skipped
+	bool OnScalar(Json::Value&& value)
+	{
+		if (frames_.empty())
+		{
+			WARNING_INFO("json visit, the root is not an object");
+			return true;
+		}
+		Frame& frame = frames_.back();
+		switch (frame.type)
+		{
+		case FT_Value:
+			return Forward([&value](Json::SaxValueBuilder& builder)
+				{
+					switch (value.type())
+					{
+					case Json::nullValue:
+						return builder.onNull();
+					case Json::booleanValue:
+						return builder.onBool(value.asBool());
+					case Json::intValue:
+						return builder.onInt(value.asLargestInt());
+					case Json::uintValue:
+						return builder.onUInt(value.asLargestUInt());
+					default:
+						return builder.onDouble(value.asDouble());
+					}
+				});
+		case FT_ArrayValues:
+			frame.member->value_func(std::move(value));
+			return true;
+		case FT_Vector:
+			// non number element, the vector is rejected at the end
+			frame.vector_element_count = 4;
+			return true;
+		case FT_Object:
+			if (frame.member)
+			{
+				if (frame.member->type == YJsonObjectVisitor::MT_Value)
+				{
+					frame.member->value_func(std::move(value));
+				}
+				else
+				{
+					WARNING_INFO("json member ", frame.member->key, " has the wrong type");
+				}
+				frame.member = nullptr;
+			}
+			return true;
+		default:
+			return true;
+		}
+	}
+
+	// start building the value of the current member or array element, false if nothing wants it
+	bool BeginValue()
+	{
+		Frame& frame = frames_.back();
+		const YJsonObjectVisitor::Member* member = nullptr;
+		if (frame.type == FT_ArrayValues)
+		{
+			member = frame.member;
+		}
+		else if (frame.type == FT_Object && frame.member)
+		{
+			if (frame.member->type == YJsonObjectVisitor::MT_Value)
+			{
+				member = frame.member;
+			}
+			else
+			{
+				WARNING_INFO("json member ", frame.member->key, " has the wrong type");
+			}
+			frame.member = nullptr;
+		}
+		else if (frame.type == FT_Vector)
+		{
+			frame.vector_element_count = 4;
+		}
+		if (!member)
+		{
+			return false;
+		}
+		value_ = Json::Value();
+		builder_ = std::make_unique<Json::SaxValueBuilder>(value_, arena_);
+		frames_.push_back(Frame{ FT_Value, nullptr, member });
+		return true;
+	}
+
+	template<typename Func>
+	bool Forward(Func&& func)
+	{
+		if (!func(*builder_))
+		{
+			return false;
+		}
+		if (builder_->isComplete())
+		{
+			const YJsonObjectVisitor::Member* member = frames_.back().member;
+			frames_.pop_back();
+			builder_ = nullptr;
+			member->value_func(std::move(value_));
+		}
+		return true;
+	}
+
+	void PushSkip()
+	{
+		if (!frames_.empty() && frames_.back().type == FT_Skip)
+		{
+			frames_.back().depth++;
+			return;
+		}
+		frames_.push_back(Frame{ FT_Skip, nullptr, nullptr, 1 });
+	}
+
+	template<typename Func>
+	bool OnContainerEnd(Func&& builder_func)
+	{
+		Frame& frame = frames_.back();
+		switch (frame.type)
+		{
+		case FT_Value:
+			return Forward(builder_func);
+		case FT_Skip:
+			if (--frame.depth == 0)
+			{
+				frames_.pop_back();
+			}
+			return true;
+		case FT_Vector:
+			if (frame.vector_element_count == 3)
+			{
+				frame.member->vector_func(YVector(frame.vector_elements[0], frame.vector_elements[1], frame.vector_elements[2]));
+			}
+			else
+			{
+				WARNING_INFO("json member ", frame.member->key, " is not a vector");
+			}
+			frames_.pop_back();
+			return true;
+		default:
+			frames_.pop_back();
+			return true;
+		}
+	}
+
+	const YJsonObjectVisitor& root_visitor_;
+	Json::Arena* arena_;
+	std::vector<Frame> frames_;
+	std::unique_ptr<Json::SaxValueBuilder> builder_;
+	Json::Value value_;
+};
+
+bool YJsonHelper::VisitJson(const char* begin, const char* end, const YJsonObjectVisitor& root_visitor, std::string* out_error /*= nullptr*/, Json::Arena* arena /*= nullptr*/)
+{
+	YJsonVisitHandler handler(root_visitor, arena);
+	Json::SaxReader json_reader;
+	if (!json_reader.parse(begin, end, handler))
+	{
+		if (out_error)
+		{
+			*out_error = json_reader.getFormattedErrorMessages();
+		}
+		return false;
+	}
+	return true;
+}
+
+bool YJsonHelper::VisitJsonInSitu(char* begin, char* end, const YJsonObjectVisitor& root_visitor, Json::Arena& arena, std::string* out_error /*= nullptr*/)
+{
+	YJsonVisitHandler handler(root_visitor, &arena);
+	Json::SaxReader json_reader;
+	if (!json_reader.parseInSitu(begin, end, handler))
+	{
+		if (out_error)
+		{
+			*out_error = json_reader.getFormattedErrorMessages();
+		}
+		return false;
+	}
+	return true;
+}
+
+bool YJsonHelper::VisitJsonFromFile(const std::string& path, const YJsonObjectVisitor& root_visitor)
+{
+	YFile json_file(path, YFile::FileType(YFile::FT_TXT | YFile::FT_Read));
+	std::unique_ptr<MemoryFile> mem_file = json_file.ReadFile();
+	if (!mem_file)
+	{
+		ERROR_INFO("visit json ", path, " failed!, read file error");
+		return false;
+	}
+	std::string error;
+	if (!VisitJson((const char*)mem_file->GetData(), (const char*)(mem_file->GetData() + mem_file->GetSize()), root_visitor, &error))
+	{
+		ERROR_INFO("visit json ", path, " failed!, json parse failed, reason ", error);
+		return false;
+	}
+	return true;
+}
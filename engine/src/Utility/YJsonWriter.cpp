@@ -0,0 +1,387 @@
+#include "Utility/YJsonWriter.h"
+#include "Engine/YFile.h"
+#include <cassert>
+#include <charconv>
+#include <cmath>
+
+YJsonWriter::YJsonWriter(MemoryFile& mem_file, EStyle style /*= JS_Compact*/)
+	:mem_file_(&mem_file), style_(style), buffer_(buffer_size)
+{
+
+}
+
+YJsonWriter::YJsonWriter(FILE* file, EStyle style /*= JS_Compact*/)
+	:file_(file), style_(style), buffer_(buffer_size)
+{
+	assert(file);
+	good_ = file != nullptr;
+}
+
+YJsonWriter::~YJsonWriter()
+{
+	Flush();
+}
+
+YJsonWriter& YJsonWriter::BeginObject()
+{
+	BeginValue();
+	Put('{');
+	scopes_.push_back(Scope{ true, false, 0 });
+	return *this;
+}
+
+YJsonWriter& YJsonWriter::EndObject()
+{
+	assert(!scopes_.empty() && scopes_.back().is_object && !after_key_);
+	const bool has_member = scopes_.back().count > 0;
+	scopes_.pop_back();
+	if (has_member)
+	{
+		NewLine(scopes_.size());
+	}
+	Put('}');
+	return *this;
+}
+
+YJsonWriter& YJsonWriter::BeginArray(bool single_line /*= false*/)
+{
+	BeginValue();
+	Put('[');
+	scopes_.push_back(Scope{ false, single_line, 0 });
+	return *this;
+}
+
+YJsonWriter& YJsonWriter::EndArray()
+{
+	assert(!scopes_.empty() && !scopes_.back().is_object);
+	const Scope scope = scopes_.back();
+	scopes_.pop_back();
+	if (scope.count > 0 && !scope.single_line)
+	{
+		NewLine(scopes_.size());
+	}
+	Put(']');
+	return *this;
+}
+
+YJsonWriter& YJsonWriter::Key(const char* key, size_t length)
+{
+	assert(!scopes_.empty() && scopes_.back().is_object && !after_key_);
+	Scope& scope = scopes_.back();
+	if (scope.count++ > 0)
+	{
+		Put(',');
+	}
+	NewLine(scopes_.size());
+	PutString(key, length);
+	Put(':');
+	if (style_ == JS_Pretty)
+	{
+		Put(' ');
+	}
+	after_key_ = true;
+	return *this;
+}
+
+void YJsonWriter::BeginValue()
+{
+	if (after_key_)
+	{
+		after_key_ = false;
+		return;
+	}
+	if (scopes_.empty())
+	{
+		return;
+	}
+	Scope& scope = scopes_.back();
+	// a key and a value are one step in an object, see Key
+	assert(!scope.is_object);
+	if (scope.count++ > 0)
+	{
+		Put(',');
+		if (scope.single_line && style_ == JS_Pretty)
+		{
+			Put(' ');
+		}
+	}
+	if (!scope.single_line)
+	{
+		NewLine(scopes_.size());
+	}
+}
+
+void YJsonWriter::NewLine(size_t depth)
+{
+	if (style_ != JS_Pretty)
+	{
+		return;
+	}
+	Put('\n');
+	for (size_t i = 0; i < depth; ++i)
+	{
+		Put('\t');
+	}
+}
+
+YJsonWriter& YJsonWriter::WriteNull()
+{
+	BeginValue();
+	Put("null", 4);
+	return *this;
+}
+
+YJsonWriter& YJsonWriter::WriteBool(bool value)
+{
+	BeginValue();
+	if (value)
+	{
+		Put("true", 4);
+	}
+	else
+	{
+		Put("false", 5);
+	}
+	return *this;
+}
+
+YJsonWriter& YJsonWriter::WriteInt(int64_t value)
+{
+	BeginValue();
+	char text[24];
+	const std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+	Put(text, result.ptr - text);
+	return *this;
+}
+
+YJsonWriter& YJsonWriter::WriteUInt(uint64_t value)
+{
+	BeginValue();
+	char text[24];
+	const std::to_chars_result result = std::to_chars(text, text + sizeof(text), value);
+	Put(text, result.ptr - text);
+	return *this;
+}
+
+template<typename T>
+static size_t FormatReal(T value, char* text, size_t size)
+{
+// the float path jsoncpp takes, snprintf with enough digits to round trip without floating point to_chars
+#if JSONCPP_HAS_FLOAT_CHARCONV
+	size_t length = std::to_chars(text, text + size, value).ptr - text;
+#else
+	size_t length = (size_t)snprintf(text, size, "%.*g", sizeof(T) == sizeof(float) ? 9 : 17, (double)value);
+	// the c locale may use a decimal comma
+	for (size_t i = 0; i < length; ++i)
+	{
+		if (text[i] == ',')
+		{
+			text[i] = '.';
+		}
+	}
+#endif
+	// "1" would read back as an int
+	if (!memchr(text, '.', length) && !memchr(text, 'e', length))
+	{
+		text[length++] = '.';
+		text[length++] = '0';
+	}
+	return length;
+}
+
+YJsonWriter& YJsonWriter::WriteFloat(float value)
+{
+	if (!std::isfinite(value))
+	{
+		return WriteNull();
+	}
+	BeginValue();
+	char text[32];
+	Put(text, FormatReal(value, text, sizeof(text) - 2));
+	return *this;
+}
+
+YJsonWriter& YJsonWriter::WriteDouble(double value)
+{
+	if (!std::isfinite(value))
+	{
+		return WriteNull();
+	}
+	BeginValue();
+	char text[40];
+	Put(text, FormatReal(value, text, sizeof(text) - 2));
+	return *this;
+}
+
+YJsonWriter& YJsonWriter::WriteString(const char* str, size_t length)
+{
+	BeginValue();
+	PutString(str, length);
+	return *this;
+}
+
+void YJsonWriter::PutString(const char* str, size_t length)
+{
+	static const char hex_digits[] = "0123456789abcdef";
+	Put('"');
+	// runs without anything to escape are copied in one go
+	const char* run_begin = str;
+	const char* end = str + length;
+	for (const char* c = str; c != end; ++c)
+	{
+		const unsigned char ch = (unsigned char)*c;
+		if (ch >= 0x20 && ch != '"' && ch != '\\')
+		{
+			continue;
+		}
+		Put(run_begin, c - run_begin);
+		run_begin = c + 1;
+		switch (ch)
+		{
+		case '"':
+			Put("\\\"", 2);
+			break;
+		case '\\':
+			Put("\\\\", 2);
+			break;
+		case '\n':
+			Put("\\n", 2);
+			break;
+		case '\r':
+			Put("\\r", 2);
+			break;
+		case '\t':
+			Put("\\t", 2);
+			break;
+		default:
+		{
+			const char escaped[6] = { '\\', 'u', '0', '0', hex_digits[ch >> 4], hex_digits[ch & 0xf] };
+			Put(escaped, sizeof(escaped));
+			break;
+		}
+		}
+	}
+	Put(run_begin, end - run_begin);
+	Put('"');
+}
+
+YJsonWriter& YJsonWriter::WriteVector(const YVector& v)
+{
+	return BeginArray(true).WriteFloat(v.x).WriteFloat(v.y).WriteFloat(v.z).EndArray();
+}
+
+YJsonWriter& YJsonWriter::WriteVector4(const YVector4& v)
+{
+	return BeginArray(true).WriteFloat(v.x).WriteFloat(v.y).WriteFloat(v.z).WriteFloat(v.w).EndArray();
+}
+
+YJsonWriter& YJsonWriter::WriteRotator(const YRotator& v)
+{
+	return BeginArray(true).WriteFloat(v.pitch).WriteFloat(v.yaw).WriteFloat(v.roll).EndArray();
+}
+
+YJsonWriter& YJsonWriter::WriteValue(const Json::Value& value)
+{
+	switch (value.type())
+	{
+	case Json::nullValue:
+		return WriteNull();
+	case Json::intValue:
+		return WriteInt(value.asLargestInt());
+	case Json::uintValue:
+		return WriteUInt(value.asLargestUInt());
+	case Json::realValue:
+		return WriteDouble(value.asDouble());
+	case Json::stringValue:
+	{
+		const char* begin = nullptr;
+		const char* end = nullptr;
+		if (!value.getString(&begin, &end))
+		{
+			return WriteString("", 0);
+		}
+		return WriteString(begin, end - begin);
+	}
+	case Json::booleanValue:
+		return WriteBool(value.asBool());
+	case Json::arrayValue:
+	{
+		bool single_line = true;
+		for (const Json::Value& element : value)
+		{
+			if (element.isArray() || element.isObject())
+			{
+				single_line = false;
+				break;
+			}
+		}
+		BeginArray(single_line);
+		for (const Json::Value& element : value)
+		{
+			WriteValue(element);
+		}
+		return EndArray();
+	}
+	case Json::objectValue:
+		BeginObject();
+		for (Json::Value::const_iterator iter = value.begin(); iter != value.end(); ++iter)
+		{
+			char const* key_end = nullptr;
+			char const* key = iter.memberName(&key_end);
+			Key(key, key_end - key);
+			WriteValue(*iter);
+		}
+		return EndObject();
+	}
+	return *this;
+}
+
+bool YJsonWriter::Flush()
+{
+	FlushBuffer();
+	if (file_ && fflush(file_) != 0)
+	{
+		good_ = false;
+	}
+	return good_;
+}
+
+void YJsonWriter::Put(const char* str, size_t length)
+{
+	if (buffer_pos_ + length > buffer_.size())
+	{
+		FlushBuffer();
+		// larger than the whole buffer, skip the copy
+		if (length > buffer_.size())
+		{
+			if (mem_file_)
+			{
+				mem_file_->WriteChars(str, (int)length);
+			}
+			else if (good_ && fwrite(str, 1, length, file_) != length)
+			{
+				good_ = false;
+			}
+			return;
+		}
+	}
+	memcpy(&buffer_[buffer_pos_], str, length);
+	buffer_pos_ += length;
+}
+
+void YJsonWriter::FlushBuffer()
+{
+	if (buffer_pos_ == 0)
+	{
+		return;
+	}
+	if (mem_file_)
+	{
+		mem_file_->WriteChars(buffer_.data(), (int)buffer_pos_);
+	}
+	else if (good_ && fwrite(buffer_.data(), 1, buffer_pos_, file_) != buffer_pos_)
+	{
+		good_ = false;
+	}
+	buffer_pos_ = 0;
+}
@@ -0,0 +1,165 @@
+#include "Utility/YObjectPool.h"
+#include "Engine/YLog.h"
+#include <new>
+#include <algorithm>
+
+static const size_t pool_slab_size = 64 * 1024;
+static const int min_blocks_per_slab = 16;
+
+static std::mutex& GetPoolRegistryMutex()
+{
+	static std::mutex registry_mutex;
+	return registry_mutex;
+}
+
+static std::vector<YObjectPool*>& GetPoolRegistry()
+{
+	static std::vector<YObjectPool*> registry;
+	return registry;
+}
+
+YObjectPool::YObjectPool(const std::string& name, size_t object_size)
+	:name_(name), object_size_(object_size)
+{
+	// keep every object 16 byte aligned
+	block_size_ = sizeof(BlockHeader) + ((object_size + 15) & ~size_t(15));
+	blocks_per_slab_ = std::max(min_blocks_per_slab, (int)(pool_slab_size / block_size_));
+	std::lock_guard<std::mutex> lock(GetPoolRegistryMutex());
+	GetPoolRegistry().push_back(this);
+}
+
+YObjectPool::~YObjectPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(GetPoolRegistryMutex());
+		std::vector<YObjectPool*>& registry = GetPoolRegistry();
+		registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+	}
+	assert(!live_count_);
+	for (unsigned char* slab : slabs_)
+	{
+		delete[] slab;
+	}
+}
+
+void* YObjectPool::Allocate(size_t object_size)
+{
+	assert(object_size <= object_size_);
+	std::lock_guard<std::mutex> lock(mutex_);
+	BlockHeader* header = nullptr;
+	if (free_list_)
+	{
+		header = free_list_;
+		free_list_ = header->next_free;
+	}
+	else
+	{
+		if (slabs_.empty() || slab_used_blocks_ == blocks_per_slab_)
+		{
+			AllocSlab();
+		}
+		header = reinterpret_cast<BlockHeader*>(slabs_.back() + slab_used_blocks_ * block_size_);
+		slab_used_blocks_++;
+	}
+	header->pool = this;
+	header->next_free = nullptr;
+	live_count_++;
+	peak_count_ = std::max(peak_count_, live_count_);
+	alloc_count_++;
+	return header + 1;
+}
+
+void YObjectPool::Free(BlockHeader* header)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	header->next_free = free_list_;
+	free_list_ = header;
+	live_count_--;
+	free_count_++;
+}
+
+void YObjectPool::AllocSlab()
+{
+	slabs_.push_back(new unsigned char[block_size_ * blocks_per_slab_]);
+	slab_used_blocks_ = 0;
+}
+
+bool YObjectPool::TrimIfEmpty()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (live_count_ || slabs_.empty())
+	{
+		return false;
+	}
+	for (unsigned char* slab : slabs_)
+	{
+		delete[] slab;
+	}
+	slabs_.clear();
+	slab_used_blocks_ = 0;
+	free_list_ = nullptr;
+	return true;
+}
+
+YObjectPoolStats YObjectPool::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	YObjectPoolStats stats;
+	stats.name = name_;
+	stats.block_size = block_size_;
+	stats.live_count = live_count_;
+	stats.peak_count = peak_count_;
+	stats.slab_count = (int)slabs_.size();
+	stats.alloc_count = alloc_count_;
+	stats.free_count = free_count_;
+	return stats;
+}
+
+void* YObjectPool::AllocateFromHeap(size_t object_size)
+{
+	BlockHeader* header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + object_size));
+	header->pool = nullptr;
+	header->next_free = nullptr;
+	return header + 1;
+}
+
+void YObjectPool::FreeObject(void* object)
+{
+	if (!object)
+	{
+		return;
+	}
+	BlockHeader* header = static_cast<BlockHeader*>(object) - 1;
+	if (header->pool)
+	{
+		header->pool->Free(header);
+	}
+	else
+	{
+		::operator delete(header);
+	}
+}
+
+void YObjectPool::TrimAll()
+{
+	std::lock_guard<std::mutex> lock(GetPoolRegistryMutex());
+	for (YObjectPool* pool : GetPoolRegistry())
+	{
+		YObjectPoolStats stats = pool->GetStats();
+		if (pool->TrimIfEmpty())
+		{
+			LOG_INFO("object pool ", stats.name, " released ", stats.slab_count, " slabs, peak ", stats.peak_count, " objects");
+		}
+	}
+}
+
+std::vector<YObjectPoolStats> YObjectPool::GetAllPoolStats()
+{
+	std::lock_guard<std::mutex> lock(GetPoolRegistryMutex());
+	std::vector<YObjectPoolStats> all_stats;
+	for (YObjectPool* pool : GetPoolRegistry())
+	{
+		all_stats.push_back(pool->GetStats());
+	}
+	return all_stats;
+}
@@ -87,6 +87,16 @@ bool YPath::FileExists(const std::string& InPath)
 	return YSysUtility::FileExists(InPath);
 }
 
+bool YPath::GetFileModifyTime(const std::string& InPath, uint64_t& out_time)
+{
+	return YSysUtility::GetFileModifyTime(InPath, out_time);
+}
+
+bool YPath::MoveFileReplace(const std::string& from, const std::string& to)
+{
+	return YSysUtility::MoveFileReplace(from, to);
+}
+
 bool YPath::DirectoryExists(const std::string& InPath)
 {
 	return 	YSysUtility::IsDirectoryExist(InPath);
@@ -99,7 +109,32 @@ bool YPath::IsRelative(const std::string& InPath)
 
 void YPath::NormalizeFilename(std::string& InPath)
 {
-
+	// a\\b/./c//d/../e ==> a/b/c/e
+	std::vector<std::string> segments;
+	const bool absolute = !InPath.empty() && separators.find(InPath[0]) != std::string::npos;
+	for (std::string& segment : GetFilePathsSeperate(InPath))
+	{
+		if (segment.empty() || segment == ".")
+		{
+			continue;
+		}
+		if (segment == ".." && !segments.empty() && segments.back() != "..")
+		{
+			segments.pop_back();
+			continue;
+		}
+		segments.push_back(segment);
+	}
+	std::string normalized = absolute ? std::string(1, directory_seperater) : std::string();
+	for (size_t i = 0; i < segments.size(); ++i)
+	{
+		if (i)
+		{
+			normalized += directory_seperater;
+		}
+		normalized += segments[i];
+	}
+	InPath = normalized;
 }
 
 std::string YPath::PathCombine(const std::string& a, const std::string& b)
@@ -0,0 +1,68 @@
+// Copyright 2007-2010 Baptiste Lepilleur and The JsonCpp Authors
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef JSON_ARENA_H_INCLUDED
+#define JSON_ARENA_H_INCLUDED
+
+#if !defined(JSON_IS_AMALGAMATION)
+#include "forwards.h"
+#endif // if !defined(JSON_IS_AMALGAMATION)
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#pragma pack(push, 8)
+
+namespace Json {
+
+/** \brief Monotonic memory for the values of one parsed document.
+ *
+ * Values created with an Arena take their member storage and strings from
+ * it, and the keys of their members are interned so every distinct key is
+ * stored once. Nothing is freed until the arena is destroyed, destroying the
+ * tree only walks it.
+ *
+ * The arena must outlive every value that uses it. Copying a value out of
+ * the tree makes a regular heap copy, moving or swapping it out does not.
+ * \code
+ * Json::Arena arena;
+ * Json::Value root;
+ * reader.parse(begin, end, root, arena);
+ * \endcode
+ */
+class JSON_API Arena {
+public:
+  explicit Arena(size_t initialSize = 64 * 1024);
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  std::pmr::memory_resource* resource() { return &resource_; }
+  void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    return resource_.allocate(size, alignment);
+  }
+  /// Null terminated copy of the key, the same pointer for equal keys.
+  const char* internKey(const char* begin, const char* end);
+  size_t keyCount() const { return keys_.size(); }
+  /// Keeps owner, typically the buffer of a document parsed in place, alive
+  /// until the arena is destroyed.
+  void keepAlive(std::shared_ptr<void> owner) {
+    owners_.push_back(std::move(owner));
+  }
+
+private:
+  std::pmr::monotonic_buffer_resource resource_;
+  // views into resource_
+  std::pmr::unordered_set<std::string_view> keys_;
+  std::vector<std::shared_ptr<void>> owners_;
+};
+
+} // namespace Json
+
+#pragma pack(pop)
+
+#endif // JSON_ARENA_H_INCLUDED
@@ -13,6 +13,22 @@
 #include <sstream>
 #include <string>
 #include <type_traits>
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+// Floating point std::from_chars/std::to_chars, correctly rounded and locale
+// independent. Missing from older standard libraries, strtod/snprintf are
+// used there.
+// Also read by code outside the library that formats numbers for the same
+// documents, so every writer takes the same path.
+#ifndef JSONCPP_HAS_FLOAT_CHARCONV
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define JSONCPP_HAS_FLOAT_CHARCONV 1
+#else
+#define JSONCPP_HAS_FLOAT_CHARCONV 0
+#endif
+#endif
 
 // If non-zero, the library uses exceptions to report bad input instead of C
 // assertion macros. The default is to use exceptions.
@@ -20,6 +36,12 @@
 #define JSON_USE_EXCEPTION 1
 #endif
 
+// If non-zero, Value::getMemberNames(), and so the writers, list object
+// members in insertion order instead of sorted by name.
+#ifndef JSON_USE_INSERTION_ORDER
+#define JSON_USE_INSERTION_ORDER 0
+#endif
+
 // Temporary, tracked for removal with issue #982.
 #ifndef JSON_USE_NULLREF
 #define JSON_USE_NULLREF 1
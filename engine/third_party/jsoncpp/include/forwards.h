@@ -28,6 +28,9 @@ class CharReaderBuilder;
 // json_features.h
 class Features;
 
+// arena.h
+class Arena;
+
 // value.h
 using ArrayIndex = unsigned int;
 class StaticString;
@@ -19,6 +19,9 @@
 #include <clocale>
 #endif
 
+#include <cstdlib>
+#include <cstring>
+
 /* This header provides common string manipulation support, such as UTF-8,
  * portable conversion from/to string...
  *
@@ -112,6 +115,38 @@ template <typename Iter> void fixNumericLocaleInput(Iter begin, Iter end) {
   }
 }
 
+/** Parse the JSON number [begin, end) as a double, false unless all of it is
+ * a number. Out of range values become +-infinity or +-0, as with strtod.
+ */
+static inline bool decodeDoubleValue(char const* begin, char const* end,
+                                     double& value) {
+  if (begin == end)
+    return false;
+#if JSONCPP_HAS_FLOAT_CHARCONV
+  const std::from_chars_result result = std::from_chars(begin, end, value);
+  if (result.ptr != end)
+    return false;
+  if (result.ec == std::errc())
+    return true;
+  // out of range, strtod below tells overflow from underflow
+#endif
+  char buffer[64];
+  String longBuffer;
+  char* text = buffer;
+  const size_t length = static_cast<size_t>(end - begin);
+  if (length < sizeof(buffer)) {
+    memcpy(buffer, begin, length);
+    buffer[length] = 0;
+  } else {
+    longBuffer.assign(begin, end);
+    text = &longBuffer[0];
+  }
+  fixNumericLocaleInput(text, text + length);
+  char* parsedEnd = nullptr;
+  value = std::strtod(text, &parsedEnd);
+  return parsedEnd == text + length;
+}
+
 /**
  * Return iterator that would be the new end of the range [begin,end), if we
  * were to delete zeros in the end of string, but not the last zero before '.'.
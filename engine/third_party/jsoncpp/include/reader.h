@@ -95,6 +95,23 @@ public:
   bool parse(const char* beginDoc, const char* endDoc, Value& root,
              bool collectComments = true);
 
+  /** \brief Same as parse() above, the arrays, objects and strings of the
+   * document are allocated from \p arena, which must outlive \p root.
+   * \see Arena
+   */
+  bool parse(const char* beginDoc, const char* endDoc, Value& root,
+             Arena& arena, bool collectComments = true);
+
+  /** \brief Same as parse() with an arena, strings without escape sequence
+   * are not copied but stay in the document as InSituString values.
+   *
+   * The closing quote of those strings is overwritten with a null character,
+   * the document must stay alive and unchanged as long as \p root, see
+   * Arena::keepAlive(). Escaped strings are decoded into \p arena.
+   */
+  bool parseInSitu(char* beginDoc, char* endDoc, Value& root, Arena& arena,
+                   bool collectComments = true);
+
   /// \brief Parse from input stream.
   /// \see Json::operator>>(std::istream&, Json::Value&).
   bool parse(IStream& is, Value& root, bool collectComments = true);
@@ -237,6 +254,8 @@ private:
   String commentsBefore_;
   Features features_;
   bool collectComments_{};
+  Arena* arena_{};
+  bool inSitu_{};
 }; // Reader
 
 /** Interface for reading JSON from a char array.
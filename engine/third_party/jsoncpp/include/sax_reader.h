@@ -0,0 +1,128 @@
+// Copyright 2007-2010 Baptiste Lepilleur and The JsonCpp Authors
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#ifndef JSON_SAX_READER_H_INCLUDED
+#define JSON_SAX_READER_H_INCLUDED
+
+#if !defined(JSON_IS_AMALGAMATION)
+#include "json_features.h"
+#include "value.h"
+#endif // if !defined(JSON_IS_AMALGAMATION)
+#include <string>
+#include <vector>
+
+#pragma pack(push, 8)
+
+namespace Json {
+
+/** \brief Receives the events of a SaxReader in document order.
+ *
+ * Strings and keys are passed as [begin, end) ranges that are only valid
+ * during the call. They point into the document when the string has no
+ * escape sequence. Returning \c false from any callback stops parsing and
+ * SaxReader::parse() returns \c false.
+ */
+class JSON_API SaxHandler {
+public:
+  virtual ~SaxHandler();
+  virtual bool onNull() = 0;
+  virtual bool onBool(bool value) = 0;
+  virtual bool onInt(LargestInt value) = 0;
+  virtual bool onUInt(LargestUInt value) = 0;
+  virtual bool onDouble(double value) = 0;
+  virtual bool onString(const char* begin, const char* end) = 0;
+  /// Strings without escape sequence in SaxReader::parseInSitu(), null
+  /// terminated at \p end inside the document. Forwards to onString().
+  virtual bool onInSituString(const char* begin, const char* end);
+  virtual bool onObjectBegin() = 0;
+  virtual bool onKey(const char* begin, const char* end) = 0;
+  virtual bool onObjectEnd() = 0;
+  virtual bool onArrayBegin() = 0;
+  virtual bool onArrayEnd() = 0;
+};
+
+/** \brief SaxHandler that builds a Value from the events, for the parts of a
+ * streamed document that still need a DOM.
+ *
+ * Numbers get the same type as with Reader: integers that fit in an Int are
+ * stored as Int, larger ones as UInt64/Int64. With an arena, arrays, objects
+ * and strings are allocated from it as with Reader::parse().
+ */
+class JSON_API SaxValueBuilder : public SaxHandler {
+public:
+  explicit SaxValueBuilder(Value& root, Arena* arena = nullptr);
+  bool onNull() override;
+  bool onBool(bool value) override;
+  bool onInt(LargestInt value) override;
+  bool onUInt(LargestUInt value) override;
+  bool onDouble(double value) override;
+  bool onString(const char* begin, const char* end) override;
+  /// kept in the document as an InSituString
+  bool onInSituString(const char* begin, const char* end) override;
+  bool onObjectBegin() override;
+  bool onKey(const char* begin, const char* end) override;
+  bool onObjectEnd() override;
+  bool onArrayBegin() override;
+  bool onArrayEnd() override;
+  /// \c true once the root value is complete
+  bool isComplete() const { return complete_; }
+
+private:
+  Value& nextValue();
+  Value& root_;
+  Arena* arena_;
+  std::vector<Value*> stack_;
+  String key_;
+  bool complete_{false};
+};
+
+/** \brief One pass event driven reader, the document is never materialized.
+ *
+ * Accepts the same documents as Reader with the given Features except
+ * allowDroppedNullPlaceholders_ and allowNumericKeys_, comments are skipped.
+ * Text after the root value and a lone '-' are errors, Reader lets them pass.
+ */
+class JSON_API SaxReader {
+public:
+  SaxReader();
+  explicit SaxReader(const Features& features);
+
+  bool parse(const char* beginDoc, const char* endDoc, SaxHandler& handler);
+  /// Strings without escape sequence go to SaxHandler::onInSituString(), the
+  /// closing quote of each one is overwritten with a null character.
+  bool parseInSitu(char* beginDoc, char* endDoc, SaxHandler& handler);
+
+  /// empty if the last parse succeeded or was stopped by the handler
+  String getFormattedErrorMessages() const;
+  /// byte offset of the error in the document
+  ptrdiff_t getErrorOffset() const { return errorOffset_; }
+
+private:
+  bool readValue(SaxHandler& handler, int depth);
+  bool readObject(SaxHandler& handler, int depth);
+  bool readArray(SaxHandler& handler, int depth);
+  bool readString(const char*& begin, const char*& end);
+  bool readNumber(SaxHandler& handler);
+  bool readLiteral(const char* literal);
+  void skipSpaces();
+  bool skipComment();
+  bool addError(const char* message);
+
+  Features features_;
+  const char* begin_{nullptr};
+  const char* end_{nullptr};
+  const char* current_{nullptr};
+  String scratch_;
+  String error_;
+  ptrdiff_t errorOffset_{0};
+  bool stopped_{false};
+  bool inSitu_{false};
+};
+
+} // namespace Json
+
+#pragma pack(pop)
+
+#endif // JSON_SAX_READER_H_INCLUDED
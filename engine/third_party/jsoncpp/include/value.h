@@ -7,6 +7,7 @@
 #define JSON_H_INCLUDED
 
 #if !defined(JSON_IS_AMALGAMATION)
+#include "arena.h"
 #include "forwards.h"
 #endif // if !defined(JSON_IS_AMALGAMATION)
 
@@ -43,6 +44,7 @@
 #include <exception>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -156,6 +158,25 @@ private:
   const char* c_str_;
 };
 
+/** \brief Null terminated string inside a document parsed in place, see
+ * Reader::parseInSitu().
+ *
+ * Like StaticString the string is not duplicated, unlike StaticString a
+ * copy of the Value duplicates it, so only the values left in the document
+ * refer to the document buffer.
+ */
+class JSON_API InSituString {
+public:
+  explicit InSituString(const char* czstring) : c_str_(czstring) {}
+
+  operator const char*() const { return c_str_; }
+
+  const char* c_str() const { return c_str_; }
+
+private:
+  const char* c_str_;
+};
+
 /** \brief Represents a <a HREF="http://www.json.org">JSON</a> value.
  *
  * This class is a discriminated union wrapper that can represents a:
@@ -292,7 +313,7 @@ private:
   };
 
 public:
-  typedef std::map<CZString, Value> ObjectValues;
+  class ObjectValues;
 #endif // ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
 
 public:
@@ -322,6 +343,11 @@ public:
   Value(double value);
   Value(const char* value); ///< Copy til first 0. (NULL causes to seg-fault.)
   Value(const char* begin, const char* end); ///< Copy all, incl zeroes.
+  /// Array or object whose members live in arena, see Arena. A null arena
+  /// is the same as Value(type).
+  Value(ValueType type, Arena* arena);
+  /// Copy all, incl zeroes, into arena unless it is null.
+  Value(const char* begin, const char* end, Arena* arena);
   /**
    * \brief Constructs a value from a static string.
    *
@@ -340,6 +366,7 @@ public:
    *   \endcode
    */
   Value(const StaticString& value);
+  Value(const InSituString& value);
   Value(const String& value);
   Value(bool value);
   Value(std::nullptr_t ptr) = delete;
@@ -559,6 +586,8 @@ public:
   /// If null, return an empty list.
   /// \pre type() is objectValue or nullValue
   /// \post if type() was nullValue, it remains nullValue
+  /// Sorted by name unless JSON_USE_INSERTION_ORDER is set, the writers
+  /// output the members in this order.
   Members getMemberNames() const;
 
   /// \deprecated Always pass len.
@@ -578,6 +607,7 @@ public:
 
   String toStyledString() const;
 
+  /// Object members are visited in insertion order, array elements by index.
   const_iterator begin() const;
   const_iterator end() const;
 
@@ -597,6 +627,8 @@ private:
   }
   bool isAllocated() const { return bits_.allocated_; }
   void setIsAllocated(bool v) { bits_.allocated_ = v; }
+  bool isInArena() const { return bits_.arena_; }
+  void setIsInArena(bool v) { bits_.arena_ = v; }
 
   void initBasic(ValueType type, bool allocated = false);
   void dupPayload(const Value& other);
@@ -629,6 +661,9 @@ private:
     unsigned int value_type_ : 8;
     // Unless allocated_, string_ must be null-terminated.
     unsigned int allocated_ : 1;
+    // string_ or map_ is owned by an Arena or, for a string that is not
+    // allocated_, the document buffer. It is not freed, copies duplicate it.
+    unsigned int arena_ : 1;
   } bits_;
 
   class Comments {
@@ -654,6 +689,71 @@ private:
   ptrdiff_t limit_;
 };
 
+#ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
+/** \brief Members of an arrayValue or objectValue.
+ *
+ * The members live in one flat vector. Object keys are kept in insertion
+ * order and looked up linearly while the object is small, past
+ * hashThreshold members an open addressing index over the vector is kept.
+ * Array indexes are kept sorted, a dense array is indexed directly.
+ * With an Arena the members are allocated from it and keys are interned.
+ *
+ * Unlike std::map, inserting or erasing a member invalidates iterators and
+ * references to the other members of the same container.
+ */
+class JSON_API Value::ObjectValues {
+public:
+  using value_type = std::pair<CZString, Value>;
+  using Entries = std::pmr::vector<value_type>;
+  using iterator = Entries::iterator;
+  using const_iterator = Entries::const_iterator;
+  static constexpr size_t hashThreshold = 8;
+
+  explicit ObjectValues(Arena* arena = nullptr);
+  /// The copy is on the heap, whatever other was allocated from.
+  ObjectValues(const ObjectValues& other);
+  ObjectValues& operator=(const ObjectValues& other) = delete;
+
+  Arena* arena() const { return arena_; }
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.empty(); }
+  void clear();
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+
+  iterator find(const CZString& key);
+  const_iterator find(const CZString& key) const;
+  /// Inserts a copy of key with \c value unless the key is present, the
+  /// member with that key is returned either way.
+  std::pair<iterator, bool> emplace(const CZString& key, Value&& value);
+  iterator erase(const_iterator it);
+  size_t erase(const CZString& key);
+
+  /// Same members with equal values, in any order.
+  bool operator==(const ObjectValues& other) const;
+  /// Compares the members ordered by key, as std::map did.
+  bool operator<(const ObjectValues& other) const;
+
+private:
+  struct Slot {
+    unsigned hash;
+    unsigned entry; // index in entries_ + 1, 0 marks an empty slot
+  };
+  size_t findEntry(const CZString& key) const;
+  void insertSlot(unsigned hash, size_t entry);
+  void rebuildSlots();
+
+  Entries entries_;
+  // empty while the container holds array indexes or few keys
+  std::pmr::vector<Slot> slots_;
+  Arena* arena_;
+};
+#endif // ifndef JSONCPP_DOC_EXCLUDE_IMPLEMENTATION
+
 template <> inline bool Value::as<bool>() const { return asBool(); }
 template <> inline bool Value::is<bool>() const { return isBool(); }
 
@@ -107,7 +107,8 @@ public:
    *    NaN values as "NaN", positive infinity as "Infinity", and negative
    *  infinity as "-Infinity".
    *  - "precision": int
-   *  - Number of precision digits for formatting of real values.
+   *  - Number of precision digits for formatting of real values. The default
+   *    17 writes the shortest text that reads back to the same value.
    *  - "precisionType": "significant"(default) or "decimal"
    *  - Type of precision for formatting of real values.
    *  - "emitUTF8": false or true
@@ -348,6 +349,8 @@ String JSON_API valueToString(UInt value);
 #endif // if defined(JSON_HAS_INT64)
 String JSON_API valueToString(LargestInt value);
 String JSON_API valueToString(LargestUInt value);
+/// With the default precision the shortest text that reads back to the same
+/// double is written, where std::to_chars supports it.
 String JSON_API valueToString(
     double value, unsigned int precision = Value::defaultRealPrecision,
     PrecisionType precisionType = PrecisionType::significantDigits);
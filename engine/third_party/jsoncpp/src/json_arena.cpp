@@ -0,0 +1,27 @@
+// Copyright 2007-2010 Baptiste Lepilleur and The JsonCpp Authors
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#if !defined(JSON_IS_AMALGAMATION)
+#include <arena.h>
+#endif // if !defined(JSON_IS_AMALGAMATION)
+#include <cstring>
+
+namespace Json {
+
+Arena::Arena(size_t initialSize) : resource_(initialSize), keys_(&resource_) {}
+
+const char* Arena::internKey(const char* begin, const char* end) {
+  const std::string_view key(begin, static_cast<size_t>(end - begin));
+  auto found = keys_.find(key);
+  if (found != keys_.end())
+    return found->data();
+  char* copy = static_cast<char*>(resource_.allocate(key.size() + 1, 1));
+  memcpy(copy, key.data(), key.size());
+  copy[key.size()] = 0;
+  keys_.insert(std::string_view(copy, key.size()));
+  return copy;
+}
+
+} // namespace Json
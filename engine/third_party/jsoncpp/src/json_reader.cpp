@@ -109,6 +109,22 @@ bool Reader::parse(std::istream& is, Value& root, bool collectComments) {
   return parse(doc.data(), doc.data() + doc.size(), root, collectComments);
 }
 
+bool Reader::parse(const char* beginDoc, const char* endDoc, Value& root,
+                   Arena& arena, bool collectComments) {
+  arena_ = &arena;
+  bool successful = parse(beginDoc, endDoc, root, collectComments);
+  arena_ = nullptr;
+  return successful;
+}
+
+bool Reader::parseInSitu(char* beginDoc, char* endDoc, Value& root,
+                         Arena& arena, bool collectComments) {
+  inSitu_ = true;
+  bool successful = parse(beginDoc, endDoc, root, arena, collectComments);
+  inSitu_ = false;
+  return successful;
+}
+
 bool Reader::parse(const char* beginDoc, const char* endDoc, Value& root,
                    bool collectComments) {
   if (!features_.allowComments_) {
@@ -443,7 +459,7 @@ bool Reader::readString() {
 bool Reader::readObject(Token& token) {
   Token tokenName;
   String name;
-  Value init(objectValue);
+  Value init(objectValue, arena_);
   currentValue().swapPayload(init);
   currentValue().setOffsetStart(token.start_ - begin_);
   while (readToken(tokenName)) {
@@ -497,7 +513,7 @@ bool Reader::readObject(Token& token) {
 }
 
 bool Reader::readArray(Token& token) {
-  Value init(arrayValue);
+  Value init(arrayValue, arena_);
   currentValue().swapPayload(init);
   currentValue().setOffsetStart(token.start_ - begin_);
   skipSpaces();
@@ -599,26 +615,32 @@ bool Reader::decodeDouble(Token& token) {
 
 bool Reader::decodeDouble(Token& token, Value& decoded) {
   double value = 0;
-  String buffer(token.start_, token.end_);
-  IStringStream is(buffer);
-  if (!(is >> value)) {
-    if (value == std::numeric_limits<double>::max())
-      value = std::numeric_limits<double>::infinity();
-    else if (value == std::numeric_limits<double>::lowest())
-      value = -std::numeric_limits<double>::infinity();
-    else if (!std::isinf(value))
-      return addError(
+  if (!decodeDoubleValue(token.start_, token.end_, value))
+    return addError(
         "'" + String(token.start_, token.end_) + "' is not a number.", token);
-  }
   decoded = value;
   return true;
 }
 
 bool Reader::decodeString(Token& token) {
+  const char* stringBegin = token.start_ + 1;
+  const char* stringEnd = token.end_ - 1;
+  const auto length = static_cast<size_t>(stringEnd - stringBegin);
+  if (inSitu_ && !memchr(stringBegin, '\\', length) &&
+      !memchr(stringBegin, 0, length)) {
+    // the closing quote becomes the terminator, the document is writable
+    *const_cast<char*>(stringEnd) = 0;
+    Value decoded(InSituString{stringBegin});
+    currentValue().swapPayload(decoded);
+    currentValue().setOffsetStart(token.start_ - begin_);
+    currentValue().setOffsetLimit(token.end_ - begin_);
+    return true;
+  }
   String decoded_string;
   if (!decodeString(token, decoded_string))
     return false;
-  Value decoded(decoded_string);
+  Value decoded(decoded_string.data(),
+                decoded_string.data() + decoded_string.length(), arena_);
   currentValue().swapPayload(decoded);
   currentValue().setOffsetStart(token.start_ - begin_);
   currentValue().setOffsetLimit(token.end_ - begin_);
@@ -1651,17 +1673,9 @@ bool OurReader::decodeDouble(Token& token) {
 
 bool OurReader::decodeDouble(Token& token, Value& decoded) {
   double value = 0;
-  const String buffer(token.start_, token.end_);
-  IStringStream is(buffer);
-  if (!(is >> value)) {
-    if (value == std::numeric_limits<double>::max())
-      value = std::numeric_limits<double>::infinity();
-    else if (value == std::numeric_limits<double>::lowest())
-      value = -std::numeric_limits<double>::infinity();
-    else if (!std::isinf(value))
-      return addError(
+  if (!decodeDoubleValue(token.start_, token.end_, value))
+    return addError(
         "'" + String(token.start_, token.end_) + "' is not a number.", token);
-  }
   decoded = value;
   return true;
 }
@@ -0,0 +1,535 @@
+// Copyright 2007-2011 Baptiste Lepilleur and The JsonCpp Authors
+// Distributed under MIT license, or public domain if desired and
+// recognized in your jurisdiction.
+// See file LICENSE for detail or copy at http://jsoncpp.sourceforge.net/LICENSE
+
+#if !defined(JSON_IS_AMALGAMATION)
+#include "json_tool.h"
+#include <sax_reader.h>
+#endif // if !defined(JSON_IS_AMALGAMATION)
+#include <cstdlib>
+#include <cstring>
+
+// same nesting limit as Reader, the reader recurses once per level
+#if !defined(JSONCPP_DEPRECATED_STACK_LIMIT)
+#define JSONCPP_DEPRECATED_STACK_LIMIT 1000
+#endif
+
+namespace Json {
+
+static int const saxStackLimit_g = JSONCPP_DEPRECATED_STACK_LIMIT;
+
+// Implementation of class SaxHandler
+// ////////////////////////////////
+
+SaxHandler::~SaxHandler() = default;
+
+// Implementation of class SaxValueBuilder
+// ////////////////////////////////
+
+bool SaxHandler::onInSituString(const char* begin, const char* end) {
+  return onString(begin, end);
+}
+
+SaxValueBuilder::SaxValueBuilder(Value& root, Arena* arena)
+    : root_(root), arena_(arena) {}
+
+Value& SaxValueBuilder::nextValue() {
+  if (stack_.empty())
+    return root_;
+  Value& parent = *stack_.back();
+  if (parent.isArray())
+    return parent.append(Value());
+  return parent[key_];
+}
+
+bool SaxValueBuilder::onNull() {
+  nextValue() = Value();
+  complete_ = stack_.empty();
+  return true;
+}
+
+bool SaxValueBuilder::onBool(bool value) {
+  nextValue() = value;
+  complete_ = stack_.empty();
+  return true;
+}
+
+bool SaxValueBuilder::onInt(LargestInt value) {
+  nextValue() = value;
+  complete_ = stack_.empty();
+  return true;
+}
+
+bool SaxValueBuilder::onUInt(LargestUInt value) {
+  nextValue() = value;
+  complete_ = stack_.empty();
+  return true;
+}
+
+bool SaxValueBuilder::onDouble(double value) {
+  nextValue() = value;
+  complete_ = stack_.empty();
+  return true;
+}
+
+bool SaxValueBuilder::onString(const char* begin, const char* end) {
+  nextValue() = Value(begin, end, arena_);
+  complete_ = stack_.empty();
+  return true;
+}
+
+bool SaxValueBuilder::onInSituString(const char* begin, const char* end) {
+  // an embedded null would cut the string short
+  if (memchr(begin, 0, static_cast<size_t>(end - begin)))
+    return onString(begin, end);
+  nextValue() = Value(InSituString{begin});
+  complete_ = stack_.empty();
+  return true;
+}
+
+bool SaxValueBuilder::onObjectBegin() {
+  Value& value = nextValue();
+  value = Value(objectValue, arena_);
+  stack_.push_back(&value);
+  return true;
+}
+
+bool SaxValueBuilder::onKey(const char* begin, const char* end) {
+  key_.assign(begin, end);
+  return true;
+}
+
+bool SaxValueBuilder::onObjectEnd() {
+  stack_.pop_back();
+  complete_ = stack_.empty();
+  return true;
+}
+
+bool SaxValueBuilder::onArrayBegin() {
+  Value& value = nextValue();
+  value = Value(arrayValue, arena_);
+  stack_.push_back(&value);
+  return true;
+}
+
+bool SaxValueBuilder::onArrayEnd() {
+  stack_.pop_back();
+  complete_ = stack_.empty();
+  return true;
+}
+
+// Implementation of class SaxReader
+// ////////////////////////////////
+
+SaxReader::SaxReader() : features_(Features::all()) {}
+
+SaxReader::SaxReader(const Features& features) : features_(features) {}
+
+bool SaxReader::parseInSitu(char* beginDoc, char* endDoc,
+                            SaxHandler& handler) {
+  inSitu_ = true;
+  bool ok = parse(beginDoc, endDoc, handler);
+  inSitu_ = false;
+  return ok;
+}
+
+bool SaxReader::parse(const char* beginDoc, const char* endDoc,
+                      SaxHandler& handler) {
+  begin_ = beginDoc;
+  end_ = endDoc;
+  current_ = beginDoc;
+  error_.clear();
+  errorOffset_ = 0;
+  stopped_ = false;
+  skipSpaces();
+  if (features_.strictRoot_ && current_ != end_ && *current_ != '{' &&
+      *current_ != '[')
+    return addError(
+        "A valid JSON document must be either an array or an object value.");
+  if (!readValue(handler, 0))
+    return false;
+  skipSpaces();
+  if (current_ != end_)
+    return addError("Extra non-whitespace after JSON value.");
+  return true;
+}
+
+String SaxReader::getFormattedErrorMessages() const {
+  if (error_.empty())
+    return error_;
+  // line and column like Reader
+  int line = 1;
+  const char* lineStart = begin_;
+  for (const char* c = begin_; c < begin_ + errorOffset_; ++c) {
+    if (*c == '\n') {
+      ++line;
+      lineStart = c + 1;
+    }
+  }
+  return "* Line " + std::to_string(line) + ", Column " +
+         std::to_string(begin_ + errorOffset_ - lineStart + 1) + "\n  " +
+         error_ + "\n";
+}
+
+bool SaxReader::addError(const char* message) {
+  if (!stopped_ && error_.empty()) {
+    error_ = message;
+    errorOffset_ = current_ - begin_;
+  }
+  return false;
+}
+
+void SaxReader::skipSpaces() {
+  while (current_ != end_) {
+    char c = *current_;
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+      ++current_;
+    else if (c == '/' && features_.allowComments_) {
+      if (!skipComment())
+        return;
+    } else
+      return;
+  }
+}
+
+bool SaxReader::skipComment() {
+  if (end_ - current_ < 2)
+    return false;
+  if (current_[1] == '/') {
+    current_ += 2;
+    while (current_ != end_ && *current_ != '\n' && *current_ != '\r')
+      ++current_;
+    return true;
+  }
+  if (current_[1] == '*') {
+    const char* commentEnd = current_ + 2;
+    while (end_ - commentEnd >= 2 &&
+           !(commentEnd[0] == '*' && commentEnd[1] == '/'))
+      ++commentEnd;
+    if (end_ - commentEnd < 2)
+      return false;
+    current_ = commentEnd + 2;
+    return true;
+  }
+  return false;
+}
+
+bool SaxReader::readValue(SaxHandler& handler, int depth) {
+  if (depth > saxStackLimit_g)
+    return addError("Exceeded stackLimit in readValue().");
+  skipSpaces();
+  if (current_ == end_)
+    return addError("Syntax error: value, object or array expected.");
+  bool ok = true;
+  switch (*current_) {
+  case '{':
+    return readObject(handler, depth);
+  case '[':
+    return readArray(handler, depth);
+  case '"': {
+    const char* stringBegin;
+    const char* stringEnd;
+    if (!readString(stringBegin, stringEnd))
+      return false;
+    // escaped strings are decoded into scratch_, the others are in the
+    // document with the closing quote at stringEnd
+    if (inSitu_ && stringBegin != scratch_.data()) {
+      *const_cast<char*>(stringEnd) = 0;
+      ok = handler.onInSituString(stringBegin, stringEnd);
+    } else {
+      ok = handler.onString(stringBegin, stringEnd);
+    }
+  } break;
+  case 't':
+    if (!readLiteral("true"))
+      return false;
+    ok = handler.onBool(true);
+    break;
+  case 'f':
+    if (!readLiteral("false"))
+      return false;
+    ok = handler.onBool(false);
+    break;
+  case 'n':
+    if (!readLiteral("null"))
+      return false;
+    ok = handler.onNull();
+    break;
+  default:
+    return readNumber(handler);
+  }
+  if (!ok)
+    stopped_ = true;
+  return ok;
+}
+
+bool SaxReader::readObject(SaxHandler& handler, int depth) {
+  ++current_; // '{'
+  if (!handler.onObjectBegin()) {
+    stopped_ = true;
+    return false;
+  }
+  skipSpaces();
+  if (current_ != end_ && *current_ == '}') {
+    ++current_;
+    if (!handler.onObjectEnd()) {
+      stopped_ = true;
+      return false;
+    }
+    return true;
+  }
+  while (true) {
+    skipSpaces();
+    if (current_ == end_ || *current_ != '"')
+      return addError("Missing '}' or object member name");
+    const char* keyBegin;
+    const char* keyEnd;
+    if (!readString(keyBegin, keyEnd))
+      return false;
+    if (!handler.onKey(keyBegin, keyEnd)) {
+      stopped_ = true;
+      return false;
+    }
+    skipSpaces();
+    if (current_ == end_ || *current_ != ':')
+      return addError("Missing ':' after object member name");
+    ++current_;
+    if (!readValue(handler, depth + 1))
+      return false;
+    skipSpaces();
+    if (current_ == end_)
+      return addError("Missing ',' or '}' in object declaration");
+    if (*current_ == '}') {
+      ++current_;
+      if (!handler.onObjectEnd()) {
+        stopped_ = true;
+        return false;
+      }
+      return true;
+    }
+    if (*current_ != ',')
+      return addError("Missing ',' or '}' in object declaration");
+    ++current_;
+  }
+}
+
+bool SaxReader::readArray(SaxHandler& handler, int depth) {
+  ++current_; // '['
+  if (!handler.onArrayBegin()) {
+    stopped_ = true;
+    return false;
+  }
+  skipSpaces();
+  if (current_ != end_ && *current_ == ']') {
+    ++current_;
+    if (!handler.onArrayEnd()) {
+      stopped_ = true;
+      return false;
+    }
+    return true;
+  }
+  while (true) {
+    if (!readValue(handler, depth + 1))
+      return false;
+    skipSpaces();
+    if (current_ == end_)
+      return addError("Missing ',' or ']' in array declaration");
+    if (*current_ == ']') {
+      ++current_;
+      if (!handler.onArrayEnd()) {
+        stopped_ = true;
+        return false;
+      }
+      return true;
+    }
+    if (*current_ != ',')
+      return addError("Missing ',' or ']' in array declaration");
+    ++current_;
+  }
+}
+
+bool SaxReader::readLiteral(const char* literal) {
+  size_t length = strlen(literal);
+  if ((size_t)(end_ - current_) < length ||
+      memcmp(current_, literal, length) != 0)
+    return addError("Syntax error: value, object or array expected.");
+  current_ += length;
+  return true;
+}
+
+static bool decodeHex4(const char*& current, const char* end,
+                       unsigned int& unicode) {
+  if (end - current < 4)
+    return false;
+  unicode = 0;
+  for (int index = 0; index < 4; ++index) {
+    char c = *current++;
+    unicode *= 16;
+    if (c >= '0' && c <= '9')
+      unicode += c - '0';
+    else if (c >= 'a' && c <= 'f')
+      unicode += c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F')
+      unicode += c - 'A' + 10;
+    else
+      return false;
+  }
+  return true;
+}
+
+bool SaxReader::readString(const char*& begin, const char*& end) {
+  ++current_; // '"'
+  const char* stringBegin = current_;
+  // fast path, no escape: the range points into the document
+  while (current_ != end_ && *current_ != '"' && *current_ != '\\')
+    ++current_;
+  if (current_ == end_)
+    return addError("Missing '\"' at the end of a string");
+  if (*current_ == '"') {
+    begin = stringBegin;
+    end = current_;
+    ++current_;
+    return true;
+  }
+  scratch_.assign(stringBegin, current_);
+  while (current_ != end_ && *current_ != '"') {
+    char c = *current_++;
+    if (c != '\\') {
+      scratch_ += c;
+      continue;
+    }
+    if (current_ == end_)
+      return addError("Empty escape sequence in string");
+    char escape = *current_++;
+    switch (escape) {
+    case '"':
+      scratch_ += '"';
+      break;
+    case '/':
+      scratch_ += '/';
+      break;
+    case '\\':
+      scratch_ += '\\';
+      break;
+    case 'b':
+      scratch_ += '\b';
+      break;
+    case 'f':
+      scratch_ += '\f';
+      break;
+    case 'n':
+      scratch_ += '\n';
+      break;
+    case 'r':
+      scratch_ += '\r';
+      break;
+    case 't':
+      scratch_ += '\t';
+      break;
+    case 'u': {
+      unsigned int unicode;
+      if (!decodeHex4(current_, end_, unicode))
+        return addError(
+            "Bad unicode escape sequence in string: four digits expected.");
+      if (unicode >= 0xD800 && unicode <= 0xDBFF) {
+        // surrogate pairs
+        unsigned int surrogatePair;
+        if (end_ - current_ < 6 || current_[0] != '\\' || current_[1] != 'u')
+          return addError("expecting another \\u token to begin the second "
+                          "half of a unicode surrogate pair");
+        current_ += 2;
+        if (!decodeHex4(current_, end_, surrogatePair))
+          return addError(
+              "Bad unicode escape sequence in string: four digits expected.");
+        unicode = 0x10000 + ((unicode & 0x3FF) << 10) + (surrogatePair & 0x3FF);
+      }
+      scratch_ += codePointToUTF8(unicode);
+    } break;
+    default:
+      return addError("Bad escape sequence in string");
+    }
+  }
+  if (current_ == end_)
+    return addError("Missing '\"' at the end of a string");
+  ++current_;
+  begin = scratch_.data();
+  end = scratch_.data() + scratch_.size();
+  return true;
+}
+
+bool SaxReader::readNumber(SaxHandler& handler) {
+  const char* numberBegin = current_;
+  if (current_ != end_ && *current_ == '-')
+    ++current_;
+  bool isInteger = true;
+  // same token rule as Reader::readNumber
+  while (current_ != end_ && *current_ >= '0' && *current_ <= '9')
+    ++current_;
+  if (current_ != end_ && *current_ == '.') {
+    isInteger = false;
+    ++current_;
+    while (current_ != end_ && *current_ >= '0' && *current_ <= '9')
+      ++current_;
+  }
+  if (current_ != end_ && (*current_ == 'e' || *current_ == 'E')) {
+    isInteger = false;
+    ++current_;
+    if (current_ != end_ && (*current_ == '+' || *current_ == '-'))
+      ++current_;
+    while (current_ != end_ && *current_ >= '0' && *current_ <= '9')
+      ++current_;
+  }
+  const char* numberEnd = current_;
+  const bool isNegative = *numberBegin == '-';
+  const char* digits = numberBegin + (isNegative ? 1 : 0);
+  if (digits == numberEnd || *digits < '0' || *digits > '9') {
+    current_ = numberBegin;
+    return addError("Syntax error: value, object or array expected.");
+  }
+
+  bool ok;
+  if (isInteger) {
+    // Reader::decodeNumber, falls back to double on overflow
+    LargestUInt maxIntegerValue =
+        isNegative ? LargestUInt(Value::maxLargestInt) + 1
+                   : Value::maxLargestUInt;
+    LargestUInt threshold = maxIntegerValue / 10;
+    LargestUInt value = 0;
+    for (const char* c = digits; c != numberEnd; ++c) {
+      auto digit = static_cast<unsigned int>(*c - '0');
+      if (value >= threshold &&
+          (value > threshold || c + 1 != numberEnd ||
+           digit > maxIntegerValue % 10)) {
+        isInteger = false;
+        break;
+      }
+      value = value * 10 + digit;
+    }
+    if (isInteger) {
+      if (isNegative && value == maxIntegerValue)
+        ok = handler.onInt(Value::minLargestInt);
+      else if (isNegative)
+        ok = handler.onInt(-LargestInt(value));
+      else if (value <= LargestUInt(Value::maxInt))
+        ok = handler.onInt(LargestInt(value));
+      else
+        ok = handler.onUInt(value);
+      if (!ok)
+        stopped_ = true;
+      return ok;
+    }
+  }
+  // out of range values become +-infinity as in Reader
+  double value = 0;
+  if (!decodeDoubleValue(numberBegin, numberEnd, value)) {
+    current_ = numberBegin;
+    return addError("Syntax error: value, object or array expected.");
+  }
+  ok = handler.onDouble(value);
+  if (!ok)
+    stopped_ = true;
+  return ok;
+}
+
+} // namespace Json
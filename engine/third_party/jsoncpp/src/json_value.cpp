@@ -14,7 +14,9 @@
 #include <cstddef>
 #include <cstring>
 #include <iostream>
+#include <new>
 #include <sstream>
+#include <tuple>
 #include <utility>
 
 // Provide implementation equivalent of std::snprintf for older _MSC compilers
@@ -150,6 +152,21 @@ static inline char* duplicateAndPrefixStringValue(const char* value,
       0; // to avoid buffer over-run accidents by users later
   return newString;
 }
+// Same layout as duplicateAndPrefixStringValue(), released with the arena.
+static inline char* arenaPrefixedStringValue(Arena& arena, const char* value,
+                                             unsigned int length) {
+  JSON_ASSERT_MESSAGE(length <= static_cast<unsigned>(Value::maxInt) -
+                                    sizeof(unsigned) - 1U,
+                      "in Json::Value::arenaPrefixedStringValue(): "
+                      "length too big for prefixing");
+  size_t actualLength = sizeof(length) + length + 1;
+  auto newString =
+      static_cast<char*>(arena.allocate(actualLength, alignof(unsigned)));
+  *reinterpret_cast<unsigned*>(newString) = length;
+  memcpy(newString + sizeof(unsigned), value, length);
+  newString[actualLength - 1U] = 0;
+  return newString;
+}
 inline static void decodePrefixedString(bool isPrefixed, char const* prefixed,
                                         unsigned* length, char const** value) {
   if (!isPrefixed) {
@@ -286,9 +303,9 @@ Value::CZString& Value::CZString::operator=(const CZString& other) {
 }
 
 Value::CZString& Value::CZString::operator=(CZString&& other) noexcept {
-  cstr_ = other.cstr_;
-  index_ = other.index_;
-  other.cstr_ = nullptr;
+  // swapped so an owned key that is overwritten, as when ObjectValues shifts
+  // its members, is released by other
+  swap(other);
   return *this;
 }
 
@@ -332,6 +349,200 @@ bool Value::CZString::isStaticString() const {
   return storage_.policy_ == noDuplication;
 }
 
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// class Value::ObjectValues
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+// multiplicative, four bytes per step, member names are short
+static unsigned hashMemberName(char const* str, unsigned length) {
+  unsigned hash = length * 0x9E3779B1U;
+  for (; length >= 4; str += 4, length -= 4) {
+    unsigned word;
+    memcpy(&word, str, 4);
+    hash = ((hash ^ word) * 0x9E3779B1U) ^ (hash >> 15);
+  }
+  for (; length > 0; ++str, --length)
+    hash = (hash ^ static_cast<unsigned char>(*str)) * 0x01000193U;
+  return hash ^ (hash >> 16);
+}
+
+Value::ObjectValues::ObjectValues(Arena* arena)
+    : entries_(arena ? arena->resource() : std::pmr::get_default_resource()),
+      slots_(entries_.get_allocator()), arena_(arena) {}
+
+Value::ObjectValues::ObjectValues(const ObjectValues& other)
+    : entries_(other.entries_, std::pmr::get_default_resource()),
+      slots_(other.slots_, std::pmr::get_default_resource()), arena_(nullptr) {}
+
+void Value::ObjectValues::clear() {
+  entries_.clear();
+  slots_.clear();
+}
+
+size_t Value::ObjectValues::findEntry(const CZString& key) const {
+  const size_t count = entries_.size();
+  if (!key.data()) {
+    // array indexes are sorted and an appended array has no hole
+    const ArrayIndex index = key.index();
+    if (index < count && entries_[index].first.index() == index)
+      return index;
+    auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), key,
+        [](const value_type& entry, const CZString& k) {
+          return entry.first < k;
+        });
+    return it != entries_.end() && it->first == key
+               ? static_cast<size_t>(it - entries_.begin())
+               : count;
+  }
+  if (slots_.empty()) {
+    for (size_t i = 0; i < count; ++i) {
+      if (entries_[i].first == key)
+        return i;
+    }
+    return count;
+  }
+  const unsigned hash = hashMemberName(key.data(), key.length());
+  const size_t mask = slots_.size() - 1;
+  for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+    const Slot& current = slots_[slot];
+    if (current.entry == 0)
+      return count;
+    if (current.hash == hash && entries_[current.entry - 1].first == key)
+      return current.entry - 1;
+  }
+}
+
+void Value::ObjectValues::insertSlot(unsigned hash, size_t entry) {
+  const size_t mask = slots_.size() - 1;
+  size_t slot = hash & mask;
+  while (slots_[slot].entry != 0)
+    slot = (slot + 1) & mask;
+  slots_[slot].hash = hash;
+  slots_[slot].entry = static_cast<unsigned>(entry + 1);
+}
+
+void Value::ObjectValues::rebuildSlots() {
+  // power of two, at most half full
+  size_t capacity = hashThreshold * 2;
+  while (capacity < entries_.size() * 2)
+    capacity *= 2;
+  slots_.assign(capacity, Slot{0, 0});
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const CZString& key = entries_[i].first;
+    insertSlot(hashMemberName(key.data(), key.length()), i);
+  }
+}
+
+Value::ObjectValues::iterator Value::ObjectValues::find(const CZString& key) {
+  return entries_.begin() + static_cast<ptrdiff_t>(findEntry(key));
+}
+
+Value::ObjectValues::const_iterator
+Value::ObjectValues::find(const CZString& key) const {
+  return entries_.begin() + static_cast<ptrdiff_t>(findEntry(key));
+}
+
+std::pair<Value::ObjectValues::iterator, bool>
+Value::ObjectValues::emplace(const CZString& key, Value&& value) {
+  const size_t found = findEntry(key);
+  if (found != entries_.size())
+    return std::make_pair(entries_.begin() + static_cast<ptrdiff_t>(found),
+                          false);
+  // an arena key is shared by every member with that name, copies of the
+  // value duplicate it
+  CZString stored =
+      arena_ && key.data()
+          ? CZString(arena_->internKey(key.data(), key.data() + key.length()),
+                     key.length(), CZString::duplicateOnCopy)
+          : CZString(key);
+  if (!key.data() && !entries_.empty() && key < entries_.back().first) {
+    // an index below the last one, only when an array is filled out of order
+    auto it = std::lower_bound(
+        entries_.begin(), entries_.end(), key,
+        [](const value_type& entry, const CZString& k) {
+          return entry.first < k;
+        });
+    it = entries_.emplace(it, std::piecewise_construct,
+                          std::forward_as_tuple(std::move(stored)),
+                          std::forward_as_tuple(std::move(value)));
+    return std::make_pair(it, true);
+  }
+  entries_.emplace_back(std::piecewise_construct,
+                        std::forward_as_tuple(std::move(stored)),
+                        std::forward_as_tuple(std::move(value)));
+  if (key.data()) {
+    if (!slots_.empty() && entries_.size() * 2 <= slots_.size())
+      insertSlot(hashMemberName(key.data(), key.length()),
+                 entries_.size() - 1);
+    else if (entries_.size() > hashThreshold)
+      rebuildSlots();
+  }
+  return std::make_pair(entries_.end() - 1, true);
+}
+
+Value::ObjectValues::iterator
+Value::ObjectValues::erase(const_iterator it) {
+  iterator next = entries_.erase(it);
+  // the entries behind it moved, removal is rare enough to reindex all
+  if (!slots_.empty()) {
+    if (entries_.size() > hashThreshold)
+      rebuildSlots();
+    else
+      slots_.clear();
+  }
+  return next;
+}
+
+size_t Value::ObjectValues::erase(const CZString& key) {
+  const_iterator it = find(key);
+  if (it == entries_.end())
+    return 0;
+  erase(it);
+  return 1;
+}
+
+bool Value::ObjectValues::operator==(const ObjectValues& other) const {
+  if (entries_.size() != other.entries_.size())
+    return false;
+  for (const value_type& entry : entries_) {
+    const size_t found = other.findEntry(entry.first);
+    if (found == other.entries_.size() ||
+        !(entry.second == other.entries_[found].second))
+      return false;
+  }
+  return true;
+}
+
+bool Value::ObjectValues::operator<(const ObjectValues& other) const {
+  auto sortedEntries = [](const Entries& entries) {
+    std::vector<const value_type*> sorted;
+    sorted.reserve(entries.size());
+    for (const value_type& entry : entries)
+      sorted.push_back(&entry);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const value_type* a, const value_type* b) {
+                return a->first < b->first;
+              });
+    return sorted;
+  };
+  const std::vector<const value_type*> mine = sortedEntries(entries_);
+  const std::vector<const value_type*> theirs = sortedEntries(other.entries_);
+  return std::lexicographical_compare(
+      mine.begin(), mine.end(), theirs.begin(), theirs.end(),
+      [](const value_type* a, const value_type* b) {
+        if (a->first < b->first)
+          return true;
+        if (b->first < a->first)
+          return false;
+        return a->second < b->second;
+      });
+}
+
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
@@ -412,6 +623,33 @@ Value::Value(const char* begin, const char* end) {
       duplicateAndPrefixStringValue(begin, static_cast<unsigned>(end - begin));
 }
 
+Value::Value(ValueType type, Arena* arena)
+    : Value(type == arrayValue || type == objectValue ? nullValue : type) {
+  if (type != arrayValue && type != objectValue)
+    return;
+  setType(type);
+  if (arena) {
+    value_.map_ = new (arena->allocate(sizeof(ObjectValues),
+                                       alignof(ObjectValues)))
+        ObjectValues(arena);
+    setIsInArena(true);
+  } else {
+    value_.map_ = new ObjectValues();
+  }
+}
+
+Value::Value(const char* begin, const char* end, Arena* arena) {
+  initBasic(stringValue, true);
+  if (arena) {
+    value_.string_ = arenaPrefixedStringValue(
+        *arena, begin, static_cast<unsigned>(end - begin));
+    setIsInArena(true);
+  } else {
+    value_.string_ = duplicateAndPrefixStringValue(
+        begin, static_cast<unsigned>(end - begin));
+  }
+}
+
 Value::Value(const String& value) {
   initBasic(stringValue, true);
   value_.string_ = duplicateAndPrefixStringValue(
@@ -423,6 +661,12 @@ Value::Value(const StaticString& value) {
   value_.string_ = const_cast<char*>(value.c_str());
 }
 
+Value::Value(const InSituString& value) {
+  initBasic(stringValue);
+  value_.string_ = const_cast<char*>(value.c_str());
+  setIsInArena(true);
+}
+
 Value::Value(bool value) {
   initBasic(booleanValue);
   value_.bool_ = value;
@@ -915,8 +1159,9 @@ void Value::resize(ArrayIndex newSize) {
     for (ArrayIndex i = oldSize; i < newSize; ++i)
       (*this)[i];
   else {
-    for (ArrayIndex index = newSize; index < oldSize; ++index) {
-      value_.map_->erase(index);
+    // from the back, each erase is a pop
+    for (ArrayIndex index = oldSize; index > newSize; --index) {
+      value_.map_->erase(index - 1);
     }
     JSON_ASSERT(size() == newSize);
   }
@@ -929,13 +1174,7 @@ Value& Value::operator[](ArrayIndex index) {
   if (type() == nullValue)
     *this = Value(arrayValue);
   CZString key(index);
-  auto it = value_.map_->lower_bound(key);
-  if (it != value_.map_->end() && (*it).first == key)
-    return (*it).second;
-
-  ObjectValues::value_type defaultValue(key, nullSingleton());
-  it = value_.map_->insert(it, defaultValue);
-  return (*it).second;
+  return value_.map_->emplace(key, Value()).first->second;
 }
 
 Value& Value::operator[](int index) {
@@ -968,6 +1207,7 @@ const Value& Value::operator[](int index) const {
 void Value::initBasic(ValueType type, bool allocated) {
   setType(type);
   setIsAllocated(allocated);
+  setIsInArena(false);
   comments_ = Comments{};
   start_ = 0;
   limit_ = 0;
@@ -976,6 +1216,7 @@ void Value::initBasic(ValueType type, bool allocated) {
 void Value::dupPayload(const Value& other) {
   setType(other.type());
   setIsAllocated(false);
+  setIsInArena(false);
   switch (type()) {
   case nullValue:
   case intValue:
@@ -985,7 +1226,7 @@ void Value::dupPayload(const Value& other) {
     value_ = other.value_;
     break;
   case stringValue:
-    if (other.value_.string_ && other.isAllocated()) {
+    if (other.value_.string_ && (other.isAllocated() || other.isInArena())) {
       unsigned len;
       char const* str;
       decodePrefixedString(other.isAllocated(), other.value_.string_, &len,
@@ -1014,12 +1255,16 @@ void Value::releasePayload() {
   case booleanValue:
     break;
   case stringValue:
-    if (isAllocated())
+    if (isAllocated() && !isInArena())
       releasePrefixedStringValue(value_.string_);
     break;
   case arrayValue:
   case objectValue:
-    delete value_.map_;
+    // the members are destroyed, their memory goes with the arena
+    if (isInArena())
+      value_.map_->~ObjectValues();
+    else
+      delete value_.map_;
     break;
   default:
     JSON_ASSERT_UNREACHABLE;
@@ -1043,14 +1288,7 @@ Value& Value::resolveReference(const char* key) {
     *this = Value(objectValue);
   CZString actualKey(key, static_cast<unsigned>(strlen(key)),
                      CZString::noDuplication); // NOTE!
-  auto it = value_.map_->lower_bound(actualKey);
-  if (it != value_.map_->end() && (*it).first == actualKey)
-    return (*it).second;
-
-  ObjectValues::value_type defaultValue(actualKey, nullSingleton());
-  it = value_.map_->insert(it, defaultValue);
-  Value& value = (*it).second;
-  return value;
+  return value_.map_->emplace(actualKey, Value()).first->second;
 }
 
 // @param key is not null-terminated.
@@ -1062,14 +1300,7 @@ Value& Value::resolveReference(char const* key, char const* end) {
     *this = Value(objectValue);
   CZString actualKey(key, static_cast<unsigned>(end - key),
                      CZString::duplicateOnCopy);
-  auto it = value_.map_->lower_bound(actualKey);
-  if (it != value_.map_->end() && (*it).first == actualKey)
-    return (*it).second;
-
-  ObjectValues::value_type defaultValue(actualKey, nullSingleton());
-  it = value_.map_->insert(it, defaultValue);
-  Value& value = (*it).second;
-  return value;
+  return value_.map_->emplace(actualKey, Value()).first->second;
 }
 
 Value Value::get(ArrayIndex index, const Value& defaultValue) const {
@@ -1146,7 +1377,9 @@ bool Value::insert(ArrayIndex index, Value&& newValue) {
     return false;
   }
   for (ArrayIndex i = length; i > index; i--) {
-    (*this)[i] = std::move((*this)[i - 1]);
+    // taken out first, creating (*this)[i] may move the members
+    Value moved(std::move((*this)[i - 1]));
+    (*this)[i] = std::move(moved);
   }
   (*this)[index] = std::move(newValue);
   return true;
@@ -1209,8 +1442,11 @@ bool Value::removeIndex(ArrayIndex index, Value* removed) {
   ArrayIndex oldSize = size();
   // shift left all items left, into the place of the "removed"
   for (ArrayIndex i = index; i < (oldSize - 1); ++i) {
-    CZString keey(i);
-    (*value_.map_)[keey] = (*this)[i + 1];
+    auto next = value_.map_->find(CZString(i + 1));
+    Value moved;
+    if (next != value_.map_->end())
+      moved.swap(next->second);
+    (*this)[i] = std::move(moved);
   }
   // erase the last one ("leftover")
   CZString keyLast(oldSize - 1);
@@ -1243,6 +1479,11 @@ Value::Members Value::getMemberNames() const {
   for (; it != itEnd; ++it) {
     members.push_back(String((*it).first.data(), (*it).first.length()));
   }
+#if !JSON_USE_INSERTION_ORDER
+  // the writers list members in this order, keep it independent of how the
+  // object was built
+  std::sort(members.begin(), members.end());
+#endif
   return members;
 }
 
@@ -136,24 +136,46 @@ String valueToString(double value, bool useSpecialFloats,
                [isnan(value) ? 0 : (value < 0) ? 1 : 2];
   }
 
-  String buffer(size_t(36), '\0');
-  while (true) {
-    int len = jsoncpp_snprintf(
-        &*buffer.begin(), buffer.size(),
-        (precisionType == PrecisionType::significantDigits) ? "%.*g" : "%.*f",
-        precision, value);
-    assert(len >= 0);
-    auto wouldPrint = static_cast<size_t>(len);
-    if (wouldPrint >= buffer.size()) {
-      buffer.resize(wouldPrint + 1);
-      continue;
+  String buffer;
+#if JSONCPP_HAS_FLOAT_CHARCONV
+  // Same text as the printf formats below, except that the default precision
+  // prints the shortest text that reads back to the same double.
+  char chars[64];
+  std::to_chars_result result;
+  if (precisionType == PrecisionType::decimalPlaces)
+    result = std::to_chars(chars, chars + sizeof(chars), value,
+                           std::chars_format::fixed,
+                           static_cast<int>(precision));
+  else if (precision == Value::defaultRealPrecision)
+    result = std::to_chars(chars, chars + sizeof(chars), value);
+  else
+    result = std::to_chars(chars, chars + sizeof(chars), value,
+                           std::chars_format::general,
+                           static_cast<int>(precision));
+  if (result.ec == std::errc())
+    buffer.assign(chars, result.ptr);
+#endif
+  if (buffer.empty()) {
+    buffer.resize(36);
+    while (true) {
+      int len = jsoncpp_snprintf(
+          &*buffer.begin(), buffer.size(),
+          (precisionType == PrecisionType::significantDigits) ? "%.*g"
+                                                               : "%.*f",
+          precision, value);
+      assert(len >= 0);
+      auto wouldPrint = static_cast<size_t>(len);
+      if (wouldPrint >= buffer.size()) {
+        buffer.resize(wouldPrint + 1);
+        continue;
+      }
+      buffer.resize(wouldPrint);
+      break;
     }
-    buffer.resize(wouldPrint);
-    break;
+    buffer.erase(fixNumericLocale(buffer.begin(), buffer.end()),
+                 buffer.end());
   }
 
-  buffer.erase(fixNumericLocale(buffer.begin(), buffer.end()), buffer.end());
-
   // try to ensure we preserve the fact that this was given to us as a double on
   // input
   if (buffer.find('.') == buffer.npos && buffer.find('e') == buffer.npos) {
@@ -0,0 +1,120 @@
+#include "Engine/YRenderScene.h"
+#include <cstdio>
+#include <vector>
+
+// draw_merge_validation
+// YRenderScene::MergeInstancedDraws on fake proxies, no window or device is created
+// the mesh pointers are never dereferenced, only compared
+
+static int g_fail_count = 0;
+
+static void Check(bool condition, const char* what)
+{
+	if (!condition)
+	{
+		printf("fail: %s\n", what);
+		++g_fail_count;
+	}
+}
+
+// the x translation of every primitive is its collection index, so the order can be read back from the matrices
+static void AddPrimitive(YRenderScene& scene, YStaticMesh* mesh)
+{
+	PrimitiveElementProxy primitive_elem;
+	primitive_elem.mesh_ = mesh;
+	primitive_elem.local_to_world_ = YMatrix::Identity;
+	primitive_elem.local_to_world_.m[3][0] = (float)scene.primitive_elements_.size();
+	scene.primitive_elements_.push_back(primitive_elem);
+}
+
+static YStaticMesh* FakeMesh(int index)
+{
+	return reinterpret_cast<YStaticMesh*>((size_t)(index + 1) * 64);
+}
+
+static void CheckMixedScene()
+{
+	// mesh 0 three times, mesh 1 once, mesh 2 twice, two primitives without mesh
+	const int mesh_order[] = { 0, 1, 2, 0, 2, 0 };
+	YRenderScene scene;
+	for (int mesh_index : mesh_order)
+	{
+		AddPrimitive(scene, FakeMesh(mesh_index));
+	}
+	AddPrimitive(scene, nullptr);
+	AddPrimitive(scene, nullptr);
+	scene.MergeInstancedDraws();
+
+	const YDrawMergeStats& stats = scene.draw_merge_stats_;
+	Check(stats.primitive_count == 8, "primitive_count");
+	Check(stats.batch_count == 2, "batch_count");
+	Check(stats.merged_primitive_count == 5, "merged_primitive_count");
+	Check(stats.draw_count_before == 8, "draw_count_before");
+	Check(stats.draw_count_after == 5, "draw_count_after");
+	Check(scene.instanced_elements_.size() == 2, "instanced element count");
+	Check(scene.instance_matrices_.size() == 5, "instance matrix count");
+
+	// the single mesh 1 and the meshless primitives stay, in their collection order
+	Check(scene.primitive_elements_.size() == 3, "kept primitive count");
+	if (scene.primitive_elements_.size() == 3)
+	{
+		Check(scene.primitive_elements_[0].mesh_ == FakeMesh(1) && scene.primitive_elements_[0].local_to_world_.m[3][0] == 1.0f, "kept mesh 1");
+		Check(!scene.primitive_elements_[1].mesh_ && scene.primitive_elements_[1].local_to_world_.m[3][0] == 6.0f, "kept first meshless");
+		Check(!scene.primitive_elements_[2].mesh_ && scene.primitive_elements_[2].local_to_world_.m[3][0] == 7.0f, "kept second meshless");
+	}
+
+	// every batch holds the instances of its mesh in collection order
+	for (const InstancedElementProxy& instanced_elem : scene.instanced_elements_)
+	{
+		const int expected_count = instanced_elem.mesh_ == FakeMesh(0) ? 3 : instanced_elem.mesh_ == FakeMesh(2) ? 2 : -1;
+		Check(instanced_elem.instance_count_ == expected_count, "batch instance count");
+		float prev_index = -1.0f;
+		for (int i = instanced_elem.first_instance_; i < instanced_elem.first_instance_ + instanced_elem.instance_count_; ++i)
+		{
+			const float index = scene.instance_matrices_[i].m[3][0];
+			Check(index > prev_index, "instance order");
+			Check(FakeMesh(mesh_order[(int)index]) == instanced_elem.mesh_, "instance mesh");
+			prev_index = index;
+		}
+	}
+}
+
+static void CheckMinBatchSize()
+{
+	YRenderScene scene;
+	for (int i = 0; i < 6; ++i)
+	{
+		AddPrimitive(scene, FakeMesh(i % 3));
+	}
+	// two primitives per mesh, below the batch size nothing is merged
+	scene.MergeInstancedDraws(3);
+	Check(scene.draw_merge_stats_.batch_count == 0, "min batch size, batch_count");
+	Check(scene.draw_merge_stats_.draw_count_after == 6, "min batch size, draw_count_after");
+	Check(scene.primitive_elements_.size() == 6 && scene.instanced_elements_.empty(), "min batch size, untouched");
+}
+
+static void CheckLargeScene()
+{
+	const int primitive_count = 20000;
+	const int mesh_count = 5;
+	YRenderScene scene;
+	for (int i = 0; i < primitive_count; ++i)
+	{
+		AddPrimitive(scene, FakeMesh(i % mesh_count));
+	}
+	scene.MergeInstancedDraws();
+	Check(scene.draw_merge_stats_.batch_count == mesh_count, "large scene, batch_count");
+	Check(scene.draw_merge_stats_.draw_count_after == mesh_count, "large scene, draw_count_after");
+	Check(scene.instance_matrices_.size() == primitive_count && scene.primitive_elements_.empty(), "large scene, all merged");
+	printf("%d primitives of %d meshes: %d draws instead of %d\n", primitive_count, mesh_count,
+		scene.draw_merge_stats_.draw_count_after, scene.draw_merge_stats_.draw_count_before);
+}
+
+int main()
+{
+	CheckMixedScene();
+	CheckMinBatchSize();
+	CheckLargeScene();
+	printf("draw merge %s\n", g_fail_count ? "fail" : "pass");
+	return g_fail_count ? 1 : 0;
+}
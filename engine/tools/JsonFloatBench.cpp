@@ -0,0 +1,232 @@
+#include <json.h>
+#include <json_tool.h>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <locale>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// json_float_bench [-actors n] [-repeat n] [-save doc.json]
+// times FastWriter and Reader on a float heavy world document shaped like the scene json,
+// next to the istringstream/snprintf conversions jsoncpp used before from_chars/to_chars,
+// configure with -DCMAKE_CXX_FLAGS=-DJSONCPP_HAS_FLOAT_CHARCONV=0 to time the whole document on the strtod/snprintf fallback
+
+static Json::Value MakeFloatArray(std::mt19937& rng, int count, float range)
+{
+	std::uniform_real_distribution<float> dist(-range, range);
+	Json::Value array(Json::arrayValue);
+	for (int i = 0; i < count; ++i)
+	{
+		array.append((double)dist(rng));
+	}
+	return array;
+}
+
+static Json::Value MakeFloatDocument(int actor_count)
+{
+	std::mt19937 rng(12345);
+	Json::Value root;
+	Json::Value& actors = root["actors"];
+	for (int i = 0; i < actor_count; ++i)
+	{
+		Json::Value actor;
+		actor["name"] = "actor_" + std::to_string(i);
+		Json::Value& component = actor["root_component"];
+		component["type"] = "StaticMeshComponent";
+		component["local_translation"] = MakeFloatArray(rng, 3, 10000.0f);
+		component["local_rotation"] = MakeFloatArray(rng, 4, 1.0f);
+		component["local_scale"] = MakeFloatArray(rng, 3, 4.0f);
+		component["color"] = MakeFloatArray(rng, 3, 1.0f);
+		actors.append(actor);
+	}
+	return root;
+}
+
+static void CollectNumbers(const Json::Value& value, std::vector<double>& numbers)
+{
+	if (value.isDouble())
+	{
+		numbers.push_back(value.asDouble());
+	}
+	else if (value.isArray() || value.isObject())
+	{
+		for (const Json::Value& child : value)
+		{
+			CollectNumbers(child, numbers);
+		}
+	}
+}
+
+// volatile so the parsed numbers are not thrown away
+static volatile double number_sink = 0.0;
+
+template<typename Func>
+static double BestOfMs(int repeat, Func&& func)
+{
+	double best = 0.0;
+	for (int i = 0; i < repeat; ++i)
+	{
+		const auto begin = std::chrono::steady_clock::now();
+		func();
+		const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+		best = i == 0 ? ms : std::min(best, ms);
+	}
+	return best;
+}
+
+// doubles and floats printed by FastWriter must read back to the same bits
+static int CountRoundTripErrors(int count)
+{
+	std::mt19937_64 rng(6789);
+	std::uniform_int_distribution<uint64_t> bits_dist;
+	Json::Value array(Json::arrayValue);
+	std::vector<double> expected;
+	while ((int)expected.size() < count)
+	{
+		const uint64_t bits = bits_dist(rng);
+		double d = 0.0;
+		memcpy(&d, &bits, sizeof(d));
+		if (!std::isfinite(d))
+		{
+			continue;
+		}
+		const double as_float = (double)(float)d;
+		expected.push_back(d);
+		expected.push_back(std::isfinite(as_float) ? as_float : 0.0);
+	}
+	for (double d : expected)
+	{
+		array.append(d);
+	}
+	Json::FastWriter writer;
+	const std::string text = writer.write(array);
+	Json::Value read_back;
+	Json::Reader reader;
+	if (!reader.parse(text, read_back) || read_back.size() != expected.size())
+	{
+		return (int)expected.size();
+	}
+	int errors = 0;
+	for (Json::ArrayIndex i = 0; i < read_back.size(); ++i)
+	{
+		const double d = read_back[i].asDouble();
+		errors += memcmp(&d, &expected[i], sizeof(d)) != 0;
+	}
+	return errors;
+}
+
+int main(int argc, char** argv)
+{
+	int actor_count = 20000;
+	int repeat = 5;
+	std::string save_path;
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "-actors") && has_value)
+		{
+			actor_count = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "-repeat") && has_value)
+		{
+			repeat = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "-save") && has_value)
+		{
+			save_path = argv[++i];
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-actors n] [-repeat n] [-save doc.json]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (actor_count < 1 || repeat < 1)
+	{
+		fprintf(stderr, "actors and repeat must be positive\n");
+		return 2;
+	}
+
+	const Json::Value document = MakeFloatDocument(actor_count);
+	std::vector<double> numbers;
+	CollectNumbers(document, numbers);
+	Json::FastWriter writer;
+	std::string text = writer.write(document);
+	if (!save_path.empty())
+	{
+		std::ofstream(save_path, std::ios::binary) << text;
+	}
+	printf("charconv %s, %d actors, %zu numbers, %.1f MB, best of %d\n", JSONCPP_HAS_FLOAT_CHARCONV ? "on" : "off",
+		actor_count, numbers.size(), text.size() / (1024.0 * 1024.0), repeat);
+
+	const double write_ms = BestOfMs(repeat, [&]() { text = writer.write(document); });
+	const double read_ms = BestOfMs(repeat, [&]()
+	{
+		Json::Value root;
+		Json::Reader reader;
+		if (!reader.parse(text, root))
+		{
+			fprintf(stderr, "parse failed: %s\n", reader.getFormattedErrorMessages().c_str());
+			exit(1);
+		}
+	});
+
+	// the conversions alone, legacy is what valueToString and decodeDouble did before charconv
+	std::vector<std::string> number_texts(numbers.size());
+	const double legacy_print_ms = BestOfMs(repeat, [&]()
+	{
+		char buffer[36];
+		for (size_t i = 0; i < numbers.size(); ++i)
+		{
+			snprintf(buffer, sizeof(buffer), "%.17g", numbers[i]);
+			number_texts[i] = buffer;
+		}
+	});
+	const double print_ms = BestOfMs(repeat, [&]()
+	{
+		for (size_t i = 0; i < numbers.size(); ++i)
+		{
+			number_texts[i] = Json::valueToString(numbers[i]);
+		}
+	});
+	const double legacy_parse_ms = BestOfMs(repeat, [&]()
+	{
+		std::istringstream is;
+		is.imbue(std::locale::classic());
+		for (const std::string& number_text : number_texts)
+		{
+			double d = 0.0;
+			is.clear();
+			is.str(number_text);
+			is >> d;
+			number_sink = d;
+		}
+	});
+	const double parse_ms = BestOfMs(repeat, [&]()
+	{
+		for (const std::string& number_text : number_texts)
+		{
+			double d = 0.0;
+			Json::decodeDoubleValue(number_text.data(), number_text.data() + number_text.size(), d);
+			number_sink = d;
+		}
+	});
+
+	printf("%-28s %10.2f ms\n", "FastWriter document", write_ms);
+	printf("%-28s %10.2f ms\n", "Reader document", read_ms);
+	printf("%-28s %10.2f ms\n", "print legacy %.17g", legacy_print_ms);
+	printf("%-28s %10.2f ms\n", "print valueToString", print_ms);
+	printf("%-28s %10.2f ms\n", "parse legacy istringstream", legacy_parse_ms);
+	printf("%-28s %10.2f ms\n", "parse decodeDoubleValue", parse_ms);
+
+	const int round_trip_errors = CountRoundTripErrors(100000);
+	printf("round trip errors %d\n", round_trip_errors);
+	return round_trip_errors == 0 ? 0 : 1;
+}
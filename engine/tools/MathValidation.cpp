@@ -0,0 +1,41 @@
+#include "Math/YMathValidation.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// math_validation [report.json] [-array_size n] [-samples n] [-repeat n]
+// the same report as the -math_validation option of the demo, from a build without the renderer
+int main(int argc, char** argv)
+{
+	std::string path = "math_validation.json";
+	YMathValidationOptions options;
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "-array_size") && has_value)
+		{
+			options.array_size = (size_t)strtoull(argv[++i], nullptr, 10);
+		}
+		else if (!strcmp(argv[i], "-samples") && has_value)
+		{
+			options.accuracy_samples = (size_t)strtoull(argv[++i], nullptr, 10);
+		}
+		else if (!strcmp(argv[i], "-repeat") && has_value)
+		{
+			options.repeat = atoi(argv[++i]);
+		}
+		else if (argv[i][0] != '-')
+		{
+			path = argv[i];
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [report.json] [-array_size n] [-samples n] [-repeat n]\n", argv[0]);
+			return 2;
+		}
+	}
+	const bool pass = YMathValidation::RunToFile(path, options);
+	printf("%s %s\n", path.c_str(), pass ? "pass" : "fail");
+	return pass ? 0 : 1;
+}
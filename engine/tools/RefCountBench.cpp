@@ -0,0 +1,114 @@
+#include "Engine/YReferenceCount.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// refcount_bench [-threads n] [-iterations n]
+// cost of one AddRef+Release pair for both counting policies, every thread either hammers one shared object
+// or its own object, the shared case is the contention a render thread and the game thread would see
+
+template<ERefCountMode Mode>
+class alignas(64) TBenchObject : public TRefCountedObject<Mode>
+{
+};
+
+// every thread adds its own sum once at the end, so the returned counts are used
+static std::atomic<uint32_t> refs_sink(0);
+
+template<ERefCountMode Mode>
+static double MeasurePairNs(int thread_count, size_t iterations, bool shared)
+{
+	std::vector<TBenchObject<Mode>*> objects(shared ? 1 : thread_count);
+	for (TBenchObject<Mode>*& object : objects)
+	{
+		object = new TBenchObject<Mode>();
+		object->AddRef();
+	}
+	std::atomic<int> ready(0);
+	std::atomic<bool> go(false);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < thread_count; ++t)
+	{
+		TBenchObject<Mode>* object = objects[shared ? 0 : t];
+		threads.emplace_back([object, iterations, &ready, &go]()
+		{
+			ready.fetch_add(1);
+			while (!go.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+			uint32_t sink = 0;
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				sink += object->AddRef();
+				// compiler barrier only, keeps the plain counter from folding the pair away
+				std::atomic_signal_fence(std::memory_order_seq_cst);
+				sink += object->Release();
+			}
+			refs_sink.fetch_add(sink, std::memory_order_relaxed);
+		});
+	}
+	while (ready.load() != thread_count)
+	{
+		std::this_thread::yield();
+	}
+	const auto begin = std::chrono::steady_clock::now();
+	go.store(true, std::memory_order_release);
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	const auto end = std::chrono::steady_clock::now();
+	for (TBenchObject<Mode>* object : objects)
+	{
+		object->Release();
+	}
+	// wall time per pair of one thread, equal to the single thread cost when nothing is contended
+	return std::chrono::duration<double, std::nano>(end - begin).count() / (double)iterations;
+}
+
+int main(int argc, char** argv)
+{
+	int max_threads = (int)std::thread::hardware_concurrency();
+	if (max_threads < 2)
+	{
+		max_threads = 2;
+	}
+	size_t iterations = 10000000;
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool has_value = i + 1 < argc;
+		if (!strcmp(argv[i], "-threads") && has_value)
+		{
+			max_threads = atoi(argv[++i]);
+		}
+		else if (!strcmp(argv[i], "-iterations") && has_value)
+		{
+			iterations = (size_t)strtoull(argv[++i], nullptr, 10);
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [-threads n] [-iterations n]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (max_threads < 1 || iterations == 0)
+	{
+		fprintf(stderr, "threads and iterations must be positive\n");
+		return 2;
+	}
+	printf("hardware threads %u, %zu pairs per thread\n", std::thread::hardware_concurrency(), iterations);
+	// the plain counter is only valid on one thread, it is the baseline
+	printf("%-14s %8s %-8s %10s\n", "mode", "threads", "object", "ns/pair");
+	printf("%-14s %8d %-8s %10.2f\n", "NotThreadSafe", 1, "private", MeasurePairNs<ERefCountMode::NotThreadSafe>(1, iterations, false));
+	for (int thread_count = 1; thread_count <= max_threads; thread_count *= 2)
+	{
+		printf("%-14s %8d %-8s %10.2f\n", "ThreadSafe", thread_count, "private", MeasurePairNs<ERefCountMode::ThreadSafe>(thread_count, iterations, false));
+		printf("%-14s %8d %-8s %10.2f\n", "ThreadSafe", thread_count, "shared", MeasurePairNs<ERefCountMode::ThreadSafe>(thread_count, iterations, true));
+	}
+	return 0;
+}
@@ -25,6 +25,8 @@ public:
 	static YRotator ConvertRotation(const FbxQuaternion& quaternion);
 	static YQuat ConvertFbxQutaToQuat(const FbxQuaternion& quaternion);
 	static YMatrix ConvertFbxMatrix(const FbxAMatrix& matrix);
+	// m with m.TransformPosition(p) == ConvertPos(matrix.MultT(p)), for converting points in bulk with YBatchMath
+	static YMatrix ConvertTransformMatrix(const FbxAMatrix& matrix);
 
 	//our to fbx
 	static FbxVector4 ConvertToFbxPos(const YVector& vector);
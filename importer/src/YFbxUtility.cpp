@@ -92,6 +92,20 @@ YMatrix FbxDataConverter::ConvertFbxMatrix(const FbxAMatrix& matrix)
 	return us_matrix;
 }
 
+YMatrix FbxDataConverter::ConvertTransformMatrix(const FbxAMatrix& matrix)
+{
+	// ConvertPos and ConvertDir negate z, the third column for row vectors
+	YMatrix us_matrix;
+	for (int i = 0; i < 4; ++i)
+	{
+		us_matrix.m[i][0] = (float)matrix[i][0];
+		us_matrix.m[i][1] = (float)matrix[i][1];
+		us_matrix.m[i][2] = (float)-matrix[i][2];
+		us_matrix.m[i][3] = (float)matrix[i][3];
+	}
+	return us_matrix;
+}
+
 FbxVector4 FbxDataConverter::ConvertToFbxPos(const YVector& vector)
 {
 	FbxVector4 fbx_pos(vector.x, vector.y, vector.z);
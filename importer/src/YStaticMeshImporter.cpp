@@ -6,6 +6,21 @@
 #include "YFbxUtility.h"
 #include "Engine/YMaterial.h"
 #include "Engine/YLog.h"
+#include "Math/YBatchMath.h"
+
+// the direct values of a normal, tangent or binormal layer through matrix, indexed like the direct array
+template<typename FbxLayerElementType>
+static void ConvertLayerDirections(FbxLayerElementType* layer, const YMatrix& matrix, std::vector<YVector>& directions)
+{
+	const int count = layer->GetDirectArray().GetCount();
+	directions.resize(count);
+	for (int i = 0; i < count; ++i)
+	{
+		const FbxVector4 value = layer->GetDirectArray().GetAt(i);
+		directions[i] = YVector((float)value[0], (float)value[1], (float)value[2]);
+	}
+	YBatchMath::TransformVectors(directions.data(), matrix, directions.data(), directions.size());
+}
 
 bool YFbxImporter::BuildStaticMeshFromGeometry(FbxNode* node, YLODMesh* raw_mesh, std::vector<YFbxMaterial*>& existing_materials)
 {
@@ -162,14 +177,39 @@ bool YFbxImporter::BuildStaticMeshFromGeometry(FbxNode* node, YLODMesh* raw_mesh
 	//lod_mesh->vertex_instance_uvs.resize(uv_num);
 
 
+	// control points, normals, tangents and binormals are converted in bulk, the handedness flip is folded into the matrices
+	std::vector<YVector> control_points(vertex_count);
+	{
+		const FbxVector4* fbx_control_points = fbx_mesh->GetControlPoints();
+		for (int vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
+		{
+			const FbxVector4& fbx_position = fbx_control_points[vertex_index];
+			control_points[vertex_index] = YVector((float)fbx_position[0], (float)fbx_position[1], (float)fbx_position[2]);
+		}
+		YBatchMath::TransformPositions(control_points.data(), converter_.ConvertTransformMatrix(total_matrix), control_points.data(), control_points.size());
+	}
+	std::vector<YVector> normals;
+	std::vector<YVector> tangents;
+	std::vector<YVector> binormals;
+	{
+		const YMatrix normal_matrix = converter_.ConvertTransformMatrix(total_matrix_for_normal);
+		if (normal_layer)
+		{
+			ConvertLayerDirections(normal_layer, normal_matrix, normals);
+		}
+		if (has_NTB_information)
+		{
+			ConvertLayerDirections(tangent_layer, normal_matrix, tangents);
+			ConvertLayerDirections(binormal_layer, normal_matrix, binormals);
+		}
+	}
+
+	raw_mesh->vertex_position.reserve(raw_mesh->vertex_position.size() + vertex_count);
 	for (int vertex_index = 0; vertex_index < vertex_count; ++vertex_index)
 	{
 		int real_vertex_index = vertex_offset + vertex_index;
-		FbxVector4 fbx_position = fbx_mesh->GetControlPoints()[vertex_index];
-		fbx_position = total_matrix.MultT(fbx_position);
-		const YVector vertex_position = converter_.ConvertPos(fbx_position);
 		YMeshVertex new_mesh_vertex;
-		new_mesh_vertex.position = vertex_position;
+		new_mesh_vertex.position = control_points[vertex_index];
 		raw_mesh->vertex_position.push_back(new_mesh_vertex);
 		if (raw_mesh->vertex_position.size() != (real_vertex_index + 1))
 		{
@@ -296,26 +336,20 @@ bool YFbxImporter::BuildStaticMeshFromGeometry(FbxNode* node, YLODMesh* raw_mesh
 					int normal_map_index = (normal_mapping_mode == FbxLayerElement::eByControlPoint) ? control_point_index : real_fbx_vertex_index;
 					int normal_value_index = (normal_reference_mode == FbxLayerElement::eDirect) ? normal_map_index : normal_layer->GetIndexArray().GetAt(normal_map_index);
 
-					FbxVector4 temp_value = normal_layer->GetDirectArray().GetAt(normal_value_index);
-					temp_value = total_matrix_for_normal.MultT(temp_value);
-					YVector tangent_z = converter_.ConvertDir(temp_value);
+					YVector tangent_z = normals[normal_value_index];
 					cur_vertex_instance.vertex_instance_normal = tangent_z;
 
 					if (has_NTB_information)
 					{
 						int tangent_map_index = (tangent_mapping_mode == FbxLayerElement::eByControlPoint) ? control_point_index : real_fbx_vertex_index;
 						int tangent_value_index = (tangent_reference_mode == FbxLayerElement::eDirect) ? tangent_map_index : tangent_layer->GetIndexArray().GetAt(tangent_map_index);
-						FbxVector4 tangent_value = tangent_layer->GetDirectArray().GetAt(tangent_value_index);
-						tangent_value = total_matrix_for_normal.MultT(tangent_value);
-						YVector tangent_x = converter_.ConvertDir(tangent_value);
+						YVector tangent_x = tangents[tangent_value_index];
 						cur_vertex_instance.vertex_instance_tangent = tangent_x;
 
 						int binormal_map_index = (binormal_mapping_mode == FbxLayerElement::eByControlPoint) ? control_point_index : real_fbx_vertex_index;
 						int binormal_value_index = (binormal_reference_mode == FbxLayerElement::eDirect) ? binormal_map_index : binormal_layer->GetIndexArray().GetAt(binormal_map_index);
-						FbxVector4 binormal_value = binormal_layer->GetDirectArray().GetAt(binormal_value_index);
-						binormal_value = total_matrix_for_normal.MultT(binormal_value);
 						// 
-						YVector tanget_y = -converter_.ConvertDir(binormal_value);
+						YVector tanget_y = -binormals[binormal_value_index];
 						cur_vertex_instance.vertex_instance_binormal_sign = YMath::GetBasisDeterminantSign(tangent_x, tanget_y, tangent_z);
 					}
 				}
@@ -1,4 +1,6 @@
 ﻿#include "D3DInit.h"
+#include "Math/YMathValidation.h"
+#include <cstring>
 
 HINSTANCE	g_hInstance(nullptr);
 HWND		g_hWnd(nullptr);
@@ -86,9 +88,37 @@ bool CreateWindows()
 	return TRUE;
 }
 
+// -math_validation [report.json] writes the math benchmark and accuracy report without opening a window
+static bool RunMathValidation(const char* cmd_line, int& exit_code)
+{
+	const char* option = strstr(cmd_line, "-math_validation");
+	if (!option)
+	{
+		return false;
+	}
+	const char* path_begin = option + strlen("-math_validation");
+	while (*path_begin == ' ')
+	{
+		++path_begin;
+	}
+	const char* path_end = path_begin;
+	while (*path_end && *path_end != ' ')
+	{
+		++path_end;
+	}
+	const std::string path = path_end > path_begin ? std::string(path_begin, path_end) : std::string("math_validation.json");
+	exit_code = YMathValidation::RunToFile(path) ? 0 : 1;
+	return true;
+}
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR cmdLine, int cmdShow)
 {
 	g_hInstance = hInstance;
+	int exit_code = 0;
+	if (RunMathValidation(cmdLine, exit_code))
+	{
+		return exit_code;
+	}
 
 	if (!CreateWindows())
 		return -1;
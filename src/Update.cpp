@@ -7,10 +7,13 @@
 #include "Utility/YPath.h"
 #include "Engine/YReferenceCount.h"
 #include "SObject/SWorld.h"
+#include "SObject/SWorldLoader.h"
+#include "SObject/SCookedWorld.h"
 #include "SObject/SObjectManager.h"
 #include "Engine/YRenderScene.h"
 #include "Render/YRenderInterface.h"
 #include "Render/YForwardRenderer.h"
+#include "Engine/YTaskSystem.h"
 ID3D11DeviceContext* g_deviceContext(nullptr);
 IDXGISwapChain* g_swapChain(nullptr);
 bool is_resizing = false;
@@ -23,11 +26,39 @@ std::unique_ptr<CameraController> camera_controller;
 std::chrono::time_point<std::chrono::high_resolution_clock> last_frame_time;
 std::chrono::time_point<std::chrono::high_resolution_clock> game_start_time;
 std::unique_ptr<IRenderInterface> renderer;
+std::unique_ptr<SWorldLoader> world_loader;
 AverageSmooth<float> fps(1000);
 bool show_demo_window = false;
 bool show_another_window = false;
 bool show_normal = false;
 YVector light_dir(0.0, 0.0, 0.0);
+// the last left click, the name is kept instead of the component which may be gone by the next frame
+std::string pick_text = "click a mesh to pick it";
+void PickAt(int x, int y)
+{
+	SWorld* world = SWorld::GetWorld();
+	if (!world || ImGui::GetIO().WantCaptureMouse)
+	{
+		return;
+	}
+	const YRay ray = main_camera->GetScreenRay((float)x, (float)y, (float)g_winWidth, (float)g_winHeight);
+	std::chrono::time_point<std::chrono::high_resolution_clock> start_time = std::chrono::high_resolution_clock::now();
+	SSceneHit hit;
+	world->RayCast(ray, hit);
+	const double pick_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start_time).count();
+	char text[256];
+	if (hit.IsValid())
+	{
+		YStaticMesh* mesh = hit.component->GetMesh();
+		snprintf(text, sizeof(text), "pick %s: group %d, polygon %d, uv (%.3f, %.3f), %.1f away, %.3f ms", mesh ? mesh->model_name.c_str() : "", hit.mesh_hit.polygon_group,
+			hit.mesh_hit.polygon, hit.mesh_hit.u, hit.mesh_hit.v, hit.mesh_hit.distance, pick_ms);
+	}
+	else
+	{
+		snprintf(text, sizeof(text), "pick nothing, %.3f ms", pick_ms);
+	}
+	pick_text = text;
+}
 bool InitIMGUI()
 {
 	// Setup Dear ImGui context
@@ -74,6 +105,7 @@ bool InitD3D()
 
 	//inmput manager
 	g_input_manager = new InputManger();
+	g_input_manager->mouse_LButton_down_funcs_.push_back([](int x, int y) { PickAt(x, y); });
 
 	// camera controller
 	{
@@ -114,9 +146,27 @@ bool InitD3D()
 
 	//load world
 	std::string world_map_path = "map/world.json";
-	TRefCountPtr<SWorld> new_world = SObjectManager::ConstructUnifyFromPackage<SWorld>(world_map_path);
+#if defined(COOK_WORLD_ON_LOAD)
+	// cmake -DCOOK_WORLD_ON_LOAD=ON, the loader below takes the fresh binary world like a shipped build
+	if (!SCookedWorld::CookWorldFile(world_map_path))
+	{
+		ERROR_INFO("cook world ", world_map_path, " failed");
+		return false;
+	}
+#endif
+	world_loader = std::make_unique<SWorldLoader>();
+	if (!world_loader->BeginLoad(world_map_path))
+	{
+		return false;
+	}
+	// first frame only waits for critical actors, the rest are finalized in Update
+	if (!world_loader->WaitForCriticalActors())
+	{
+		ERROR_INFO("load world ", world_map_path, " failed");
+		return false;
+	}
+	TRefCountPtr<SWorld> new_world = world_loader->GetWorld();
 	SWorld::SetWorld(new_world);
-	new_world->PostLoadOp();
 	SWorld::GetWorld()->SetCamera(main_camera.get());
 	renderer = std::make_unique<YForwardRenderer>();
 	if (!renderer->Init())
@@ -219,6 +269,25 @@ void DrawUI()
 		ImGui::Text("counter = %d", counter);
 
 		ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+		if (world_loader)
+		{
+			SWorldLoadProgress progress = world_loader->GetProgress();
+			ImGui::Text("world load %s: %d/%d actors, %.0f%%, %.1f ms", GetWorldLoadStageName(progress.stage), progress.finalized_actor_count, progress.total_actor_count, progress.GetFraction() * 100.0f, progress.elapsed_ms);
+		}
+		if (SWorld* world = SWorld::GetWorld())
+		{
+			if (SWorldPartition* partition = world->GetPartition())
+			{
+				SWorldPartitionStats stats = partition->GetStats();
+				ImGui::Text("cells %d/%d resident, %d loading, %d actors, %.1f MB, %d over budget", stats.resident_cell_count, stats.cell_count, stats.loading_cell_count, stats.resident_actor_count, stats.resident_bytes / (1024.0 * 1024.0), stats.budget_blocked_cell_count);
+			}
+			for (int phase = 0; phase < TP_Num; ++phase)
+			{
+				const STickPhaseStats& stats = world->GetTickPhaseStats((ETickPhase)phase);
+				ImGui::Text("%s: %.3f ms, %d actors, %d batches, %d commands", GetTickPhaseName((ETickPhase)phase), stats.time_ms, stats.actor_count, stats.batch_count, stats.command_count);
+			}
+		}
+		ImGui::Text("%s", pick_text.c_str());
 		ImGui::End();
 	}
 
@@ -238,6 +307,8 @@ void DrawUI()
 	ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
 }
 
+// gpu upload time per frame for actors still streaming in
+const double world_finalize_budget_ms = 4.0;
 void Update(double delta_time)
 {
 	camera_controller->Update(delta_time);
@@ -245,7 +316,12 @@ void Update(double delta_time)
 	DrawUtility::DrawGrid();
 	DrawUtility::DrawWorldCoordinate(main_camera.get());
 	g_Canvas->Update();
+	if (world_loader && world_loader->Tick(world_finalize_budget_ms))
+	{
+		world_loader = nullptr;
+	}
 	SWorld::GetWorld()->Update(delta_time);
+	SObjectManager::GetManager().FrameDestroy();
 }
 void Render()
 {
@@ -287,6 +363,8 @@ void Release()
 	delete g_input_manager;
 	g_input_manager = nullptr;
 	renderer->Clearup();
+	world_loader = nullptr;
+	YTaskSystem::Get().Shutdown();
 }
 
 void OnResize()
@@ -309,6 +387,14 @@ LRESULT CALLBACK WinProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
 	switch (msg)
 	{
+	case WM_LBUTTONDOWN:
+		g_input_manager->OnEventLButtonDown(x, y);
+		break;
+
+	case WM_LBUTTONUP:
+		g_input_manager->OnEventLButtonUp(x, y);
+		break;
+
 	case WM_RBUTTONDOWN:
 		SetCapture(hwnd);
 		g_input_manager->OnEventRButtonDown(x, y);